@@ -0,0 +1,31 @@
+# Virtual Sensor Replay Example
+#
+# USE THIS EXAMPLE WITH A USD CARD!
+#
+# On firmware built with the virtual sensor driver, sensor.reset() falls back to the virtual
+# sensor when no image sensor is attached. The virtual sensor replays frames recorded by the
+# Image Writer object, MJPEG files or numbered image files (e.g. "/frames/%04d.pgm") through
+# sensor.snapshot(), so the same script can be benchmarked against recorded data.
+
+import sensor, image, time
+
+sensor.reset()
+sensor.set_pixformat(sensor.RGB565)
+sensor.set_framesize(sensor.QQVGA)
+
+if sensor.get_id() == sensor.VSENSOR:
+    # Loop the recording and replay it at the recorded frame times. Set realtime to
+    # False to replay as fast as possible or use sensor.set_framerate() for a fixed rate.
+    sensor.ioctl(sensor.IOCTL_VSENSOR_SET_SOURCE, "/stream.bin", True, True)
+
+clock = time.clock()
+
+while(True):
+    clock.tick()
+    img = sensor.snapshot()
+    # Do machine vision algorithms on the image here.
+    if sensor.get_id() == sensor.VSENSOR:
+        frame, timestamp_ms = sensor.ioctl(sensor.IOCTL_VSENSOR_GET_FRAME_INFO)
+        print("frame %d at %d ms, %f fps" % (frame, timestamp_ms, clock.fps()))
+    else:
+        print(clock.fps())
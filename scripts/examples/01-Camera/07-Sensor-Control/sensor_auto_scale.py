@@ -0,0 +1,20 @@
+# Sensor Auto Scale
+#
+# This example shows off how to keep the whole field of view when the frame size is too large
+# for the frame buffer. By default frames that don't fit are switched to BAYER and cropped. With
+# auto scale enabled a smaller frame size with the same aspect ratio is used instead, which the
+# sensor produces by binning or scaling the image.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.WQXGA2) # Set frame size to WQXGA2 (2592x1944), too large to fit.
+sensor.auto_scale(True)             # Scale instead of cropping.
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    img = sensor.snapshot()         # Take a picture and return the image.
+    print("%dx%d %f fps" % (img.width(), img.height(), clock.fps()))
@@ -0,0 +1,31 @@
+# Sensor Bus Statistics
+#
+# This example shows off how to count the number of bus transfers and bytes used to
+# configure the sensor. Sensor drivers write register tables using burst writes and
+# skip registers that already hold the requested value, so switching between modes
+# that share most of their settings only costs a few transfers.
+
+import sensor, image, time
+
+sensor.ioctl(sensor.IOCTL_RESET_BUS_STATS)
+start = time.ticks_ms()
+sensor.reset()                      # Reset and initialize the sensor.
+print("Reset took %d ms, %d transfers, %d bytes" % \
+    ((time.ticks_diff(time.ticks_ms(), start),) + sensor.ioctl(sensor.IOCTL_GET_BUS_STATS)))
+
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+
+for framesize in [sensor.QVGA, sensor.VGA, sensor.QVGA, sensor.QVGA]:
+    sensor.ioctl(sensor.IOCTL_RESET_BUS_STATS)
+    start = time.ticks_ms()
+    sensor.set_framesize(framesize)
+    print("Mode switch took %d ms, %d transfers, %d bytes" % \
+        ((time.ticks_diff(time.ticks_ms(), start),) + sensor.ioctl(sensor.IOCTL_GET_BUS_STATS)))
+
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    img = sensor.snapshot()         # Take a picture and return the image.
+    print(clock.fps())
@@ -0,0 +1,25 @@
+# Sensor Capture Histogram
+#
+# This example shows off how to gather a luma histogram of each frame while it is being
+# captured. Each line is sampled as it's received from the sensor, so the histogram is
+# ready as soon as the frame is without an extra pass over the image.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.QVGA)   # Set frame size to QVGA (320x240)
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+
+sensor.ioctl(sensor.IOCTL_SET_CAPTURE_HISTOGRAM, True)
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    img = sensor.snapshot()         # Take a picture and return the image.
+    bins = sensor.ioctl(sensor.IOCTL_GET_CAPTURE_HISTOGRAM)
+    total = sum(bins)
+    if total:
+        # Each bin covers 4 luma levels, compute the mean luma from the bin centers.
+        mean = sum(((i * 4) + 2) * b for i, b in enumerate(bins)) // total
+        print("mean luma %d, %f fps" % (mean, clock.fps()))
@@ -0,0 +1,26 @@
+# Sensor HDR Capture
+#
+# This example shows off how to capture scenes with both dark shadows and bright highlights.
+# Each snapshot captures a frame with a long exposure time and a frame with a short exposure
+# time and fuses them by weighting each pixel by how well exposed it is. So, the shadows come
+# from the long exposure and the highlights from the short exposure.
+#
+# HDR capture lowers the frame rate and works in GRAYSCALE and RGB565 only.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.QVGA)   # Set frame size to QVGA (320x240)
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+
+# Use 4x and 1/4x the auto exposure time. The last argument is the number of frames the
+# sensor takes to apply a new exposure time (frames captured meanwhile are skipped).
+exposure_us = sensor.get_exposure_us()
+sensor.ioctl(sensor.IOCTL_SET_HDR, True, exposure_us * 4, exposure_us // 4, 1)
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    img = sensor.snapshot()         # Take an HDR picture and return the image.
+    print(clock.fps())
@@ -0,0 +1,26 @@
+# Sensor Line Scan
+#
+# This example shows off how to turn the camera into a line scan camera, e.g. to inspect
+# objects moving on a conveyor belt. Only a few rows are copied from each frame and appended
+# to a strip image, so snapshot() returns a picture built up over time without storing the
+# whole frames. The capture time of each row of the strip is also recorded.
+#
+# Use a small frame size and a fast frame rate to get a high line rate.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.GRAYSCALE) # Set pixel format to GRAYSCALE (or RGB565)
+sensor.set_framesize(sensor.QVGA)   # Set frame size to QVGA (320x240)
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+
+# Capture rows 119 and 120 from each frame into a 240 row strip (120 frames per strip).
+sensor.set_linescan([119, 120], 240)
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    strip = sensor.snapshot()       # Returns the strip once it's full.
+    timestamps = sensor.get_linescan_timestamps()
+    line_rate = (len(timestamps) - 1) * 1000000 / (timestamps[-1] - timestamps[0])
+    print("%f lines/s, %f strips/s" % (line_rate, clock.fps()))
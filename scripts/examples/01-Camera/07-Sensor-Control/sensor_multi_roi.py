@@ -0,0 +1,23 @@
+# Sensor Multiple Regions of Interest
+#
+# This example shows off how to capture several small regions from a high resolution frame.
+# Only the regions are copied to the frame buffer while the frame is received, so you get
+# full resolution detail using a fraction of the memory of capturing the whole frame.
+#
+# The x offset and width of each region must be even.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.VGA)    # Set frame size to VGA (640x480)
+sensor.set_rois([(32, 32, 64, 64), (544, 32, 64, 64), (288, 208, 64, 64)])
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    # With regions of interest snapshot() returns one image per region. The images are only
+    # valid until the next snapshot. The IDE shows the first region.
+    rois = sensor.snapshot()
+    print(["%d" % img.get_statistics().l_mean() for img in rois], clock.fps())
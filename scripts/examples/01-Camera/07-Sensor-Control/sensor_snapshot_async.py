@@ -0,0 +1,34 @@
+# Sensor Non-Blocking Snapshot
+#
+# This example shows off how to capture frames without blocking. sensor.snapshot_async()
+# returns the next frame if one is ready and None otherwise, while the frame capture keeps
+# running in the background. This leaves the time spent waiting for the sensor free for
+# other work. sensor.frame_ready() tells you if a frame is ready without taking it and the
+# frame callback is called (in interrupt context) each time a frame has been received.
+#
+# Note: This needs two or more frame buffers. With a single frame buffer, and on sensors
+# that don't capture in the background, sensor.snapshot_async() waits like sensor.snapshot().
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.QVGA)   # Set frame size to QVGA (320x240)
+sensor.set_framebuffers(3)          # Triple buffering always keeps the latest frame ready.
+sensor.skip_frames(time = 2000)     # Wait for settings take effect.
+
+frames = 0
+def frame_received():
+    global frames
+    frames += 1
+
+sensor.set_frame_callback(frame_received)
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    img = sensor.snapshot_async()
+    if img is None:
+        # Do something else while the frame is being captured.
+        continue
+    clock.tick()                    # Update the FPS clock.
+    print("%d frames received, %f fps" % (frames, clock.fps()))
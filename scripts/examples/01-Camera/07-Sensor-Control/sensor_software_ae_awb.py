@@ -0,0 +1,31 @@
+# Sensor Software Auto Exposure/White Balance
+#
+# This example shows off how to use the software auto exposure and auto white balance
+# controllers with sensors that have weak or no on-chip AEC/AWB. The controllers gather
+# statistics from each captured frame and update the sensor settings before the next
+# frame, so there is no per-frame work to do in Python.
+
+import sensor, image, time
+
+sensor.reset()                      # Reset and initialize the sensor.
+sensor.set_pixformat(sensor.RGB565) # Set pixel format to RGB565 (or GRAYSCALE)
+sensor.set_framesize(sensor.QVGA)   # Set frame size to QVGA (320x240)
+
+# Keep the mean luma at 128, limit the exposure time to 20ms (to limit motion blur) and the
+# gain to 24dB (to limit noise). The exposure time is used up first and then the gain.
+sensor.ioctl(sensor.IOCTL_SET_SOFTWARE_AE, True, 128, 20000, 24.0)
+
+# Balance the colors using the brightest part of the image (or sensor.AWB_GRAY_WORLD).
+# This only works if the sensor supports setting the RGB gains.
+try:
+    sensor.ioctl(sensor.IOCTL_SET_SOFTWARE_AWB, True, sensor.AWB_WHITE_PATCH)
+except Exception:
+    print("Software auto white balance is not supported.")
+
+clock = time.clock()                # Create a clock object to track the FPS.
+
+while(True):
+    clock.tick()                    # Update the FPS clock.
+    img = sensor.snapshot()         # Take a picture and return the image.
+    print("exposure %d us, gain %f dB, %f fps" % \
+        (sensor.get_exposure_us(), sensor.get_gain_db(), clock.fps()))
@@ -0,0 +1,40 @@
+# Polygon Drawing
+#
+# This example shows off drawing filled polygons and anti-aliased lines on the OpenMV Cam.
+
+import sensor, image, time, pyb
+
+sensor.reset()
+sensor.set_pixformat(sensor.RGB565) # or GRAYSCALE...
+sensor.set_framesize(sensor.QVGA) # or QQVGA...
+sensor.skip_frames(time = 2000)
+clock = time.clock()
+
+while(True):
+    clock.tick()
+
+    img = sensor.snapshot()
+
+    for i in range(10):
+        points = []
+        for j in range(3 + (pyb.rng() % 4)):
+            x = (pyb.rng() % (2*img.width())) - (img.width()//2)
+            y = (pyb.rng() % (2*img.height())) - (img.height()//2)
+            points.append((x, y))
+        r = (pyb.rng() % 127) + 128
+        g = (pyb.rng() % 127) + 128
+        b = (pyb.rng() % 127) + 128
+
+        # Self intersecting polygons are filled using the even-odd rule.
+        img.draw_polygon(points, color = (r, g, b), fill = (i % 2) == 0)
+
+    for i in range(10):
+        x0 = pyb.rng() % img.width()
+        y0 = pyb.rng() % img.height()
+        x1 = pyb.rng() % img.width()
+        y1 = pyb.rng() % img.height()
+
+        # Anti-aliasing is only applied to lines with a thickness of 1.
+        img.draw_line(x0, y0, x1, y1, color = (255, 255, 255), antialias = True)
+
+    print(clock.fps())
@@ -0,0 +1,45 @@
+# Persistent Blob Tracking Example
+#
+# This example shows off tracking blobs across frames with stable ids using image.BlobTracker().
+# Once objects are being tracked only the windows around their predicted positions are searched,
+# with a full frame search every few frames to pick up new objects.
+
+import sensor, image, time
+
+# Color Tracking Thresholds (L Min, L Max, A Min, A Max, B Min, B Max)
+thresholds = [(30, 100, 15, 127, 15, 127)] # generic_red_thresholds
+
+sensor.reset()
+sensor.set_pixformat(sensor.RGB565)
+sensor.set_framesize(sensor.QVGA)
+sensor.skip_frames(time = 2000)
+sensor.set_auto_gain(False) # must be turned off for color tracking
+sensor.set_auto_whitebal(False) # must be turned off for color tracking
+clock = time.clock()
+
+# Tracks are matched to blobs by overlap ("min_iou") or by centroid distance ("max_distance") and
+# are dropped after "max_misses" frames without a match.
+tracker = image.BlobTracker(max_tracks=16, max_distance=32, min_iou=0.1, max_misses=5)
+full_search_period = 10
+frame = 0
+
+while(True):
+    clock.tick()
+    img = sensor.snapshot()
+
+    if tracker.tracks() and (frame % full_search_period):
+        blobs = []
+        for roi in tracker.rois(img, margin=8):
+            blobs += img.find_blobs(thresholds, roi=roi, pixels_threshold=200, area_threshold=200, merge=True)
+    else:
+        blobs = img.find_blobs(thresholds, pixels_threshold=200, area_threshold=200, merge=True)
+
+    for track in tracker.update(blobs):
+        if track.blob():
+            img.draw_rectangle(track.rect())
+            img.draw_string(track.x(), track.y() - 10, "%d" % track.id(), mono_space=False)
+            img.draw_arrow(int(track.cx()), int(track.cy()),
+                           int(track.cx() + track.vx() * 4), int(track.cy() + track.vy() * 4))
+
+    frame += 1
+    print(clock.fps())
@@ -0,0 +1,41 @@
+# In Memory Background Subtraction Example
+#
+# This example demonstrates using image.BackgroundModel() to find moving objects. The
+# model keeps a running mean and variance per pixel and marks pixels that are too far
+# from their mean as foreground, learning the background in the same pass. Because the
+# noise of every pixel is modelled, flickering areas need a larger change to trigger than
+# steady ones.
+
+import sensor, image, time
+
+TRIGGER_THRESHOLD = 200 # Foreground pixels needed to trigger.
+
+sensor.reset() # Initialize the camera sensor.
+sensor.set_pixformat(sensor.GRAYSCALE) # or sensor.RGB565
+sensor.set_framesize(sensor.QQVGA) # The model needs 4 bytes per pixel (77 KB at QQVGA).
+sensor.skip_frames(time = 2000) # Let new settings take affect.
+sensor.set_auto_gain(False) # Turn off gain control so the background stays steady.
+sensor.set_auto_exposure(False)
+clock = time.clock() # Tracks FPS.
+
+# "rate" is how fast the background is learned, "threshold" is how many standard deviations
+# from the background a pixel must be to be foreground and "min_sigma" is the smallest
+# standard deviation assumed for any pixel. With "selective" foreground is not learned, so
+# objects that stop are kept until they move away again. The model is kept in the frame
+# buffer RAM after the mask below, release it with bg.close() before the mask if needed.
+bg = image.BackgroundModel(rate=0.05, threshold=2.5, min_sigma=4, selective=True)
+
+# The foreground mask is kept in the frame buffer RAM.
+mask = sensor.alloc_extra_fb(sensor.width(), sensor.height(), sensor.BINARY)
+
+while(True):
+    clock.tick() # Track elapsed milliseconds between snapshots().
+    img = sensor.snapshot() # Take a picture and return the image.
+
+    bg.update(img, mask=mask)
+    mask.erode(1) # Remove lone noise pixels.
+
+    for blob in mask.find_blobs([(1, 1)], pixels_threshold=50, area_threshold=50, merge=True):
+        img.draw_rectangle(blob.rect(), color=255)
+
+    print(clock.fps(), bg.count() > TRIGGER_THRESHOLD)
@@ -0,0 +1,33 @@
+# In Memory Motion Vectors Example
+#
+# This example demonstrates block-matching motion estimation with find_motion_vectors().
+# Each 16x16 block of the new frame is matched against the previous frame and the
+# displacement of the blocks that moved is drawn. Unlike frame differencing this tells
+# you where things are moving to, not just where something changed.
+
+import sensor, image, time
+
+sensor.reset() # Initialize the camera sensor.
+sensor.set_pixformat(sensor.GRAYSCALE) # or sensor.RGB565
+sensor.set_framesize(sensor.QVGA) # or sensor.QQVGA (or others)
+sensor.skip_frames(time = 2000) # Let new settings take affect.
+clock = time.clock() # Tracks FPS.
+
+# Holds the previous frame to match the new frame against.
+extra_fb = sensor.alloc_extra_fb(sensor.width(), sensor.height(), sensor.GRAYSCALE)
+extra_fb.replace(sensor.snapshot())
+
+while(True):
+    clock.tick() # Track elapsed milliseconds between snapshots().
+    img = sensor.snapshot() # Take a picture and return the image.
+
+    # Blocks that differ from the previous frame by "threshold" or less on average are static
+    # and are skipped, the rest are searched up to "search_range" pixels away.
+    vectors = img.find_motion_vectors(extra_fb, block_size=16, search_range=7, threshold=4)
+    extra_fb.replace(img)
+
+    moving = [v for v in vectors if v[2] or v[3]]
+    for x, y, dx, dy, sad in moving:
+        img.draw_line(x + 8 - dx, y + 8 - dy, x + 8, y + 8, color=255)
+
+    print(clock.fps(), len(moving))
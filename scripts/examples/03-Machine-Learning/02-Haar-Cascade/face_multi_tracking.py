@@ -0,0 +1,42 @@
+# Face Multi-Object Tracking Example
+#
+# This example shows off tracking detections across frames with image.Tracker().
+#
+# The tracker keeps a Kalman filter per object and matches new detections to the
+# predicted boxes by overlap, so every face keeps the same id while it moves and
+# short detection dropouts are bridged. update() takes any list of rects or of
+# objects with a rect() method, e.g. tf.detect() or find_apriltags() results.
+
+import sensor, time, image
+
+# Reset sensor
+sensor.reset()
+
+# Sensor settings
+sensor.set_contrast(3)
+sensor.set_gainceiling(16)
+sensor.set_framesize(sensor.HQVGA)
+sensor.set_pixformat(sensor.GRAYSCALE)
+
+face_cascade = image.HaarCascade("frontalface", stages=25)
+
+# Tracks are reported after "min_hits" matched frames and dropped after "max_misses"
+# frames without a match. "hungarian=False" uses a faster greedy matcher instead.
+tracker = image.Tracker(max_tracks=32, min_iou=0.3, min_hits=3, max_misses=5, hungarian=True)
+
+# FPS clock
+clock = time.clock()
+
+while (True):
+    clock.tick()
+
+    # Capture snapshot
+    img = sensor.snapshot()
+
+    objects = img.find_features(face_cascade, threshold=0.75, scale_factor=1.25)
+
+    for track in tracker.update(objects):
+        img.draw_rectangle(track.rect(), color=255 if track.object() else 128)
+        img.draw_string(track.x(), track.y() - 10, "%d" % track.id(), mono_space=False)
+
+    print(clock.fps())
@@ -0,0 +1,31 @@
+# Face recognition with an LBP gallery.
+# See Timo Ahonen's "Face Recognition with Local Binary Patterns".
+#
+# The first image of every subject is enrolled into an LBPGallery, the other
+# images are then matched against all enrolled subjects in a single call.
+#
+# Before running the example:
+# 1) Download the AT&T faces database http://www.cl.cam.ac.uk/Research/DTG/attarchive/pub/data/att_faces.zip
+# 2) Exract and copy the orl_faces directory to the SD card root.
+
+import time, image
+
+NUM_SUBJECTS = 5
+NUM_SUBJECTS_IMGS = 10
+
+def lbp(path):
+    img = image.Image(path).mask_ellipse()
+    return img.find_lbp((0, 0, img.width(), img.height()))
+
+gallery = image.LBPGallery()
+for s in range(1, NUM_SUBJECTS+1):
+    gallery.append(lbp("orl_faces/s%d/1.pgm"%(s)))
+
+correct = 0
+for s in range(1, NUM_SUBJECTS+1):
+    for i in range(2, NUM_SUBJECTS_IMGS+1):
+        t = time.ticks_ms()
+        index, dist = image.match_descriptor(lbp("orl_faces/s%d/%d.pgm"%(s, i)), gallery)
+        print("s%d/%d.pgm -> subject %d (dist %d) %d ms"%(s, i, index + 1, dist, time.ticks_diff(time.ticks_ms(), t)))
+        correct += (index + 1) == s
+print("Recognized %d/%d"%(correct, NUM_SUBJECTS * (NUM_SUBJECTS_IMGS - 1)))
@@ -0,0 +1,31 @@
+# Histogram of Oriented Gradients (HoG) Detector Example
+#
+# This example demonstrates a linear SVM sliding window detector on top of HoG
+# features. Cell histograms and blocks are computed once per frame and shared
+# by all windows.
+#
+# The weights must be trained offline on hog_descriptor() / 255 features of
+# window sized crops (e.g. with sklearn.svm.LinearSVC) and saved as raw float32
+# values followed by the bias in "/hog_svm.bin".
+
+import sensor, image, time, array
+
+WINDOW = (32, 64) # Detector window in pixels, a multiple of the cell size.
+CELL = 8
+
+sensor.reset()
+sensor.set_framesize(sensor.QVGA)
+sensor.set_pixformat(sensor.GRAYSCALE)
+sensor.skip_frames(time = 2000)
+
+with open("/hog_svm.bin", "rb") as f:
+    svm = array.array('f', f.read())
+weights, bias = svm[:-1], svm[-1]
+
+clock = time.clock() # Tracks FPS.
+while (True):
+    clock.tick()
+    img = sensor.snapshot()
+    for x, y, w, h, score in img.find_hog_objects(weights, bias, window_size=WINDOW, size=CELL, threshold=0.5):
+        img.draw_rectangle(x, y, w, h, color=255)
+    print(clock.fps())
@@ -0,0 +1,46 @@
+# Optical Flow Feature Tracking Example
+#
+# This example shows off tracking keypoints from frame to frame with sparse pyramidal
+# Lucas-Kanade optical flow using image.LKFlow(). Keypoints are detected once and then
+# followed by the flow, new keypoints are only detected when too many have been lost.
+# The median flow of the tracked points is the camera (ego) motion.
+
+import sensor, image, time
+
+sensor.reset()
+sensor.set_pixformat(sensor.GRAYSCALE)
+sensor.set_framesize(sensor.QQVGA)
+sensor.skip_frames(time = 2000)
+clock = time.clock()
+
+# "levels" is the number of pyramid levels (larger motions need more levels), "window" is the
+# size of the patch tracked around each point and points whose patch differs by more than
+# "max_error" on average after tracking are reported as lost. The pyramids of the last two
+# frames are kept in frame buffer memory (like sensor.alloc_extra_fb()) until flow.close().
+flow = image.LKFlow(levels=3, window=15, iterations=10, max_error=10)
+min_points = 20
+points = []
+
+def median(values):
+    values = sorted(values)
+    return values[len(values) // 2]
+
+while(True):
+    clock.tick()
+    img = sensor.snapshot()
+
+    if len(points) < min_points:
+        kpts = img.find_keypoints(max_keypoints=60, threshold=10, normalized=True)
+        flow.reset()
+        flow.track(img, kpts if kpts else [])
+        points = [(kp[0], kp[1]) for kp in kpts] if kpts else []
+        continue
+
+    results = [p for p in flow.track(img, points) if p[4]]
+    points = [(p[0], p[1]) for p in results]
+
+    for x, y, dx, dy, status in results:
+        img.draw_line(int(x - dx), int(y - dy), int(x), int(y))
+
+    if results:
+        print("motion: %.2f %.2f" % (median([p[2] for p in results]), median([p[3] for p in results])), clock.fps())
@@ -0,0 +1,26 @@
+# Audio Features Example
+#
+# This example shows how to compute a log-mel spectrogram (or MFCCs) from the
+# microphone in C and run a TensorFlow Lite keyword model on it. The features
+# are quantized to int8 so spectrogram() can be passed directly to tf.classify().
+import audio, time, tf
+
+model = tf.load('/model.tflite')
+features = audio.Features(audio.LOG_MEL, frequency=16000, frame_length=480,
+                          frame_step=320, fft_length=512, n_mels=40, n_frames=49)
+
+audio.init(channels=1, frequency=16000, gain_db=24, highpass=0.9883)
+
+# Start audio streaming, the features are computed in the audio callback.
+audio.start_streaming(features.process)
+
+clock = time.clock()
+while (True):
+    clock.tick()
+    if features.new_frames():
+        for obj in tf.classify(model, features.spectrogram()):
+            print(obj.output())
+    print(clock.fps())
+
+# Stop streaming
+audio.stop_streaming()
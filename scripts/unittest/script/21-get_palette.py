@@ -0,0 +1,33 @@
+def unittest(data_path, temp_path):
+    import image, sensor
+    img = image.Image(32, 32, sensor.RGB565, copy_to_fb=True)
+    img.clear()
+    img.draw_rectangle(0, 0, 16, 32, color=(255, 0, 0), fill=True)
+    img.draw_rectangle(16, 0, 16, 32, color=(0, 0, 255), fill=True)
+
+    # Two flat colors must give back exactly those colors.
+    palette = img.get_palette(k=2, step=1, seed=1234)
+    # The same seed must give the same result.
+    rgb = sorted(palette) == [(0, 0, 255), (255, 0, 0)] and\
+          img.get_palette(k=2, step=1, seed=1234) == palette
+
+    # Grayscale centroids are not rounded through RGB565.
+    img = image.Image(32, 32, sensor.GRAYSCALE, copy_to_fb=True)
+    img.draw_rectangle(0, 0, 16, 32, color=101, fill=True)
+    img.draw_rectangle(16, 0, 16, 32, color=203, fill=True)
+    gray = sorted(img.get_palette(k=2, step=1, seed=1234)) == [101, 203]
+
+    # Corners in two far apart groups cluster into one group each with every keypoint assigned.
+    img = image.Image(160, 120, sensor.GRAYSCALE, copy_to_fb=True)
+    img.clear()
+    for x, y in ((10, 10), (30, 30), (10, 30), (120, 80), (140, 100), (120, 100)):
+        img.draw_rectangle(x, y, 12, 12, color=255, fill=True)
+    kpts = img.find_keypoints(max_keypoints=100, threshold=10)
+    if kpts is None:
+        return False
+    clusters = image.cluster_keypoints(kpts, k=2, seed=1234)
+    sides = sorted(c[0] < 80 for c in clusters)
+    keypoints = sum(c[4] for c in clusters) == len(kpts) and sides == [False, True] and\
+                image.cluster_keypoints(kpts, k=2, seed=1234) == clusters
+
+    return rgb and gray and keypoints
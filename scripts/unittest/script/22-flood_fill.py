@@ -0,0 +1,73 @@
+def unittest(data_path, temp_path):
+    import image, sensor
+
+    # Reference 4-connected fill: a pixel is filled if it is within the seed threshold of the
+    # seed pixel and within the floating threshold of the filled neighbour it is reached from.
+    def reference(pixels, w, h, x, y, bound):
+        seed = pixels[y * w + x]
+        filled = bytearray(w * h)
+        filled[y * w + x] = 1
+        stack = [(x, y)]
+        while stack:
+            px, py = stack.pop()
+            p = pixels[py * w + px]
+            for nx, ny in ((px - 1, py), (px + 1, py), (px, py - 1), (px, py + 1)):
+                if (0 <= nx < w) and (0 <= ny < h) and not filled[ny * w + nx]:
+                    q = pixels[ny * w + nx]
+                    if bound(q, seed, 0) and bound(q, p, 1):
+                        filled[ny * w + nx] = 1
+                        stack.append((nx, ny))
+        return filled
+
+    def check(img, pixels, w, h, x, y, bound):
+        img.flood_fill(x, y, seed_threshold=0.2, floating_threshold=0.05,
+                       color=(255, 255, 255), clear_background=True)
+        filled = reference(pixels, w, h, x, y, bound)
+        for i in range(w * h):
+            if (img.get_pixel(i % w, i // w, rgbtuple=False) != 0) != filled[i]:
+                return False
+        return True
+
+    w, h = 64, 48
+    seed = 12345
+
+    def rand():
+        nonlocal seed
+        seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+        return seed >> 16
+
+    # Noisy ramps with a few walls give irregular regions with holes and overhangs.
+    gray = []
+    rgb = []
+    for y in range(h):
+        for x in range(w):
+            wall = (x == 20 and y < 40) or (y == 30 and x > 10)
+            g = 255 if wall else (x + y + (rand() % 24))
+            gray.append(g)
+            rgb.append((31, 63, 31) if wall else ((x // 3) + (rand() % 2), (y // 2) + (rand() % 4), rand() % 2))
+
+    # Thresholds are scaled to each channel and floored like the C code does.
+    gray_thr = (int(0.2 * 255), int(0.05 * 255))
+    rgb_thr = ((int(0.2 * 31), int(0.2 * 63), int(0.2 * 31)), (int(0.05 * 31), int(0.05 * 63), int(0.05 * 31)))
+
+    def gray_bound(a, b, t):
+        return abs(a - b) <= gray_thr[t]
+
+    def rgb_bound(a, b, t):
+        return all(abs(a[c] - b[c]) <= rgb_thr[t][c] for c in range(3))
+
+    for x, y in ((0, 0), (40, 10), (5, 45)):
+        img = image.Image(w, h, sensor.GRAYSCALE, copy_to_fb=True)
+        for i in range(w * h):
+            img.set_pixel(i % w, i // w, gray[i])
+        if not check(img, gray, w, h, x, y, gray_bound):
+            return False
+
+        img = image.Image(w, h, sensor.RGB565, copy_to_fb=True)
+        for i in range(w * h):
+            r, g, b = rgb[i]
+            img.set_pixel(i % w, i // w, (r << 3, g << 2, b << 3))
+        if not check(img, rgb, w, h, x, y, rgb_bound):
+            return False
+
+    return True
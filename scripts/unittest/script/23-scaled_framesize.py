@@ -0,0 +1,48 @@
+def unittest(data_path, temp_path):
+    import sensor
+    sizes = {
+        sensor.QQCIF: (88, 72), sensor.QCIF: (176, 144), sensor.CIF: (352, 288),
+        sensor.QQSIF: (88, 60), sensor.QSIF: (176, 120), sensor.SIF: (352, 240),
+        sensor.QQQQVGA: (40, 30), sensor.QQQVGA: (80, 60), sensor.QQVGA: (160, 120),
+        sensor.QVGA: (320, 240), sensor.VGA: (640, 480), sensor.HQQQQVGA: (30, 20),
+        sensor.HQQQVGA: (60, 40), sensor.HQQVGA: (120, 80), sensor.HQVGA: (240, 160),
+        sensor.HVGA: (480, 320), sensor.B64X32: (64, 32), sensor.B64X64: (64, 64),
+        sensor.B128X64: (128, 64), sensor.B128X128: (128, 128), sensor.B160X160: (160, 160),
+        sensor.B320X320: (320, 320), sensor.LCD: (128, 160), sensor.QQVGA2: (128, 160),
+        sensor.WVGA: (720, 480), sensor.WVGA2: (752, 480), sensor.SVGA: (800, 600),
+        sensor.XGA: (1024, 768), sensor.WXGA: (1280, 768), sensor.SXGA: (1280, 1024),
+        sensor.SXGAM: (1280, 960), sensor.UXGA: (1600, 1200), sensor.HD: (1280, 720),
+        sensor.FHD: (1920, 1080), sensor.QHD: (2560, 1440), sensor.QXGA: (2048, 1536),
+        sensor.WQXGA: (2560, 1600), sensor.WQXGA2: (2592, 1944)
+    }
+
+    # The largest frame size with the same field of view that is no larger and fits.
+    def expected(framesize, bpp, size, max_pixels):
+        w, h = sizes[framesize]
+        best, best_pixels = None, 0
+        for i, (i_w, i_h) in sizes.items():
+            pixels = i_w * i_h
+            if (i_w * h == i_h * w) and (i_w <= w) and (i_h <= h) and (pixels < max_pixels) \
+                    and (pixels * bpp <= size) and (pixels > best_pixels or
+                                                     (pixels == best_pixels and i < best)):
+                best, best_pixels = i, pixels
+        return best
+
+    for framesize, (w, h) in sizes.items():
+        for bpp in (1, 2):
+            size = w * h * bpp
+            # A frame that fits keeps its resolution (LCD and QQVGA2 are the same).
+            if sizes[sensor.get_scaled_framesize(framesize, bpp, size)] != (w, h):
+                return False
+            # Nothing fits in no memory.
+            if sensor.get_scaled_framesize(framesize, bpp, 0) is not None:
+                return False
+            # One byte short, smaller than itself (what auto_scale asks for) and a quarter.
+            for args in ((size - 1, 0xFFFFFF), (size, w * h), (size // 4, 0xFFFFFF)):
+                if sensor.get_scaled_framesize(framesize, bpp, *args) != expected(framesize, bpp, *args):
+                    return False
+
+    # Spot checks.
+    return sensor.get_scaled_framesize(sensor.VGA, 2, 320 * 240 * 2) == sensor.QVGA and \
+           sensor.get_scaled_framesize(sensor.QQQQVGA, 2, 40 * 30 * 2 - 1) is None and \
+           sensor.get_scaled_framesize(sensor.HD, 2, 1280 * 720 * 2, 1280 * 720) is None
@@ -0,0 +1,27 @@
+def unittest(data_path, temp_path):
+    import sensor
+    try:
+        sensor.reset()
+        sensor.set_pixformat(sensor.GRAYSCALE)
+        sensor.set_framesize(sensor.QQVGA)
+        sensor.set_linescan([59, 60], 40)
+    except Exception:
+        raise Exception("Line scan unavailable")
+
+    # ticks_us() wraps around so compare the difference.
+    def in_order(t):
+        return all(((b - a) & 0xFFFFFFFF) < 0x80000000 for a, b in zip(t, t[1:]))
+
+    try:
+        strip = sensor.snapshot()
+        w, h = strip.width(), strip.height()
+        timestamps = sensor.get_linescan_timestamps()
+        sensor.snapshot()
+        next_timestamps = sensor.get_linescan_timestamps()
+    finally:
+        sensor.set_linescan([], 0)
+
+    # The strip is as wide as the frame and as tall as asked for, with one timestamp per row.
+    # Rows are appended in capture order and the next strip is captured after this one.
+    return w == 160 and h == 40 and len(timestamps) == 40 and \
+           in_order(timestamps) and in_order(timestamps[-1:] + next_timestamps)
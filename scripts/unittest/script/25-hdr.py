@@ -0,0 +1,42 @@
+def unittest(data_path, temp_path):
+    import sensor
+    try:
+        sensor.reset()
+        sensor.set_pixformat(sensor.GRAYSCALE)
+        sensor.set_framesize(sensor.QQVGA)
+        sensor.skip_frames(time = 500)
+        exposure_us = sensor.get_exposure_us()
+        sensor.set_auto_exposure(False, exposure_us = exposure_us)
+    except Exception:
+        raise Exception("HDR unavailable")
+
+    long_us, short_us = exposure_us * 4, max(exposure_us // 4, 1)
+
+    def mean(exposure_us):
+        sensor.set_auto_exposure(False, exposure_us = exposure_us)
+        sensor.skip_frames(n = 5)
+        return sensor.snapshot().get_statistics().mean()
+
+    long_mean, short_mean = mean(long_us), mean(short_us)
+
+    def raises(f):
+        try:
+            f()
+            return False
+        except Exception:
+            return True
+
+    try:
+        sensor.ioctl(sensor.IOCTL_SET_HDR, True, long_us, short_us, 2)
+        # Each fused pixel is a weighted average of the two exposures (allow for noise).
+        hdr_mean = sensor.snapshot().get_statistics().mean()
+        fused = (min(long_mean, short_mean) - 4) <= hdr_mean <= (max(long_mean, short_mean) + 4)
+        # Frames can't be fused without waiting for both exposures.
+        no_async = raises(sensor.snapshot_async)
+        # Only GRAYSCALE and RGB565 frames are fused.
+        no_bayer = raises(lambda: sensor.set_pixformat(sensor.BAYER)) or raises(sensor.snapshot)
+    finally:
+        sensor.ioctl(sensor.IOCTL_SET_HDR, False)
+        sensor.reset()
+
+    return fused and no_async and no_bayer
@@ -0,0 +1,37 @@
+def unittest(data_path, temp_path):
+    import image, sensor
+
+    def frames(w, h, pixfmt, changes):
+        out = [image.Image(w, h, pixfmt)]
+        for y in range(h):
+            for x in range(w):
+                out[0].set_pixel(x, y, ((x * 7) + (y * 13)) & 0xFF)
+        for pixels in changes:
+            out.append(out[-1].copy())
+            for x, y in pixels:
+                out[-1].set_pixel(x, y, 255 - out[-1].get_pixel(x, y, rgbtuple=False) & 0xFF)
+        return out
+
+    def check(w, h, pixfmt, bpp, changes, expected):
+        f = frames(w, h, pixfmt, changes)
+        panel = image.Image(w, h, pixfmt)
+        result = image.display_diff(f, tile_size=16, panel=panel)
+        windows = [r[0] for r in result]
+        sizes = [r[1] for r in result]
+        # Only the changed tiles are sent, adjacent ones merged into a single window,
+        # and the panel ends up showing the last frame.
+        return windows == expected and \
+               sizes == [sum(ww * wh * bpp for _, _, ww, wh in e) for e in expected] and \
+               panel.bytearray() == f[-1].bytearray()
+
+    # The first frame is sent in full, an unchanged frame sends nothing.
+    gray = check(64, 48, sensor.GRAYSCALE, 1,
+                 [[], [(20, 5)], [(5, 40), (60, 40)]],
+                 [[(0, 0, 64, 48)], [], [(16, 0, 16, 16)], [(0, 32, 16, 16), (48, 32, 16, 16)]])
+
+    # Windows are clipped to frames that aren't a multiple of the tile size.
+    rgb = check(70, 50, sensor.RGB565, 2,
+                [[(69, 49)], [(20, y) for y in range(32)]],
+                [[(0, 0, 70, 50)], [(64, 48, 6, 2)], [(16, 0, 16, 32)]])
+
+    return gray and rgb
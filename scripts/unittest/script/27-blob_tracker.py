@@ -0,0 +1,49 @@
+def unittest(data_path, temp_path):
+    import image, sensor
+    tracker = image.BlobTracker(max_tracks=4, max_distance=16, max_misses=3)
+
+    def rect(x, y):
+        return (x, y, 10, 10)
+
+    def inside(r, roi):
+        return roi[0] <= r[0] and roi[1] <= r[1] and \
+               (r[0] + r[2]) <= (roi[0] + roi[2]) and (r[1] + r[3]) <= (roi[1] + roi[3])
+
+    # Two objects moving in opposite directions, detections in a different order each frame.
+    ids = None
+    for i in range(10):
+        a, b = rect(10 + (2 * i), 10), rect(100 - (2 * i), 40)
+        tracks = tracker.update([b, a] if i % 2 else [a, b])
+        by_rect = {t.rect(): t for t in tracks}
+        if len(tracks) != 2 or a not in by_rect or b not in by_rect:
+            return False
+        frame_ids = (by_rect[a].id(), by_rect[b].id())
+        if ids is None:
+            ids = frame_ids
+        # Each object keeps its id and tracks age once per update.
+        if frame_ids != ids or by_rect[a].age() != i or by_rect[a].misses() != 0:
+            return False
+
+    # The search windows cover where both objects are expected next.
+    img = image.Image(160, 120, sensor.GRAYSCALE)
+    rois = tracker.rois(img, margin=4)
+    if len(rois) != 2 or not inside(rect(30, 10), rois[0]) or not inside(rect(80, 40), rois[1]):
+        return False
+
+    # The second object disappears for two frames, its track coasts without a blob.
+    for i in range(10, 12):
+        tracks = tracker.update([rect(10 + (2 * i), 10)])
+        if len(tracks) != 2 or tracks[1].id() != ids[1] or tracks[1].blob() is not None or \
+                tracks[1].misses() != i - 9:
+            return False
+
+    # When it is back it picks up its old id.
+    tracks = tracker.update([rect(10 + 24, 10), rect(100 - 24, 40)])
+    if [t.id() for t in tracks] != list(ids) or tracks[1].misses() != 0:
+        return False
+
+    # Missing more than max_misses frames drops the track, a new object gets a new id.
+    for i in range(4):
+        tracks = tracker.update([rect(10 + 26 + (2 * i), 10)])
+    tracks = tracker.update([rect(10 + 34, 10), rect(10, 100)])
+    return [t.id() for t in tracks] == [ids[0], max(ids) + 1]
@@ -0,0 +1,56 @@
+def unittest(data_path, temp_path):
+    import image
+    tracker = image.Tracker(min_hits=3, max_misses=2)
+
+    def rect(x, y):
+        return (x, y, 20, 20)
+
+    def near(r0, r1, d):
+        return all(abs(a - b) <= d for a, b in zip(r0, r1))
+
+    # Two objects moving in opposite directions, detections in a different order each frame.
+    # Tracks are only reported once they have been matched min_hits times.
+    ids = None
+    for i in range(10):
+        a, b = rect(10 + (2 * i), 10), rect(120 - (2 * i), 60)
+        tracks = tracker.update([b, a] if i % 2 else [a, b])
+        if i < 2:
+            if tracks:
+                return False
+            continue
+        objects = [t.object() for t in tracks]
+        if len(tracks) != 2 or a not in objects or b not in objects:
+            return False
+        by_object = {t.object(): t for t in tracks}
+        frame_ids = (by_object[a].id(), by_object[b].id())
+        if ids is None:
+            ids = frame_ids
+        # Each object keeps its id and every frame counts as a hit.
+        if frame_ids != ids or by_object[a].hits() != i + 1 or by_object[a].age() != i:
+            return False
+
+    # The second object disappears, its track coasts along its velocity without an object.
+    for i in range(10, 12):
+        tracks = tracker.update([rect(10 + (2 * i), 10)])
+        coasting = [t for t in tracks if t.id() == ids[1]]
+        if len(tracks) != 2 or len(coasting) != 1 or coasting[0].object() is not None or \
+                coasting[0].misses() != i - 9 or not near(coasting[0].rect(), rect(120 - (2 * i), 60), 3):
+            return False
+
+    # When it is back it picks up its old id.
+    tracks = tracker.update([rect(34, 10), rect(96, 60)])
+    if sorted(t.id() for t in tracks) != sorted(ids) or any(t.misses() for t in tracks):
+        return False
+
+    # Missing more than max_misses frames drops the track.
+    for i in range(3):
+        tracks = tracker.update([rect(36 + (2 * i), 10)])
+    if [t.id() for t in tracks] != [ids[0]]:
+        return False
+
+    # A detection seen only once is dropped on its first miss, so the next one gets a new id.
+    tracker.update([rect(42, 10), rect(100, 100)])
+    tracker.update([rect(44, 10)])
+    for i in range(3):
+        tracks = tracker.update([rect(46 + (2 * i), 10), rect(100, 100)])
+    return sorted(t.id() for t in tracks) == [ids[0], max(ids) + 2]
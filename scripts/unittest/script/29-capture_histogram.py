@@ -0,0 +1,28 @@
+def unittest(data_path, temp_path):
+    import sensor
+    try:
+        sensor.reset()
+        sensor.set_pixformat(sensor.GRAYSCALE)
+        sensor.set_framesize(sensor.QQVGA)
+        sensor.skip_frames(time = 500)
+        sensor.ioctl(sensor.IOCTL_SET_CAPTURE_HISTOGRAM, True)
+    except Exception:
+        raise Exception("Capture histogram unavailable")
+
+    try:
+        sensor.skip_frames(n = 2)
+        img = sensor.snapshot()
+        bins = sensor.ioctl(sensor.IOCTL_GET_CAPTURE_HISTOGRAM)
+    finally:
+        sensor.ioctl(sensor.IOCTL_SET_CAPTURE_HISTOGRAM, False)
+
+    # Every other line is sampled with at most 128 samples per line.
+    w, h = img.width(), img.height()
+    step = max(w // 128, 1)
+    total = sum(bins)
+    if len(bins) != 64 or total != ((h + 1) // 2) * ((w + step - 1) // step):
+        return False
+
+    # The scene is static, so the sampled histogram is close to the one of the frame.
+    hist = img.get_histogram(bins=64).bins()
+    return sum(abs((b / total) - f) for b, f in zip(bins, hist)) < 0.25
@@ -0,0 +1,43 @@
+def unittest(data_path, temp_path):
+    import sensor
+    try:
+        sensor.reset()
+        sensor.set_pixformat(sensor.GRAYSCALE)
+        sensor.set_framesize(sensor.QQVGA)
+        sensor.skip_frames(time = 500)
+        sensor.set_auto_gain(False)
+        sensor.set_auto_exposure(False, exposure_us = sensor.get_exposure_us())
+        sensor.set_rois([(0, 0, 40, 30)])
+        sensor.set_rois([])
+    except Exception:
+        raise Exception("ROIs unavailable")
+
+    def raises(f):
+        try:
+            f()
+            return False
+        except Exception:
+            return True
+
+    rois = [(0, 0, 40, 30), (100, 20, 32, 16), (60, 80, 20, 40)]
+    try:
+        sensor.skip_frames(n = 2)
+        full = sensor.snapshot().copy()
+        sensor.set_rois(rois)
+        sensor.skip_frames(n = 2)
+        images = sensor.snapshot()
+        sizes = [(img.width(), img.height()) for img in images]
+        # The scene is static, so each region matches the same window of a full frame.
+        means = [full.copy(roi = r).difference(img).get_statistics().mean() for r, img in zip(rois, images)]
+        # Overlapping regions that don't fit in their bounding box and transposing are rejected.
+        no_overlap = raises(lambda: sensor.set_rois([(0, 0, 40, 40)] * 3))
+        no_transpose = raises(lambda: sensor.set_transpose(True)) and \
+                       raises(lambda: sensor.set_auto_rotation(True))
+        sensor.set_rois([])
+        sensor.set_transpose(True)
+        no_rois = raises(lambda: sensor.set_rois(rois))
+    finally:
+        sensor.reset()
+
+    return len(images) == len(rois) and sizes == [(r[2], r[3]) for r in rois] and \
+           all(m < 16 for m in means) and no_overlap and no_transpose and no_rois
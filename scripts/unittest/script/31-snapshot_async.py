@@ -0,0 +1,43 @@
+def unittest(data_path, temp_path):
+    import sensor, time
+    try:
+        sensor.reset()
+        sensor.set_pixformat(sensor.GRAYSCALE)
+        sensor.set_framesize(sensor.QQVGA)
+        sensor.set_framebuffers(3)
+        sensor.skip_frames(time = 500)
+    except Exception:
+        raise Exception("Non-blocking snapshot unavailable")
+
+    def next_frame():
+        start = time.ticks_ms()
+        while time.ticks_diff(time.ticks_ms(), start) < 2000:
+            ready = sensor.frame_ready()
+            img = sensor.snapshot_async()
+            # A ready frame is returned by the next call.
+            if ready and img is None:
+                return None, False
+            if img is not None:
+                return img, True
+        return None, False
+
+    try:
+        frames, not_ready, unchanged = 0, 0, True
+        for i in range(5):
+            img, ok = next_frame()
+            if not ok or img.width() != 160 or img.height() != 120:
+                return False
+            frames += 1
+            # Returning None while the next frame is captured leaves the last image alone.
+            data = bytes(img.bytearray())
+            if sensor.snapshot_async() is None:
+                not_ready += 1
+                unchanged = unchanged and bytes(img.bytearray()) == data
+
+        # In single buffer mode the capture only runs inside the call, which waits for the frame.
+        sensor.set_framebuffers(1)
+        blocking = all(sensor.snapshot_async() is not None for i in range(3))
+    finally:
+        sensor.reset()
+
+    return frames == 5 and not_ready > 0 and unchanged and blocking
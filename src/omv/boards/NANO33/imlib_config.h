@@ -150,6 +150,15 @@
 // Enable STM32 DMA2D
 //#define IMLIB_ENABLE_DMA2D
 
+// Enable sparse optical flow (image.LKFlow)
+// #define IMLIB_ENABLE_OPTICAL_FLOW
+
+// Enable find_motion_vectors()
+// #define IMLIB_ENABLE_FIND_MOTION_VECTORS
+
+// Enable image.BackgroundModel()
+// #define IMLIB_ENABLE_BACKGROUND_MODEL
+
 // Stereo Imaging
 // #define IMLIB_ENABLE_STEREO_DISPARITY
 
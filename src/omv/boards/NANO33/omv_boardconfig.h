@@ -42,6 +42,7 @@
 #define OMV_ENABLE_HM01B0       (0)
 #define OMV_ENABLE_PAJ6100      (0)
 #define OMV_ENABLE_FROGEYE2020  (0)
+#define OMV_ENABLE_VSENSOR      (0)
 
 // Set which OV767x sensor is used
 #define OMV_OV7670_VERSION      (75)
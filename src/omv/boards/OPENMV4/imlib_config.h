@@ -153,6 +153,15 @@
 #define IMLIB_ENABLE_PNG_ENCODER
 #define IMLIB_ENABLE_PNG_DECODER
 
+// Enable sparse optical flow (image.LKFlow)
+#define IMLIB_ENABLE_OPTICAL_FLOW
+
+// Enable find_motion_vectors()
+#define IMLIB_ENABLE_FIND_MOTION_VECTORS
+
+// Enable image.BackgroundModel()
+#define IMLIB_ENABLE_BACKGROUND_MODEL
+
 // Stereo Imaging
 // #define IMLIB_ENABLE_STEREO_DISPARITY
 
@@ -24,6 +24,7 @@ MICROPY_PY_NETWORK_CYW43 = 1
 MICROPY_PY_BLUETOOTH = 1
 MICROPY_BLUETOOTH_NIMBLE = 1
 MICROPY_PY_AUDIO = 1
+MICROPY_PY_AUDIO_FEATURES = 1
 MICROPY_PY_MICRO_SPEECH = 1
 MICROPY_PY_LCD = 1
 MICROPY_PY_TV = 1
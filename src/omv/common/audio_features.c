@@ -0,0 +1,218 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Audio feature extraction (log-mel spectrogram and MFCC).
+ */
+#if MICROPY_PY_AUDIO_FEATURES
+#include <math.h>
+#include <string.h>
+#include "xalloc.h"
+#include "fmath.h"
+#include "common.h"
+#include "audio_features.h"
+#define LOG_MEL_FLOOR   (1e-6f)
+
+static float hz_to_mel(float hz)
+{
+    return 2595.0f * log10f(1.0f + (hz / 700.0f));
+}
+
+static float mel_to_hz(float mel)
+{
+    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+static void audio_features_init_filterbank(audio_features_t *af)
+{
+    uint32_t n_mels = af->cfg.n_mels;
+    float mel_min = hz_to_mel(af->cfg.fmin);
+    float mel_max = hz_to_mel(af->cfg.fmax);
+    float bin_hz = af->cfg.sample_rate / ((float) af->cfg.fft_length);
+
+    // Filter edges (n_mels + 2 points evenly spaced on the mel scale) in fractional bins.
+    float edges[AUDIO_FEATURES_MAX_MELS + 2];
+    for (uint32_t i = 0; i < n_mels + 2; i++) {
+        edges[i] = mel_to_hz(mel_min + (((mel_max - mel_min) * i) / (n_mels + 1))) / bin_hz;
+    }
+
+    // First pass counts the non-zero weights of each triangle.
+    uint32_t n_weights = 0;
+    for (uint32_t m = 0; m < n_mels; m++) {
+        int start = OMV_MAX((int) ceilf(edges[m]), 0);
+        int end = OMV_MIN((int) floorf(edges[m + 2]), (int) af->n_bins - 1);
+        af->bin_start[m] = start;
+        af->bin_count[m] = (end >= start) ? (end - start + 1) : 0;
+        n_weights += af->bin_count[m];
+    }
+
+    af->weights = xalloc(n_weights * sizeof(float));
+
+    for (uint32_t m = 0, w = 0; m < n_mels; m++) {
+        float left = edges[m], center = edges[m + 1], right = edges[m + 2];
+        for (uint32_t i = 0; i < af->bin_count[m]; i++, w++) {
+            float bin = af->bin_start[m] + i;
+            float weight = (bin <= center)
+                         ? ((bin - left) / OMV_MAX(center - left, 1e-6f))
+                         : ((right - bin) / OMV_MAX(right - center, 1e-6f));
+            af->weights[w] = OMV_MAX(weight, 0.0f);
+        }
+    }
+}
+
+static void audio_features_init_dct(audio_features_t *af)
+{
+    uint32_t n_mels = af->cfg.n_mels;
+    uint32_t n_mfcc = af->cfg.n_mfcc;
+    af->dct = xalloc(n_mfcc * n_mels * sizeof(float));
+
+    // Orthonormal DCT-II.
+    for (uint32_t k = 0; k < n_mfcc; k++) {
+        float norm = (k == 0) ? sqrtf(1.0f / n_mels) : sqrtf(2.0f / n_mels);
+        for (uint32_t n = 0; n < n_mels; n++) {
+            af->dct[(k * n_mels) + n] = norm * cosf((M_PI / n_mels) * (n + 0.5f) * k);
+        }
+    }
+}
+
+int audio_features_init(audio_features_t *af, const audio_features_config_t *cfg)
+{
+    memset(af, 0, sizeof(*af));
+    af->cfg = *cfg;
+
+    if ((cfg->fft_length > AUDIO_FEATURES_MAX_FFT_LENGTH)
+            || (cfg->frame_length == 0)
+            || (cfg->frame_length > cfg->fft_length)
+            || (cfg->frame_step == 0)
+            || (cfg->frame_step > cfg->frame_length)
+            || (cfg->n_mels == 0)
+            || (cfg->n_mels > AUDIO_FEATURES_MAX_MELS)
+            || ((cfg->type == AUDIO_FEATURES_MFCC) && ((cfg->n_mfcc == 0) || (cfg->n_mfcc > cfg->n_mels)))
+            || (cfg->fmax <= cfg->fmin)
+            || (cfg->scale <= 0.0f)) {
+        return -1;
+    }
+
+    // arm_rfft_fast_init_f32() only accepts the lengths it has twiddle tables for.
+    if (arm_rfft_fast_init_f32(&af->rfft, cfg->fft_length) != ARM_MATH_SUCCESS) {
+        return -1;
+    }
+
+    af->n_bins = (cfg->fft_length / 2) + 1;
+    af->n_outputs = (cfg->type == AUDIO_FEATURES_MFCC) ? cfg->n_mfcc : cfg->n_mels;
+
+    af->frame = xalloc0(cfg->frame_length * sizeof(int16_t));
+    af->window = xalloc(cfg->frame_length * sizeof(float));
+    af->fft_in = xalloc0(cfg->fft_length * sizeof(float));
+    af->fft_out = xalloc(cfg->fft_length * sizeof(float));
+    af->mel = xalloc(cfg->n_mels * sizeof(float));
+    af->bin_start = xalloc(cfg->n_mels * sizeof(uint16_t));
+    af->bin_count = xalloc(cfg->n_mels * sizeof(uint16_t));
+
+    // Periodic Hann window, folded with the int16 -> [-1, 1) normalization.
+    for (uint32_t i = 0; i < cfg->frame_length; i++) {
+        af->window[i] = (0.5f - (0.5f * cosf((2.0f * M_PI * i) / cfg->frame_length))) / 32768.0f;
+    }
+
+    audio_features_init_filterbank(af);
+
+    if (cfg->type == AUDIO_FEATURES_MFCC) {
+        audio_features_init_dct(af);
+    }
+
+    return 0;
+}
+
+void audio_features_reset(audio_features_t *af)
+{
+    af->fill = 0;
+}
+
+static inline int8_t audio_features_quantize(audio_features_t *af, float value)
+{
+    int q = fast_roundf(value / af->cfg.scale) + af->cfg.zero_point;
+    return __SSAT(q, 8);
+}
+
+void audio_features_compute(audio_features_t *af, const int16_t *pcm, int8_t *out)
+{
+    float *fft_in = af->fft_in;
+    float *fft_out = af->fft_out;
+
+    // Only the first frame_length samples are written, the rest is zero padding.
+    for (uint32_t i = 0; i < af->cfg.frame_length; i++) {
+        fft_in[i] = pcm[i] * af->window[i];
+    }
+
+    // NOTE: arm_rfft_fast_f32() uses fft_in as scratch.
+    arm_rfft_fast_f32(&af->rfft, fft_in, fft_out, 0);
+
+    // Power spectrum is computed in place: fft_out[0] holds DC and fft_out[1]
+    // holds Nyquist, every following pair is (re, im) for bins 1...n_bins - 2.
+    float *power = fft_in;
+    power[0] = fft_out[0] * fft_out[0];
+    power[af->n_bins - 1] = fft_out[1] * fft_out[1];
+    for (uint32_t i = 1; i < af->n_bins - 1; i++) {
+        float re = fft_out[2 * i], im = fft_out[(2 * i) + 1];
+        power[i] = (re * re) + (im * im);
+    }
+
+    // Sparse mel filterbank followed by log compression.
+    const float *weights = af->weights;
+    for (uint32_t m = 0; m < af->cfg.n_mels; m++) {
+        const float *p = power + af->bin_start[m];
+        float acc = 0.0f;
+        for (uint32_t i = 0, ii = af->bin_count[m]; i < ii; i++) {
+            acc += p[i] * weights[i];
+        }
+        weights += af->bin_count[m];
+        af->mel[m] = logf(OMV_MAX(acc, LOG_MEL_FLOOR));
+    }
+
+    if (af->cfg.type == AUDIO_FEATURES_MFCC) {
+        const float *dct = af->dct;
+        for (uint32_t k = 0; k < af->cfg.n_mfcc; k++, dct += af->cfg.n_mels) {
+            float acc = 0.0f;
+            for (uint32_t n = 0; n < af->cfg.n_mels; n++) {
+                acc += dct[n] * af->mel[n];
+            }
+            out[k] = audio_features_quantize(af, acc);
+        }
+    } else {
+        for (uint32_t m = 0; m < af->cfg.n_mels; m++) {
+            out[m] = audio_features_quantize(af, af->mel[m]);
+        }
+    }
+
+    // Restore the zero padding clobbered by the power spectrum above.
+    if (af->cfg.fft_length > af->cfg.frame_length) {
+        memset(fft_in + af->cfg.frame_length, 0,
+               (af->cfg.fft_length - af->cfg.frame_length) * sizeof(float));
+    }
+}
+
+size_t audio_features_process(audio_features_t *af, const int16_t *pcm, size_t n_samples,
+                              int8_t *out, bool *frame_ready)
+{
+    uint32_t frame_length = af->cfg.frame_length;
+    uint32_t frame_step = af->cfg.frame_step;
+    size_t n = OMV_MIN(n_samples, frame_length - af->fill);
+
+    memcpy(af->frame + af->fill, pcm, n * sizeof(int16_t));
+    af->fill += n;
+    *frame_ready = (af->fill == frame_length);
+
+    if (*frame_ready) {
+        audio_features_compute(af, af->frame, out);
+        // Keep the overlap for the next window.
+        memmove(af->frame, af->frame + frame_step, (frame_length - frame_step) * sizeof(int16_t));
+        af->fill -= frame_step;
+    }
+
+    return n;
+}
+#endif // MICROPY_PY_AUDIO_FEATURES
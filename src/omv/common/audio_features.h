@@ -0,0 +1,69 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Audio feature extraction (log-mel spectrogram and MFCC).
+ */
+#ifndef __AUDIO_FEATURES_H__
+#define __AUDIO_FEATURES_H__
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <arm_math.h>
+
+#define AUDIO_FEATURES_MAX_FFT_LENGTH   (4096)
+#define AUDIO_FEATURES_MAX_MELS         (128)
+
+typedef enum audio_features_type {
+    AUDIO_FEATURES_LOG_MEL,
+    AUDIO_FEATURES_MFCC,
+} audio_features_type_t;
+
+typedef struct audio_features_config {
+    audio_features_type_t type;
+    uint32_t sample_rate;
+    uint32_t frame_length;  // samples per analysis window.
+    uint32_t frame_step;    // hop between windows in samples.
+    uint32_t fft_length;    // power of 2 >= frame_length.
+    uint32_t n_mels;
+    uint32_t n_mfcc;        // only used for AUDIO_FEATURES_MFCC.
+    float fmin;
+    float fmax;
+    float scale;            // int8 output quantization scale.
+    int32_t zero_point;     // int8 output quantization zero point.
+} audio_features_config_t;
+
+typedef struct audio_features {
+    audio_features_config_t cfg;
+    uint32_t n_bins;        // fft_length / 2 + 1
+    uint32_t n_outputs;     // n_mels or n_mfcc
+    uint32_t fill;          // samples currently held in the frame buffer.
+    arm_rfft_fast_instance_f32 rfft;
+    int16_t *frame;         // frame_length streaming buffer.
+    float *window;          // frame_length Hann window (with 1/32768 normalization).
+    float *fft_in;          // fft_length
+    float *fft_out;         // fft_length
+    float *mel;             // n_mels
+    // Sparse triangular mel filterbank: each filter covers bin_count[i] bins
+    // starting at bin_start[i], its weights are packed back to back.
+    uint16_t *bin_start;
+    uint16_t *bin_count;
+    float *weights;
+    float *dct;             // n_mfcc * n_mels DCT-II matrix (MFCC only).
+} audio_features_t;
+
+// Allocates all tables with xalloc(), returns 0 on success.
+int audio_features_init(audio_features_t *af, const audio_features_config_t *cfg);
+void audio_features_reset(audio_features_t *af);
+// Computes one feature vector from frame_length samples (no streaming state).
+void audio_features_compute(audio_features_t *af, const int16_t *pcm, int8_t *out);
+// Streams samples through the hop buffer, stopping after at most one frame is
+// completed (written to out, n_outputs bytes). Returns the number of samples
+// consumed, call again with the remaining samples until all are consumed.
+size_t audio_features_process(audio_features_t *af, const int16_t *pcm, size_t n_samples,
+                              int8_t *out, bool *frame_ready);
+#endif // __AUDIO_FEATURES_H__
@@ -42,8 +42,23 @@ typedef struct _cambus {
     omv_gpio_t scl_pin;
     omv_gpio_t sda_pin;
     omv_cambus_t i2c;
+    uint32_t xfer_count;        // Number of bus transfers.
+    uint32_t xfer_bytes;        // Number of bytes transferred (including register addresses).
 } cambus_t;
 
+// Transfer statistics, used to profile register access.
+static inline void cambus_update_stats(cambus_t *bus, uint32_t count, uint32_t bytes)
+{
+    bus->xfer_count += count;
+    bus->xfer_bytes += bytes;
+}
+
+static inline void cambus_reset_stats(cambus_t *bus)
+{
+    bus->xfer_count = 0;
+    bus->xfer_bytes = 0;
+}
+
 int cambus_init(cambus_t *bus, uint32_t bus_id, uint32_t speed);
 int cambus_deinit(cambus_t *bus);
 int cambus_scan(cambus_t *bus, uint8_t *list, uint8_t size);
@@ -0,0 +1,157 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Dirty rectangle display updates.
+ */
+#include <string.h>
+#include "common.h"
+#include "display_diff.h"
+
+void display_sink_reset_stats(display_sink_t *sink)
+{
+    sink->windows = 0;
+    sink->bytes = 0;
+}
+
+static void display_sink_memory_set_window(display_sink_t *sink, int x, int y, int w, int h)
+{
+    display_sink_memory_t *mem = (display_sink_memory_t *) sink;
+    mem->win_x = x;
+    mem->win_y = y;
+    mem->win_w = w;
+    mem->win_h = h;
+    mem->win_row = 0;
+}
+
+static void display_sink_memory_write_row(display_sink_t *sink, const uint8_t *data, int w)
+{
+    display_sink_memory_t *mem = (display_sink_memory_t *) sink;
+    if (mem->win_row < mem->win_h) {
+        int y = mem->win_y + mem->win_row++;
+        memcpy(mem->pixels + (((y * mem->w) + mem->win_x) * mem->bpp), data, OMV_MIN(w, mem->win_w) * mem->bpp);
+    }
+}
+
+void display_sink_memory_init(display_sink_memory_t *sink, uint8_t *pixels, int w, int h, int bpp)
+{
+    memset(sink, 0, sizeof(display_sink_memory_t));
+    sink->base.set_window = display_sink_memory_set_window;
+    sink->base.write_row = display_sink_memory_write_row;
+    sink->pixels = pixels;
+    sink->w = w;
+    sink->h = h;
+    sink->bpp = bpp;
+}
+
+void display_diff_init(display_diff_t *diff, int w, int h, int bpp, int tile_w, int tile_h,
+                       uint8_t *shadow, uint8_t *dirty)
+{
+    diff->w = w;
+    diff->h = h;
+    diff->bpp = bpp;
+    diff->tile_w = tile_w;
+    diff->tile_h = tile_h;
+    diff->tiles_w = DISPLAY_DIFF_TILES(w, tile_w);
+    diff->tiles_h = DISPLAY_DIFF_TILES(h, tile_h);
+    diff->shadow = shadow;
+    diff->dirty = dirty;
+    memset(dirty, 0, diff->tiles_w * diff->tiles_h);
+    diff->valid = false;
+}
+
+void display_diff_invalidate(display_diff_t *diff)
+{
+    diff->valid = false;
+}
+
+void display_diff_row(display_diff_t *diff, int y, const uint8_t *row)
+{
+    uint8_t *shadow = diff->shadow + (y * diff->w * diff->bpp);
+    uint8_t *dirty = diff->dirty + ((y / diff->tile_h) * diff->tiles_w);
+    size_t tile_bytes = diff->tile_w * diff->bpp;
+    size_t row_bytes = diff->w * diff->bpp;
+
+    for (size_t i = 0; i < row_bytes; i += tile_bytes, dirty++) {
+        size_t n = OMV_MIN(tile_bytes, row_bytes - i);
+        // Tiles already known to be dirty are copied without comparing.
+        if ((*dirty) || (!diff->valid) || memcmp(shadow + i, row + i, n)) {
+            memcpy(shadow + i, row + i, n);
+            *dirty = 1;
+        }
+    }
+}
+
+static bool display_diff_run_dirty(display_diff_t *diff, int ty, int tx0, int tx1)
+{
+    uint8_t *dirty = diff->dirty + (ty * diff->tiles_w);
+
+    // The run has to match exactly so it isn't split by the merge.
+    if (((tx0 > 0) && dirty[tx0 - 1]) || ((tx1 < diff->tiles_w) && dirty[tx1])) {
+        return false;
+    }
+
+    for (int tx = tx0; tx < tx1; tx++) {
+        if (!dirty[tx]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int display_diff_flush(display_diff_t *diff, display_sink_t *sink)
+{
+    int n_windows = 0;
+
+    if (!diff->valid) {
+        memset(diff->dirty, 1, diff->tiles_w * diff->tiles_h);
+        diff->valid = true;
+    }
+
+    for (int ty = 0; ty < diff->tiles_h; ty++) {
+        uint8_t *dirty = diff->dirty + (ty * diff->tiles_w);
+
+        for (int tx0 = 0; tx0 < diff->tiles_w; tx0++) {
+            if (!dirty[tx0]) {
+                continue;
+            }
+
+            // Horizontal run of dirty tiles.
+            int tx1 = tx0 + 1;
+            while ((tx1 < diff->tiles_w) && dirty[tx1]) {
+                tx1++;
+            }
+
+            // Grow the window down while the rows below have the same run.
+            int ty1 = ty + 1;
+            while ((ty1 < diff->tiles_h) && display_diff_run_dirty(diff, ty1, tx0, tx1)) {
+                memset(diff->dirty + (ty1 * diff->tiles_w) + tx0, 0, tx1 - tx0);
+                ty1++;
+            }
+
+            memset(dirty + tx0, 0, tx1 - tx0);
+
+            int x = tx0 * diff->tile_w;
+            int y = ty * diff->tile_h;
+            int w = OMV_MIN(tx1 * diff->tile_w, diff->w) - x;
+            int h = OMV_MIN(ty1 * diff->tile_h, diff->h) - y;
+
+            sink->set_window(sink, x, y, w, h);
+            for (int i = 0; i < h; i++) {
+                sink->write_row(sink, diff->shadow + ((((y + i) * diff->w) + x) * diff->bpp), w);
+            }
+
+            sink->windows += 1;
+            sink->bytes += w * h * diff->bpp;
+            n_windows += 1;
+            tx0 = tx1;
+        }
+    }
+
+    return n_windows;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Dirty rectangle display updates.
+ *
+ * Composed rows are compared against a shadow copy of the last transmitted
+ * frame at tile granularity, only the windows covering changed tiles are then
+ * sent to a display sink.
+ */
+#ifndef __DISPLAY_DIFF_H__
+#define __DISPLAY_DIFF_H__
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define DISPLAY_DIFF_TILES(size, tile_size) (((size) + (tile_size) - 1) / (tile_size))
+
+typedef struct display_sink display_sink_t;
+
+// A display sink receives windows followed by their rows (top to bottom), like
+// a panel with column/page address set and memory write commands.
+struct display_sink {
+    void (*set_window)(display_sink_t *sink, int x, int y, int w, int h);
+    void (*write_row)(display_sink_t *sink, const uint8_t *data, int w);
+    uint32_t windows;   // windows sent since the last reset.
+    uint32_t bytes;     // pixel bytes sent since the last reset.
+};
+
+// In-memory sink, used for testing the diffing and bandwidth accounting.
+typedef struct display_sink_memory {
+    display_sink_t base;
+    uint8_t *pixels;
+    int w, h, bpp;
+    int win_x, win_y, win_w, win_h, win_row;
+} display_sink_memory_t;
+
+typedef struct display_diff {
+    int w, h, bpp;      // bpp is the size of a pixel in bytes.
+    int tile_w, tile_h;
+    int tiles_w, tiles_h;
+    bool valid;         // shadow holds the last transmitted frame.
+    uint8_t *shadow;    // w * h * bpp bytes.
+    uint8_t *dirty;     // tiles_w * tiles_h flags.
+} display_diff_t;
+
+void display_sink_reset_stats(display_sink_t *sink);
+void display_sink_memory_init(display_sink_memory_t *sink, uint8_t *pixels, int w, int h, int bpp);
+
+// shadow must hold w * h * bpp bytes and dirty DISPLAY_DIFF_TILES(w, tile_w) *
+// DISPLAY_DIFF_TILES(h, tile_h) bytes. The first frame is always sent in full.
+void display_diff_init(display_diff_t *diff, int w, int h, int bpp, int tile_w, int tile_h,
+                       uint8_t *shadow, uint8_t *dirty);
+// Forces the next flush to send the whole frame (e.g. after the panel was reset).
+void display_diff_invalidate(display_diff_t *diff);
+// Compares a composed row against the shadow, rows must be passed top to bottom.
+void display_diff_row(display_diff_t *diff, int y, const uint8_t *row);
+// Sends the changed windows to the sink, returns the number of windows sent.
+int display_diff_flush(display_diff_t *diff, display_sink_t *sink);
+#endif // __DISPLAY_DIFF_H__
@@ -57,6 +57,7 @@
 #define GC2145_ID               (0x21)
 #define PAJ6100_ID              (0x6100)
 #define FROGEYE2020_ID          (0x2020)
+#define VSENSOR_ID              (0x5653)
 
 typedef enum {
     FRAMESIZE_INVALID = 0,
@@ -160,6 +161,15 @@ typedef enum {
     IOCTL_HIMAX_MD_WINDOW,
     IOCTL_HIMAX_MD_THRESHOLD,
     IOCTL_HIMAX_OSC_ENABLE,
+    IOCTL_VSENSOR_SET_SOURCE,
+    IOCTL_VSENSOR_GET_FRAME_INFO,
+    IOCTL_GET_BUS_STATS,
+    IOCTL_RESET_BUS_STATS,
+    IOCTL_SET_SOFTWARE_AE,
+    IOCTL_SET_SOFTWARE_AWB,
+    IOCTL_SET_CAPTURE_HISTOGRAM,
+    IOCTL_GET_CAPTURE_HISTOGRAM,
+    IOCTL_SET_HDR,
 } ioctl_t;
 
 typedef enum {
@@ -184,8 +194,15 @@ typedef enum {
     SENSOR_ERROR_FRAMEBUFFER_ERROR      = -18,
     SENSOR_ERROR_FRAMEBUFFER_OVERFLOW   = -19,
     SENSOR_ERROR_JPEG_OVERFLOW          = -20,
+    SENSOR_ERROR_END_OF_STREAM          = -21,
+    SENSOR_ERROR_FRAME_NOT_READY        = -22,
 } sensor_error_t;
 
+// Snapshot flags.
+// Return SENSOR_ERROR_FRAME_NOT_READY instead of waiting. Only the stm32 and rp2 ports with two or more
+// frame buffers honor it, single buffer mode and the lepton, vsensor and nrf drivers always wait.
+#define SENSOR_SNAPSHOT_NO_WAIT         (1 << 0)
+
 // Bayer patterns.
 // NOTE: These must match the Bayer subformats in imlib.h
 #define SENSOR_HW_FLAGS_BAYER_BGGR      (SUBFORMAT_ID_BGGR)
@@ -195,8 +212,69 @@ typedef enum {
 #define SENSOR_HW_FLAGS_YUV422          (SUBFORMAT_ID_YUV422)
 #define SENSOR_HW_FLAGS_YVU422          (SUBFORMAT_ID_YVU422)
 
+// Maximum number of regions of interest captured from each frame.
+#define SENSOR_MAX_ROIS                 (8)
+
+// Maximum number of rows captured from each frame in line scan mode.
+#define SENSOR_MAX_LINESCAN_ROWS        (8)
+
+// Number of bins of the luma histogram gathered during capture.
+#define SENSOR_CAPTURE_HIST_BINS        (64)
+
+// Register shadow size (must be a power of 2) and maximum registers per burst write.
+#define SENSOR_REG_SHADOW_SIZE          (128)
+#define SENSOR_REG_BURST_SIZE           (32)
+
+// Software auto-white-balance modes.
+typedef enum {
+    SENSOR_AWB_GRAY_WORLD,
+    SENSOR_AWB_WHITE_PATCH,
+} sensor_awb_mode_t;
+
 typedef void (*vsync_cb_t)(uint32_t vsync);
 typedef void (*frame_cb_t)();
+// Called from the capture interrupt with each line of the frame as received from the sensor and
+// after horizontal cropping (width pixels in the sensor pixel format and byte order). The line
+// is only valid until the callback returns and the callback must be as fast as possible.
+//
+// Only statistics (see sensor_set_capture_histogram()) are gathered this way. Grayscale
+// extraction is already done by the line copy (GRAYSCALE on YUV sensors) and downscaling by the
+// sensor (set_framesize() and auto_scale). Integral image rows would need a 4 bytes per pixel
+// buffer that outlives the frame, larger than the frame itself.
+typedef void (*line_cb_t)(void *arg, uint32_t line, const uint8_t *data, uint32_t width);
+
+// Last value written to a register, used to skip redundant register writes.
+typedef struct _sensor_reg_shadow {
+    uint16_t addr;
+    uint8_t  data;
+    uint8_t  valid;
+} sensor_reg_shadow_t;
+
+// Software auto-exposure/auto-white-balance controller state.
+typedef struct _sensor_ae {
+    bool ae_enabled;            // Software auto-exposure enabled.
+    bool awb_enabled;           // Software auto-white-balance enabled.
+    uint8_t awb_mode;           // Software auto-white-balance mode.
+    uint8_t target;             // Target mean luma.
+    uint8_t settle;             // Frames to skip while new settings take effect.
+    int max_exposure_us;        // Exposure limit (0 for the sensor limit).
+    float max_gain_db;          // Gain limit (0 for the sensor limit).
+    float ev;                   // Log2 of the exposure time (us) times the linear gain.
+    float error;                // Last exposure error in EV.
+    int exposure_us;            // Exposure time applied by the controller.
+    float gain_db;              // Gain applied by the controller.
+    float r_gain_db;            // White balance gains applied by the controller.
+    float g_gain_db;
+    float b_gain_db;
+} sensor_ae_t;
+
+// Multi-exposure HDR capture state.
+typedef struct _sensor_hdr {
+    bool enabled;               // HDR capture enabled.
+    uint8_t skip;               // Frames to skip while a new exposure time takes effect.
+    int8_t current;             // Exposure currently set (0 long, 1 short, -1 unknown).
+    int exposure_us[2];         // Long and short exposure times.
+} sensor_hdr_t;
 
 typedef struct _sensor sensor_t;
 typedef struct _sensor {
@@ -223,9 +301,17 @@ typedef struct _sensor {
 
     const uint16_t *color_palette;    // Color palette used for color lookup.
     bool disable_full_flush;    // Turn off default frame buffer flush policy when full.
+    bool auto_scale;            // Scale instead of crop frames that don't fit in the frame buffer.
+    rectangle_t rois[SENSOR_MAX_ROIS]; // Regions of interest captured from each frame.
+    int n_rois;                 // Number of regions of interest (0 to capture the window).
+    uint16_t linescan_rows[SENSOR_MAX_LINESCAN_ROWS]; // Rows captured from each frame (ascending).
+    int n_linescan_rows;        // Number of rows captured from each frame (0 to disable line scan).
+    int linescan_height;        // Number of rows in the line scan strip image.
 
     vsync_cb_t vsync_callback;  // VSYNC callback.
     frame_cb_t frame_callback;  // Frame callback.
+    line_cb_t line_callback;    // Line callback.
+    void *line_callback_arg;    // Line callback argument.
     polarity_t pwdn_pol;        // PWDN polarity (TODO move to hw_flags)
     polarity_t reset_pol;       // Reset polarity (TODO move to hw_flags)
 
@@ -244,6 +330,10 @@ typedef struct _sensor {
     bool detected;              // Set to true when the sensor is initialized.
 
     cambus_t bus;               // SCCB/I2C bus.
+    sensor_reg_shadow_t reg_shadow[SENSOR_REG_SHADOW_SIZE]; // Register shadow (direct mapped).
+    const uint16_t (*volatile_regs)[2]; // Register ranges that are never shadowed (zero terminated).
+    sensor_ae_t ae;             // Software AE/AWB controller.
+    sensor_hdr_t hdr;           // Multi-exposure HDR capture.
 
     // Sensor function pointers
     int  (*reset)               (sensor_t *sensor);
@@ -420,6 +510,33 @@ int sensor_set_vsync_callback(vsync_cb_t vsync_cb);
 // Set frame callback function.
 int sensor_set_frame_callback(frame_cb_t vsync_cb);
 
+// Capture up to SENSOR_MAX_ROIS regions of interest from each frame (only supported on some ports).
+// Only the regions are copied to the frame buffer, one after the other, and the frame buffer image
+// is the first region. The x offset and width of each region must be even, overlapping regions must
+// fit in their bounding box, and regions can't be transposed. Pass zero regions to capture the whole
+// frame again.
+int sensor_set_rois(const rectangle_t *rois, int n_rois);
+
+// Capture up to SENSOR_MAX_LINESCAN_ROWS rows (in ascending order) from each frame into a strip
+// image of height rows (only supported on some ports). Rows are appended to the strip frame after
+// frame and snapshot() returns the strip once it's full. Rows can't be transposed. Pass zero rows to
+// capture frames again.
+int sensor_set_linescan(const uint16_t *rows, int n_rows, int height);
+
+// Returns the capture time in microseconds of each row of a line scan strip. The timestamps are
+// stored in the frame buffer right after the strip (at the next aligned offset).
+struct vbuffer;
+uint32_t *sensor_get_linescan_timestamps(struct vbuffer *buffer);
+
+// Set line callback function (only supported on some ports).
+int sensor_set_line_callback(line_cb_t line_cb, void *arg);
+
+// Enable or disable gathering a luma histogram of each frame during capture.
+int sensor_set_capture_histogram(int enable);
+
+// Get the luma histogram (SENSOR_CAPTURE_HIST_BINS bins) of the last captured frame.
+int sensor_get_capture_histogram(uint32_t *bins);
+
 // Set color palette
 int sensor_set_color_palette(const uint16_t *color_palette);
 
@@ -429,9 +546,62 @@ const uint16_t *sensor_get_color_palette();
 // Return true if the current frame size/format fits in RAM.
 int sensor_check_framebuffer_size();
 
-// Auto-crop frame buffer until it fits in RAM (may switch pixel format to BAYER).
+// Auto-crop frame buffer until it fits in RAM (may switch pixel format to BAYER). If auto_scale
+// is enabled a smaller frame size with the same field of view is tried first.
 int sensor_auto_crop_framebuffer();
 
+// Returns the largest frame size with the same aspect ratio as framesize, no larger than framesize,
+// with less than max_pixels pixels and that fits in size bytes, or FRAMESIZE_INVALID if none fits.
+framesize_t sensor_get_scaled_framesize(framesize_t framesize, uint32_t bpp, uint32_t size, uint32_t max_pixels);
+
+// Invalidate the register shadow (must be called after the sensor registers are reset).
+void sensor_reg_shadow_reset(sensor_t *sensor);
+
+// Read a 16-bit address register from the register shadow, or from the sensor on a miss.
+int sensor_readb2(sensor_t *sensor, uint16_t reg_addr, uint8_t *reg_data);
+
+// Write a 16-bit address register and update the register shadow.
+int sensor_writeb2(sensor_t *sensor, uint16_t reg_addr, uint8_t reg_data);
+
+// Update the masked bits of a 16-bit address register. The register is read from the shadow
+// when possible and is only written if its value changes.
+int sensor_update_reg_bits(sensor_t *sensor, uint16_t reg_addr, uint8_t mask, uint8_t value);
+
+// Write len consecutive 16-bit address registers using burst writes. Leading and trailing
+// registers that already hold the shadowed value are not written. Only use this function
+// for registers that auto-increment and that the sensor doesn't update by itself.
+int sensor_write_burst2(sensor_t *sensor, uint16_t reg_addr, const uint8_t *reg_data, int len);
+
+// Write a register table of {addr_h, addr_l, data} entries terminated by a zero entry.
+// Runs of consecutive addresses are coalesced and written with sensor_write_burst2().
+int sensor_write_regs2(sensor_t *sensor, const uint8_t (*regs)[3]);
+
+// Enable or disable the software auto-exposure controller. The controller adjusts the exposure
+// first and then the gain to keep the mean luma of captured frames at target.
+int sensor_set_software_ae(int enable, int target, int max_exposure_us, float max_gain_db);
+
+// Enable or disable the software auto-white-balance controller (see sensor_awb_mode_t).
+int sensor_set_software_awb(int enable, int mode);
+
+// Run one software AE/AWB step on a captured frame. Does nothing if both are disabled.
+// This is called at the end of snapshot() and any new settings are written over the sensor
+// bus right away, so that snapshot() takes longer on frames where they change. The writes
+// are not deferred to the VSYNC callback since it runs in interrupt context and the bus
+// drivers block. The frame in flight was exposed with the old settings, so it is not used
+// for the next step.
+void sensor_software_ae_update(image_t *image);
+
+// Returns true if a new frame has been captured and snapshot() can return it without waiting.
+bool sensor_frame_ready();
+
+// Enable or disable multi-exposure HDR capture. Each snapshot captures a frame with the long and
+// a frame with the short exposure time and fuses them into one frame (GRAYSCALE/RGB565 only).
+// Skip is the number of frames the sensor takes to apply a new exposure time.
+int sensor_set_hdr(int enable, int long_exposure_us, int short_exposure_us, int skip);
+
+// Capture and fuse an HDR frame using sensor->snapshot() (SENSOR_SNAPSHOT_NO_WAIT is rejected).
+int sensor_hdr_snapshot(sensor_t *sensor, image_t *image, uint32_t flags);
+
 // Default snapshot function.
 int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags);
 
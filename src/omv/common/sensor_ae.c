@@ -0,0 +1,332 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Software auto-exposure/auto-white-balance controller.
+ *
+ * Frame statistics are gathered from a decimated grid of samples after capture. The exposure
+ * loop is a PI controller working in EV (log2) units and the white balance loop moves the red
+ * and blue gains towards the green channel using gray-world or white-patch estimates. Sensor
+ * registers are only written when the settings change, synchronously at the end of snapshot().
+ */
+#if MICROPY_PY_SENSOR
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor.h"
+#include "imlib.h"
+#include "fmath.h"
+
+#define AE_GRID_W               (64)    // Maximum number of samples per row.
+#define AE_GRID_H               (48)    // Maximum number of sampled rows.
+#define AE_HIST_BINS            (64)
+#define AE_KP                   (0.1f)  // Proportional gain (velocity form).
+#define AE_KI                   (0.7f)  // Integral gain (velocity form).
+#define AE_DEADBAND_EV          (0.05f)
+#define AE_DEADBAND_DB          (0.1f)
+#define AE_MAX_ERROR_EV         (2.0f)
+#define AE_SETTLE_FRAMES        (1)     // Frames captured with the old settings after a write.
+#define AE_DB_PER_EV            (6.0206f)
+#define AWB_RATE                (0.5f)
+#define AWB_DEADBAND_DB         (0.1f)
+#define AWB_MAX_GAIN_DB         (12.0f)
+#define AWB_WHITE_PATCH_PCT     (5)     // Brightest percentage of samples used by white-patch.
+#define AWB_CLIP_LEVEL          (250)   // Samples with a channel above this level are ignored.
+
+typedef struct ae_stats {
+    uint32_t n, y, r, g, b;
+} ae_stats_t;
+
+static inline float ae_ev_to_linear(float ev)
+{
+    return fast_expf(ev * 0.69314718f);
+}
+
+// Returns the luma of the sample at x, y and its color channels in r, g, b.
+static int ae_get_sample(image_t *image, int x, int y, int *r, int *g, int *b)
+{
+    switch (image->pixfmt) {
+        case PIXFORMAT_GRAYSCALE: {
+            *r = *g = *b = IMAGE_GET_GRAYSCALE_PIXEL(image, x, y);
+            return *g;
+        }
+        case PIXFORMAT_RGB565: {
+            int pixel = IMAGE_GET_RGB565_PIXEL(image, x, y);
+            *r = COLOR_RGB565_TO_R8(pixel);
+            *g = COLOR_RGB565_TO_G8(pixel);
+            *b = COLOR_RGB565_TO_B8(pixel);
+            return COLOR_RGB888_TO_Y(*r, *g, *b);
+        }
+        case PIXFORMAT_BAYER_ANY: {
+            // Sample the 2x2 bayer cell starting at the even pixel.
+            x &= ~1;
+            y &= ~1;
+            uint8_t *row0 = IMAGE_COMPUTE_BAYER_PIXEL_ROW_PTR(image, y) + x;
+            uint8_t *row1 = IMAGE_COMPUTE_BAYER_PIXEL_ROW_PTR(image, y + 1) + x;
+            switch (image->subfmt_id) {
+                case SUBFORMAT_ID_BGGR:
+                    *b = row0[0]; *g = (row0[1] + row1[0]) >> 1; *r = row1[1];
+                    break;
+                case SUBFORMAT_ID_GBRG:
+                    *g = (row0[0] + row1[1]) >> 1; *b = row0[1]; *r = row1[0];
+                    break;
+                case SUBFORMAT_ID_GRBG:
+                    *g = (row0[0] + row1[1]) >> 1; *r = row0[1]; *b = row1[0];
+                    break;
+                default: // SUBFORMAT_ID_RGGB
+                    *r = row0[0]; *g = (row0[1] + row1[0]) >> 1; *b = row1[1];
+                    break;
+            }
+            return COLOR_RGB888_TO_Y(*r, *g, *b);
+        }
+        default: { // PIXFORMAT_YUV_ANY
+            *r = *g = *b = IMAGE_GET_YUV_PIXEL(image, x, y) & 0xff;
+            return *g;
+        }
+    }
+}
+
+static void ae_update_exposure(sensor_ae_t *ae, int mean)
+{
+    // The sensor response is linear so the error is measured in EV.
+    float error = fast_log2(ae->target / ((float) IM_MAX(mean, 1)));
+    error = IM_MAX(IM_MIN(error, AE_MAX_ERROR_EV), -AE_MAX_ERROR_EV);
+
+    float step = (AE_KP * (error - ae->error)) + (AE_KI * error);
+    ae->error = error;
+
+    if (fast_fabsf(error) < AE_DEADBAND_EV) {
+        return;
+    }
+
+    // Use as much exposure time as allowed and make up the rest with gain.
+    float total_us = ae_ev_to_linear(ae->ev + step);
+    int exposure_us = IM_MAX(fast_roundf(total_us), 1);
+
+    if (ae->max_exposure_us > 0) {
+        exposure_us = IM_MIN(exposure_us, ae->max_exposure_us);
+    }
+
+    if (exposure_us != ae->exposure_us) {
+        if (sensor_set_auto_exposure(0, exposure_us) != 0) {
+            return;
+        }
+
+        // The sensor rounds and clamps the exposure time.
+        sensor_get_exposure_us(&exposure_us);
+        ae->exposure_us = IM_MAX(exposure_us, 1);
+        ae->settle = AE_SETTLE_FRAMES;
+    }
+
+    float gain_db = IM_MAX(fast_log2(total_us / ae->exposure_us) * AE_DB_PER_EV, 0.0f);
+
+    if (ae->max_gain_db > 0.0f) {
+        gain_db = IM_MIN(gain_db, ae->max_gain_db);
+    }
+
+    if (fast_fabsf(gain_db - ae->gain_db) >= AE_DEADBAND_DB) {
+        if (sensor_set_auto_gain(0, gain_db, NAN) != 0) {
+            return;
+        }
+
+        // The sensor rounds and clamps the gain.
+        sensor_get_gain_db(&gain_db);
+        ae->gain_db = gain_db;
+        ae->settle = AE_SETTLE_FRAMES;
+    }
+
+    // Track the settings the sensor actually applied so that the loop doesn't wind up at the limits.
+    ae->ev = fast_log2(ae->exposure_us) + (ae->gain_db / AE_DB_PER_EV);
+}
+
+static void ae_update_whitebal(sensor_ae_t *ae, ae_stats_t *stats)
+{
+    if ((!stats->r) || (!stats->g) || (!stats->b)) {
+        return;
+    }
+
+    // The frame was captured with the current gains applied, so move towards the residual error.
+    float r_gain_db = ae->r_gain_db + (AWB_RATE * fast_log2(stats->g / ((float) stats->r)) * AE_DB_PER_EV);
+    float b_gain_db = ae->b_gain_db + (AWB_RATE * fast_log2(stats->g / ((float) stats->b)) * AE_DB_PER_EV);
+    r_gain_db = IM_MAX(IM_MIN(r_gain_db, AWB_MAX_GAIN_DB), -AWB_MAX_GAIN_DB);
+    b_gain_db = IM_MAX(IM_MIN(b_gain_db, AWB_MAX_GAIN_DB), -AWB_MAX_GAIN_DB);
+
+    if ((fast_fabsf(r_gain_db - ae->r_gain_db) < AWB_DEADBAND_DB)
+    &&  (fast_fabsf(b_gain_db - ae->b_gain_db) < AWB_DEADBAND_DB)) {
+        return;
+    }
+
+    if (sensor_set_auto_whitebal(0, r_gain_db, ae->g_gain_db, b_gain_db) != 0) {
+        return;
+    }
+
+    ae->r_gain_db = r_gain_db;
+    ae->b_gain_db = b_gain_db;
+    ae->settle = AE_SETTLE_FRAMES;
+}
+
+int sensor_set_software_ae(int enable, int target, int max_exposure_us, float max_gain_db)
+{
+    sensor_ae_t *ae = &sensor.ae;
+    int exposure_us, ret;
+    float gain_db;
+
+    if (!enable) {
+        ae->ae_enabled = false;
+        return 0;
+    }
+
+    if ((target < 1) || (target > 254) || (max_exposure_us < 0) || (max_gain_db < 0.0f)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Start from the current settings and hand them over to the controller.
+    if ((ret = sensor_get_exposure_us(&exposure_us)) != 0
+    ||  (ret = sensor_get_gain_db(&gain_db)) != 0
+    ||  (ret = sensor_set_auto_exposure(0, exposure_us)) != 0
+    ||  (ret = sensor_set_auto_gain(0, gain_db, NAN)) != 0) {
+        return ret;
+    }
+
+    ae->target = target;
+    ae->max_exposure_us = max_exposure_us;
+    ae->max_gain_db = max_gain_db;
+    ae->exposure_us = IM_MAX(exposure_us, 1);
+    ae->gain_db = gain_db;
+    ae->ev = fast_log2(ae->exposure_us) + (gain_db / AE_DB_PER_EV);
+    ae->error = 0.0f;
+    ae->settle = 0;
+    ae->ae_enabled = true;
+    return 0;
+}
+
+int sensor_set_software_awb(int enable, int mode)
+{
+    sensor_ae_t *ae = &sensor.ae;
+    int ret;
+
+    if (!enable) {
+        ae->awb_enabled = false;
+        return 0;
+    }
+
+    if ((mode != SENSOR_AWB_GRAY_WORLD) && (mode != SENSOR_AWB_WHITE_PATCH)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Not all sensors can read back the gains, start from unity gains in that case.
+    if (sensor_get_rgb_gain_db(&ae->r_gain_db, &ae->g_gain_db, &ae->b_gain_db) != 0) {
+        ae->r_gain_db = ae->g_gain_db = ae->b_gain_db = 0.0f;
+    }
+
+    if ((ret = sensor_set_auto_whitebal(0, ae->r_gain_db, ae->g_gain_db, ae->b_gain_db)) != 0) {
+        return ret;
+    }
+
+    ae->awb_mode = mode;
+    ae->settle = 0;
+    ae->awb_enabled = true;
+    return 0;
+}
+
+void sensor_software_ae_update(image_t *image)
+{
+    sensor_ae_t *ae = &sensor.ae;
+
+    if ((!ae->ae_enabled) && (!ae->awb_enabled)) {
+        return;
+    }
+
+    if (ae->settle) {
+        ae->settle--;
+        return;
+    }
+
+    bool color = false, bayer = false;
+
+    switch (image->pixfmt) {
+        case PIXFORMAT_GRAYSCALE:
+        case PIXFORMAT_YUV_ANY:
+            break;
+        case PIXFORMAT_RGB565:
+            color = true;
+            break;
+        case PIXFORMAT_BAYER_ANY:
+            // Bayer samples are read from 2x2 cells.
+            if ((image->w < 2) || (image->h < 2)) {
+                return;
+            }
+            color = bayer = true;
+            break;
+        default:
+            return;
+    }
+
+    int x_step = IM_MAX(image->w / AE_GRID_W, 1);
+    int y_step = IM_MAX(image->h / AE_GRID_H, 1);
+    int x_end = bayer ? (image->w & ~1) : image->w;
+    int y_end = bayer ? (image->h & ~1) : image->h;
+    uint32_t hist[AE_HIST_BINS] = {0};
+    ae_stats_t stats = {0};
+
+    for (int y = y_step / 2; y < y_end; y += y_step) {
+        for (int x = x_step / 2; x < x_end; x += x_step) {
+            int r, g, b, luma = ae_get_sample(image, x, y, &r, &g, &b);
+            hist[(luma * AE_HIST_BINS) >> 8] += 1;
+            stats.n += 1;
+            stats.y += luma;
+            stats.r += r;
+            stats.g += g;
+            stats.b += b;
+        }
+    }
+
+    if (!stats.n) {
+        return;
+    }
+
+    if (ae->ae_enabled) {
+        ae_update_exposure(ae, stats.y / stats.n);
+    }
+
+    if ((!ae->awb_enabled) || (!color)) {
+        return;
+    }
+
+    if (ae->awb_mode == SENSOR_AWB_WHITE_PATCH) {
+        // Find the luma bin above which the brightest samples are and average their color.
+        uint32_t count = 0, limit = IM_MAX((stats.n * AWB_WHITE_PATCH_PCT) / 100, 1U);
+        int bin = AE_HIST_BINS - 1;
+
+        for (; (bin > 0) && ((count += hist[bin]) < limit); bin--) {
+        }
+
+        ae_stats_t white = {0};
+
+        for (int y = y_step / 2; y < y_end; y += y_step) {
+            for (int x = x_step / 2; x < x_end; x += x_step) {
+                int r, g, b, luma = ae_get_sample(image, x, y, &r, &g, &b);
+                if ((((luma * AE_HIST_BINS) >> 8) >= bin)
+                &&  (r < AWB_CLIP_LEVEL) && (g < AWB_CLIP_LEVEL) && (b < AWB_CLIP_LEVEL)) {
+                    white.n += 1;
+                    white.r += r;
+                    white.g += g;
+                    white.b += b;
+                }
+            }
+        }
+
+        // Fall back to gray-world if every bright sample is clipped.
+        if (white.n) {
+            stats = white;
+        }
+    }
+
+    ae_update_whitebal(ae, &stats);
+}
+#endif // MICROPY_PY_SENSOR
@@ -0,0 +1,181 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Multi-exposure HDR capture.
+ *
+ * Two consecutive frames are captured with a long and a short exposure time and fused into one
+ * frame by weighting each pixel by how well exposed it is (single-scale Mertens exposure fusion).
+ * The exposures alternate between snapshots, so only one exposure change is needed per snapshot,
+ * and the fusion is done in fixed point in a single pass over both frames.
+ */
+#if MICROPY_PY_SENSOR
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor.h"
+#include "imlib.h"
+#include "fb_alloc.h"
+#include "fmath.h"
+
+#define HDR_MID_LEVEL           (128)
+#define HDR_SIGMA               (0.2f * 255.0f) // Well-exposedness spread (from Mertens et al.).
+#define HDR_MAX_SKIP_FRAMES     (8)
+
+// Well-exposedness weight of each luma level, never zero so the weights always sum up.
+static uint8_t hdr_weights[256];
+
+static void hdr_init_weights()
+{
+    for (int i = 0; i < 256; i++) {
+        float d = (i - HDR_MID_LEVEL) / HDR_SIGMA;
+        hdr_weights[i] = 1 + fast_roundf(254.0f * fast_expf(-0.5f * d * d));
+    }
+}
+
+// Captures a frame with the long (0) or short (1) exposure. Frames captured while a new exposure
+// time takes effect are skipped.
+static int hdr_capture(sensor_t *sensor, image_t *image, int index)
+{
+    sensor_hdr_t *hdr = &sensor->hdr;
+    int ret, skip = 0;
+
+    if (hdr->current != index) {
+        if ((ret = sensor_set_auto_exposure(0, hdr->exposure_us[index])) != 0) {
+            return ret;
+        }
+        // Drop the frames queued (or being captured) with the old exposure time when there is
+        // more than one frame buffer.
+        sensor_abort();
+        hdr->current = index;
+        skip = hdr->skip;
+    }
+
+    do {
+        if ((ret = sensor->snapshot(sensor, image, 0)) != 0) {
+            // The exposure time is unknown after a failed capture.
+            hdr->current = -1;
+            return ret;
+        }
+    } while (skip--);
+
+    return 0;
+}
+
+// Fuses src into dst (in place) using the well-exposedness weights of each pixel.
+static void hdr_merge(image_t *dst, image_t *src)
+{
+    int n = dst->w * dst->h;
+
+    switch (dst->pixfmt) {
+        case PIXFORMAT_GRAYSCALE: {
+            uint8_t *a = dst->data, *b = src->data;
+            for (int i = 0; i < n; i++) {
+                int wa = hdr_weights[a[i]];
+                int wb = hdr_weights[b[i]];
+                a[i] = ((a[i] * wa) + (b[i] * wb) + ((wa + wb) / 2)) / (wa + wb);
+            }
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *a = (uint16_t *) dst->data, *b = (uint16_t *) src->data;
+            for (int i = 0; i < n; i++) {
+                int pa = a[i], pb = b[i];
+                int wa = hdr_weights[COLOR_RGB565_TO_Y(pa)];
+                int wb = hdr_weights[COLOR_RGB565_TO_Y(pb)];
+                // Q8 weight of the first pixel, one division per pixel.
+                int alpha = (wa << 8) / (wa + wb), beta = 256 - alpha;
+                int r = ((COLOR_RGB565_TO_R5(pa) * alpha) + (COLOR_RGB565_TO_R5(pb) * beta) + 128) >> 8;
+                int g = ((COLOR_RGB565_TO_G6(pa) * alpha) + (COLOR_RGB565_TO_G6(pb) * beta) + 128) >> 8;
+                int bl = ((COLOR_RGB565_TO_B5(pa) * alpha) + (COLOR_RGB565_TO_B5(pb) * beta) + 128) >> 8;
+                a[i] = COLOR_R5_G6_B5_TO_RGB565(r, g, bl);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int sensor_set_hdr(int enable, int long_exposure_us, int short_exposure_us, int skip)
+{
+    sensor_hdr_t *hdr = &sensor.hdr;
+
+    if (!enable) {
+        if (!hdr->enabled) {
+            return 0;
+        }
+        hdr->enabled = false;
+        // Hand the exposure back to the sensor.
+        return sensor_set_auto_exposure(1, 0);
+    }
+
+    if ((short_exposure_us < 1) || (long_exposure_us <= short_exposure_us)
+    ||  (skip < 0) || (skip > HDR_MAX_SKIP_FRAMES)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (!hdr_weights[0]) {
+        hdr_init_weights();
+    }
+
+    // The software AE controller would fight over the exposure time.
+    sensor.ae.ae_enabled = false;
+
+    hdr->exposure_us[0] = long_exposure_us;
+    hdr->exposure_us[1] = short_exposure_us;
+    hdr->skip = skip;
+    hdr->current = -1;
+    hdr->enabled = true;
+    return 0;
+}
+
+int sensor_hdr_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
+{
+    sensor_hdr_t *hdr = &sensor->hdr;
+    int ret;
+
+    // Regions of interest and line scan strips are not merged and both frames are always waited
+    // for (snapshot_async() is not supported).
+    if (sensor->n_rois || sensor->n_linescan_rows || (flags & SENSOR_SNAPSHOT_NO_WAIT)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((sensor->pixformat != PIXFORMAT_GRAYSCALE) && (sensor->pixformat != PIXFORMAT_RGB565)) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    // Start with the exposure that is already set so it doesn't have to be changed twice.
+    int first = (hdr->current == 1) ? 1 : 0;
+
+    if ((ret = hdr_capture(sensor, image, first)) != 0) {
+        return ret;
+    }
+
+    // The pixel format can change if the frame didn't fit in the frame buffer.
+    if ((image->pixfmt != PIXFORMAT_GRAYSCALE) && (image->pixfmt != PIXFORMAT_RGB565)) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    // Keep a copy of the first frame since the next capture reuses the frame buffer.
+    image_t first_image = *image;
+    first_image.data = fb_alloc(image_size(image), FB_ALLOC_NO_HINT);
+    memcpy(first_image.data, image->data, image_size(image));
+
+    if ((ret = hdr_capture(sensor, image, !first)) == 0) {
+        if ((image->w != first_image.w) || (image->h != first_image.h)
+        ||  (image->pixfmt != first_image.pixfmt)) {
+            ret = SENSOR_ERROR_CAPTURE_FAILED;
+        } else {
+            hdr_merge(image, &first_image);
+        }
+    }
+
+    fb_free();
+    return ret;
+}
+#endif //MICROPY_PY_SENSOR
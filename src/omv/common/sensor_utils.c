@@ -30,10 +30,11 @@
 #include "paj6100.h"
 #include "frogeye2020.h"
 #include "gc2145.h"
+#include "vsensor.h"
 #include "framebuffer.h"
 #include "omv_boardconfig.h"
 
-#if (OMV_ENABLE_PAJ6100 == 1)
+#if (OMV_ENABLE_PAJ6100 == 1) || (OMV_ENABLE_VSENSOR == 1)
 #define OMV_ENABLE_NONI2CIS
 #endif
 
@@ -130,11 +131,23 @@ __weak int sensor_reset()
     #endif // MICROPY_PY_IMU
     sensor.vsync_callback       = NULL;
     sensor.frame_callback       = NULL;
+    sensor.line_callback        = NULL;
+    sensor.line_callback_arg    = NULL;
 
     // Reset default color palette.
     sensor.color_palette        = rainbow_table;
 
     sensor.disable_full_flush   = false;
+    sensor.auto_scale           = false;
+    sensor.n_rois               = 0;
+    sensor.n_linescan_rows      = 0;
+    MAIN_FB()->trailer_size     = 0;
+
+    // Disable the software AE/AWB controller.
+    memset(&sensor.ae, 0, sizeof(sensor.ae));
+
+    // Disable HDR capture.
+    memset(&sensor.hdr, 0, sizeof(sensor.hdr));
 
     // Restore shutdown state on reset.
     sensor_shutdown(false);
@@ -158,6 +171,9 @@ __weak int sensor_reset()
     // Re-enable the bus.
     cambus_enable(&sensor.bus, true);
 
+    // Registers are back to their default values.
+    sensor_reg_shadow_reset(&sensor);
+
     // Call sensor-specific reset function
     if (sensor.reset != NULL
             && sensor.reset(&sensor) != 0) {
@@ -294,8 +310,9 @@ int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed)
             break;
         #endif // (OMV_ENABLE_FROGEYE2020 == 1)
 
-        #if (OMV_ENABLE_PAJ6100 == 1)
+        #if (OMV_ENABLE_PAJ6100 == 1) || (OMV_ENABLE_VSENSOR == 1)
         case 0:
+            #if (OMV_ENABLE_PAJ6100 == 1)
             if (paj6100_detect(&sensor)) {
                 // Found PixArt PAJ6100
                 sensor.chip_id_w = PAJ6100_ID;
@@ -303,7 +320,14 @@ int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed)
                 sensor.reset_pol = ACTIVE_LOW;
                 break;
             }
+            #endif
+            #if (OMV_ENABLE_VSENSOR == 1)
+            // No image sensor found, replay recorded frames instead.
+            sensor.chip_id_w = VSENSOR_ID;
+            break;
+            #else
             return SENSOR_ERROR_ISC_UNDETECTED;
+            #endif
         #endif
 
         default:
@@ -443,6 +467,12 @@ int sensor_probe_init(uint32_t bus_id, uint32_t bus_speed)
             break;
         #endif // (OMV_ENABLE_FROGEYE2020 == 1)
 
+        #if (OMV_ENABLE_VSENSOR == 1)
+        case VSENSOR_ID:
+            init_ret = vsensor_init(&sensor);
+            break;
+        #endif // (OMV_ENABLE_VSENSOR == 1)
+
         default:
             return SENSOR_ERROR_ISC_UNSUPPORTED;
             break;
@@ -552,6 +582,142 @@ __weak int sensor_write_reg(uint16_t reg_addr, uint16_t reg_data)
     return 0;
 }
 
+static inline sensor_reg_shadow_t *sensor_reg_shadow(sensor_t *sensor, uint16_t reg_addr)
+{
+    // Mix the page bits into the index so that blocks of registers on different pages don't alias.
+    return &sensor->reg_shadow[(reg_addr ^ (reg_addr >> 7)) & (SENSOR_REG_SHADOW_SIZE - 1)];
+}
+
+static bool sensor_reg_is_volatile(sensor_t *sensor, uint16_t reg_addr)
+{
+    if (sensor->volatile_regs != NULL) {
+        for (int i = 0; sensor->volatile_regs[i][1]; i++) {
+            if ((sensor->volatile_regs[i][0] <= reg_addr) && (reg_addr <= sensor->volatile_regs[i][1])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static inline bool sensor_reg_shadow_match(sensor_t *sensor, uint16_t reg_addr, uint8_t reg_data)
+{
+    sensor_reg_shadow_t *shadow = sensor_reg_shadow(sensor, reg_addr);
+    return shadow->valid && (shadow->addr == reg_addr) && (shadow->data == reg_data);
+}
+
+static inline void sensor_reg_shadow_update(sensor_t *sensor, uint16_t reg_addr, uint8_t reg_data, bool valid)
+{
+    sensor_reg_shadow_t *shadow = sensor_reg_shadow(sensor, reg_addr);
+    shadow->addr = reg_addr;
+    shadow->data = reg_data;
+    // Registers that the sensor updates by itself (or that are self-clearing) are never cached.
+    shadow->valid = valid && !sensor_reg_is_volatile(sensor, reg_addr);
+}
+
+void sensor_reg_shadow_reset(sensor_t *sensor)
+{
+    memset(sensor->reg_shadow, 0, sizeof(sensor->reg_shadow));
+}
+
+int sensor_readb2(sensor_t *sensor, uint16_t reg_addr, uint8_t *reg_data)
+{
+    sensor_reg_shadow_t *shadow = sensor_reg_shadow(sensor, reg_addr);
+
+    if (shadow->valid && (shadow->addr == reg_addr)) {
+        *reg_data = shadow->data;
+        return 0;
+    }
+
+    uint8_t buf[] = {reg_addr >> 8, reg_addr};
+    int ret = cambus_write_bytes(&sensor->bus, sensor->slv_addr, buf, sizeof(buf), CAMBUS_XFER_NO_STOP);
+    ret |= cambus_read_bytes(&sensor->bus, sensor->slv_addr, reg_data, 1, CAMBUS_XFER_NO_FLAGS);
+
+    if (ret == 0) {
+        sensor_reg_shadow_update(sensor, reg_addr, *reg_data, true);
+    }
+
+    return ret;
+}
+
+int sensor_writeb2(sensor_t *sensor, uint16_t reg_addr, uint8_t reg_data)
+{
+    uint8_t buf[] = {reg_addr >> 8, reg_addr, reg_data};
+    int ret = cambus_write_bytes(&sensor->bus, sensor->slv_addr, buf, sizeof(buf), CAMBUS_XFER_NO_FLAGS);
+    // The register state is unknown if the write failed.
+    sensor_reg_shadow_update(sensor, reg_addr, reg_data, (ret == 0));
+    return ret;
+}
+
+int sensor_update_reg_bits(sensor_t *sensor, uint16_t reg_addr, uint8_t mask, uint8_t value)
+{
+    uint8_t reg_data;
+
+    if (sensor_readb2(sensor, reg_addr, &reg_data) != 0) {
+        return -1;
+    }
+
+    uint8_t new_data = (reg_data & ~mask) | (value & mask);
+
+    if (new_data == reg_data) {
+        return 0;
+    }
+
+    return sensor_writeb2(sensor, reg_addr, new_data);
+}
+
+int sensor_write_burst2(sensor_t *sensor, uint16_t reg_addr, const uint8_t *reg_data, int len)
+{
+    int ret = 0;
+    uint8_t buf[2 + SENSOR_REG_BURST_SIZE];
+
+    // Unchanged registers in the middle of a run are cheaper to rewrite than to split the burst.
+    for (; (len > 0) && sensor_reg_shadow_match(sensor, reg_addr, reg_data[0]); reg_addr++, reg_data++, len--);
+    for (; (len > 0) && sensor_reg_shadow_match(sensor, reg_addr + len - 1, reg_data[len - 1]); len--);
+
+    while (len > 0) {
+        int n = (len < SENSOR_REG_BURST_SIZE) ? len : SENSOR_REG_BURST_SIZE;
+
+        buf[0] = reg_addr >> 8;
+        buf[1] = reg_addr;
+        memcpy(buf + 2, reg_data, n);
+
+        int err = cambus_write_bytes(&sensor->bus, sensor->slv_addr, buf, n + 2, CAMBUS_XFER_NO_FLAGS);
+
+        for (int i = 0; i < n; i++) {
+            sensor_reg_shadow_update(sensor, reg_addr + i, reg_data[i], (err == 0));
+        }
+
+        ret |= err;
+        reg_addr += n;
+        reg_data += n;
+        len -= n;
+    }
+
+    return ret;
+}
+
+int sensor_write_regs2(sensor_t *sensor, const uint8_t (*regs)[3])
+{
+    int ret = 0;
+    uint8_t buf[SENSOR_REG_BURST_SIZE];
+
+    for (int i = 0; regs[i][0]; ) {
+        uint16_t reg_addr = (regs[i][0] << 8) | regs[i][1];
+        int n = 0;
+
+        // Collect a run of consecutive register addresses.
+        do {
+            buf[n++] = regs[i++][2];
+        } while (regs[i][0] && (n < SENSOR_REG_BURST_SIZE)
+                && (((regs[i][0] << 8) | regs[i][1]) == (reg_addr + n)));
+
+        ret |= sensor_write_burst2(sensor, reg_addr, buf, n);
+    }
+
+    return ret;
+}
+
 __weak int sensor_set_pixformat(pixformat_t pixformat)
 {
     // Check if the value has changed.
@@ -570,9 +736,9 @@ __weak int sensor_set_pixformat(pixformat_t pixformat)
         return 0;
     }
 
-    // Cropping and transposing (and thus auto rotation) don't work in JPEG mode.
+    // Cropping, regions of interest and transposing (and thus auto rotation) don't work in JPEG mode.
     if ((pixformat == PIXFORMAT_JPEG)
-            && (sensor_get_cropped() || sensor.transpose || sensor.auto_rotation)) {
+            && (sensor_get_cropped() || sensor.n_rois || sensor.transpose || sensor.auto_rotation)) {
         return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
     }
 
@@ -634,6 +800,11 @@ __weak int sensor_set_framesize(framesize_t framesize)
     // Set framebuffer size
     sensor.framesize = framesize;
 
+    // Regions of interest and line scan rows are relative to the frame size.
+    sensor.n_rois = 0;
+    sensor.n_linescan_rows = 0;
+    MAIN_FB()->trailer_size = 0;
+
     // Skip the first frame.
     MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
 
@@ -717,7 +888,8 @@ __weak int sensor_set_windowing(int x, int y, int w, int h)
 {
     // Check if the value has changed.
     if ((MAIN_FB()->x == x) && (MAIN_FB()->y == y) &&
-            (MAIN_FB()->u == w) && (MAIN_FB()->v == h)) {
+            (MAIN_FB()->u == w) && (MAIN_FB()->v == h) &&
+            (!sensor.n_rois) && (!sensor.n_linescan_rows)) {
         return 0;
     }
 
@@ -739,6 +911,11 @@ __weak int sensor_set_windowing(int x, int y, int w, int h)
     MAIN_FB()->w = MAIN_FB()->u = w;
     MAIN_FB()->h = MAIN_FB()->v = h;
 
+    // The window replaces the regions of interest and line scan rows.
+    sensor.n_rois = 0;
+    sensor.n_linescan_rows = 0;
+    MAIN_FB()->trailer_size = 0;
+
     // Pickout a good buffer count for the user.
     framebuffer_auto_adjust_buffers();
 
@@ -1008,6 +1185,11 @@ __weak int sensor_set_transpose(bool enable)
         return 0;
     }
 
+    // Regions of interest and line scan rows are never transposed.
+    if (enable && (sensor.n_rois || sensor.n_linescan_rows)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
     // Disable any ongoing frame capture.
     sensor_abort();
 
@@ -1033,6 +1215,11 @@ __weak int sensor_set_auto_rotation(bool enable)
         return 0;
     }
 
+    // Regions of interest and line scan rows are never transposed.
+    if (enable && (sensor.n_rois || sensor.n_linescan_rows)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
     // Disable any ongoing frame capture.
     sensor_abort();
 
@@ -1102,16 +1289,71 @@ __weak int sensor_set_lens_correction(int enable, int radi, int coef)
 
 __weak int sensor_ioctl(int request, ... /* arg */)
 {
+    va_list ap;
+    va_start(ap, request);
+
+    // Bus statistics are common to all sensors.
+    switch (request) {
+        case IOCTL_GET_BUS_STATS: {
+            *va_arg(ap, int *) = sensor.bus.xfer_count;
+            *va_arg(ap, int *) = sensor.bus.xfer_bytes;
+            va_end(ap);
+            return 0;
+        }
+        case IOCTL_RESET_BUS_STATS: {
+            cambus_reset_stats(&sensor.bus);
+            va_end(ap);
+            return 0;
+        }
+        case IOCTL_SET_SOFTWARE_AE: {
+            int enable = va_arg(ap, int);
+            int target = va_arg(ap, int);
+            int max_exposure_us = va_arg(ap, int);
+            float *max_gain_db = va_arg(ap, float *);
+            int ret = sensor_set_software_ae(enable, target, max_exposure_us, *max_gain_db);
+            va_end(ap);
+            return ret;
+        }
+        case IOCTL_SET_SOFTWARE_AWB: {
+            int enable = va_arg(ap, int);
+            int mode = va_arg(ap, int);
+            int ret = sensor_set_software_awb(enable, mode);
+            va_end(ap);
+            return ret;
+        }
+        case IOCTL_SET_CAPTURE_HISTOGRAM: {
+            int ret = sensor_set_capture_histogram(va_arg(ap, int));
+            va_end(ap);
+            return ret;
+        }
+        case IOCTL_GET_CAPTURE_HISTOGRAM: {
+            int ret = sensor_get_capture_histogram(va_arg(ap, uint32_t *));
+            va_end(ap);
+            return ret;
+        }
+        case IOCTL_SET_HDR: {
+            int enable = va_arg(ap, int);
+            int long_exposure_us = va_arg(ap, int);
+            int short_exposure_us = va_arg(ap, int);
+            int skip = va_arg(ap, int);
+            int ret = sensor_set_hdr(enable, long_exposure_us, short_exposure_us, skip);
+            va_end(ap);
+            return ret;
+        }
+        default: {
+            break;
+        }
+    }
+
     // Disable any ongoing frame capture.
     sensor_abort();
 
     // Check if the control is supported.
     if (sensor.ioctl == NULL) {
+        va_end(ap);
         return SENSOR_ERROR_CTL_UNSUPPORTED;
     }
 
-    va_list ap;
-    va_start(ap, request);
     // Call the sensor specific function.
     int ret = sensor.ioctl(&sensor, request, ap);
     va_end(ap);
@@ -1131,6 +1373,111 @@ __weak int sensor_set_frame_callback(frame_cb_t vsync_cb)
     return 0;
 }
 
+__weak int sensor_set_rois(const rectangle_t *rois, int n_rois)
+{
+    // The port must copy the regions of interest during capture.
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
+__weak int sensor_set_linescan(const uint16_t *rows, int n_rows, int height)
+{
+    // The port must copy the line scan rows during capture.
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
+uint32_t *sensor_get_linescan_timestamps(vbuffer_t *buffer)
+{
+    uint32_t size = MAIN_FB()->u * sensor.linescan_height * sensor_get_dst_bpp();
+    return (uint32_t *) (buffer->data + FB_ALIGN_SIZE_ROUND_UP(size));
+}
+
+__weak int sensor_set_line_callback(line_cb_t line_cb, void *arg)
+{
+    // The port must call the line callback during capture.
+    return SENSOR_ERROR_CTL_UNSUPPORTED;
+}
+
+// Luma histogram gathered during capture. The first set of bins is accumulated while the frame
+// is received and is copied to the second set once the last line is received.
+static uint32_t capture_hist[2][SENSOR_CAPTURE_HIST_BINS];
+
+static void sensor_capture_hist_line_cb(void *arg, uint32_t line, const uint8_t *data, uint32_t width)
+{
+    uint32_t *bins = capture_hist[0];
+    // Sample every other line and at most 128 pixels per line to keep the interrupt short.
+    uint32_t step = IM_MAX(width / 128, 1U);
+
+    if (line == 0) {
+        memset(bins, 0, sizeof(capture_hist[0]));
+    }
+
+    if (!(line % 2)) {
+        switch (sensor.pixformat) {
+            case PIXFORMAT_GRAYSCALE:
+                if (sensor.hw_flags.gs_bpp == 2) {
+                    // Y channel of YUV.
+                    for (uint32_t x = 0; x < width; x += step) {
+                        bins[(data[x * 2] * SENSOR_CAPTURE_HIST_BINS) >> 8] += 1;
+                    }
+                    break;
+                }
+                // Fall through (1BPP GRAYSCALE).
+            case PIXFORMAT_BAYER:
+                for (uint32_t x = 0; x < width; x += step) {
+                    bins[(data[x] * SENSOR_CAPTURE_HIST_BINS) >> 8] += 1;
+                }
+                break;
+            case PIXFORMAT_YUV422: {
+                const uint8_t *y_data = data + sensor.hw_flags.yuv_swap;
+                for (uint32_t x = 0; x < width; x += step) {
+                    bins[(y_data[x * 2] * SENSOR_CAPTURE_HIST_BINS) >> 8] += 1;
+                }
+                break;
+            }
+            case PIXFORMAT_RGB565: {
+                for (uint32_t x = 0; x < width; x += step) {
+                    uint32_t lo = data[x * 2], hi = data[(x * 2) + 1];
+                    int pixel = sensor.hw_flags.rgb_swap ? ((lo << 8) | hi) : ((hi << 8) | lo);
+                    bins[(COLOR_RGB565_TO_Y(pixel) * SENSOR_CAPTURE_HIST_BINS) >> 8] += 1;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    if (line == (uint32_t) (MAIN_FB()->v - 1)) {
+        memcpy(capture_hist[1], bins, sizeof(capture_hist[1]));
+    }
+}
+
+int sensor_set_capture_histogram(int enable)
+{
+    if (!enable) {
+        // Don't remove another line callback.
+        if (sensor.line_callback != sensor_capture_hist_line_cb) {
+            return 0;
+        }
+        return sensor_set_line_callback(NULL, NULL);
+    }
+
+    memset(capture_hist, 0, sizeof(capture_hist));
+    return sensor_set_line_callback(sensor_capture_hist_line_cb, NULL);
+}
+
+int sensor_get_capture_histogram(uint32_t *bins)
+{
+    if (sensor.line_callback != sensor_capture_hist_line_cb) {
+        return SENSOR_ERROR_CTL_FAILED;
+    }
+
+    // The bins are updated by the capture interrupt at the end of each frame. A copy racing with
+    // the end of the next frame mixes the two frames, which is fine for statistics.
+    memcpy(bins, capture_hist[1], sizeof(capture_hist[1]));
+    return 0;
+}
+
 __weak int sensor_set_color_palette(const uint16_t *color_palette)
 {
     sensor.color_palette = color_palette;
@@ -1142,11 +1489,68 @@ __weak const uint16_t *sensor_get_color_palette()
     return sensor.color_palette;
 }
 
+// Returns the number of pixels copied to the frame buffer for each frame.
+static uint32_t sensor_get_fb_pixels()
+{
+    if (sensor.n_linescan_rows) {
+        return MAIN_FB()->u * sensor.linescan_height;
+    }
+
+    if (!sensor.n_rois) {
+        return MAIN_FB()->u * MAIN_FB()->v;
+    }
+
+    uint32_t pixels = 0;
+    for (int i = 0; i < sensor.n_rois; i++) {
+        pixels += sensor.rois[i].w * sensor.rois[i].h;
+    }
+    return pixels;
+}
+
+// Returns the number of bytes used in the frame buffer for each frame.
+static uint32_t sensor_get_fb_size(uint32_t bpp)
+{
+    uint32_t size = sensor_get_fb_pixels() * bpp;
+
+    // Line scan row timestamps are stored after the strip (see MAIN_FB()->trailer_size).
+    if (sensor.n_linescan_rows) {
+        size = FB_ALIGN_SIZE_ROUND_UP(size) + (sensor.linescan_height * sizeof(uint32_t));
+    }
+
+    return size;
+}
+
 __weak int sensor_check_framebuffer_size()
 {
     uint32_t bpp = sensor_get_dst_bpp();
     uint32_t size = framebuffer_get_buffer_size();
-    return (((MAIN_FB()->u * MAIN_FB()->v * bpp) <= size) ? 0 : -1);
+    return ((sensor_get_fb_size(bpp) <= size) ? 0 : -1);
+}
+
+framesize_t sensor_get_scaled_framesize(framesize_t framesize, uint32_t bpp, uint32_t size, uint32_t max_pixels)
+{
+    framesize_t best = FRAMESIZE_INVALID;
+    uint32_t best_pixels = 0;
+    uint32_t w = resolution[framesize][0];
+    uint32_t h = resolution[framesize][1];
+
+    for (framesize_t i = FRAMESIZE_INVALID + 1; i <= FRAMESIZE_WQXGA2; i++) {
+        uint32_t i_w = resolution[i][0];
+        uint32_t i_h = resolution[i][1];
+        uint32_t pixels = i_w * i_h;
+
+        // Same field of view, smaller, fits and larger than the best so far.
+        if (((i_w * h) == (i_h * w))
+        &&  (i_w <= w) && (i_h <= h)
+        &&  (pixels < max_pixels)
+        &&  ((pixels * bpp) <= size)
+        &&  (pixels > best_pixels)) {
+            best = i;
+            best_pixels = pixels;
+        }
+    }
+
+    return best;
 }
 
 __weak int sensor_auto_crop_framebuffer()
@@ -1160,10 +1564,32 @@ __weak int sensor_auto_crop_framebuffer()
     }
 
     // MAIN_FB() fits, we are done.
-    if ((MAIN_FB()->u * MAIN_FB()->v * bpp) <= size) {
+    if (sensor_get_fb_size(bpp) <= size) {
         return 0;
     }
 
+    // Regions of interest and line scan strips are not cropped.
+    if (sensor.n_rois || sensor.n_linescan_rows) {
+        return -1;
+    }
+
+    // Switch to a smaller frame size to keep the field of view and the pixel format. The sensor
+    // bins, subsamples or scales the image to the new frame size. This only works if the user
+    // didn't set a window since the window is relative to the frame size.
+    if (sensor.auto_scale && (sensor.framesize != FRAMESIZE_INVALID) && (!sensor_get_cropped())) {
+        uint32_t max_pixels = MAIN_FB()->u * MAIN_FB()->v;
+        framesize_t framesize;
+
+        // Not all sensors support all frame sizes so keep trying smaller ones.
+        while ((framesize = sensor_get_scaled_framesize(sensor.framesize, bpp, size, max_pixels))) {
+            if (sensor_set_framesize(framesize) == 0) {
+                return 0;
+            }
+
+            max_pixels = resolution[framesize][0] * resolution[framesize][1];
+        }
+    }
+
     if ((sensor.pixformat == PIXFORMAT_RGB565) || (sensor.pixformat == PIXFORMAT_YUV422)) {
         // Switch to bayer for the quick 2x savings.
         sensor_set_pixformat(PIXFORMAT_BAYER);
@@ -1262,6 +1688,8 @@ const char *sensor_strerror(int error)
         "Frame buffer error.",
         "Frame buffer overflow, try reducing the frame size.",
         "JPEG frame buffer overflow.",
+        "End of the recorded frames.",
+        "No new frame is ready.",
     };
 
     // Sensor errors are negative.
@@ -1274,6 +1702,16 @@ const char *sensor_strerror(int error)
     }
 }
 
+bool sensor_frame_ready()
+{
+    // In single buffer mode the capture only runs inside snapshot(), which always waits for it.
+    if ((MAIN_FB()->n_buffers == 1) && (MAIN_FB()->pixfmt != PIXFORMAT_INVALID)) {
+        return false;
+    }
+
+    return framebuffer_get_head(FB_PEEK) != NULL;
+}
+
 __weak int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
 {
     return -1;
@@ -0,0 +1,120 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Running Gaussian background model.
+ */
+#include <stdlib.h>
+#include "imlib.h"
+#ifdef IMLIB_ENABLE_BACKGROUND_MODEL
+
+// Means are kept in Q8 and variances in Q4 (grayscale units squared).
+#define BG_MODEL_MEAN_BITS      (8)
+#define BG_MODEL_VAR_BITS       (4)
+#define BG_MODEL_RATE_BITS      (16)
+
+size_t imlib_bg_model_size(int w, int h)
+{
+    return w * h * 2 * sizeof(uint16_t);
+}
+
+void imlib_bg_model_init(bg_model_t *model, int w, int h, float rate, float threshold, float min_sigma,
+                         bool selective, uint16_t *buffer)
+{
+    model->w = w;
+    model->h = h;
+    // Rates are capped at 0.5 so that the Q16 products below fit in 32 bits.
+    model->rate = IM_MAX(IM_MIN(fast_roundf(rate * (1 << BG_MODEL_RATE_BITS)), INT16_MAX), 1);
+    model->threshold = IM_MIN(fast_roundf(threshold * threshold * (1 << BG_MODEL_VAR_BITS)), UINT16_MAX);
+    model->min_variance = IM_MIN(fast_roundf(min_sigma * min_sigma * (1 << BG_MODEL_VAR_BITS)), UINT16_MAX);
+    model->selective = selective;
+    model->valid = false;
+    model->mean = buffer;
+    model->variance = buffer + (w * h);
+}
+
+static inline const void *bg_model_get_row_ptr(image_t *img, int y)
+{
+    if (img->pixfmt == PIXFORMAT_RGB565) {
+        return IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+    }
+
+    return IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+}
+
+static inline int bg_model_get_y(image_t *img, int x, const void *row_ptr)
+{
+    if (img->pixfmt == PIXFORMAT_RGB565) {
+        return COLOR_RGB565_TO_Y(IMAGE_GET_RGB565_PIXEL_FAST((const uint16_t *) row_ptr, x));
+    }
+
+    return IMAGE_GET_GRAYSCALE_PIXEL_FAST((const uint8_t *) row_ptr, x);
+}
+
+// Classifies every pixel of img against the model and updates the model in the same pass.
+// Pixels further than threshold standard deviations from their mean are foreground, are
+// set in mask (if not NULL) and are not learned when the model is selective. Returns the
+// number of foreground pixels.
+int imlib_bg_model_update(bg_model_t *model, image_t *img, image_t *mask)
+{
+    int count = 0;
+
+    if (!model->valid) {
+        for (int y = 0, i = 0; y < model->h; y++) {
+            const void *row_ptr = bg_model_get_row_ptr(img, y);
+            for (int x = 0; x < model->w; x++, i++) {
+                model->mean[i] = bg_model_get_y(img, x, row_ptr) << BG_MODEL_MEAN_BITS;
+                model->variance[i] = model->min_variance;
+            }
+        }
+
+        if (mask) {
+            memset(mask->data, 0, image_size(mask));
+        }
+
+        model->valid = true;
+        return 0;
+    }
+
+    for (int y = 0, i = 0; y < model->h; y++) {
+        const void *row_ptr = bg_model_get_row_ptr(img, y);
+        uint32_t *mask_row_ptr = mask ? IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(mask, y) : NULL;
+
+        for (int x = 0; x < model->w; ) {
+            uint32_t bits = 0;
+
+            for (int b = 0; (b < UINT32_T_BITS) && (x < model->w); b++, x++, i++) {
+                int mean = model->mean[i], variance = model->variance[i];
+                int d = (bg_model_get_y(img, x, row_ptr) << BG_MODEL_MEAN_BITS) - mean;
+                // d^2 in Q16 to Q4 with rounding.
+                uint32_t d2 = ((((uint32_t) abs(d)) * abs(d)) + (1 << ((2 * BG_MODEL_MEAN_BITS) - BG_MODEL_VAR_BITS - 1)))
+                              >> ((2 * BG_MODEL_MEAN_BITS) - BG_MODEL_VAR_BITS);
+                bool fg = (d2 << BG_MODEL_VAR_BITS) > (model->threshold * ((uint32_t) variance));
+
+                if (fg) {
+                    bits |= 1 << b;
+                    count += 1;
+                }
+
+                if (!(fg && model->selective)) {
+                    mean += (d * model->rate) >> BG_MODEL_RATE_BITS;
+                    int sample = IM_MIN(d2, (uint32_t) UINT16_MAX);
+                    variance += ((sample - variance) * model->rate) >> BG_MODEL_RATE_BITS;
+                    model->mean[i] = mean;
+                    model->variance[i] = IM_MAX(variance, model->min_variance);
+                }
+            }
+
+            if (mask_row_ptr) {
+                *mask_row_ptr++ = bits;
+            }
+        }
+    }
+
+    return count;
+}
+#endif // IMLIB_ENABLE_BACKGROUND_MODEL
@@ -15,6 +15,11 @@ typedef struct xylr {
 }
 xylr_t;
 
+typedef struct flood_fill_span {
+    int16_t y, l, r;
+}
+flood_fill_span_t;
+
 static float sign(float x)
 {
     return x / fabsf(x);
@@ -1062,364 +1067,210 @@ void imlib_find_blobs(list_t *out, image_t *ptr, rectangle_t *roi, unsigned int
     }
 }
 
-void imlib_flood_fill_int(image_t *out, image_t *img, int x, int y,
-                          int seed_threshold, int floating_threshold,
-                          flood_fill_call_back_t cb, void *data)
+static inline void *flood_fill_get_row_ptr(image_t *img, int y)
 {
-    lifo_t lifo;
-    size_t lifo_len;
-    lifo_alloc_all(&lifo, &lifo_len, sizeof(xylr_t));
-
     switch (img->pixfmt) {
         case PIXFORMAT_BINARY: {
-            for(int seed_pixel = IMAGE_GET_BINARY_PIXEL(img, x, y);;) {
-                int left = x, right = x;
-                uint32_t *row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
-                uint32_t *out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y);
-
-                while ((left > 0)
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, left - 1))
-                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, left - 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, left - 1),
-                                      IMAGE_GET_BINARY_PIXEL_FAST(row, left), floating_threshold)) {
-                    left--;
-                }
+            return IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            return IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+        }
+        case PIXFORMAT_RGB565: {
+            return IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+        }
+        default: {
+            return NULL;
+        }
+    }
+}
 
-                while ((right < (img->w - 1))
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, right + 1))
-                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, right + 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, right + 1),
-                                      IMAGE_GET_BINARY_PIXEL_FAST(row, right), floating_threshold)) {
-                    right++;
-                }
+static inline int flood_fill_get_pixel(image_t *img, const void *row_ptr, int x)
+{
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            return IMAGE_GET_BINARY_PIXEL_FAST((uint32_t *) row_ptr, x);
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            return IMAGE_GET_GRAYSCALE_PIXEL_FAST((uint8_t *) row_ptr, x);
+        }
+        case PIXFORMAT_RGB565: {
+            return IMAGE_GET_RGB565_PIXEL_FAST((uint16_t *) row_ptr, x);
+        }
+        default: {
+            return 0;
+        }
+    }
+}
 
-                for (int i = left; i <= right; i++) {
-                    IMAGE_SET_BINARY_PIXEL_FAST(out_row, i);
-                }
+static inline bool flood_fill_bound(image_t *img, int p0, int p1, int threshold)
+{
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            return COLOR_BOUND_BINARY(p0, p1, threshold);
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            return COLOR_BOUND_GRAYSCALE(p0, p1, threshold);
+        }
+        case PIXFORMAT_RGB565: {
+            return COLOR_BOUND_RGB565(p0, p1, threshold);
+        }
+        default: {
+            return false;
+        }
+    }
+}
 
-                int top_left = left;
-                int bot_left = left;
-                bool break_out = false;
-                for(;;) {
-                    if (lifo_size(&lifo) < lifo_len) {
-                        uint32_t *old_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
-
-                        if (y > 0) {
-                            row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y - 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y - 1);
-
-                            bool recurse = false;
-                            for (int i = top_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, i),
-                                                      IMAGE_GET_BINARY_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = i + 1; // Don't test the same pixel again...
-                                    context.b_l = bot_left;
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y - 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
+// Returns the first x in [x, r] whose bit is clear, or r + 1 if there is none.
+static inline int flood_fill_next_clear(uint32_t *row_ptr, int x, int r)
+{
+    while (x <= r) {
+        uint32_t bits = ~row_ptr[x >> UINT32_T_SHIFT] >> (x & UINT32_T_MASK);
 
-                        if (y < (img->h - 1)) {
-                            row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y + 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y + 1);
+        if (bits) {
+            return IM_MIN(x + __CLZ(__RBIT(bits)), r + 1);
+        }
 
-                            bool recurse = false;
-                            for (int i = bot_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_BINARY(IMAGE_GET_BINARY_PIXEL_FAST(row, i),
-                                                      IMAGE_GET_BINARY_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = top_left;
-                                    context.b_l = i + 1; // Don't test the same pixel again...
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y + 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
-                    }
+        x = (x | UINT32_T_MASK) + 1;
+    }
 
-                    if (cb) cb(img, y, left, right, data);
+    return IM_MIN(x, r + 1);
+}
 
-                    if (!lifo_size(&lifo)) {
-                        break_out = true;
-                        break;
-                    }
+static void flood_fill_set_span(uint32_t *row_ptr, int l, int r)
+{
+    int l_word = l >> UINT32_T_SHIFT, r_word = r >> UINT32_T_SHIFT;
+    uint32_t l_mask = UINT32_MAX << (l & UINT32_T_MASK);
+    uint32_t r_mask = UINT32_MAX >> (UINT32_T_MASK - (r & UINT32_T_MASK));
 
-                    xylr_t context;
-                    lifo_dequeue(&lifo, &context);
-                    x = context.x;
-                    y = context.y;
-                    left = context.l;
-                    right = context.r;
-                    top_left = context.t_l;
-                    bot_left = context.b_l;
-                }
+    if (l_word == r_word) {
+        row_ptr[l_word] |= l_mask & r_mask;
+    } else {
+        row_ptr[l_word] |= l_mask;
 
-                if (break_out) {
-                    break;
-                }
-            }
-            break;
+        for (int i = l_word + 1; i < r_word; i++) {
+            row_ptr[i] = UINT32_MAX;
         }
-        case PIXFORMAT_GRAYSCALE: {
-            for(int seed_pixel = IMAGE_GET_GRAYSCALE_PIXEL(img, x, y);;) {
-                int left = x, right = x;
-                uint8_t *row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
-                uint32_t *out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y);
-
-                while ((left > 0)
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, left - 1))
-                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, left - 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, left - 1),
-                                         IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, left), floating_threshold)) {
-                    left--;
-                }
 
-                while ((right < (img->w - 1))
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, right + 1))
-                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, right + 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, right + 1),
-                                         IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, right), floating_threshold)) {
-                    right++;
-                }
+        row_ptr[r_word] |= r_mask;
+    }
+}
 
-                for (int i = left; i <= right; i++) {
-                    IMAGE_SET_BINARY_PIXEL_FAST(out_row, i);
-                }
+// Grows the seed pixel at x into the run of unfilled matching pixels around it and marks it filled.
+static void flood_fill_grow_span(image_t *img, void *row_ptr, uint32_t *out_row_ptr,
+                                 int x, int x_min, int x_max, int seed_pixel,
+                                 int seed_threshold, int floating_threshold,
+                                 flood_fill_span_t *span)
+{
+    int left = x, right = x;
 
-                int top_left = left;
-                int bot_left = left;
-                bool break_out = false;
-                for(;;) {
-                    if (lifo_size(&lifo) < lifo_len) {
-                        uint8_t *old_row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
-
-                        if (y > 0) {
-                            row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y - 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y - 1);
-
-                            bool recurse = false;
-                            for (int i = top_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, i),
-                                                         IMAGE_GET_GRAYSCALE_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = i + 1; // Don't test the same pixel again...
-                                    context.b_l = bot_left;
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y - 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
+    for (int pixel = flood_fill_get_pixel(img, row_ptr, x); left > x_min; left--) {
+        int next = flood_fill_get_pixel(img, row_ptr, left - 1);
+        if (IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, left - 1)
+                || (!flood_fill_bound(img, next, seed_pixel, seed_threshold))
+                || (!flood_fill_bound(img, next, pixel, floating_threshold))) {
+            break;
+        }
+        pixel = next;
+    }
 
-                        if (y < (img->h - 1)) {
-                            row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y + 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y + 1);
+    for (int pixel = flood_fill_get_pixel(img, row_ptr, x); right < x_max; right++) {
+        int next = flood_fill_get_pixel(img, row_ptr, right + 1);
+        if (IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, right + 1)
+                || (!flood_fill_bound(img, next, seed_pixel, seed_threshold))
+                || (!flood_fill_bound(img, next, pixel, floating_threshold))) {
+            break;
+        }
+        pixel = next;
+    }
 
-                            bool recurse = false;
-                            for (int i = bot_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_GRAYSCALE(IMAGE_GET_GRAYSCALE_PIXEL_FAST(row, i),
-                                                         IMAGE_GET_GRAYSCALE_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = top_left;
-                                    context.b_l = i + 1; // Don't test the same pixel again...
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y + 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
-                    }
+    flood_fill_set_span(out_row_ptr, left, right);
+    span->l = left;
+    span->r = right;
+}
 
-                    if (cb) cb(img, y, left, right, data);
+// Scanline flood fill. Every span is grown and marked in out when it is found and then pushed
+// onto the stack. Popping a span scans the rows above and below it for unfilled matching pixels
+// which seed new spans. The callback gets a span only after both of its neighbouring rows were
+// scanned, so callbacks are free to modify the pixels they are given.
+//
+// The stack is allocated with all the remaining frame buffer memory. Spans that do not fit on it
+// are left unfilled, which may cut the fill short on huge images with very complex regions, so
+// the number of seed pixels that were dropped is returned (0 if the fill is complete).
+int imlib_flood_fill_int(image_t *out, image_t *img, int x, int y,
+                         int seed_threshold, int floating_threshold,
+                         rectangle_t *roi, flood_fill_call_back_t cb, void *data)
+{
+    int x_min = 0, x_max = img->w - 1, y_min = 0, y_max = img->h - 1;
 
-                    if (!lifo_size(&lifo)) {
-                        break_out = true;
-                        break;
-                    }
+    if (roi) {
+        x_min = IM_MAX(roi->x, 0);
+        x_max = IM_MIN(roi->x + roi->w, img->w) - 1;
+        y_min = IM_MAX(roi->y, 0);
+        y_max = IM_MIN(roi->y + roi->h, img->h) - 1;
+    }
 
-                    xylr_t context;
-                    lifo_dequeue(&lifo, &context);
-                    x = context.x;
-                    y = context.y;
-                    left = context.l;
-                    right = context.r;
-                    top_left = context.t_l;
-                    bot_left = context.b_l;
-                }
+    if ((x < x_min) || (x > x_max) || (y < y_min) || (y > y_max)
+            || IMAGE_GET_BINARY_PIXEL(out, x, y)) {
+        return 0;
+    }
 
-                if (break_out) {
-                    break;
-                }
-            }
-            break;
-        }
-        case PIXFORMAT_RGB565: {
-            for(int seed_pixel = IMAGE_GET_RGB565_PIXEL(img, x, y);;) {
-                int left = x, right = x;
-                uint16_t *row = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
-                uint32_t *out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y);
-
-                while ((left > 0)
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, left - 1))
-                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, left - 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, left - 1),
-                                      IMAGE_GET_RGB565_PIXEL_FAST(row, left), floating_threshold)) {
-                    left--;
-                }
+    int dropped = 0;
+    lifo_t lifo;
+    size_t lifo_len;
+    lifo_alloc_all(&lifo, &lifo_len, sizeof(flood_fill_span_t));
 
-                while ((right < (img->w - 1))
-                && (!IMAGE_GET_BINARY_PIXEL_FAST(out_row, right + 1))
-                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, right + 1), seed_pixel, seed_threshold)
-                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, right + 1),
-                                      IMAGE_GET_RGB565_PIXEL_FAST(row, right), floating_threshold)) {
-                    right++;
-                }
+    void *row_ptr = flood_fill_get_row_ptr(img, y);
+    int seed_pixel = flood_fill_get_pixel(img, row_ptr, x);
 
-                for (int i = left; i <= right; i++) {
-                    IMAGE_SET_BINARY_PIXEL_FAST(out_row, i);
-                }
+    flood_fill_span_t span;
+    span.y = y;
+    flood_fill_grow_span(img, row_ptr, IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y),
+                         x, x_min, x_max, seed_pixel, seed_threshold, floating_threshold, &span);
+    lifo_enqueue(&lifo, &span);
 
-                int top_left = left;
-                int bot_left = left;
-                bool break_out = false;
-                for(;;) {
-                    if (lifo_size(&lifo) < lifo_len) {
-                        uint16_t *old_row = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
-
-                        if (y > 0) {
-                            row = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y - 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y - 1);
-
-                            bool recurse = false;
-                            for (int i = top_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, i),
-                                                      IMAGE_GET_RGB565_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = i + 1; // Don't test the same pixel again...
-                                    context.b_l = bot_left;
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y - 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
+    while (lifo_is_not_empty(&lifo)) {
+        lifo_dequeue(&lifo, &span);
+        row_ptr = flood_fill_get_row_ptr(img, span.y);
+        int left = span.l, right = span.r, line = span.y;
 
-                        if (y < (img->h - 1)) {
-                            row = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y + 1);
-                            out_row = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, y + 1);
+        for (int dy = -1; dy <= 1; dy += 2) {
+            int ny = line + dy;
 
-                            bool recurse = false;
-                            for (int i = bot_left; i <= right; i++) {
-                                if ((!IMAGE_GET_BINARY_PIXEL_FAST(out_row, i))
-                                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, i), seed_pixel, seed_threshold)
-                                && COLOR_BOUND_RGB565(IMAGE_GET_RGB565_PIXEL_FAST(row, i),
-                                                      IMAGE_GET_RGB565_PIXEL_FAST(old_row, i), floating_threshold)) {
-                                    xylr_t context;
-                                    context.x = x;
-                                    context.y = y;
-                                    context.l = left;
-                                    context.r = right;
-                                    context.t_l = top_left;
-                                    context.b_l = i + 1; // Don't test the same pixel again...
-                                    lifo_enqueue(&lifo, &context);
-                                    x = i;
-                                    y = y + 1;
-                                    recurse = true;
-                                    break;
-                                }
-                            }
-                            if (recurse) {
-                                break;
-                            }
-                        }
-                    }
+            if ((ny < y_min) || (ny > y_max)) {
+                continue;
+            }
 
-                    if (cb) cb(img, y, left, right, data);
+            void *n_row_ptr = flood_fill_get_row_ptr(img, ny);
+            uint32_t *n_out_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(out, ny);
 
-                    if (!lifo_size(&lifo)) {
-                        break_out = true;
-                        break;
-                    }
+            // Already filled pixels are skipped a word at a time.
+            for (int i = flood_fill_next_clear(n_out_row_ptr, left, right); i <= right;
+                 i = flood_fill_next_clear(n_out_row_ptr, i + 1, right)) {
+                int pixel = flood_fill_get_pixel(img, n_row_ptr, i);
 
-                    xylr_t context;
-                    lifo_dequeue(&lifo, &context);
-                    x = context.x;
-                    y = context.y;
-                    left = context.l;
-                    right = context.r;
-                    top_left = context.t_l;
-                    bot_left = context.b_l;
-                }
+                if (flood_fill_bound(img, pixel, seed_pixel, seed_threshold)
+                        && flood_fill_bound(img, pixel, flood_fill_get_pixel(img, row_ptr, i), floating_threshold)) {
+                    if (!lifo_is_not_full(&lifo)) {
+                        dropped += 1;
+                        continue;
+                    }
 
-                if (break_out) {
-                    break;
+                    flood_fill_span_t n_span;
+                    n_span.y = ny;
+                    flood_fill_grow_span(img, n_row_ptr, n_out_row_ptr, i, x_min, x_max, seed_pixel,
+                                         seed_threshold, floating_threshold, &n_span);
+                    lifo_enqueue(&lifo, &n_span);
+                    i = n_span.r;
                 }
             }
-            break;
         }
-        default: {
-            break;
+
+        if (cb) {
+            cb(img, line, left, right, data);
         }
     }
 
     lifo_free(&lifo);
+    return dropped;
 }
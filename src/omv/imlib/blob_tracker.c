@@ -0,0 +1,183 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Blob tracking across frames.
+ */
+#include <stdlib.h>
+#include "imlib.h"
+#include "fb_alloc.h"
+
+// Alpha-beta filter gains of the constant velocity predictor.
+#define BLOB_TRACKER_ALPHA  (0.7f)
+#define BLOB_TRACKER_BETA   (0.3f)
+
+typedef struct blob_tracker_pair {
+    float cost;
+    uint16_t track, det;
+} blob_tracker_pair_t;
+
+static int blob_tracker_pair_compare(const void *a, const void *b)
+{
+    float diff = ((const blob_tracker_pair_t *) a)->cost - ((const blob_tracker_pair_t *) b)->cost;
+    return (diff < 0) ? -1 : ((diff > 0) ? 1 : 0);
+}
+
+// Where the track is expected to be in the next frame.
+static void blob_tracker_predict(blob_track_t *track, rectangle_t *rect, float *cx, float *cy)
+{
+    *cx = track->cx + track->vx;
+    *cy = track->cy + track->vy;
+    rect->x = track->rect.x + fast_roundf(*cx - track->cx);
+    rect->y = track->rect.y + fast_roundf(*cy - track->cy);
+    rect->w = track->rect.w;
+    rect->h = track->rect.h;
+}
+
+void imlib_blob_tracker_init(blob_tracker_t *tracker, int max_tracks, int max_distance, float min_iou, int max_misses)
+{
+    memset(tracker, 0, sizeof(blob_tracker_t));
+    tracker->max_tracks = IM_MIN(IM_MAX(max_tracks, 1), BLOB_TRACKER_MAX_TRACKS);
+    tracker->max_distance = max_distance;
+    tracker->min_iou = min_iou;
+    tracker->max_misses = max_misses;
+    tracker->next_id = 1;
+}
+
+void imlib_blob_tracker_update(blob_tracker_t *tracker, blob_tracker_detection_t *dets, int dets_len)
+{
+    rectangle_t pred_rect[BLOB_TRACKER_MAX_TRACKS];
+    float pred_cx[BLOB_TRACKER_MAX_TRACKS], pred_cy[BLOB_TRACKER_MAX_TRACKS];
+
+    for (int i = 0; i < tracker->count; i++) {
+        blob_tracker_predict(&tracker->tracks[i], &pred_rect[i], &pred_cx[i], &pred_cy[i]);
+        tracker->tracks[i].match = -1;
+    }
+
+    // Gate all track/detection pairs on overlap or centroid distance and greedily assign
+    // them cheapest first. The cost mixes both so overlapping blobs win over near ones.
+    int pairs_len = 0;
+    blob_tracker_pair_t *pairs = fb_alloc((tracker->count * dets_len * sizeof(blob_tracker_pair_t)) + 1, FB_ALLOC_NO_HINT);
+    int8_t *det_track = fb_alloc(dets_len + 1, FB_ALLOC_NO_HINT);
+    memset(det_track, -1, dets_len);
+
+    for (int i = 0; i < tracker->count; i++) {
+        for (int j = 0; j < dets_len; j++) {
+            float iou = rectangle_iou(&pred_rect[i], &dets[j].rect);
+            float dx = dets[j].cx - pred_cx[i], dy = dets[j].cy - pred_cy[i];
+            float distance = fast_sqrtf((dx * dx) + (dy * dy));
+
+            if ((iou > 0.0f && iou >= tracker->min_iou) || (distance <= tracker->max_distance)) {
+                pairs[pairs_len].cost = (1.0f - iou) + (distance / IM_MAX(tracker->max_distance, 1));
+                pairs[pairs_len].track = i;
+                pairs[pairs_len].det = j;
+                pairs_len += 1;
+            }
+        }
+    }
+
+    qsort(pairs, pairs_len, sizeof(blob_tracker_pair_t), blob_tracker_pair_compare);
+
+    for (int i = 0; i < pairs_len; i++) {
+        blob_track_t *track = &tracker->tracks[pairs[i].track];
+        int j = pairs[i].det;
+
+        if ((track->match >= 0) || (det_track[j] >= 0)) {
+            continue;
+        }
+
+        track->match = j;
+        det_track[j] = pairs[i].track;
+
+        float rx = dets[j].cx - pred_cx[pairs[i].track];
+        float ry = dets[j].cy - pred_cy[pairs[i].track];
+        track->cx = pred_cx[pairs[i].track] + (BLOB_TRACKER_ALPHA * rx);
+        track->cy = pred_cy[pairs[i].track] + (BLOB_TRACKER_ALPHA * ry);
+        track->vx += BLOB_TRACKER_BETA * rx;
+        track->vy += BLOB_TRACKER_BETA * ry;
+        track->rect = dets[j].rect;
+        track->misses = 0;
+    }
+
+    // Unmatched tracks coast on their prediction until they miss too many frames.
+    for (int i = 0; i < tracker->count; i++) {
+        blob_track_t *track = &tracker->tracks[i];
+        track->age += 1;
+
+        if (track->match < 0) {
+            track->misses += 1;
+            track->rect = pred_rect[i];
+            track->cx = pred_cx[i];
+            track->cy = pred_cy[i];
+        }
+    }
+
+    // Drop dead tracks keeping the rest in creation order.
+    int count = 0;
+    for (int i = 0; i < tracker->count; i++) {
+        if (tracker->tracks[i].misses <= tracker->max_misses) {
+            tracker->tracks[count++] = tracker->tracks[i];
+        }
+    }
+    tracker->count = count;
+
+    // Unmatched detections start new tracks while there is room in the pool.
+    for (int j = 0; j < dets_len; j++) {
+        if ((det_track[j] < 0) && (tracker->count < tracker->max_tracks)) {
+            blob_track_t *track = &tracker->tracks[tracker->count++];
+            memset(track, 0, sizeof(blob_track_t));
+            track->id = tracker->next_id++;
+            track->rect = dets[j].rect;
+            track->cx = dets[j].cx;
+            track->cy = dets[j].cy;
+            track->match = j;
+        }
+    }
+
+    fb_free(); // det_track
+    fb_free(); // pairs
+}
+
+int imlib_blob_tracker_rois(blob_tracker_t *tracker, image_t *img, int margin, rectangle_t *rois)
+{
+    rectangle_t bounds = { 0, 0, img->w, img->h };
+    int rois_len = 0;
+
+    for (int i = 0; i < tracker->count; i++) {
+        blob_track_t *track = &tracker->tracks[i];
+        rectangle_t r;
+        float cx, cy;
+        blob_tracker_predict(track, &r, &cx, &cy);
+
+        // Faster objects and objects that have been lost for a while get a larger window.
+        int x_margin = margin + fast_ceilf(fast_fabsf(track->vx) * (track->misses + 1));
+        int y_margin = margin + fast_ceilf(fast_fabsf(track->vy) * (track->misses + 1));
+        rectangle_init(&r, r.x - x_margin, r.y - y_margin, r.w + (2 * x_margin), r.h + (2 * y_margin));
+
+        if (rectangle_overlap(&r, &bounds)) {
+            rectangle_intersected(&r, &bounds);
+            rois[rois_len++] = r;
+        }
+    }
+
+    // Merge overlapping windows so that no blob is found twice.
+    for (bool merged = true; merged; ) {
+        merged = false;
+        for (int i = 0; i < rois_len; i++) {
+            for (int j = i + 1; j < rois_len; j++) {
+                if (rectangle_overlap(&rois[i], &rois[j])) {
+                    rectangle_united(&rois[i], &rois[j]);
+                    rois[j] = rois[--rois_len];
+                    merged = true;
+                    j = i;
+                }
+            }
+        }
+    }
+
+    return rois_len;
+}
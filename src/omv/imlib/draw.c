@@ -78,18 +78,126 @@ void imlib_set_pixel(image_t *img, int x, int y, int p)
     }
 }
 
-// https://stackoverflow.com/questions/1201200/fast-algorithm-for-drawing-filled-circles
-static void point_fill(image_t *img, int cx, int cy, int r0, int r1, int c)
+// Fills pixels x0...x1 (inclusive and already clipped) of row y.
+static void fill_span(image_t *img, int x0, int x1, int y, int c)
 {
-    for (int y = r0; y <= r1; y++) {
-        for (int x = r0; x <= r1; x++) {
-            if (((x * x) + (y * y)) <= (r0 * r0)) {
-                imlib_set_pixel(img, cx + x, cy + y, c);
+    switch (img->pixfmt) {
+        case PIXFORMAT_BINARY: {
+            uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
+            for (; (x0 <= x1) && (x0 & UINT32_T_MASK); x0++) IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x0, c);
+            for (uint32_t fill = (c & 1) ? 0xFFFFFFFF : 0; (x0 + UINT32_T_MASK) <= x1; x0 += UINT32_T_BITS) {
+                row_ptr[x0 >> UINT32_T_SHIFT] = fill;
             }
+            for (; x0 <= x1; x0++) IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x0, c);
+            break;
+        }
+        case PIXFORMAT_GRAYSCALE: {
+            memset(IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y) + x0, c, x1 - x0 + 1);
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+            for (; x0 <= x1; x0++) IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x0, c);
+            break;
+        }
+        default: {
+            break;
         }
     }
 }
 
+// Fills a rectangle clipped to the image.
+static void fill_rect(image_t *img, int x, int y, int w, int h, int c)
+{
+    int x0 = IM_MAX(x, 0), x1 = IM_MIN(x + w, img->w) - 1;
+    int y0 = IM_MAX(y, 0), y1 = IM_MIN(y + h, img->h) - 1;
+    for (; (x0 <= x1) && (y0 <= y1); y0++) fill_span(img, x0, x1, y0, c);
+}
+
+// Fills pixels x0...x1 (inclusive) of row y clipping the span once.
+static void draw_span(image_t *img, int x0, int x1, int y, int c)
+{
+    if ((0 <= y) && (y < img->h)) {
+        x0 = IM_MAX(x0, 0);
+        x1 = IM_MIN(x1, img->w - 1);
+        if (x0 <= x1) fill_span(img, x0, x1, y, c);
+    }
+}
+
+// Scanline Rasterizer
+//
+// Shapes that are not produced row by row add their pixels to a span table which keeps the
+// leftmost and rightmost pixel of each image row. The table is then filled with one clipped
+// span per row. This is exact for convex shapes.
+typedef struct span_table {
+    int y_min, y_max; // touched rows.
+    int16_t *x_min, *x_max;
+} span_table_t;
+
+static void span_table_alloc(image_t *img, span_table_t *table)
+{
+    table->y_min = img->h;
+    table->y_max = -1;
+    table->x_min = fb_alloc(img->h * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    table->x_max = fb_alloc(img->h * sizeof(int16_t), FB_ALLOC_NO_HINT);
+
+    for (int i = 0; i < img->h; i++) {
+        table->x_min[i] = INT16_MAX;
+        table->x_max[i] = INT16_MIN;
+    }
+}
+
+static void span_table_add(image_t *img, span_table_t *table, int x0, int x1, int y)
+{
+    if ((0 <= y) && (y < img->h) && (x0 <= x1)) {
+        table->y_min = IM_MIN(table->y_min, y);
+        table->y_max = IM_MAX(table->y_max, y);
+        table->x_min[y] = IM_MIN(table->x_min[y], IM_MAX(x0, INT16_MIN));
+        table->x_max[y] = IM_MAX(table->x_max[y], IM_MIN(x1, INT16_MAX));
+    }
+}
+
+static void span_table_add_vline(image_t *img, span_table_t *table, int x, int y0, int y1)
+{
+    for (int y = IM_MAX(y0, 0), yy = IM_MIN(y1, img->h - 1); y <= yy; y++) {
+        span_table_add(img, table, x, x, y);
+    }
+}
+
+static void span_table_fill_and_free(image_t *img, span_table_t *table, int c)
+{
+    for (int y = table->y_min; y <= table->y_max; y++) {
+        if (table->x_min[y] <= table->x_max[y]) draw_span(img, table->x_min[y], table->x_max[y], y, c);
+    }
+
+    fb_free(); // x_max
+    fb_free(); // x_min
+}
+
+// Returns the largest x >= 0 such that x * x <= v starting the search at x (v >= 0).
+static int isqrt_from(int x, int v)
+{
+    while ((x > 0) && ((x * x) > v)) x--;
+    while (((x + 1) * (x + 1)) <= v) x++;
+    return x;
+}
+
+// Fills the pixels within [r0, r1] of (cx, cy) inside the disk of radius -r0 (r0 <= 0).
+// https://stackoverflow.com/questions/1201200/fast-algorithm-for-drawing-filled-circles
+static void point_fill(image_t *img, int cx, int cy, int r0, int r1, int c)
+{
+    if (r0 == r1) {
+        imlib_set_pixel(img, cx + r0, cy + r0, c);
+        return;
+    }
+
+    for (int y = r0, x = 0, rr = r0 * r0; y <= r1; y++) {
+        if ((y * y) > rr) continue;
+        x = isqrt_from(x, rr - (y * y));
+        draw_span(img, cx + IM_MAX(r0, -x), cx + IM_MIN(r1, x), cy + y, c);
+    }
+}
+
 // https://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C
 void imlib_draw_line(image_t *img, int x0, int y0, int x1, int y1, int c, int thickness)
 {
@@ -112,24 +220,20 @@ void imlib_draw_line(image_t *img, int x0, int y0, int x1, int y1, int c, int th
 
 static void xLine(image_t *img, int x1, int x2, int y, int c)
 {
-    while (x1 <= x2) imlib_set_pixel(img, x1++, y, c);
+    draw_span(img, x1, x2, y, c);
 }
 
 static void yLine(image_t *img, int x, int y1, int y2, int c)
 {
-    while (y1 <= y2) imlib_set_pixel(img, x, y1++, c);
+    if ((0 <= x) && (x < img->w)) {
+        for (int y = IM_MAX(y1, 0), yy = IM_MIN(y2, img->h - 1); y <= yy; y++) fill_span(img, x, x, y, c);
+    }
 }
 
 void imlib_draw_rectangle(image_t *img, int rx, int ry, int rw, int rh, int c, int thickness, bool fill)
 {
     if (fill) {
-
-        for (int y = ry, yy = ry + rh; y < yy; y++) {
-            for (int x = rx, xx = rx + rw; x < xx; x++) {
-                imlib_set_pixel(img, x, y, c);
-            }
-        }
-
+        fill_rect(img, rx, ry, rw, rh, c);
     } else if (thickness > 0) {
         int thickness0 = (thickness - 0) / 2;
         int thickness1 = (thickness - 1) / 2;
@@ -202,10 +306,10 @@ static void scratch_draw_pixel(image_t *img, int x0, int y0, int dx, int dy, flo
 }
 
 // https://scratch.mit.edu/projects/50039326/
-static void scratch_draw_line(image_t *img, int x0, int y0, int dx, int dy0, int dy1, float shear_dx, float shear_dy, int c)
+static void scratch_draw_line(image_t *img, span_table_t *table, int x0, int y0, int dx, int dy0, int dy1, float shear_dx, float shear_dy)
 {
     int y = y0 + fast_floorf((dx * shear_dy) / shear_dx);
-    yLine(img, x0 + dx, y + dy0, y + dy1, c);
+    span_table_add_vline(img, table, x0 + dx, y + dy0, y + dy1);
 }
 
 // https://scratch.mit.edu/projects/50039326/
@@ -223,10 +327,13 @@ static void scratch_draw_sheared_ellipse(image_t *img, int x0, int y0, int width
         int y = height;
         int sigma = (2 * b_squared) + (a_squared * (1 - (2 * height)));
 
+        span_table_t table;
+        if (filled) span_table_alloc(img, &table);
+
         while ((b_squared * x) <= (a_squared * y)) {
             if (filled) {
-                scratch_draw_line(img, x0, y0, x, -y, y, shear_dx, shear_dy, c);
-                scratch_draw_line(img, x0, y0, -x, -y, y, shear_dx, shear_dy, c);
+                scratch_draw_line(img, &table, x0, y0, x, -y, y, shear_dx, shear_dy);
+                scratch_draw_line(img, &table, x0, y0, -x, -y, y, shear_dx, shear_dy);
             } else {
                 scratch_draw_pixel(img, x0, y0, x, y, shear_dx, shear_dy, -thickness0, thickness1, c);
                 scratch_draw_pixel(img, x0, y0, -x, y, shear_dx, shear_dy, -thickness0, thickness1, c);
@@ -249,8 +356,8 @@ static void scratch_draw_sheared_ellipse(image_t *img, int x0, int y0, int width
 
         while ((a_squared * y) <= (b_squared * x)) {
             if (filled) {
-                scratch_draw_line(img, x0, y0, x, -y, y, shear_dx, shear_dy, c);
-                scratch_draw_line(img, x0, y0, -x, -y, y, shear_dx, shear_dy, c);
+                scratch_draw_line(img, &table, x0, y0, x, -y, y, shear_dx, shear_dy);
+                scratch_draw_line(img, &table, x0, y0, -x, -y, y, shear_dx, shear_dy);
             } else {
                 scratch_draw_pixel(img, x0, y0, x, y, shear_dx, shear_dy, -thickness0, thickness1, c);
                 scratch_draw_pixel(img, x0, y0, -x, y, shear_dx, shear_dy, -thickness0, thickness1, c);
@@ -266,6 +373,8 @@ static void scratch_draw_sheared_ellipse(image_t *img, int x0, int y0, int width
             sigma += a_squared * ((4 * y) + 6);
             y += 1;
         }
+
+        if (filled) span_table_fill_and_free(img, &table, c);
     }
 }
 
@@ -313,8 +422,292 @@ void imlib_draw_ellipse(image_t *img, int cx, int cy, int rx, int ry, int rotati
     scratch_draw_rotated_ellipse(img, cx, cy, rx * 2, ry * 2, r, fill, c, thickness);
 }
 
+// Fills the inside of a polygon (even-odd rule, sampled at pixel centers) and strokes its edges
+// so a filled polygon covers the same pixels as its outline.
+void imlib_draw_polygon(image_t *img, point_t *points, int points_len, int c, int thickness, bool fill)
+{
+    if (points_len < 2) {
+        if (points_len == 1) imlib_draw_line(img, points[0].x, points[0].y, points[0].x, points[0].y, c, thickness);
+        return;
+    }
+
+    if (fill && (points_len >= 3)) {
+        int y_min = INT_MAX, y_max = INT_MIN;
+
+        for (int i = 0; i < points_len; i++) {
+            y_min = IM_MIN(y_min, points[i].y);
+            y_max = IM_MAX(y_max, points[i].y);
+        }
+
+        y_min = IM_MAX(y_min, 0);
+        y_max = IM_MIN(y_max, img->h - 1);
+        int32_t *nodes = fb_alloc(points_len * sizeof(int32_t), FB_ALLOC_NO_HINT);
+
+        for (int y = y_min; y <= y_max; y++) {
+            int nodes_len = 0;
+
+            // Edges include their top row and exclude their bottom row.
+            for (int i = 0, j = points_len - 1; i < points_len; j = i++) {
+                int x0 = points[j].x, y0 = points[j].y, x1 = points[i].x, y1 = points[i].y;
+                if (y0 > y1) { int t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+                if ((y < y0) || (y >= y1)) continue;
+
+                // 16.16 fixed point x of the crossing, insertion sorted.
+                int32_t x = (x0 * 65536) + (int32_t) ((((int64_t) (y - y0)) * (x1 - x0) * 65536) / (y1 - y0));
+                int k = nodes_len++;
+                for (; (k > 0) && (nodes[k - 1] > x); k--) nodes[k] = nodes[k - 1];
+                nodes[k] = x;
+            }
+
+            for (int i = 0; (i + 1) < nodes_len; i += 2) {
+                draw_span(img, (nodes[i] + 0xFFFF) >> 16, nodes[i + 1] >> 16, y, c);
+            }
+        }
+
+        fb_free(); // nodes
+        thickness = IM_MAX(thickness, 1);
+    }
+
+    for (int i = 0, j = points_len - 1; i < points_len; j = i++) {
+        imlib_draw_line(img, points[j].x, points[j].y, points[i].x, points[i].y, c, thickness);
+    }
+}
+
+// Blends c over the pixel at (x, y) with alpha in [0:256].
+static void blend_pixel(image_t *img, int x, int y, int c, int alpha)
+{
+    if ((0 <= x) && (x < img->w) && (0 <= y) && (y < img->h) && (alpha > 0)) {
+        switch (img->pixfmt) {
+            case PIXFORMAT_BINARY: {
+                if (alpha >= 128) IMAGE_PUT_BINARY_PIXEL(img, x, y, c);
+                break;
+            }
+            case PIXFORMAT_GRAYSCALE: {
+                uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+                int p = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row_ptr, x);
+                IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row_ptr, x, ((c * alpha) + (p * (256 - alpha))) >> 8);
+                break;
+            }
+            case PIXFORMAT_RGB565: {
+                uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+                int p = IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x);
+                int r = ((COLOR_RGB565_TO_R5(c) * alpha) + (COLOR_RGB565_TO_R5(p) * (256 - alpha))) >> 8;
+                int g = ((COLOR_RGB565_TO_G6(c) * alpha) + (COLOR_RGB565_TO_G6(p) * (256 - alpha))) >> 8;
+                int b = ((COLOR_RGB565_TO_B5(c) * alpha) + (COLOR_RGB565_TO_B5(p) * (256 - alpha))) >> 8;
+                IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x, COLOR_R5_G6_B5_TO_RGB565(r, g, b));
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+// https://en.wikipedia.org/wiki/Xiaolin_Wu%27s_line_algorithm
+void imlib_draw_line_aa(image_t *img, int x0, int y0, int x1, int y1, int c)
+{
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+
+    if (steep) {
+        int t = x0; x0 = y0; y0 = t;
+        t = x1; x1 = y1; y1 = t;
+    }
+
+    if (x0 > x1) {
+        int t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    int dx = x1 - x0;
+    int32_t gradient = dx ? ((int32_t) ((((int64_t) (y1 - y0)) * 65536) / dx)) : 0;
+
+    for (int32_t x = x0, y = y0 * 65536; x <= x1; x++, y += gradient) {
+        int yi = y >> 16, frac = (y >> 8) & 0xFF;
+
+        if (steep) {
+            blend_pixel(img, yi, x, c, 256 - frac);
+            blend_pixel(img, yi + 1, x, c, frac);
+        } else {
+            blend_pixel(img, x, yi, c, 256 - frac);
+            blend_pixel(img, x, yi + 1, c, frac);
+        }
+    }
+}
+
 // char rotation == 0, 90, 180, 360, etc.
 // string rotation == 0, 90, 180, 360, etc.
+// Glyph Cache
+//
+// A glyph drawn with a given style (scale, rotations and mirroring) is cached as the list
+// of rectangles covering its set pixels in image space, relative to the glyph anchor. The
+// rectangles are built from runs of set bits merged across rows so drawing a cached glyph
+// only fills a handful of spans. The cache is direct mapped, colliding glyphs replace each
+// other.
+#define GLYPH_CACHE_SIZE        32 // power of 2
+#define GLYPH_CACHE_MAX_RECTS   16
+
+typedef struct glyph_cache_entry {
+    float scale;
+    uint8_t ch;
+    uint8_t style;
+    int8_t lead, trail; // first/last set column in source pixels (-1 if empty).
+    uint8_t rects_len;
+    struct { int16_t x, y, w, h; } rects[GLYPH_CACHE_MAX_RECTS];
+} glyph_cache_entry_t;
+
+static glyph_cache_entry_t glyph_cache[GLYPH_CACHE_SIZE];
+
+#define GLYPH_STYLE(char_rotation, char_hmirror, char_vflip, string_rotation, string_hmirror) \
+    (((char_rotation) / 90) | (((string_rotation) / 90) << 2) | \
+     ((char_hmirror) << 4) | ((char_vflip) << 5) | ((string_hmirror) << 6) | 0x80)
+
+// Rotates by a multiple of 90 degrees (exact version of point_rotate()).
+static void glyph_rotate(int *x, int *y, int rotation)
+{
+    int tx = *x, ty = *y;
+    switch (rotation) {
+        case 90: *x = -ty; *y = tx; break;
+        case 180: *x = -tx; *y = -ty; break;
+        case 270: *x = ty; *y = -tx; break;
+        default: break;
+    }
+}
+
+static bool glyph_pixel(const glyph_t *g, int x, int y, bool flip_y, bool flip_x)
+{
+    return g->data[flip_y ? (g->h - 1 - y) : y] & (1 << (flip_x ? x : (g->w - 1 - x)));
+}
+
+// Finds the first (lead) and last (trail) set columns used for proportional spacing.
+static void glyph_extents(const glyph_t *g, bool char_swap_w_h, bool flip_y, bool flip_x, int8_t *lead, int8_t *trail)
+{
+    *lead = *trail = -1;
+
+    if (!char_swap_w_h) {
+        for (int x = 0; x < g->w; x++) {
+            for (int y = 0; y < g->h; y++) {
+                if (glyph_pixel(g, x, y, flip_y, flip_x)) {
+                    if (*lead < 0) *lead = x;
+                    *trail = x;
+                    break;
+                }
+            }
+        }
+    } else {
+        for (int y = g->h - 1; y >= 0; y--) {
+            for (int x = 0; x < g->w; x++) {
+                if (glyph_pixel(g, x, y, flip_y, flip_x)) {
+                    if (*lead < 0) *lead = g->h - 1 - y;
+                    *trail = g->h - 1 - y;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Returns the first scaled coordinate that maps back to source coordinate i (or size if none).
+static int glyph_scaled_start(int i, int size, float scale)
+{
+    int s = fast_floorf(i * scale);
+    while ((s > 0) && (fast_floorf((s - 1) / scale) >= i)) s--;
+    while ((s < size) && (fast_floorf(s / scale) < i)) s++;
+    return s;
+}
+
+static void glyph_cache_fill(glyph_cache_entry_t *e, const glyph_t *g, float scale,
+                             int char_rotation, bool char_hmirror, bool char_vflip, int string_rotation)
+{
+    int xx = fast_floorf(g->w * scale), yy = fast_floorf(g->h * scale);
+    int sx[9], sy[11]; // font glyphs are at most 8x10.
+
+    for (int i = 0; i <= g->w; i++) sx[i] = glyph_scaled_start(i, xx, scale);
+    for (int i = 0; i <= g->h; i++) sy[i] = glyph_scaled_start(i, yy, scale);
+
+    e->rects_len = 0;
+
+    // Source rectangles as [x0, x1) x [y0, y1), runs equal to the run above extend it.
+    int src[GLYPH_CACHE_MAX_RECTS][4];
+    int src_len = 0;
+
+    for (int y = 0; y < g->h; y++) {
+        for (int x = 0; x < g->w;) {
+            if (!glyph_pixel(g, x, y, false, false)) {
+                x++;
+                continue;
+            }
+
+            int x0 = x;
+            while ((x < g->w) && glyph_pixel(g, x, y, false, false)) x++;
+
+            int i = 0;
+            for (; i < src_len; i++) {
+                if ((src[i][0] == x0) && (src[i][1] == x) && (src[i][3] == y)) break;
+            }
+
+            if (i < src_len) {
+                src[i][3] = y + 1;
+            } else if (src_len < GLYPH_CACHE_MAX_RECTS) {
+                src[src_len][0] = x0;
+                src[src_len][1] = x;
+                src[src_len][2] = y;
+                src[src_len][3] = y + 1;
+                src_len++;
+            } else {
+                e->rects_len = 0xFF; // does not fit
+                return;
+            }
+        }
+    }
+
+    for (int i = 0; i < src_len; i++) {
+        // Scaled and mirrored pixel coordinates (inclusive).
+        int x0 = sx[src[i][0]], x1 = sx[src[i][1]] - 1;
+        int y0 = sy[src[i][2]], y1 = sy[src[i][3]] - 1;
+        if ((x0 > x1) || (y0 > y1)) continue;
+        if (char_hmirror) { int t = x0; x0 = xx - 1 - x1; x1 = xx - 1 - t; }
+        if (char_vflip) { int t = y0; y0 = yy - 1 - y1; y1 = yy - 1 - t; }
+
+        // Rotate both corners around the glyph center then around the string origin.
+        x0 -= xx / 2; x1 -= xx / 2; y0 -= yy / 2; y1 -= yy / 2;
+        glyph_rotate(&x0, &y0, char_rotation);
+        glyph_rotate(&x1, &y1, char_rotation);
+        x0 += xx / 2; x1 += xx / 2; y0 += yy / 2; y1 += yy / 2;
+        glyph_rotate(&x0, &y0, string_rotation);
+        glyph_rotate(&x1, &y1, string_rotation);
+
+        int n = e->rects_len++;
+        e->rects[n].x = IM_MIN(x0, x1);
+        e->rects[n].y = IM_MIN(y0, y1);
+        e->rects[n].w = abs(x1 - x0) + 1;
+        e->rects[n].h = abs(y1 - y0) + 1;
+    }
+}
+
+static const glyph_cache_entry_t *glyph_cache_get(char ch, float scale, int char_rotation, bool char_hmirror, bool char_vflip,
+                                                  int string_rotation, bool string_hmirror)
+{
+    uint8_t style = GLYPH_STYLE(char_rotation, char_hmirror, char_vflip, string_rotation, string_hmirror);
+    int scale_hash = fast_floorf(scale * 16);
+    glyph_cache_entry_t *e = &glyph_cache[(ch + (style * 7) + (scale_hash * 13)) & (GLYPH_CACHE_SIZE - 1)];
+
+    if ((e->ch != ch) || (e->style != style) || (e->scale != scale)) {
+        const glyph_t *g = &font[ch - ' '];
+        bool char_swap_w_h = (char_rotation == 90) || (char_rotation == 270);
+        bool char_upsidedown = (char_rotation == 180) || (char_rotation == 270);
+
+        e->ch = ch;
+        e->style = style;
+        e->scale = scale;
+        glyph_extents(g, char_swap_w_h, char_upsidedown ^ char_vflip, char_upsidedown ^ char_hmirror ^ string_hmirror,
+                      &e->lead, &e->trail);
+        glyph_cache_fill(e, g, scale, char_rotation, char_hmirror, char_vflip, string_rotation);
+    }
+
+    return e;
+}
+
 void imlib_draw_string(image_t *img, int x_off, int y_off, const char *str, int c, float scale, int x_spacing, int y_spacing, bool mono_space,
                        int char_rotation, bool char_hmirror, bool char_vflip, int string_rotation, bool string_hmirror, bool string_vflip)
 {
@@ -327,7 +720,6 @@ void imlib_draw_string(image_t *img, int x_off, int y_off, const char *str, int
     string_rotation = (string_rotation / 90) * 90;
 
     bool char_swap_w_h = (char_rotation == 90) || (char_rotation == 270);
-    bool char_upsidedown = (char_rotation == 180) || (char_rotation == 270);
 
     if (string_hmirror) x_off -= fast_floorf(font[0].w * scale) - 1;
     if (string_vflip) y_off -= fast_floorf(font[0].h * scale) - 1;
@@ -353,86 +745,45 @@ void imlib_draw_string(image_t *img, int x_off, int y_off, const char *str, int
         }
 
         const glyph_t *g = &font[ch - ' '];
+        const glyph_cache_entry_t *e = glyph_cache_get(ch, scale, char_rotation, char_hmirror, char_vflip,
+                                                       string_rotation, string_hmirror);
 
-        if (!mono_space) {
-            // Find the first pixel set and offset to that.
-            bool exit = false;
-
-            if (!char_swap_w_h) {
-                for (int x = 0, xx = g->w; x < xx; x++) {
-                    for (int y = 0, yy = g->h; y < yy; y++) {
-                        if (g->data[(char_upsidedown ^ char_vflip) ? (g->h - 1 - y) : y] &
-                            (1 << ((char_upsidedown ^ char_hmirror ^ string_hmirror) ? x : (g->w - 1 - x)))) {
-                            x_off += (string_hmirror ? +1 : -1) * fast_floorf(x * scale);
-                            exit = true;
-                            break;
-                        }
-                    }
+        if ((!mono_space) && (e->lead >= 0)) {
+            // Offset to the first pixel set.
+            x_off += (string_hmirror ? +1 : -1) * fast_floorf(e->lead * scale);
+        }
 
-                    if (exit) break;
-                }
-            } else {
-                for (int y = g->h - 1; y >= 0; y--) {
-                    for (int x = 0, xx = g->w; x < xx; x++) {
-                        if (g->data[(char_upsidedown ^ char_vflip) ? (g->h - 1 - y) : y] &
-                            (1 << ((char_upsidedown ^ char_hmirror ^ string_hmirror) ? x : (g->w - 1 - x)))) {
-                            x_off += (string_hmirror ? +1 : -1) * fast_floorf((g->h - 1 - y) * scale);
-                            exit = true;
-                            break;
-                        }
-                    }
+        if (e->rects_len != 0xFF) {
+            int x_tmp = x_off - org_x_off, y_tmp = y_off - org_y_off;
+            glyph_rotate(&x_tmp, &y_tmp, string_rotation);
+            x_tmp += org_x_off;
+            y_tmp += org_y_off;
 
-                    if (exit) break;
-                }
+            for (int i = 0; i < e->rects_len; i++) {
+                fill_rect(img, x_tmp + e->rects[i].x, y_tmp + e->rects[i].y, e->rects[i].w, e->rects[i].h, c);
             }
-        }
-
-        for (int y = 0, yy = fast_floorf(g->h * scale); y < yy; y++) {
-            for (int x = 0, xx = fast_floorf(g->w * scale); x < xx; x++) {
-                if (g->data[fast_floorf(y / scale)] & (1 << (g->w - 1 - fast_floorf(x / scale)))) {
-                    int16_t x_tmp = x_off + (char_hmirror ? (xx - x - 1) : x), y_tmp = y_off + (char_vflip ? (yy - y - 1) : y);
-                    point_rotate(x_tmp, y_tmp, IM_DEG2RAD(char_rotation), x_off + (xx / 2), y_off + (yy / 2), &x_tmp, &y_tmp);
-                    point_rotate(x_tmp, y_tmp, IM_DEG2RAD(string_rotation), org_x_off, org_y_off, &x_tmp, &y_tmp);
-                    imlib_set_pixel(img, x_tmp, y_tmp, c);
+        } else {
+            for (int y = 0, yy = fast_floorf(g->h * scale); y < yy; y++) {
+                for (int x = 0, xx = fast_floorf(g->w * scale); x < xx; x++) {
+                    if (g->data[fast_floorf(y / scale)] & (1 << (g->w - 1 - fast_floorf(x / scale)))) {
+                        int x_tmp = (char_hmirror ? (xx - x - 1) : x) - (xx / 2), y_tmp = (char_vflip ? (yy - y - 1) : y) - (yy / 2);
+                        glyph_rotate(&x_tmp, &y_tmp, char_rotation);
+                        x_tmp += x_off + (xx / 2) - org_x_off;
+                        y_tmp += y_off + (yy / 2) - org_y_off;
+                        glyph_rotate(&x_tmp, &y_tmp, string_rotation);
+                        imlib_set_pixel(img, x_tmp + org_x_off, y_tmp + org_y_off, c);
+                    }
                 }
             }
         }
 
         if (mono_space) {
             x_off += (string_hmirror ? -1 : +1) * (fast_floorf((char_swap_w_h ? g->h : g->w) * scale) + x_spacing);
+        } else if (e->trail >= 0) {
+            // Offset to the last pixel set.
+            x_off += (string_hmirror ? -1 : +1) * (fast_floorf((e->trail + 2) * scale) + x_spacing);
         } else {
-            // Find the last pixel set and offset to that.
-            bool exit = false;
-
-            if (!char_swap_w_h) {
-                for (int x = g->w - 1; x >= 0; x--) {
-                    for (int y = g->h - 1; y >= 0; y--) {
-                        if (g->data[(char_upsidedown ^ char_vflip) ? (g->h - 1 - y) : y] &
-                            (1 << ((char_upsidedown ^ char_hmirror ^ string_hmirror) ? x : (g->w - 1 - x)))) {
-                            x_off += (string_hmirror ? -1 : +1) * (fast_floorf((x + 2) * scale) + x_spacing);
-                            exit = true;
-                            break;
-                        }
-                    }
-
-                    if (exit) break;
-                }
-            } else {
-                for (int y = 0, yy = g->h; y < yy; y++) {
-                    for (int x = g->w - 1; x >= 0; x--) {
-                        if (g->data[(char_upsidedown ^ char_vflip) ? (g->h - 1 - y) : y] &
-                            (1 << ((char_upsidedown ^ char_hmirror ^ string_hmirror) ? x : (g->w - 1 - x)))) {
-                            x_off += (string_hmirror ? -1 : +1) * (fast_floorf(((g->h - 1 - y) + 2) * scale) + x_spacing);
-                            exit = true;
-                            break;
-                        }
-                    }
-
-                    if (exit) break;
-                }
-            }
-
-            if (!exit) x_off += (string_hmirror ? -1 : +1) * fast_floorf(scale * 3); // space char
+            x_off += (string_hmirror ? -1 : +1) * fast_floorf(scale * 3); // space char
         }
     }
 }
@@ -4934,21 +5285,51 @@ void imlib_draw_image(image_t *dst_img, image_t *src_img, int dst_x_start, int d
 }
 
 #ifdef IMLIB_ENABLE_FLOOD_FILL
-void imlib_flood_fill(image_t *img, int x, int y,
-                      float seed_threshold, float floating_threshold,
-                      int c, bool invert, bool clear_background, image_t *mask)
+// Returns the first x in [x, x_max] whose bit differs from set, or x_max + 1 if there is none.
+static int flood_fill_run_end(uint32_t *row_ptr, int x, int x_max, bool set)
 {
-    if ((0 <= x) && (x < img->w) && (0 <= y) && (y < img->h)) {
+    while (x <= x_max) {
+        uint32_t bits = row_ptr[x >> UINT32_T_SHIFT];
+        bits = (set ? ~bits : bits) >> (x & UINT32_T_MASK);
+
+        if (bits) {
+            return IM_MIN(x + __CLZ(__RBIT(bits)), x_max + 1);
+        }
+
+        x = (x | UINT32_T_MASK) + 1;
+    }
+
+    return IM_MIN(x, x_max + 1);
+}
+
+int imlib_flood_fill(image_t *img, int x, int y,
+                     float seed_threshold, float floating_threshold,
+                     int c, bool invert, bool clear_background, image_t *mask, rectangle_t *roi)
+{
+    rectangle_t bounds = { 0, 0, img->w, img->h };
+    int dropped = 0;
+
+    if (roi && (!rectangle_intersects(&bounds, roi))) {
+        return 0;
+    }
+
+    if (roi) {
+        rectangle_intersected(&bounds, roi);
+    }
+
+    if ((bounds.x <= x) && (x < (bounds.x + bounds.w)) && (bounds.y <= y) && (y < (bounds.y + bounds.h))) {
         image_t out;
         out.w = img->w;
         out.h = img->h;
         out.pixfmt = PIXFORMAT_BINARY;
         out.data = fb_alloc0(image_size(&out), FB_ALLOC_NO_HINT);
 
-        if (mask) {
-            for (int y = 0, yy = out.h; y < yy; y++) {
+        if (mask && (mask->pixfmt == PIXFORMAT_BINARY) && (mask->w == out.w) && (mask->h == out.h)) {
+            memcpy(out.data, mask->data, image_size(&out));
+        } else if (mask) {
+            for (int y = bounds.y, yy = bounds.y + bounds.h; y < yy; y++) {
                 uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&out, y);
-                for (int x = 0, xx = out.w; x < xx; x++) {
+                for (int x = bounds.x, xx = bounds.x + bounds.w; x < xx; x++) {
                     if (image_get_mask_pixel(mask, x, y)) IMAGE_SET_BINARY_PIXEL_FAST(row_ptr, x);
                 }
             }
@@ -4982,57 +5363,29 @@ void imlib_flood_fill(image_t *img, int x, int y,
             }
         }
 
-        imlib_flood_fill_int(&out, img, x, y, color_seed_threshold, color_floating_threshold, NULL, NULL);
+        dropped = imlib_flood_fill_int(&out, img, x, y, color_seed_threshold, color_floating_threshold, &bounds, NULL, NULL);
 
-        switch (img->pixfmt) {
-            case PIXFORMAT_BINARY: {
-                for (int y = 0, yy = out.h; y < yy; y++) {
-                    uint32_t *row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(img, y);
-                    uint32_t *out_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&out, y);
-                    for (int x = 0, xx = out.w; x < xx; x++) {
-                        if (IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, x) ^ invert) {
-                            IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x, c);
-                        } else if (clear_background) {
-                            IMAGE_PUT_BINARY_PIXEL_FAST(row_ptr, x, 0);
-                        }
-                    }
-                }
-                break;
-            }
-            case PIXFORMAT_GRAYSCALE: {
-                for (int y = 0, yy = out.h; y < yy; y++) {
-                    uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
-                    uint32_t *out_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&out, y);
-                    for (int x = 0, xx = out.w; x < xx; x++) {
-                        if (IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, x) ^ invert) {
-                            IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row_ptr, x, c);
-                        } else if (clear_background) {
-                            IMAGE_PUT_GRAYSCALE_PIXEL_FAST(row_ptr, x, 0);
-                        }
-                    }
-                }
-                break;
-            }
-            case PIXFORMAT_RGB565: {
-                for (int y = 0, yy = out.h; y < yy; y++) {
-                    uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
-                    uint32_t *out_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&out, y);
-                    for (int x = 0, xx = out.w; x < xx; x++) {
-                        if (IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, x) ^ invert) {
-                            IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x, c);
-                        } else if (clear_background) {
-                            IMAGE_PUT_RGB565_PIXEL_FAST(row_ptr, x, 0);
-                        }
-                    }
+        // Write back whole runs of filled (or background) pixels. Masked pixels are set in out
+        // so they are written like filled pixels, as before.
+        for (int y = bounds.y, yy = bounds.y + bounds.h; y < yy; y++) {
+            uint32_t *out_row_ptr = IMAGE_COMPUTE_BINARY_PIXEL_ROW_PTR(&out, y);
+            for (int x = bounds.x, x_max = bounds.x + bounds.w - 1; x <= x_max; ) {
+                bool set = IMAGE_GET_BINARY_PIXEL_FAST(out_row_ptr, x);
+                int x_end = flood_fill_run_end(out_row_ptr, x, x_max, set);
+
+                if (set ^ invert) {
+                    fill_span(img, x, x_end - 1, y, c);
+                } else if (clear_background) {
+                    fill_span(img, x, x_end - 1, y, 0);
                 }
-                break;
-            }
-            default: {
-                break;
+
+                x = x_end;
             }
         }
 
         fb_free();
     }
+
+    return dropped;
 }
 #endif // IMLIB_ENABLE_FLOOD_FILL
@@ -1805,9 +1805,10 @@ static void imlib_cartoon_filter_fill(image_t *img, int line, int l, int r, void
     }
 }
 
-void imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_threshold, image_t *mask)
+int imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_threshold, image_t *mask)
 {
     image_t mean_image, fill_image;
+    int dropped = 0;
 
     mean_image.w = img->w;
     mean_image.h = img->h;
@@ -1863,8 +1864,8 @@ void imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_thr
 
                 imlib_cartoon_filter_mean_state_t mean_state;
                 memset(&mean_state, 0, sizeof(imlib_cartoon_filter_mean_state_t));
-                imlib_flood_fill_int(&mean_image, img, x, y, color_seed_threshold, color_floating_threshold,
-                                     imlib_cartoon_filter_mean, &mean_state);
+                dropped += imlib_flood_fill_int(&mean_image, img, x, y, color_seed_threshold, color_floating_threshold, NULL,
+                                                imlib_cartoon_filter_mean, &mean_state);
 
                 imlib_cartoon_filter_fill_state_t fill_state;
                 memset(&fill_state, 0, sizeof(imlib_cartoon_filter_fill_state_t));
@@ -1889,13 +1890,14 @@ void imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_thr
                     }
                 }
 
-                imlib_flood_fill_int(&fill_image, img, x, y, color_seed_threshold, color_floating_threshold,
-                                     imlib_cartoon_filter_fill, &fill_state);
+                dropped += imlib_flood_fill_int(&fill_image, img, x, y, color_seed_threshold, color_floating_threshold, NULL,
+                                                imlib_cartoon_filter_fill, &fill_state);
             }
         }
     }
 
     fb_free();
     fb_free();
+    return dropped;
 }
 #endif // IMLIB_ENABLE_CARTOON
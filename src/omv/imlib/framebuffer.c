@@ -13,8 +13,6 @@
 #include "framebuffer.h"
 #include "omv_boardconfig.h"
 
-#define FB_ALIGN_SIZE_ROUND_DOWN(x) (((x) / FRAMEBUFFER_ALIGNMENT) * FRAMEBUFFER_ALIGNMENT)
-#define FB_ALIGN_SIZE_ROUND_UP(x)   FB_ALIGN_SIZE_ROUND_DOWN(((x) + FRAMEBUFFER_ALIGNMENT - 1))
 #define CONSERVATIVE_JPEG_BUF_SIZE  (OMV_JPEG_BUF_SIZE-64)
 
 extern char _fb_base;
@@ -271,8 +269,11 @@ uint32_t framebuffer_get_buffer_size()
     // Do we have an estimate on the frame size with mutliple buffers? If so, we can reduce the
     // RAM each buffer takes up giving some space back to fb_alloc().
     if ((framebuffer->n_buffers != 1) && framebuffer->u && framebuffer->v) {
-        // Typically a framebuffer will not need more than u*v*2 bytes.
-        uint32_t size_guess = framebuffer->u * framebuffer->v * 2;
+        // Typically a framebuffer will not need more than u*v*2 bytes. Line scan strips are
+        // taller (h) than the window of rows they are captured from (v).
+        uint32_t size_guess = framebuffer->u * IM_MAX(framebuffer->v, framebuffer->h) * 2;
+        // Plus the data stored after the image.
+        size_guess += framebuffer->trailer_size;
         // Add in extra bytes to prevent round down from shrinking buffer too small.
         size_guess += FRAMEBUFFER_ALIGNMENT - 1;
         // Limit the frame buffer size.
@@ -336,10 +337,10 @@ int framebuffer_set_buffers(int32_t n_buffers)
 static uint32_t framebuffer_total_buffer_size()
 {
     if (framebuffer->n_buffers == 1) {
-        // Allow fb_alloc to use frame buffer space up until the image size.
+        // Allow fb_alloc to use frame buffer space up until the image size (and trailer).
         image_t img;
         framebuffer_init_image(&img);
-        return sizeof(vbuffer_t) + FB_ALIGN_SIZE_ROUND_UP(image_size(&img));
+        return sizeof(vbuffer_t) + FB_ALIGN_SIZE_ROUND_UP(image_size(&img)) + framebuffer->trailer_size;
     } else {
         // fb_alloc may only use up to the size of all the virtual buffers...
         return (sizeof(vbuffer_t) + framebuffer_get_buffer_size()) * framebuffer->n_buffers;
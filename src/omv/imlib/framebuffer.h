@@ -22,6 +22,9 @@
 #define FRAMEBUFFER_ALIGNMENT __SCB_DCACHE_LINE_SIZE
 #endif
 
+#define FB_ALIGN_SIZE_ROUND_DOWN(x) (((x) / FRAMEBUFFER_ALIGNMENT) * FRAMEBUFFER_ALIGNMENT)
+#define FB_ALIGN_SIZE_ROUND_UP(x)   FB_ALIGN_SIZE_ROUND_DOWN(((x) + FRAMEBUFFER_ALIGNMENT - 1))
+
 typedef struct framebuffer {
     int32_t x,y;
     int32_t w,h;
@@ -29,6 +32,7 @@ typedef struct framebuffer {
     PIXFORMAT_STRUCT;
     int32_t streaming_enabled;
     uint32_t raw_buffer_size;
+    uint32_t trailer_size; // Bytes stored after the aligned image in each buffer.
     int32_t n_buffers;
     int32_t head;
     volatile int32_t tail;
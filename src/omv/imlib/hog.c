@@ -17,7 +17,235 @@
 #include "xalloc.h"
 
 #ifdef IMLIB_ENABLE_HOG
-#define N_BINS      (9)
+#define HOG_ATAN_SIZE   (64)
+#define HOG_CLIP        (0.2f)  // L2-Hys clipping threshold.
+
+// atan(i / 64) in half degrees.
+static const uint8_t hog_atan_table[HOG_ATAN_SIZE + 1] = {
+     0,  2,  4,  5,  7,  9, 11, 12, 14, 16, 18, 20, 21, 23, 25, 26,
+    28, 30, 31, 33, 35, 36, 38, 40, 41, 43, 44, 46, 47, 49, 50, 52,
+    53, 55, 56, 57, 59, 60, 61, 63, 64, 65, 67, 68, 69, 70, 71, 73,
+    74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89,
+    90,
+};
+
+// Maps an unsigned orientation in half degrees to the lower of the two bins it
+// is interpolated between (high byte) and the weight of the upper bin (low byte).
+static const uint16_t hog_bin_table[360] = {
+    0x0880, 0x0886, 0x088C, 0x0893, 0x0899, 0x08A0, 0x08A6, 0x08AC, 0x08B3, 0x08B9, 0x08C0, 0x08C6,
+    0x08CC, 0x08D3, 0x08D9, 0x08E0, 0x08E6, 0x08EC, 0x08F3, 0x08F9, 0x0000, 0x0006, 0x000C, 0x0013,
+    0x0019, 0x0020, 0x0026, 0x002C, 0x0033, 0x0039, 0x0040, 0x0046, 0x004C, 0x0053, 0x0059, 0x0060,
+    0x0066, 0x006C, 0x0073, 0x0079, 0x0080, 0x0086, 0x008C, 0x0093, 0x0099, 0x00A0, 0x00A6, 0x00AC,
+    0x00B3, 0x00B9, 0x00C0, 0x00C6, 0x00CC, 0x00D3, 0x00D9, 0x00E0, 0x00E6, 0x00EC, 0x00F3, 0x00F9,
+    0x0100, 0x0106, 0x010C, 0x0113, 0x0119, 0x0120, 0x0126, 0x012C, 0x0133, 0x0139, 0x0140, 0x0146,
+    0x014C, 0x0153, 0x0159, 0x0160, 0x0166, 0x016C, 0x0173, 0x0179, 0x0180, 0x0186, 0x018C, 0x0193,
+    0x0199, 0x01A0, 0x01A6, 0x01AC, 0x01B3, 0x01B9, 0x01C0, 0x01C6, 0x01CC, 0x01D3, 0x01D9, 0x01E0,
+    0x01E6, 0x01EC, 0x01F3, 0x01F9, 0x0200, 0x0206, 0x020C, 0x0213, 0x0219, 0x0220, 0x0226, 0x022C,
+    0x0233, 0x0239, 0x0240, 0x0246, 0x024C, 0x0253, 0x0259, 0x0260, 0x0266, 0x026C, 0x0273, 0x0279,
+    0x0280, 0x0286, 0x028C, 0x0293, 0x0299, 0x02A0, 0x02A6, 0x02AC, 0x02B3, 0x02B9, 0x02C0, 0x02C6,
+    0x02CC, 0x02D3, 0x02D9, 0x02E0, 0x02E6, 0x02EC, 0x02F3, 0x02F9, 0x0300, 0x0306, 0x030C, 0x0313,
+    0x0319, 0x0320, 0x0326, 0x032C, 0x0333, 0x0339, 0x0340, 0x0346, 0x034C, 0x0353, 0x0359, 0x0360,
+    0x0366, 0x036C, 0x0373, 0x0379, 0x0380, 0x0386, 0x038C, 0x0393, 0x0399, 0x03A0, 0x03A6, 0x03AC,
+    0x03B3, 0x03B9, 0x03C0, 0x03C6, 0x03CC, 0x03D3, 0x03D9, 0x03E0, 0x03E6, 0x03EC, 0x03F3, 0x03F9,
+    0x0400, 0x0406, 0x040C, 0x0413, 0x0419, 0x0420, 0x0426, 0x042C, 0x0433, 0x0439, 0x0440, 0x0446,
+    0x044C, 0x0453, 0x0459, 0x0460, 0x0466, 0x046C, 0x0473, 0x0479, 0x0480, 0x0486, 0x048C, 0x0493,
+    0x0499, 0x04A0, 0x04A6, 0x04AC, 0x04B3, 0x04B9, 0x04C0, 0x04C6, 0x04CC, 0x04D3, 0x04D9, 0x04E0,
+    0x04E6, 0x04EC, 0x04F3, 0x04F9, 0x0500, 0x0506, 0x050C, 0x0513, 0x0519, 0x0520, 0x0526, 0x052C,
+    0x0533, 0x0539, 0x0540, 0x0546, 0x054C, 0x0553, 0x0559, 0x0560, 0x0566, 0x056C, 0x0573, 0x0579,
+    0x0580, 0x0586, 0x058C, 0x0593, 0x0599, 0x05A0, 0x05A6, 0x05AC, 0x05B3, 0x05B9, 0x05C0, 0x05C6,
+    0x05CC, 0x05D3, 0x05D9, 0x05E0, 0x05E6, 0x05EC, 0x05F3, 0x05F9, 0x0600, 0x0606, 0x060C, 0x0613,
+    0x0619, 0x0620, 0x0626, 0x062C, 0x0633, 0x0639, 0x0640, 0x0646, 0x064C, 0x0653, 0x0659, 0x0660,
+    0x0666, 0x066C, 0x0673, 0x0679, 0x0680, 0x0686, 0x068C, 0x0693, 0x0699, 0x06A0, 0x06A6, 0x06AC,
+    0x06B3, 0x06B9, 0x06C0, 0x06C6, 0x06CC, 0x06D3, 0x06D9, 0x06E0, 0x06E6, 0x06EC, 0x06F3, 0x06F9,
+    0x0700, 0x0706, 0x070C, 0x0713, 0x0719, 0x0720, 0x0726, 0x072C, 0x0733, 0x0739, 0x0740, 0x0746,
+    0x074C, 0x0753, 0x0759, 0x0760, 0x0766, 0x076C, 0x0773, 0x0779, 0x0780, 0x0786, 0x078C, 0x0793,
+    0x0799, 0x07A0, 0x07A6, 0x07AC, 0x07B3, 0x07B9, 0x07C0, 0x07C6, 0x07CC, 0x07D3, 0x07D9, 0x07E0,
+    0x07E6, 0x07EC, 0x07F3, 0x07F9, 0x0800, 0x0806, 0x080C, 0x0813, 0x0819, 0x0820, 0x0826, 0x082C,
+    0x0833, 0x0839, 0x0840, 0x0846, 0x084C, 0x0853, 0x0859, 0x0860, 0x0866, 0x086C, 0x0873, 0x0879,
+};
+// Adds the gradient (gx, gy) to the cell histogram. Orientations are unsigned
+// ([0, 180) degrees) and the Q8 magnitude is split between the two nearest bins.
+static inline void hog_bin_gradient(uint32_t *cell, int gx, int gy)
+{
+    if ((gy < 0) || ((gy == 0) && (gx < 0))) {
+        gx = -gx;
+        gy = -gy;
+    }
+
+    int ax = abs(gx);
+    int mx = IM_MAX(ax, gy);
+    int mn = IM_MIN(ax, gy);
+
+    if (!mx) {
+        return;
+    }
+
+    // Alpha max plus beta min magnitude approximation.
+    uint32_t m = ((mx * 123) + (mn * 51)) >> 7;
+    int t = hog_atan_table[(mn * HOG_ATAN_SIZE) / mx];
+    t = (gy > ax) ? (180 - t) : t;
+    t = (gx < 0) ? (360 - t) : t;
+    t = (t == 360) ? 0 : t;
+
+    int b = hog_bin_table[t];
+    int b0 = b >> 8, w = b & 0xFF;
+    cell[b0] += m * (256 - w);
+    cell[(b0 == (HOG_BINS - 1)) ? 0 : (b0 + 1)] += m * w;
+}
+
+void imlib_hog_compute(hog_t *hog, image_t *src, rectangle_t *roi, int cell_size)
+{
+    int cells_w = roi->w / cell_size;
+    int cells_h = roi->h / cell_size;
+
+    hog->cell_size = cell_size;
+    hog->cells_w = cells_w;
+    hog->cells_h = cells_h;
+    hog->blocks_w = cells_w - 1;
+    hog->blocks_h = cells_h - 1;
+    rectangle_init(&hog->roi, roi->x, roi->y, cells_w * cell_size, cells_h * cell_size);
+    hog->cells = fb_alloc0(cells_w * cells_h * HOG_BINS * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    hog->blocks = fb_alloc(hog->blocks_w * hog->blocks_h * HOG_BLOCK_SIZE, FB_ALLOC_NO_HINT);
+
+    // Cell histograms, each pixel is visited once.
+    for (int y = 0; y < hog->roi.h; y++) {
+        int sy = roi->y + y;
+        uint8_t *row_u = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(src, IM_MAX(sy - 1, 0));
+        uint8_t *row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(src, sy);
+        uint8_t *row_d = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(src, IM_MIN(sy + 1, src->h - 1));
+        uint32_t *cell = hog->cells + ((y / cell_size) * cells_w * HOG_BINS);
+
+        for (int cx = 0, sx = roi->x; cx < cells_w; cx++, cell += HOG_BINS) {
+            for (int i = 0; i < cell_size; i++, sx++) {
+                int gx = row[IM_MIN(sx + 1, src->w - 1)] - row[IM_MAX(sx - 1, 0)];
+                int gy = row_d[sx] - row_u[sx];
+                hog_bin_gradient(cell, gx, gy);
+            }
+        }
+    }
+
+    // Overlapping 2x2 cell blocks with L2-Hys normalization, stored as Q8.
+    uint8_t *block = hog->blocks;
+    for (int by = 0; by < hog->blocks_h; by++) {
+        for (int bx = 0; bx < hog->blocks_w; bx++, block += HOG_BLOCK_SIZE) {
+            uint32_t *c0 = hog->cells + (((by * cells_w) + bx) * HOG_BINS);
+            uint32_t *c1 = c0 + (cells_w * HOG_BINS);
+            float v[HOG_BLOCK_SIZE];
+            float sum = 1.0f;
+
+            for (int i = 0; i < (HOG_BINS * 2); i++) {
+                v[i] = c0[i];
+                v[i + (HOG_BINS * 2)] = c1[i];
+            }
+
+            for (int i = 0; i < HOG_BLOCK_SIZE; i++) {
+                sum += v[i] * v[i];
+            }
+
+            float scale = 1.0f / fast_sqrtf(sum);
+            sum = 1e-6f;
+
+            for (int i = 0; i < HOG_BLOCK_SIZE; i++) {
+                v[i] = IM_MIN(v[i] * scale, HOG_CLIP);
+                sum += v[i] * v[i];
+            }
+
+            scale = 255.0f / fast_sqrtf(sum);
+
+            for (int i = 0; i < HOG_BLOCK_SIZE; i++) {
+                block[i] = IM_MIN(fast_roundf(v[i] * scale), 255);
+            }
+        }
+    }
+}
+
+int imlib_hog_descriptor_size(int cells_w, int cells_h)
+{
+    return (cells_w - 1) * (cells_h - 1) * HOG_BLOCK_SIZE;
+}
+
+void imlib_hog_descriptor(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, uint8_t *desc)
+{
+    int row_size = (cells_w - 1) * HOG_BLOCK_SIZE;
+    for (int y = 0; y < (cells_h - 1); y++, desc += row_size) {
+        memcpy(desc, hog->blocks + ((((cell_y + y) * hog->blocks_w) + cell_x) * HOG_BLOCK_SIZE), row_size);
+    }
+}
+
+static int hog_detection_comp(const void *obj0, const void *obj1)
+{
+    const find_hog_list_lnk_data_t *d0 = obj0;
+    const find_hog_list_lnk_data_t *d1 = obj1;
+    return (d0->score < d1->score) - (d0->score > d1->score);
+}
+
+static float hog_rect_iou(rectangle_t *r0, rectangle_t *r1)
+{
+    int x0 = IM_MAX(r0->x, r1->x), x1 = IM_MIN(r0->x + r0->w, r1->x + r1->w);
+    int y0 = IM_MAX(r0->y, r1->y), y1 = IM_MIN(r0->y + r0->h, r1->y + r1->h);
+    if ((x1 <= x0) || (y1 <= y0)) {
+        return 0.0f;
+    }
+    int i = (x1 - x0) * (y1 - y0);
+    return i / (float) ((r0->w * r0->h) + (r1->w * r1->h) - i);
+}
+
+void imlib_hog_detect(list_t *out, hog_t *hog, int cells_w, int cells_h,
+                      const float *weights, float bias, float threshold, float overlap)
+{
+    list_init(out, sizeof(find_hog_list_lnk_data_t));
+
+    int windows_w = hog->cells_w - cells_w + 1;
+    int windows_h = hog->cells_h - cells_h + 1;
+    if ((windows_w <= 0) || (windows_h <= 0)) {
+        return;
+    }
+
+    fb_alloc_mark();
+    find_hog_list_lnk_data_t *dets = fb_alloc(windows_w * windows_h * sizeof(find_hog_list_lnk_data_t), FB_ALLOC_NO_HINT);
+    int n_dets = 0;
+    int row_size = (cells_w - 1) * HOG_BLOCK_SIZE;
+
+    // Windows slide one cell at a time, each block row of a window is a
+    // contiguous run of the block array so no features are recomputed.
+    for (int cy = 0; cy < windows_h; cy++) {
+        for (int cx = 0; cx < windows_w; cx++) {
+            const float *w = weights;
+            float score = 0.0f;
+            for (int y = 0; y < (cells_h - 1); y++, w += row_size) {
+                const uint8_t *f = hog->blocks + ((((cy + y) * hog->blocks_w) + cx) * HOG_BLOCK_SIZE);
+                for (int i = 0; i < row_size; i++) {
+                    score += w[i] * f[i];
+                }
+            }
+
+            score = (score / 255.0f) + bias;
+            if (score >= threshold) {
+                find_hog_list_lnk_data_t *d = &dets[n_dets++];
+                rectangle_init(&d->rect, hog->roi.x + (cx * hog->cell_size), hog->roi.y + (cy * hog->cell_size),
+                               cells_w * hog->cell_size, cells_h * hog->cell_size);
+                d->score = score;
+            }
+        }
+    }
+
+    // Greedy non-maximum suppression, strongest detections first.
+    qsort(dets, n_dets, sizeof(find_hog_list_lnk_data_t), hog_detection_comp);
+    for (int i = 0; i < n_dets; i++) {
+        if (dets[i].score == -INFINITY) {
+            continue;
+        }
+        list_push_back(out, &dets[i]);
+        for (int j = i + 1; j < n_dets; j++) {
+            if (hog_rect_iou(&dets[i].rect, &dets[j].rect) > overlap) {
+                dets[j].score = -INFINITY;
+            }
+        }
+    }
+
+    fb_alloc_free_till_mark();
+}
+
 typedef struct bin {
     int d;
     int m;
@@ -37,100 +265,50 @@ int bin_array_comp(const void *obj0, const void *obj1)
 
 void imlib_find_hog(image_t *src, rectangle_t *roi, int cell_size)
 {
-    int s = src->w;
-    int w = roi->x+roi->w-1;
-    int h = roi->y+roi->h-1;
-
-    int block_size = cell_size * 2;
-    int x_cells = (roi->w/cell_size);
-    int y_cells = (roi->h/cell_size);
-
-    // TODO: Assert row->w/h >= cell_size *2;
-    float *hog = fb_alloc0(x_cells * y_cells * N_BINS * sizeof*hog, FB_ALLOC_NO_HINT);
-
-    //2. Finding Image Gradients
-    for (int y=roi->y, hog_index=0; y<h; y+=block_size) {
-        for (int x=roi->x; x<w; x+=block_size) {
-            float k = 0.0f;
-            for (int cy=0; cy<block_size; cy++) {
-                for (int cx=0; cx<block_size; cx++) {
-                    if ((y+cy) > 0 && (y+cy) < h && (x+cx) > 0 && (x+cx) < w) {
-                        // Find horizontal/vertical direction
-                        int vx = src->data[(y+cy+0)*s+(x+cx+1)] - src->data[(y+cy-0)*s+(x+cx-1)];
-                        int vy = src->data[(y+cy+1)*s+(x+cx+0)] - src->data[(y+cy-1)*s+(x+cx-0)];
-                        // Find magnitude
-                        float m = fast_sqrtf(vx*vx + vy*vy);
-                        if(((int) m) > 1) {
-                            k += m*m;
-                            // Find and quantize gradient degree
-                            // TODO atan2f is swapped for visualization
-                            int t = ((int) fast_fabsf((atan2f(vx, vy)*180.0f/M_PI))) / 20;
-                            t = (t == 9)? 0 : t;
-
-                            // hog[((cy/cell_size) * x_cells + (cx/cell_size)) * N_BINS + t] += m;
-                            hog[hog_index + (((cy/8)*2+(cx/8)) * N_BINS) + t] += m;
-                        }
-                    }
-                }
-            }
-
-            // Normalize the last block
-            k = sqrtf(k);
-            for (int i=hog_index; i<(hog_index+(N_BINS*4)); i++) {
-                    hog[i] = hog[i]/k;
-            }
-
-            hog_index += (N_BINS*4);
-        }
-    }
+    hog_t hog;
+    imlib_hog_compute(&hog, src, roi, cell_size);
 
     memset(src->pixels, 0, src->w*src->h);
 
     array_t *gds;
-    bin_t bins[9];
+    bin_t bins[HOG_BINS];
     array_alloc(&gds, NULL);
 
-    for (int i=0; i<N_BINS; i++) {
+    for (int i=0; i<HOG_BINS; i++) {
         array_push_back(gds, &bins[i]);
     }
 
     int l = cell_size/2;
-    // Note cells are not ordered histograms of 4 cells
-    for (int by=0, hog_index=0; by<y_cells; by+=2) {
-        for (int bx=0; bx<x_cells; bx+=2) {
-            for (int y=0; y<2; y++) {
-                for (int x=0; x<2; x++) {
-                    // Sort and draw bins
-                    for (int i=hog_index; i<hog_index+N_BINS; i++) {
-                        int m = (int)(hog[i]*255);
-                        if (m > 255) {
-                            m = 255;
-                        } else if (m < 0) {
-                            m = 0;
-                        }
-                        bin_t *bin = array_at(gds, (i%N_BINS));
-                        bin->m = m;
-                        bin->d = ((i%N_BINS)*20);
-                    }
-
-                    array_sort(gds, bin_array_comp);
-
-                    int x1 = (x+bx) * cell_size + l;
-                    int y1 = (y+by) * cell_size + l;
-                    for (int i=0; i<N_BINS; i++) {
-                        bin_t *bin = array_at(gds, i);
-                        int x2 = l * cos_table[bin->d];
-                        int y2 = l * sin_table[bin->d];
-                        imlib_draw_line(src, (x1 - x2), (y1 + y2), (x1 + x2), (y1 - y2), bin->m, 1);
-                    }
-
-                    hog_index += N_BINS;
-                }
+    // Each cell is drawn from the block it is the top-left cell of (cells on
+    // the last row/column use the block to their top-left).
+    for (int y=0; y<hog.cells_h; y++) {
+        for (int x=0; x<hog.cells_w; x++) {
+            int bx = IM_MIN(x, hog.blocks_w-1), by = IM_MIN(y, hog.blocks_h-1);
+            uint8_t *h = hog.blocks + ((by*hog.blocks_w)+bx)*HOG_BLOCK_SIZE
+                       + (((y-by)*2)+(x-bx))*HOG_BINS;
+
+            // Sort and draw bins
+            for (int i=0; i<HOG_BINS; i++) {
+                bin_t *bin = array_at(gds, i);
+                bin->m = h[i];
+                // Lines are drawn along the edge, perpendicular to the gradient
+                // (bin centers are at 10 + 20*i degrees with y pointing down).
+                bin->d = (180+80-(i*20))%180;
+            }
+
+            array_sort(gds, bin_array_comp);
+
+            int x1 = hog.roi.x + x * cell_size + l;
+            int y1 = hog.roi.y + y * cell_size + l;
+            for (int i=0; i<HOG_BINS; i++) {
+                bin_t *bin = array_at(gds, i);
+                int x2 = l * cos_table[bin->d];
+                int y2 = l * sin_table[bin->d];
+                imlib_draw_line(src, (x1 - x2), (y1 + y2), (x1 + x2), (y1 - y2), bin->m, 1);
             }
         }
     }
 
     xfree(gds);
-    fb_free();
 }
 #endif // IMLIB_ENABLE_HOG
@@ -828,8 +828,25 @@ typedef struct cluster {
     array_t *points;
 } cluster_t;
 
-// Return the distance between a cluster centroid and some object.
-typedef float (*cluster_dist_t)(int cx, int cy, void *obj);
+#define KMEANS_MAX_DIMS         (4)
+#define KMEANS_MAX_ITERATIONS   (32)
+
+typedef enum kmeans_metric {
+    KMEANS_METRIC_L2,
+    KMEANS_METRIC_L1,
+} kmeans_metric_t;
+
+// Struct-of-arrays k-means state. The caller provides all buffers, point
+// coordinates must stay within +/-8192 so L2 distances fit 32 bits.
+typedef struct kmeans {
+    int n;                                  // number of points.
+    int dims;                               // dimensions per point.
+    int k;                                  // number of clusters (clamped to n).
+    const int16_t *data[KMEANS_MAX_DIMS];   // data[d][i] is coordinate d of point i.
+    int32_t *centroids;                     // k * dims, cluster major.
+    uint16_t *labels;                       // n, cluster index of each point.
+    uint32_t *counts;                       // k, points per cluster.
+} kmeans_t;
 
 /* Keypoint */
 typedef struct kp {
@@ -983,6 +1000,79 @@ typedef struct find_blobs_list_lnk_data {
     float centroid_x_acc, centroid_y_acc, rotation_acc_x, rotation_acc_y, roundness_acc;
 } find_blobs_list_lnk_data_t;
 
+#define BLOB_TRACKER_MAX_TRACKS (32)
+
+typedef struct blob_tracker_detection {
+    rectangle_t rect;
+    float cx, cy;
+} blob_tracker_detection_t;
+
+typedef struct blob_track {
+    uint32_t id;
+    rectangle_t rect;   // last matched bounding box (predicted while coasting).
+    float cx, cy;       // filtered centroid.
+    float vx, vy;       // pixels per frame.
+    uint32_t age;       // frames since the track was created.
+    uint16_t misses;    // consecutive frames without a matching detection.
+    int16_t match;      // detection index matched by the last update or -1.
+} blob_track_t;
+
+typedef struct blob_tracker {
+    blob_track_t tracks[BLOB_TRACKER_MAX_TRACKS];
+    int count, max_tracks, max_distance, max_misses;
+    float min_iou;
+    uint32_t next_id;
+} blob_tracker_t;
+
+#define TRACKER_MAX_TRACKS (64)
+
+typedef struct tracker_kalman {
+    float x, v;             // position and velocity (pixels per frame).
+    float p00, p01, p11;    // state covariance.
+} tracker_kalman_t;
+
+typedef struct tracker_track {
+    uint32_t id;
+    tracker_kalman_t kx, ky;    // box center.
+    float w, h, pw, ph;         // box size and its variance.
+    uint32_t age, hits;
+    uint16_t misses;
+    int16_t match;              // detection index matched by the last update or -1.
+} tracker_track_t;
+
+typedef struct tracker {
+    tracker_track_t tracks[TRACKER_MAX_TRACKS];
+    int count, max_tracks, min_hits, max_misses;
+    float min_iou;
+    bool hungarian;
+    uint32_t next_id;
+} tracker_t;
+
+#define LK_MAX_LEVELS (4)
+#define LK_MAX_WINDOW (31)
+
+// Grayscale image pyramid, level 0 is full resolution and each level halves the last.
+typedef struct lk_pyramid {
+    int levels;
+    image_t level[LK_MAX_LEVELS];
+} lk_pyramid_t;
+
+typedef struct motion_vector {
+    int8_t x, y;    // displacement of the block since the previous frame.
+    uint16_t sad;   // sum of absolute differences of the match.
+} motion_vector_t;
+
+typedef struct bg_model {
+    int w, h;
+    uint16_t rate;          // learning rate in Q16.
+    uint16_t threshold;     // squared foreground threshold in standard deviations in Q4.
+    uint16_t min_variance;  // variance floor in Q4.
+    bool selective;         // do not learn foreground pixels.
+    bool valid;             // initialized from a frame.
+    uint16_t *mean;         // per pixel mean in Q8.
+    uint16_t *variance;     // per pixel variance in Q4.
+} bg_model_t;
+
 typedef struct find_lines_list_lnk_data {
     line_t line;
     uint32_t magnitude;
@@ -1000,6 +1090,25 @@ typedef struct find_rects_list_lnk_data {
     uint32_t magnitude;
 } find_rects_list_lnk_data_t;
 
+#define HOG_BINS        (9)
+#define HOG_BLOCK_SIZE  (HOG_BINS*4)    // 2x2 cells per block
+
+// Cell histograms and normalized blocks of a region, computed once per frame.
+// Blocks overlap by one cell and are stored row major as Q8 (0-255) values.
+typedef struct hog {
+    rectangle_t roi;    // area covered by whole cells.
+    int cell_size;
+    int cells_w, cells_h;
+    int blocks_w, blocks_h;
+    uint32_t *cells;
+    uint8_t *blocks;
+} hog_t;
+
+typedef struct find_hog_list_lnk_data {
+    rectangle_t rect;
+    float score;
+} find_hog_list_lnk_data_t;
+
 typedef struct find_qrcodes_list_lnk_data {
     point_t corners[4];
     rectangle_t rect;
@@ -1175,6 +1284,7 @@ float point_distance(point_t *p1, point_t *p2);
 rectangle_t *rectangle_alloc(int16_t x, int16_t y, int16_t w, int16_t h);
 bool rectangle_equal(rectangle_t *r1, rectangle_t *r2);
 bool rectangle_intersects(rectangle_t *r1, rectangle_t *r2);
+float rectangle_iou(rectangle_t *r1, rectangle_t *r2);
 bool rectangle_subimg(image_t *img, rectangle_t *r, rectangle_t *r_out);
 array_t *rectangle_merge(array_t *rectangles);
 void rectangle_expand(rectangle_t *r, int x, int y);
@@ -1193,7 +1303,9 @@ float imlib_template_match_ds(image_t *image, image_t *template, rectangle_t *r)
 float imlib_template_match_ex(image_t *image, image_t *template, rectangle_t *roi, int step, rectangle_t *r);
 
 /* Clustering functions */
-array_t *cluster_kmeans(array_t *points, int k, cluster_dist_t dist_func);
+int imlib_kmeans(kmeans_t *km, kmeans_metric_t metric, int max_iterations, uint32_t seed);
+array_t *cluster_kmeans(array_t *points, int k, uint32_t seed);
+int imlib_kmeans_palette(image_t *img, rectangle_t *roi, int k, int step, uint32_t seed, int32_t *palette);
 
 /* Integral image functions */
 void imlib_integral_image_alloc(struct integral_image *sum, int w, int h);
@@ -1233,8 +1345,13 @@ int orb_load_descriptor(FIL *fp, array_t *kpts);
 float orb_cluster_dist(int cx, int cy, void *kp);
 
 /* LBP Operator */
+#define LBP_HIST_SIZE   (59)    //58 uniform hist + 1
+#define LBP_NUM_REGIONS (7)     //7x7 regions
+#define LBP_DESC_SIZE   (LBP_NUM_REGIONS*LBP_NUM_REGIONS*LBP_HIST_SIZE)
 uint8_t *imlib_lbp_desc(image_t *image, rectangle_t *roi);
 int imlib_lbp_desc_distance(uint8_t *d0, uint8_t *d1);
+// Matches desc against n contiguous descriptors, returns the index of the closest one (or -1).
+int imlib_lbp_desc_match(uint8_t *desc, uint8_t *gallery, int n, int *distance);
 int imlib_lbp_desc_save(FIL *fp, uint8_t *desc);
 int imlib_lbp_desc_load(FIL *fp, uint8_t **desc);
 
@@ -1250,6 +1367,11 @@ void imlib_edge_simple(image_t *src, rectangle_t *roi, int low_thresh, int high_
 void imlib_edge_canny(image_t *src, rectangle_t *roi, int low_thresh, int high_thresh);
 
 // HoG
+void imlib_hog_compute(hog_t *hog, image_t *src, rectangle_t *roi, int cell_size);
+int imlib_hog_descriptor_size(int cells_w, int cells_h);
+void imlib_hog_descriptor(hog_t *hog, int cell_x, int cell_y, int cells_w, int cells_h, uint8_t *desc);
+void imlib_hog_detect(list_t *out, hog_t *hog, int cells_w, int cells_h,
+                      const float *weights, float bias, float threshold, float overlap);
 void imlib_find_hog(image_t *src, rectangle_t *roi, int cell_size);
 
 // Helper Functions
@@ -1265,9 +1387,9 @@ void imlib_draw_row(int x_start, int x_end, int y_row, imlib_draw_row_data_t *da
 bool imlib_draw_image_rectangle(image_t *dst_img, image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale, rectangle_t *roi,
                                 int alpha, const uint8_t *alpha_palette, image_hint_t hint,
                                 int *x0, int *x1, int *y0, int *y1);
-void imlib_flood_fill_int(image_t *out, image_t *img, int x, int y,
-                          int seed_threshold, int floating_threshold,
-                          flood_fill_call_back_t cb, void *data);
+int imlib_flood_fill_int(image_t *out, image_t *img, int x, int y,
+                         int seed_threshold, int floating_threshold,
+                         rectangle_t *roi, flood_fill_call_back_t cb, void *data);
 // Drawing Functions
 int imlib_get_pixel(image_t *img, int x, int y);
 int imlib_get_pixel_fast(image_t *img, const void *row_ptr, int x);
@@ -1276,14 +1398,16 @@ void imlib_draw_line(image_t *img, int x0, int y0, int x1, int y1, int c, int th
 void imlib_draw_rectangle(image_t *img, int rx, int ry, int rw, int rh, int c, int thickness, bool fill);
 void imlib_draw_circle(image_t *img, int cx, int cy, int r, int c, int thickness, bool fill);
 void imlib_draw_ellipse(image_t *img, int cx, int cy, int rx, int ry, int rotation, int c, int thickness, bool fill);
+void imlib_draw_polygon(image_t *img, point_t *points, int points_len, int c, int thickness, bool fill);
+void imlib_draw_line_aa(image_t *img, int x0, int y0, int x1, int y1, int c);
 void imlib_draw_string(image_t *img, int x_off, int y_off, const char *str, int c, float scale, int x_spacing, int y_spacing, bool mono_space,
                        int char_rotation, bool char_hmirror, bool char_vflip, int string_rotation, bool string_hmirror, bool string_hflip);
 void imlib_draw_image(image_t *dst_img, image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale, rectangle_t *roi,
                       int rgb_channel, int alpha, const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint,
                       imlib_draw_row_callback_t callback, void *dst_row_override);
-void imlib_flood_fill(image_t *img, int x, int y,
-                      float seed_threshold, float floating_threshold,
-                      int c, bool invert, bool clear_background, image_t *mask);
+int imlib_flood_fill(image_t *img, int x, int y,
+                     float seed_threshold, float floating_threshold,
+                     int c, bool invert, bool clear_background, image_t *mask, rectangle_t *roi);
 // Binary Functions
 void imlib_binary(image_t *out, image_t *img, list_t *thresholds, bool invert, bool zero, image_t *mask);
 void imlib_invert(image_t *img);
@@ -1320,7 +1444,7 @@ void imlib_mode_filter(image_t *img, const int ksize, bool threshold, int offset
 void imlib_midpoint_filter(image_t *img, const int ksize, float bias, bool threshold, int offset, bool invert, image_t *mask);
 void imlib_morph(image_t *img, const int ksize, const int *krn, const float m, const int b, bool threshold, int offset, bool invert, image_t *mask);
 void imlib_bilateral_filter(image_t *img, const int ksize, float color_sigma, float space_sigma, bool threshold, int offset, bool invert, image_t *mask);
-void imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_threshold, image_t *mask);
+int imlib_cartoon_filter(image_t *img, float seed_threshold, float floating_threshold, image_t *mask);
 // Image Correction
 void imlib_logpolar_int(image_t *dst, image_t *src, rectangle_t *roi, bool linear, bool reverse); // helper/internal
 void imlib_logpolar(image_t *img, bool linear, bool reverse);
@@ -1344,6 +1468,25 @@ void imlib_find_blobs(list_t *out, image_t *ptr, rectangle_t *roi, unsigned int
                       bool (*threshold_cb)(void*,find_blobs_list_lnk_data_t*), void *threshold_cb_arg,
                       bool (*merge_cb)(void*,find_blobs_list_lnk_data_t*,find_blobs_list_lnk_data_t*), void *merge_cb_arg,
                       unsigned int x_hist_bins_max, unsigned int y_hist_bins_max);
+void imlib_blob_tracker_init(blob_tracker_t *tracker, int max_tracks, int max_distance, float min_iou, int max_misses);
+void imlib_blob_tracker_update(blob_tracker_t *tracker, blob_tracker_detection_t *dets, int dets_len);
+int imlib_blob_tracker_rois(blob_tracker_t *tracker, image_t *img, int margin, rectangle_t *rois);
+// Object Tracking
+void imlib_tracker_init(tracker_t *tracker, int max_tracks, float min_iou, int min_hits, int max_misses, bool hungarian);
+void imlib_tracker_update(tracker_t *tracker, rectangle_t *dets, int dets_len);
+void imlib_tracker_get_rect(tracker_track_t *track, rectangle_t *r);
+// Optical Flow
+size_t imlib_lk_pyramid_size(int w, int h, int levels);
+void imlib_lk_pyramid_build(lk_pyramid_t *pyramid, image_t *img, int levels, uint8_t *buffer);
+void imlib_lk_flow(lk_pyramid_t *prev, lk_pyramid_t *next, int window, int iterations, int max_error,
+                   int points_len, const float *prev_xy, float *next_xy, bool *status);
+void imlib_find_motion_vectors(image_t *img, image_t *prev, int block_size, int search_range, int threshold,
+                               motion_vector_t *vectors);
+// Background Subtraction
+size_t imlib_bg_model_size(int w, int h);
+void imlib_bg_model_init(bg_model_t *model, int w, int h, float rate, float threshold, float min_sigma,
+                         bool selective, uint16_t *buffer);
+int imlib_bg_model_update(bg_model_t *model, image_t *img, image_t *mask);
 // Shape Detection
 size_t trace_line(image_t *ptr, line_t *l, int *theta_buffer, uint32_t *mag_buffer, point_t *point_buffer); // helper/internal
 void merge_alot(list_t *out, int threshold, int theta_threshold); // helper/internal
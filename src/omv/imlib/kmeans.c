@@ -12,11 +12,206 @@
 #include <limits.h>
 #include <arm_math.h>
 #include <stdio.h>
+#include <string.h>
 #include "imlib.h"
 #include "array.h"
+#include "fb_alloc.h"
+#include "common.h"
 #include "xalloc.h"
 
-extern uint32_t rng_randint(uint32_t min, uint32_t max);
+// Xorshift32, kept local so results only depend on the seed.
+static inline uint32_t kmeans_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static OMV_ATTR_ALWAYS_INLINE uint32_t kmeans_dist(const kmeans_t *km, const int32_t *c, int i, kmeans_metric_t metric)
+{
+    uint32_t dist = 0;
+    for (int d = 0; d < km->dims; d++) {
+        int diff = km->data[d][i] - c[d];
+        dist += (metric == KMEANS_METRIC_L1) ? abs(diff) : (diff * diff);
+    }
+    return dist;
+}
+
+static void kmeans_set_centroid(kmeans_t *km, int c, int i)
+{
+    for (int d = 0; d < km->dims; d++) {
+        km->centroids[(c * km->dims) + d] = km->data[d][i];
+    }
+}
+
+// k-means++ seeding: each new centroid is a point drawn with probability
+// proportional to its distance to the nearest centroid chosen so far.
+static void kmeans_seed(kmeans_t *km, uint32_t *min_dist, kmeans_metric_t metric, uint32_t *rng)
+{
+    kmeans_set_centroid(km, 0, kmeans_rand(rng) % km->n);
+
+    for (int i = 0; i < km->n; i++) {
+        min_dist[i] = kmeans_dist(km, km->centroids, i, metric);
+    }
+
+    for (int c = 1; c < km->k; c++) {
+        uint64_t total = 0;
+        for (int i = 0; i < km->n; i++) {
+            total += min_dist[i];
+        }
+
+        int pick = 0;
+        if (total) {
+            uint64_t r = ((((uint64_t) kmeans_rand(rng)) << 32) | kmeans_rand(rng)) % total;
+            for (uint64_t acc = 0; pick < (km->n - 1); pick++) {
+                acc += min_dist[pick];
+                if (acc > r) {
+                    break;
+                }
+            }
+        } else {
+            // All points coincide with a centroid already.
+            pick = kmeans_rand(rng) % km->n;
+        }
+
+        kmeans_set_centroid(km, c, pick);
+        const int32_t *centroid = km->centroids + (c * km->dims);
+
+        for (int i = 0; i < km->n; i++) {
+            uint32_t d = kmeans_dist(km, centroid, i, metric);
+            if (d < min_dist[i]) {
+                min_dist[i] = d;
+            }
+        }
+    }
+}
+
+// Assigns each point to the nearest centroid, returns the number of labels changed.
+static int kmeans_assign(kmeans_t *km, uint32_t *min_dist, kmeans_metric_t metric)
+{
+    int changed = 0;
+
+    for (int i = 0; i < km->n; i++) {
+        uint32_t best_dist = UINT32_MAX;
+        int best = 0;
+        const int32_t *centroid = km->centroids;
+
+        if ((km->dims == 2) && (metric == KMEANS_METRIC_L2)) {
+            // Keypoint fast path.
+            int x = km->data[0][i], y = km->data[1][i];
+            for (int c = 0; c < km->k; c++, centroid += 2) {
+                int dx = x - centroid[0], dy = y - centroid[1];
+                uint32_t d = (dx * dx) + (dy * dy);
+                if (d < best_dist) {
+                    best_dist = d;
+                    best = c;
+                }
+            }
+        } else {
+            for (int c = 0; c < km->k; c++, centroid += km->dims) {
+                uint32_t d = kmeans_dist(km, centroid, i, metric);
+                if (d < best_dist) {
+                    best_dist = d;
+                    best = c;
+                }
+            }
+        }
+
+        if (km->labels[i] != best) {
+            km->labels[i] = best;
+            changed += 1;
+        }
+
+        min_dist[i] = best_dist;
+    }
+
+    return changed;
+}
+
+static void kmeans_update(kmeans_t *km, int32_t *sums, uint32_t *min_dist)
+{
+    memset(sums, 0, km->k * km->dims * sizeof(int32_t));
+    memset(km->counts, 0, km->k * sizeof(uint32_t));
+
+    for (int i = 0; i < km->n; i++) {
+        int c = km->labels[i];
+        for (int d = 0; d < km->dims; d++) {
+            sums[(c * km->dims) + d] += km->data[d][i];
+        }
+        km->counts[c] += 1;
+    }
+
+    for (int c = 0; c < km->k; c++) {
+        int32_t count = km->counts[c];
+        int32_t *centroid = km->centroids + (c * km->dims);
+
+        if (count) {
+            for (int d = 0; d < km->dims; d++) {
+                int32_t sum = sums[(c * km->dims) + d];
+                // Round to nearest.
+                centroid[d] = (sum + ((sum < 0) ? -(count / 2) : (count / 2))) / count;
+            }
+        } else {
+            // Move an empty cluster onto the point farthest from its centroid.
+            int far = 0;
+            for (int i = 1; i < km->n; i++) {
+                if (min_dist[i] > min_dist[far]) {
+                    far = i;
+                }
+            }
+            kmeans_set_centroid(km, c, far);
+            min_dist[far] = 0;
+        }
+    }
+}
+
+int imlib_kmeans(kmeans_t *km, kmeans_metric_t metric, int max_iterations, uint32_t seed)
+{
+    if ((km->n <= 0) || (km->k <= 0) || (km->dims <= 0) || (km->dims > KMEANS_MAX_DIMS)) {
+        return 0;
+    }
+
+    if (km->k > km->n) {
+        km->k = km->n;
+    }
+
+    if (max_iterations < 1) {
+        max_iterations = 1;
+    }
+
+    uint32_t rng = seed ? seed : 0x9E3779B9;
+    uint32_t *min_dist = fb_alloc(km->n * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    int32_t *sums = fb_alloc(km->k * km->dims * sizeof(int32_t), FB_ALLOC_NO_HINT);
+
+    kmeans_seed(km, min_dist, metric, &rng);
+
+    // Force every label to be counted as changed on the first pass.
+    memset(km->labels, 0xFF, km->n * sizeof(uint16_t));
+
+    int iterations = 0;
+    while (iterations < max_iterations) {
+        iterations += 1;
+
+        // Stop as soon as the assignment is stable.
+        if (!kmeans_assign(km, min_dist, metric)) {
+            break;
+        }
+
+        kmeans_update(km, sums, min_dist);
+    }
+
+    // Counts are only refreshed by kmeans_update().
+    memset(km->counts, 0, km->k * sizeof(uint32_t));
+    for (int i = 0; i < km->n; i++) {
+        km->counts[km->labels[i]] += 1;
+    }
+
+    fb_free(); // sums
+    fb_free(); // min_dist
+    return iterations;
+}
 
 static cluster_t *cluster_alloc(int cx, int cy)
 {
@@ -39,103 +234,105 @@ static void cluster_free(void *c)
     xfree(cl);
 }
 
-static void cluster_reset(array_t *clusters, array_t *points)
+array_t *cluster_kmeans(array_t *points, int k, uint32_t seed)
 {
-    // Reset all clusters
-    for (int j=0; j<array_length(clusters); j++) {
-         cluster_t *cl = array_at(clusters, j);
-         while (array_length(cl->points)) {
-             array_push_back(points, array_pop_back(cl->points));
-         }
-         array_free(cl->points);
-         array_alloc(&cl->points, NULL);
+    // Alloc clusters array
+    array_t *clusters=NULL;
+    array_alloc(&clusters, cluster_free);
+
+    int n = array_length(points);
+    if ((n == 0) || (k <= 0)) {
+        return clusters;
     }
-}
 
-static int cluster_update(array_t *clusters)
-{
-    // Update clusters
-    for (int j=0; j<array_length(clusters); j++) {
-        cluster_t *cl = array_at(clusters, j);
-        int cx = cl->x, cy = cl->y;
-        int cl_size = array_length(cl->points);
-
-        // Sum all points in this cluster
-        for (int i=0; i<cl_size; i++) {
-            kp_t *p = array_at(cl->points, i);
-            cl->x += p->x;
-            cl->y += p->y;
-            // Find out the max x and y while we're at it
-            if (p->x > cl->w) {
-                cl->w = p->x;
-            }
-            if (p->y > cl->h) {
-                cl->h = p->y;
-            }
-        }
+    fb_alloc_mark();
+
+    // Gather the keypoint coordinates into contiguous arrays.
+    kmeans_t km = { .n = n, .dims = 2, .k = IM_MIN(k, n) };
+    int16_t *xs = fb_alloc(n * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    int16_t *ys = fb_alloc(n * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    km.data[0] = xs;
+    km.data[1] = ys;
+    km.centroids = fb_alloc(km.k * 2 * sizeof(int32_t), FB_ALLOC_NO_HINT);
+    km.labels = fb_alloc(n * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    km.counts = fb_alloc(km.k * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+
+    for (int i = 0; i < n; i++) {
+        kp_t *p = array_at(points, i);
+        xs[i] = p->x;
+        ys[i] = p->y;
+    }
+
+    imlib_kmeans(&km, KMEANS_METRIC_L2, KMEANS_MAX_ITERATIONS, seed);
+
+    for (int c = 0; c < km.k; c++) {
+        array_push_back(clusters, cluster_alloc(km.centroids[c * 2], km.centroids[(c * 2) + 1]));
+    }
 
-        // Update centroid
-        cl->x = cl->x/cl_size;
-        cl->y = cl->y/cl_size;
-        // Update cluster size
+    // Add pointer to point to cluster and find the max x and y while we're at it.
+    // Note: Objects in the cluster are not free'd
+    for (int i = 0; i < n; i++) {
+        cluster_t *cl = array_at(clusters, km.labels[i]);
+        kp_t *p = array_at(points, i);
+        array_push_back(cl->points, p);
+        cl->w = IM_MAX(cl->w, p->x);
+        cl->h = IM_MAX(cl->h, p->y);
+    }
+
+    // Update cluster size
+    for (int c = 0; c < km.k; c++) {
+        cluster_t *cl = array_at(clusters, c);
         cl->w = (cl->w - cl->x) * 2;
         cl->h = (cl->h - cl->y) * 2;
-        if (cl->x == cx && cl->y == cy) {
-            // Cluster centroid did not change
-            return 0;
-        }
     }
 
-    return 1;
+    fb_alloc_free_till_mark();
+    return clusters;
 }
 
-static void cluster_points(array_t *clusters, array_t *points, cluster_dist_t dist_func)
+int imlib_kmeans_palette(image_t *img, rectangle_t *roi, int k, int step, uint32_t seed, int32_t *palette)
 {
-    // Add objects to cluster
-    while (array_length(points)) {
-        float distance = FLT_MAX;
-        cluster_t *cl_nearest = NULL;
-        kp_t *p = array_pop_back(points);
-
-        for (int j=0; j<array_length(clusters); j++) {
-            cluster_t *cl = array_at(clusters, j);
-            float d = dist_func(cl->x, cl->y, p);
-            if (d < distance) {
-                distance = d;
-                cl_nearest = cl;
-            }
-        }
-        // Add pointer to point to cluster.
-        // Note: Objects in the cluster are not free'd
-        array_push_back(cl_nearest->points, p);
+    step = IM_MAX(step, 1);
+    int n = ((roi->w + step - 1) / step) * ((roi->h + step - 1) / step);
+
+    if ((n == 0) || (k <= 0) || ((img->pixfmt != PIXFORMAT_GRAYSCALE) && (img->pixfmt != PIXFORMAT_RGB565))) {
+        return 0;
     }
-}
 
-array_t *cluster_kmeans(array_t *points, int k, cluster_dist_t dist_func)
-{
-    // Alloc clusters array
-    array_t *clusters=NULL;
-    array_alloc(&clusters, cluster_free);
+    fb_alloc_mark();
 
-    // Select K clusters randomly
-    for (int i=0; i<k; i++) {
-        int pidx = rng_randint(0, array_length(points)-1);
-        kp_t *p = array_at(points, pidx);
-        array_push_back(clusters, cluster_alloc(p->x, p->y));
+    kmeans_t km = { .n = n, .dims = (img->pixfmt == PIXFORMAT_GRAYSCALE) ? 1 : 3, .k = IM_MIN(k, n) };
+    for (int d = 0; d < km.dims; d++) {
+        km.data[d] = fb_alloc(n * sizeof(int16_t), FB_ALLOC_NO_HINT);
     }
+    km.centroids = fb_alloc(km.k * km.dims * sizeof(int32_t), FB_ALLOC_NO_HINT);
+    km.labels = fb_alloc(n * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    km.counts = fb_alloc(km.k * sizeof(uint32_t), FB_ALLOC_NO_HINT);
 
-    int cl_changed = 1;
-    do {
-        // Reset clusters
-        cluster_reset(clusters, points);
-
-        // Add points to clusters
-        cluster_points(clusters, points, dist_func);
+    // Sample the ROI on a regular grid.
+    int i = 0;
+    for (int y = roi->y, yy = roi->y + roi->h; y < yy; y += step) {
+        if (img->pixfmt == PIXFORMAT_GRAYSCALE) {
+            uint8_t *row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, y);
+            for (int x = roi->x, xx = roi->x + roi->w; x < xx; x += step, i++) {
+                ((int16_t *) km.data[0])[i] = IMAGE_GET_GRAYSCALE_PIXEL_FAST(row_ptr, x);
+            }
+        } else {
+            uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+            for (int x = roi->x, xx = roi->x + roi->w; x < xx; x += step, i++) {
+                int pixel = IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x);
+                ((int16_t *) km.data[0])[i] = COLOR_RGB565_TO_R8(pixel);
+                ((int16_t *) km.data[1])[i] = COLOR_RGB565_TO_G8(pixel);
+                ((int16_t *) km.data[2])[i] = COLOR_RGB565_TO_B8(pixel);
+            }
+        }
+    }
 
-        // Update centroids
-        cl_changed = cluster_update(clusters);
+    imlib_kmeans(&km, KMEANS_METRIC_L2, KMEANS_MAX_ITERATIONS, seed);
 
-    } while (cl_changed);
+    // Centroids are Y for grayscale and R8, G8, B8 otherwise, kept at full precision.
+    memcpy(palette, km.centroids, km.k * km.dims * sizeof(int32_t));
 
-    return clusters;
+    fb_alloc_free_till_mark();
+    return km.k;
 }
@@ -16,12 +16,11 @@
 
 #include "imlib.h"
 #include "xalloc.h"
+#include "fb_alloc.h"
 #include "ff.h"
 #ifdef IMLIB_ENABLE_FIND_LBP
 
-#define LBP_HIST_SIZE   (59)    //58 uniform hist + 1
-#define LBP_NUM_REGIONS (7)     //7x7 regions
-#define LBP_DESC_SIZE   (LBP_NUM_REGIONS*LBP_NUM_REGIONS*LBP_HIST_SIZE)
+#define LBP_NUM_ZERO_REGIONS (10) //regions with a zero weight
 
 const static int8_t lbp_weights [49]= {
     2, 1, 1, 1, 1, 1, 2,
@@ -33,6 +32,15 @@ const static int8_t lbp_weights [49]= {
     0, 1, 1, 1, 1, 1, 0,
 };
 
+// Non-zero weight regions sorted by decreasing weight, zero weight regions are
+// skipped entirely.
+const static uint8_t lbp_region_order[39] = {
+     8,  9, 11, 12,  0,  6,  7, 13, 38,  1,
+     2,  3,  4,  5, 10, 14, 15, 16, 18, 19,
+    20, 22, 23, 25, 26, 29, 30, 31, 32, 33,
+    36, 37, 39, 40, 43, 44, 45, 46, 47,
+};
+
 const static uint8_t uniform_tbl[256] = {
     0,   1,  2,  3,  4, 58,  5,  6,  7, 58, 58, 58,  8, 58,  9, 10,
     11, 58, 58, 58, 58, 58, 58, 58, 12, 58, 58, 58, 13, 58, 14, 15,
@@ -52,46 +60,154 @@ const static uint8_t uniform_tbl[256] = {
     47, 48, 58, 49, 58, 58, 58, 50, 51, 52, 58, 53, 54, 55, 56, 57
 };
 
+// Loads 4 consecutive pixels (unaligned) as a little-endian word.
+static inline uint32_t lbp_load32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Returns 0x01 in every byte lane where a >= b (unsigned), 0x00 otherwise.
+static inline uint32_t lbp_cmpge8(uint32_t a, uint32_t b)
+{
+    #if defined(ARM_MATH_DSP)
+    __USUB8(a, b); // Sets the GE flags for lanes where a >= b.
+    return __SEL(0x01010101, 0);
+    #else
+    // Compare the low 7 bits of each lane without borrows crossing lanes, then
+    // fix up the lanes where the top bits differ.
+    uint32_t d = (a | 0x80808080) - (b & 0x7F7F7F7F);
+    uint32_t ge = (a & ~b) | (~(a ^ b) & d);
+    return (ge >> 7) & 0x01010101;
+    #endif
+}
+
+// Computes the LBP codes of pixels [x, x + n) of row y (the 3x3 neighbourhood
+// is anchored at the top-left corner like imlib_lbp_desc() expects). Four
+// codes are computed per iteration with byte-lane compares.
+static void lbp_codes_row(const uint8_t *data, int s, int y, int x, int n, uint8_t *codes)
+{
+    const uint8_t *r0 = data + (y + 0) * s + x;
+    const uint8_t *r1 = data + (y + 1) * s + x;
+    const uint8_t *r2 = data + (y + 2) * s + x;
+    int i = 0;
+
+    for (; i <= n - 4; i += 4) {
+        uint32_t p = lbp_load32(r1 + i + 1);
+        uint32_t lbp = lbp_cmpge8(lbp_load32(r0 + i + 0), p) << 0;
+        lbp |= lbp_cmpge8(lbp_load32(r0 + i + 1), p) << 1;
+        lbp |= lbp_cmpge8(lbp_load32(r0 + i + 2), p) << 2;
+        lbp |= lbp_cmpge8(lbp_load32(r1 + i + 2), p) << 3;
+        lbp |= lbp_cmpge8(lbp_load32(r2 + i + 2), p) << 4;
+        lbp |= lbp_cmpge8(lbp_load32(r2 + i + 1), p) << 5;
+        lbp |= lbp_cmpge8(lbp_load32(r2 + i + 0), p) << 6;
+        lbp |= lbp_cmpge8(lbp_load32(r1 + i + 0), p) << 7;
+        memcpy(codes + i, &lbp, sizeof(lbp));
+    }
+
+    for (; i < n; i++) {
+        uint8_t lbp = 0;
+        uint8_t p = r1[i + 1];
+        lbp |= (r0[i + 0] >= p) << 0;
+        lbp |= (r0[i + 1] >= p) << 1;
+        lbp |= (r0[i + 2] >= p) << 2;
+        lbp |= (r1[i + 2] >= p) << 3;
+        lbp |= (r2[i + 2] >= p) << 4;
+        lbp |= (r2[i + 1] >= p) << 5;
+        lbp |= (r2[i + 0] >= p) << 6;
+        lbp |= (r1[i + 0] >= p) << 7;
+        codes[i] = lbp;
+    }
+}
+
 uint8_t *imlib_lbp_desc(image_t *image, rectangle_t *roi)
 {
     int s = image->w; //stride
-    int RX = roi->w/LBP_NUM_REGIONS;
-    int RY = roi->h/LBP_NUM_REGIONS;
+    int RX = IM_MAX(roi->w/LBP_NUM_REGIONS, 1);
+    int RY = IM_MAX(roi->h/LBP_NUM_REGIONS, 1);
+    int n = roi->w - 3;
     uint8_t *data = image->data;
     uint8_t *desc = xalloc0(LBP_DESC_SIZE);
 
+    if (n <= 0) {
+        return desc;
+    }
+
+    fb_alloc_mark();
+    uint8_t *codes = fb_alloc(n, FB_ALLOC_NO_HINT);
+
     for (int y=roi->y; y<(roi->y+roi->h)-3; y++) {
-        int y_idx = ((y-roi->y)/RY)*LBP_NUM_REGIONS;
-        for (int x=roi->x; x<(roi->x+roi->w)-3; x++) {
-            uint8_t lbp=0;
-            uint8_t p = data[(y+1)*s+x+1];
-            int hist_idx = y_idx+(x-roi->x)/RX;
-
-            lbp |= (data[(y+0)*s+x+0] >= p) << 0;
-            lbp |= (data[(y+0)*s+x+1] >= p) << 1;
-            lbp |= (data[(y+0)*s+x+2] >= p) << 2;
-            lbp |= (data[(y+1)*s+x+2] >= p) << 3;
-            lbp |= (data[(y+2)*s+x+2] >= p) << 4;
-            lbp |= (data[(y+2)*s+x+1] >= p) << 5;
-            lbp |= (data[(y+2)*s+x+0] >= p) << 6;
-            lbp |= (data[(y+1)*s+x+0] >= p) << 7;
-
-            desc[hist_idx*LBP_HIST_SIZE+uniform_tbl[lbp]]++;
+        // Pixels past the last full region are folded into the last region.
+        int y_idx = IM_MIN((y-roi->y)/RY, LBP_NUM_REGIONS-1)*LBP_NUM_REGIONS;
+        lbp_codes_row(data, s, y, roi->x, n, codes);
+
+        for (int rx=0, x=0; rx<LBP_NUM_REGIONS; rx++) {
+            int x_end = (rx == (LBP_NUM_REGIONS-1)) ? n : IM_MIN((rx+1)*RX, n);
+            uint8_t *hist = desc + (y_idx+rx)*LBP_HIST_SIZE;
+            for (; x<x_end; x++) {
+                hist[uniform_tbl[codes[x]]]++;
+            }
         }
     }
-        return desc;
+
+    fb_alloc_free_till_mark();
+    return desc;
+}
+
+// Returns the weighted chi-square distance of region r, terms where both bins
+// match (the common case for sparse histograms) contribute nothing.
+static inline uint32_t lbp_region_distance(const uint8_t *d0, const uint8_t *d1, int r)
+{
+    uint32_t sum = 0;
+    d0 += r*LBP_HIST_SIZE;
+    d1 += r*LBP_HIST_SIZE;
+    for (int i=0; i<LBP_HIST_SIZE; i++) {
+        int a = d0[i], b = d1[i];
+        if (a != b) {
+            sum += ((a - b) * (a - b))/(a + b);
+        }
+    }
+    return sum * lbp_weights[r];
 }
 
 int imlib_lbp_desc_distance(uint8_t *d0, uint8_t *d1)
 {
     uint32_t sum = 0;
-    for (int i=0; i<LBP_DESC_SIZE; i++) {
-        int w = lbp_weights[i/LBP_HIST_SIZE];
-        sum += w * ((((d0[i] - d1[i]) * (d0[i] - d1[i]))/IM_MAX((d0[i] + d1[i]),1)));
+    for (int i=0; i<LBP_NUM_REGIONS*LBP_NUM_REGIONS-LBP_NUM_ZERO_REGIONS; i++) {
+        sum += lbp_region_distance(d0, d1, lbp_region_order[i]);
     }
     return sum;
 }
 
+int imlib_lbp_desc_match(uint8_t *desc, uint8_t *gallery, int n, int *distance)
+{
+    int best = -1;
+    uint32_t best_sum = UINT32_MAX;
+
+    for (int j=0; j<n; j++, gallery+=LBP_DESC_SIZE) {
+        uint32_t sum = 0;
+        // Regions are visited heaviest first so that poor candidates exceed
+        // the best distance found so far after only a few regions.
+        for (int i=0; i<LBP_NUM_REGIONS*LBP_NUM_REGIONS-LBP_NUM_ZERO_REGIONS; i++) {
+            sum += lbp_region_distance(desc, gallery, lbp_region_order[i]);
+            if (sum >= best_sum) {
+                break;
+            }
+        }
+
+        if (sum < best_sum) {
+            best = j;
+            best_sum = sum;
+        }
+    }
+
+    if (distance) {
+        *distance = best_sum;
+    }
+    return best;
+}
+
 int imlib_lbp_desc_save(FIL *fp, uint8_t *desc)
 {
     UINT bytes;
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Block-matching motion estimation using SAD and diamond search.
+ *
+ * References:
+ * Zhu, Shan, and Kai-Kuang Ma. "A new diamond search algorithm for fast block-matching motion estimation."
+ */
+#include <stdlib.h>
+#include "imlib.h"
+#include "fb_alloc.h"
+#ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+
+// Large and small diamond search patterns (excluding the center).
+static const int8_t motion_ldsp[8][2] = {{2, 0}, {1, 1}, {0, 2}, {-1, 1}, {-2, 0}, {-1, -1}, {0, -2}, {1, -1}};
+static const int8_t motion_sdsp[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+
+// SAD of a size x size block, returns early once the sum exceeds limit.
+static inline uint32_t motion_sad(const uint8_t *a, const uint8_t *b, int stride, int size, uint32_t limit)
+{
+    uint32_t diff = 0;
+
+    for (int y = 0; y < size; y++, a += stride, b += stride) {
+#if defined(ARM_MATH_DSP)
+        for (int x = 0; x < size; x += 4) {
+            diff = __USADA8(__UNALIGNED_UINT32_READ(a + x), __UNALIGNED_UINT32_READ(b + x), diff);
+        }
+#else
+        for (int x = 0; x < size; x++) {
+            diff += abs(a[x] - b[x]);
+        }
+#endif
+
+        if (diff > limit) {
+            break;
+        }
+    }
+
+    return diff;
+}
+
+static uint8_t *motion_grayscale(image_t *img)
+{
+    if (img->pixfmt == PIXFORMAT_GRAYSCALE) {
+        return img->data;
+    }
+
+    uint8_t *data = fb_alloc(img->w * img->h, FB_ALLOC_NO_HINT);
+
+    for (int y = 0; y < img->h; y++) {
+        uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+        uint8_t *data_row_ptr = data + (y * img->w);
+        for (int x = 0; x < img->w; x++) {
+            data_row_ptr[x] = COLOR_RGB565_TO_Y(IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x));
+        }
+    }
+
+    return data;
+}
+
+void imlib_find_motion_vectors(image_t *img, image_t *prev, int block_size, int search_range, int threshold,
+                               motion_vector_t *vectors)
+{
+    int blocks_w = img->w / block_size, blocks_h = img->h / block_size, stride = img->w;
+    uint32_t static_sad = threshold * block_size * block_size;
+
+    fb_alloc_mark();
+    uint8_t *data = motion_grayscale(img);
+    uint8_t *prev_data = motion_grayscale(prev);
+
+    for (int by = 0; by < blocks_h; by++) {
+        for (int bx = 0; bx < blocks_w; bx++) {
+            motion_vector_t *mv = &vectors[(by * blocks_w) + bx];
+            int x = bx * block_size, y = by * block_size;
+            const uint8_t *block = data + (y * stride) + x;
+
+            // Offsets into the previous frame that keep the block inside of it.
+            int min_u = IM_MAX(-search_range, -x), max_u = IM_MIN(search_range, img->w - block_size - x);
+            int min_v = IM_MAX(-search_range, -y), max_v = IM_MIN(search_range, img->h - block_size - y);
+
+            // The zero vector doubles as the static block pre-test.
+            int best_u = 0, best_v = 0;
+            uint32_t best = motion_sad(block, prev_data + (y * stride) + x, stride, block_size, UINT32_MAX);
+
+            if (best > static_sad) {
+                // Neighbouring blocks usually move together so try their vectors as starting points.
+                for (int i = 0; i < 2; i++) {
+                    motion_vector_t *n = i ? ((by > 0) ? (mv - blocks_w) : NULL) : ((bx > 0) ? (mv - 1) : NULL);
+
+                    if (n && (n->x || n->y)) {
+                        int u = IM_MIN(IM_MAX(-n->x, min_u), max_u), v = IM_MIN(IM_MAX(-n->y, min_v), max_v);
+                        uint32_t diff = motion_sad(block, prev_data + ((y + v) * stride) + x + u, stride, block_size, best);
+
+                        if (diff < best) {
+                            best = diff;
+                            best_u = u;
+                            best_v = v;
+                        }
+                    }
+                }
+
+                // Large diamond steps until the center is the best point, then one small diamond step.
+                for (bool large = true, done = false; !done; ) {
+                    const int8_t (*pattern)[2] = large ? motion_ldsp : motion_sdsp;
+                    int pattern_len = large ? 8 : 4, center_u = best_u, center_v = best_v;
+
+                    for (int i = 0; i < pattern_len; i++) {
+                        int u = center_u + pattern[i][0], v = center_v + pattern[i][1];
+
+                        if ((u < min_u) || (u > max_u) || (v < min_v) || (v > max_v)) {
+                            continue;
+                        }
+
+                        uint32_t diff = motion_sad(block, prev_data + ((y + v) * stride) + x + u, stride, block_size, best);
+
+                        if (diff < best) {
+                            best = diff;
+                            best_u = u;
+                            best_v = v;
+                        }
+                    }
+
+                    if ((best_u == center_u) && (best_v == center_v)) {
+                        done = !large;
+                        large = false;
+                    } else {
+                        done = !large;
+                    }
+                }
+            }
+
+            // The block content moved from (x + u, y + v) to (x, y).
+            mv->x = -best_u;
+            mv->y = -best_v;
+            mv->sad = best;
+        }
+    }
+
+    fb_alloc_free_till_mark();
+}
+#endif // IMLIB_ENABLE_FIND_MOTION_VECTORS
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Sparse pyramidal Lucas-Kanade optical flow.
+ */
+#include <stdlib.h>
+#include "imlib.h"
+#include "fb_alloc.h"
+#ifdef IMLIB_ENABLE_OPTICAL_FLOW
+
+// Patches are bilinearly sampled with Q14 weights into Q5 intensities, which keeps
+// the Scharr gradients (divided by their gain of 32) and the patch differences in
+// the same Q5 scale, so the normal equations need no further scaling.
+#define LK_W_BITS           (14)
+#define LK_FRAC_BITS        (5)
+#define LK_MIN_LEVEL_SIZE   (16)
+// Smallest eigenvalue of the structure tensor per pixel (in squared intensity units)
+// below which a patch has too little texture to be tracked.
+#define LK_MIN_EIGENVALUE   (4.0f)
+#define LK_EPSILON          (0.01f)
+
+static int lk_levels(int w, int h, int levels)
+{
+    int n = 1;
+
+    for (; (n < levels) && ((w >> n) >= LK_MIN_LEVEL_SIZE) && ((h >> n) >= LK_MIN_LEVEL_SIZE); n++) {
+    }
+
+    return n;
+}
+
+size_t imlib_lk_pyramid_size(int w, int h, int levels)
+{
+    size_t size = 0;
+
+    for (int i = 0, ii = lk_levels(w, h, levels); i < ii; i++) {
+        size += (w >> i) * (h >> i);
+    }
+
+    return size;
+}
+
+void imlib_lk_pyramid_build(lk_pyramid_t *pyramid, image_t *img, int levels, uint8_t *buffer)
+{
+    pyramid->levels = lk_levels(img->w, img->h, levels);
+
+    for (int i = 0; i < pyramid->levels; i++) {
+        image_t *level = &pyramid->level[i];
+        level->w = img->w >> i;
+        level->h = img->h >> i;
+        level->pixfmt = PIXFORMAT_GRAYSCALE;
+        level->data = buffer;
+        buffer += level->w * level->h;
+    }
+
+    image_t *base = &pyramid->level[0];
+
+    switch (img->pixfmt) {
+        case PIXFORMAT_GRAYSCALE: {
+            memcpy(base->data, img->data, base->w * base->h);
+            break;
+        }
+        case PIXFORMAT_RGB565: {
+            for (int y = 0; y < base->h; y++) {
+                uint16_t *row_ptr = IMAGE_COMPUTE_RGB565_PIXEL_ROW_PTR(img, y);
+                uint8_t *base_row_ptr = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(base, y);
+                for (int x = 0; x < base->w; x++) {
+                    base_row_ptr[x] = COLOR_RGB565_TO_Y(IMAGE_GET_RGB565_PIXEL_FAST(row_ptr, x));
+                }
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    // Each level is the 2x2 box filtered previous level.
+    for (int i = 1; i < pyramid->levels; i++) {
+        image_t *src = &pyramid->level[i - 1], *dst = &pyramid->level[i];
+        for (int y = 0; y < dst->h; y++) {
+            uint8_t *src_row_0 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(src, y * 2);
+            uint8_t *src_row_1 = src_row_0 + src->w;
+            uint8_t *dst_row = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(dst, y);
+            for (int x = 0; x < dst->w; x++) {
+                dst_row[x] = (src_row_0[x * 2] + src_row_0[(x * 2) + 1] +
+                              src_row_1[x * 2] + src_row_1[(x * 2) + 1] + 2) >> 2;
+            }
+        }
+    }
+}
+
+// Samples a size x size patch whose top left corner is at (x, y) in Q5. Samples
+// past the image edges are clamped to the edges.
+static void lk_sample_patch(image_t *img, float x, float y, int size, int16_t *patch)
+{
+    int ix = fast_floorf(x), iy = fast_floorf(y);
+    float fx = x - ix, fy = y - iy;
+    int w00 = fast_roundf((1.0f - fx) * (1.0f - fy) * (1 << LK_W_BITS));
+    int w01 = fast_roundf(fx * (1.0f - fy) * (1 << LK_W_BITS));
+    int w10 = fast_roundf((1.0f - fx) * fy * (1 << LK_W_BITS));
+    int w11 = (1 << LK_W_BITS) - w00 - w01 - w10;
+    const int shift = LK_W_BITS - LK_FRAC_BITS, round = 1 << (shift - 1);
+
+    if ((ix >= 0) && (iy >= 0) && ((ix + size) < img->w) && ((iy + size) < img->h)) {
+        for (int j = 0; j < size; j++, patch += size) {
+            const uint8_t *r0 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, iy + j) + ix;
+            const uint8_t *r1 = r0 + img->w;
+            for (int i = 0; i < size; i++) {
+                patch[i] = ((r0[i] * w00) + (r0[i + 1] * w01) + (r1[i] * w10) + (r1[i + 1] * w11) + round) >> shift;
+            }
+        }
+    } else {
+        for (int j = 0; j < size; j++, patch += size) {
+            const uint8_t *r0 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MIN(IM_MAX(iy + j, 0), img->h - 1));
+            const uint8_t *r1 = IMAGE_COMPUTE_GRAYSCALE_PIXEL_ROW_PTR(img, IM_MIN(IM_MAX(iy + j + 1, 0), img->h - 1));
+            for (int i = 0; i < size; i++) {
+                int x0 = IM_MIN(IM_MAX(ix + i, 0), img->w - 1);
+                int x1 = IM_MIN(IM_MAX(ix + i + 1, 0), img->w - 1);
+                patch[i] = ((r0[x0] * w00) + (r0[x1] * w01) + (r1[x0] * w10) + (r1[x1] * w11) + round) >> shift;
+            }
+        }
+    }
+}
+
+void imlib_lk_flow(lk_pyramid_t *prev, lk_pyramid_t *next, int window, int iterations, int max_error,
+                   int points_len, const float *prev_xy, float *next_xy, bool *status)
+{
+    int half = window / 2, size = window + 2, area = window * window;
+    int levels = IM_MIN(prev->levels, next->levels);
+    int16_t *patch = fb_alloc(size * size * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    int16_t *i_x = fb_alloc(area * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    int16_t *i_y = fb_alloc(area * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    int16_t *i_i = fb_alloc(area * sizeof(int16_t), FB_ALLOC_NO_HINT);
+    int16_t *j_j = fb_alloc(area * sizeof(int16_t), FB_ALLOC_NO_HINT);
+
+    for (int n = 0; n < points_len; n++) {
+        float x = prev_xy[n * 2], y = prev_xy[(n * 2) + 1];
+        float g_x = 0.0f, g_y = 0.0f, v_x = 0.0f, v_y = 0.0f;
+        int error = 0;
+        bool ok = (0.0f <= x) && (x < prev->level[0].w) && (0.0f <= y) && (y < prev->level[0].h);
+
+        // Coarse to fine, the flow found on a level is the initial guess of the next one.
+        for (int l = levels - 1; ok && (l >= 0); l--) {
+            image_t *i_img = &prev->level[l], *j_img = &next->level[l];
+            float p_x = x / (1 << l), p_y = y / (1 << l);
+
+            lk_sample_patch(i_img, p_x - half - 1, p_y - half - 1, size, patch);
+
+            // Integer Scharr gradients of the previous patch and the structure tensor.
+            int64_t g_xx = 0, g_xy = 0, g_yy = 0;
+            for (int j = 0, k = 0; j < window; j++) {
+                const int16_t *r0 = patch + (j * size), *r1 = r0 + size, *r2 = r1 + size;
+                for (int i = 0; i < window; i++, k++) {
+                    int dx = (3 * (r0[i + 2] - r0[i] + r2[i + 2] - r2[i])) + (10 * (r1[i + 2] - r1[i]));
+                    int dy = (3 * (r2[i] - r0[i] + r2[i + 2] - r0[i + 2])) + (10 * (r2[i + 1] - r0[i + 1]));
+                    i_x[k] = dx >> 5;
+                    i_y[k] = dy >> 5;
+                    i_i[k] = r1[i + 1];
+                    g_xx += i_x[k] * i_x[k];
+                    g_xy += i_x[k] * i_y[k];
+                    g_yy += i_y[k] * i_y[k];
+                }
+            }
+
+            float a = g_xx, b = g_xy, c = g_yy, det = (a * c) - (b * b);
+            float min_eig = ((a + c) - fast_sqrtf(((a - c) * (a - c)) + (4.0f * b * b))) / 2.0f;
+
+            if ((min_eig / (area << (2 * LK_FRAC_BITS))) < LK_MIN_EIGENVALUE) {
+                // Too flat on this level, keep the guess from the coarser levels.
+                ok = (l != 0);
+                v_x = v_y = 0.0f;
+            } else {
+                v_x = v_y = 0.0f;
+
+                for (int it = 0; it < iterations; it++) {
+                    float q_x = p_x + g_x + v_x, q_y = p_y + g_y + v_y;
+
+                    if ((q_x < -half) || (q_y < -half) || (q_x >= (j_img->w + half)) || (q_y >= (j_img->h + half))) {
+                        ok = false;
+                        break;
+                    }
+
+                    lk_sample_patch(j_img, q_x - half, q_y - half, window, j_j);
+
+                    int64_t b_x = 0, b_y = 0;
+                    error = 0;
+                    for (int k = 0; k < area; k++) {
+                        int diff = i_i[k] - j_j[k];
+                        b_x += diff * i_x[k];
+                        b_y += diff * i_y[k];
+                        error += abs(diff);
+                    }
+
+                    float d_x = ((c * b_x) - (b * b_y)) / det;
+                    float d_y = ((a * b_y) - (b * b_x)) / det;
+                    v_x += d_x;
+                    v_y += d_y;
+
+                    if (((d_x * d_x) + (d_y * d_y)) < (LK_EPSILON * LK_EPSILON)) {
+                        break;
+                    }
+                }
+            }
+
+            if (l) {
+                g_x = 2.0f * (g_x + v_x);
+                g_y = 2.0f * (g_y + v_y);
+            }
+        }
+
+        // The error is the mean absolute difference of the patches before the last step.
+        next_xy[n * 2] = x + g_x + v_x;
+        next_xy[(n * 2) + 1] = y + g_y + v_y;
+        status[n] = ok && ((error / area) <= (max_error << LK_FRAC_BITS)) && (0.0f <= next_xy[n * 2]) && (next_xy[n * 2] < next->level[0].w)
+                       && (0.0f <= next_xy[(n * 2) + 1]) && (next_xy[(n * 2) + 1] < next->level[0].h);
+    }
+
+    fb_free(); // j_j
+    fb_free(); // i_i
+    fb_free(); // i_y
+    fb_free(); // i_x
+    fb_free(); // patch
+}
+#endif // IMLIB_ENABLE_OPTICAL_FLOW
@@ -35,6 +35,22 @@ bool rectangle_intersects(rectangle_t *r1, rectangle_t *r2)
              ((r1->y+r1->h) > r2->y));
 }
 
+// Intersection over union of two rectangles, 0 if they don't overlap.
+float rectangle_iou(rectangle_t *r1, rectangle_t *r2)
+{
+    int x0 = IM_MAX(r1->x, r2->x);
+    int y0 = IM_MAX(r1->y, r2->y);
+    int x1 = IM_MIN(r1->x + r1->w, r2->x + r2->w);
+    int y1 = IM_MIN(r1->y + r1->h, r2->y + r2->h);
+
+    if ((x0 >= x1) || (y0 >= y1)) {
+        return 0.0f;
+    }
+
+    int overlap = (x1 - x0) * (y1 - y0);
+    return overlap / ((float) ((r1->w * r1->h) + (r2->w * r2->h) - overlap));
+}
+
 // Determine subimg even if it is going off the edge of the main image.
 bool rectangle_subimg(image_t *img, rectangle_t *r, rectangle_t *r_out)
 {
@@ -17,7 +17,6 @@
 #include "xalloc.h"
 #ifdef IMLIB_ENABLE_SELECTIVE_SEARCH
 
-#define THRESHOLD(size, c) (c/size)
 typedef struct {
     uint16_t y;
     uint16_t h;
@@ -37,16 +36,38 @@ typedef struct {
 } universe;
 
 typedef struct {
-    float    w;
+    uint16_t w;
     uint16_t a;
     uint16_t b;
 } edge;
 
+// Region pair entry of the merge priority queue. Entries are invalidated lazily: an
+// entry is stale when either region has been merged (or updated) since it was pushed.
+typedef struct {
+    uint32_t sim;
+    uint16_t a;
+    uint16_t b;
+    uint16_t va;
+    uint16_t vb;
+} pair;
+
+typedef struct {
+    int len;
+    int cap;
+    pair *data;
+} pair_heap;
+
+// Edge weights are the rounded RGB euclidean distance so they fit [0, 441].
+#define EDGE_WEIGHT_BINS    (442)
+// Fixed point precision of the graph thresholds (Q8) and similarities (Q16).
+#define THRESHOLD_SHIFT     (8)
+#define SIM_SHIFT           (16)
+#define SIM_ONE             (1 << SIM_SHIFT)
+#define WEIGHT_SHIFT        (8)
+#define HIST_BINS           (75)
+
 static inline int min (int a, int b) { return (a < b) ? a : b; }
 static inline int max (int a, int b) { return (a > b) ? a : b; }
-static inline float minf (float a, float b) { return (a < b) ? a : b; }
-static inline float maxf (float a, float b) { return (a > b) ? a : b; }
-extern uint32_t rng_randint(uint32_t min, uint32_t max);
 
 static universe *universe_create(int elements)
 {
@@ -97,82 +118,122 @@ static void universe_join (universe * uni, int x, int y)
     uni->num--;
 }
 
-static int universe_get_id(universe * this, int x)
+// Histograms hold raw pixel counts so merging two regions is a plain add. The
+// intersection of the L1 normalized histograms is computed by cross multiplying
+// with the region sizes instead of dividing each bin (Q16 result in [0, 1]).
+static inline uint32_t color_similarity (const uint16_t *hist1, const uint16_t *hist2, uint32_t n1, uint32_t n2)
 {
-    return this->elts[x].rank;
+    uint32_t sim = 0;
+    for (int i = 0; i < HIST_BINS; ++i) {
+        uint32_t h1 = hist1[i] * n2;
+        uint32_t h2 = hist2[i] * n1;
+        sim += (h1 < h2) ? h1 : h2;
+    }
+    // Each of the 3 channel histograms contributes at most n1 * n2.
+    return (((uint64_t) sim) << SIM_SHIFT) / (3 * n1 * n2);
 }
 
-static void universe_set_id(universe * this, int x, int id)
+static inline uint32_t size_similarity (uint32_t a, uint32_t b, uint32_t size)
 {
-    this->elts[x].rank = id;
+    return SIM_ONE - (((a + b) << SIM_SHIFT) / size);
 }
 
-static inline float color_similarity (float * hist1, float * hist2)
+static inline uint32_t fill_similarity (region * ra, region * rb, uint32_t a, uint32_t b, uint32_t size)
 {
-    float sim = 0;
-    for (int i = 0; i < 75; ++i) {
-        sim += minf(hist1[i], hist2[i]);
-    }
-    return sim;
+    // NOTE: w/h hold the max x/y coordinates while regions are being merged.
+    uint32_t width = max(ra->w, rb->w) - min(ra->x, rb->x) + 1;
+    uint32_t height = max(ra->h, rb->h) - min(ra->y, rb->y) + 1;
+    uint32_t gap = (width * height) - a - b;
+    return (gap >= size) ? 0 : (SIM_ONE - ((gap << SIM_SHIFT) / size));
 }
 
-static inline float size_similarity (int a, int b, int size)
+static inline uint32_t similarity(region *regions, uint16_t *histogram, int *counts,
+                                  int i, int j, int size, const int *weights)
 {
-    return 1.0f - (a + b)/size;
+    int64_t sim = (int64_t) weights[0] * color_similarity(histogram + HIST_BINS * i, histogram + HIST_BINS * j, counts[i], counts[j])
+                + (int64_t) weights[1] * size_similarity(counts[i], counts[j], size)
+                + (int64_t) weights[2] * fill_similarity(regions + i, regions + j, counts[i], counts[j], size);
+    return (sim > 0) ? (sim >> WEIGHT_SHIFT) : 0;
 }
 
-static inline float fill_similarity (region * ra, region * rb, int a, int b, int size)
+static inline int diff(image_t *img, int x1, int y1, int x2, int y2)
 {
-    int width = max(ra->w, rb->w) - min(ra->x, rb->x);
-    int height = max(ra->h, rb->h) - min(ra->y, rb->y);
-    return 1.0f - (width*height - a - b)/size;
+    uint16_t p1 = IMAGE_GET_RGB565_PIXEL(img, x1, y1);
+    uint16_t p2 = IMAGE_GET_RGB565_PIXEL(img, x2, y2);
+    int r = COLOR_RGB565_TO_R8(p1) - COLOR_RGB565_TO_R8(p2);
+    int g = COLOR_RGB565_TO_G8(p1) - COLOR_RGB565_TO_G8(p2);
+    int b = COLOR_RGB565_TO_B8(p1) - COLOR_RGB565_TO_B8(p2);
+    // dissimilarity measure between pixels
+    return fast_roundf(fast_sqrtf((r * r) + (g * g) + (b * b)));
 }
 
-static inline float square(float x) { return x*x; };
+// Calls the body for every graph edge (pixel x, y to pixel x2, y2), the visit
+// order is the same for every expansion so edges can be generated in two passes.
+#define FOR_EACH_EDGE(width, height, body)                                              \
+    for (int y = 0; y < height; y++) {                                                  \
+        for (int x = 0; x < width; x++) {                                               \
+            int x2, y2;                                                                 \
+            if (x < width - 1) { x2 = x + 1; y2 = y; body; }                            \
+            if (y < height - 1) { x2 = x; y2 = y + 1; body; }                           \
+            if ((x < width - 1) && (y < height - 1)) { x2 = x + 1; y2 = y + 1; body; }  \
+            if ((x < width - 1) && (y > 0)) { x2 = x + 1; y2 = y - 1; body; }           \
+        }                                                                               \
+    }
 
-static inline float diff(image_t *img, int x1, int y1, int x2, int y2)
+// Builds the graph edges already sorted by weight using a counting sort. The
+// first pass caches the weights and their histogram, the second scatters the edges.
+static edge *build_sorted_edges(image_t *img, int width, int height, int *num_edges)
 {
-    uint16_t p1 = IMAGE_GET_RGB565_PIXEL(img, x1, y1);
-    uint16_t p2 = IMAGE_GET_RGB565_PIXEL(img, x2, y2);
-    uint8_t r1  = COLOR_RGB565_TO_R8(p1);
-    uint8_t r2  = COLOR_RGB565_TO_R8(p2);
+    int num = 0;
+    uint32_t *offsets = fb_alloc0(EDGE_WEIGHT_BINS * sizeof(uint32_t), FB_ALLOC_NO_HINT);
+    uint16_t *weights = fb_alloc(width * height * sizeof(uint16_t) * 4, FB_ALLOC_NO_HINT);
+
+    FOR_EACH_EDGE(width, height, {
+        int w = diff(img, x, y, x2, y2);
+        weights[num++] = w;
+        offsets[w]++;
+    });
+
+    for (int i = 0, sum = 0; i < EDGE_WEIGHT_BINS; i++) {
+        int count = offsets[i];
+        offsets[i] = sum;
+        sum += count;
+    }
 
-    uint8_t g1  = COLOR_RGB565_TO_G8(p1);
-    uint8_t g2  = COLOR_RGB565_TO_G8(p2);
+    edge *edges = (edge*) fb_alloc(num * sizeof(edge), FB_ALLOC_NO_HINT);
+    int i = 0;
 
-    uint8_t b1  = COLOR_RGB565_TO_B8(p1);
-    uint8_t b2  = COLOR_RGB565_TO_B8(p2);
-   // dissimilarity measure between pixels
-   return  sqrtf((r1-r2) * (r1-r2) + (g1-g2) * (g1-g2) + (b1-b2) * (b1-b2));
-}
+    FOR_EACH_EDGE(width, height, {
+        int w = weights[i++];
+        edge *e = edges + offsets[w]++;
+        e->w = w;
+        e->a = y * width + x;
+        e->b = y2 * width + x2;
+    });
 
-int comp (const void * elem1, const void * elem2) 
-{
-    edge *f = (edge*) elem1;
-    edge *s = (edge*) elem2;
-    if (f->w > s->w) return  1;
-    if (f->w < s->w) return -1;
-    return 0;
+    *num_edges = num;
+    return edges;
 }
 
 static void segment_graph(universe *u, int num_vertices, int num_edges, edge *edges, float c)
 {
-    qsort (edges, num_edges, sizeof(edge), comp);
-
-    float *threshold = fb_alloc(num_vertices * sizeof(float), FB_ALLOC_NO_HINT);
+    uint32_t c_q = fast_roundf(c * (1 << THRESHOLD_SHIFT));
+    uint32_t *threshold = fb_alloc(num_vertices * sizeof(uint32_t), FB_ALLOC_NO_HINT);
     for (int i=0; i<num_vertices; i++) {
-        threshold[i] = THRESHOLD(1, c);
+        threshold[i] = c_q;
     }
 
+    // Edges are already sorted in increasing weight order.
     for (int i=0; i<num_edges; i++) {
         edge *pedge = edges + i;
+        uint32_t w = pedge->w << THRESHOLD_SHIFT;
         int a = universe_find (u, pedge->a);
         int b = universe_find (u, pedge->b);
         if (a != b) {
-            if ((pedge->w <= threshold[a]) && (pedge->w <= threshold[b])) {
+            if ((w <= threshold[a]) && (w <= threshold[b])) {
                 universe_join (u, a, b);
                 a = universe_find (u, a);
-                threshold[a] = pedge->w + THRESHOLD(universe_size (u, a), c);
+                threshold[a] = w + (c_q / universe_size (u, a));
             }
         }
     }
@@ -181,6 +242,83 @@ static void segment_graph(universe *u, int num_vertices, int num_edges, edge *ed
     fb_free();
 }
 
+static inline bool pair_less(pair *p1, pair *p2)
+{
+    return p1->sim < p2->sim;
+}
+
+static void pair_heap_sift_up(pair_heap *h, int i)
+{
+    pair p = h->data[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!pair_less(h->data + parent, &p)) {
+            break;
+        }
+        h->data[i] = h->data[parent];
+        i = parent;
+    }
+    h->data[i] = p;
+}
+
+static void pair_heap_sift_down(pair_heap *h, int i)
+{
+    pair p = h->data[i];
+    for (;;) {
+        int child = (2 * i) + 1;
+        if (child >= h->len) {
+            break;
+        }
+        if (((child + 1) < h->len) && pair_less(h->data + child, h->data + child + 1)) {
+            child += 1;
+        }
+        if (!pair_less(&p, h->data + child)) {
+            break;
+        }
+        h->data[i] = h->data[child];
+        i = child;
+    }
+    h->data[i] = p;
+}
+
+static inline bool pair_valid(pair *p, uint16_t *version)
+{
+    return (p->va == version[p->a]) && (p->vb == version[p->b]);
+}
+
+static void pair_heap_push(pair_heap *h, pair *p, uint16_t *version)
+{
+    if (h->len == h->cap) {
+        // Drop stale entries and restore the heap property. Live entries never
+        // exceed the number of adjacent region pairs so this always frees space.
+        int len = 0;
+        for (int i = 0; i < h->len; i++) {
+            if (pair_valid(h->data + i, version)) {
+                h->data[len++] = h->data[i];
+            }
+        }
+        h->len = len;
+        for (int i = (len / 2) - 1; i >= 0; i--) {
+            pair_heap_sift_down(h, i);
+        }
+    }
+    h->data[h->len] = *p;
+    pair_heap_sift_up(h, h->len++);
+}
+
+static bool pair_heap_pop(pair_heap *h, pair *p, uint16_t *version)
+{
+    while (h->len) {
+        *p = h->data[0];
+        h->data[0] = h->data[--h->len];
+        pair_heap_sift_down(h, 0);
+        if (pair_valid(p, version)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void image_scale(image_t *src, image_t *dst)
 {
     int x_ratio = (int)((src->w<<16)/dst->w) +1;
@@ -224,39 +362,7 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
     array_alloc(&proposals, xfree);
 
     universe *u = universe_create (width * height);
-    edge *edges = (edge*) fb_alloc(width * height * sizeof(edge) * 4, FB_ALLOC_NO_HINT);
-
-    for (int y=0; y<height; y++) {
-        for (int x=0; x<width; x++) {
-            if (x < width-1) {
-                edges[num].a = y * width + x;
-                edges[num].b = y * width + (x+1);
-                edges[num].w = diff(img, x, y, x+1, y);
-                num++;
-            }
-
-            if (y < height-1) {
-                edges[num].a = y * width + x;
-                edges[num].b = (y+1) * width + x;
-                edges[num].w = diff(img, x, y, x, y+1);
-                num++;
-            }
-
-            if ((x < width-1) && (y < height-1)) {
-                edges[num].a = y * width + x;
-                edges[num].b = (y+1) * width + (x+1);
-                edges[num].w = diff(img, x, y, x+1, y+1);
-                num++;
-            }
-
-            if ((x < width-1) && (y > 0)) {
-                edges[num].a = y * width + x;
-                edges[num].b = (y-1) * width + (x+1);
-                edges[num].w = diff(img, x, y, x+1, y-1);
-                num++;
-            }
-        }
-    }
+    edge *edges = build_sorted_edges(img, width, height, &num);
 
     segment_graph(u, width * height, num, edges, t);
     
@@ -267,7 +373,9 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
             universe_join (u, a, b);
     }
 
-    // Free graph edges
+    // Free graph edges and cached weights.
+    fb_free();
+    fb_free();
     fb_free();
 
     int num_ccs = universe_num_sets(u);
@@ -280,27 +388,22 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
     }
 
     int next_component = 0;
-    int   *counts = (int*) fb_alloc0(num_ccs * sizeof(int), FB_ALLOC_NO_HINT);
-    int   *components= (int*) fb_alloc(num_ccs * sizeof(int), FB_ALLOC_NO_HINT);
-    float *histogram = (float*) fb_alloc0(num_ccs * sizeof(float) * 75, FB_ALLOC_NO_HINT);
+    int      *counts = (int*) fb_alloc0(num_ccs * sizeof(int), FB_ALLOC_NO_HINT);
+    uint16_t *histogram = (uint16_t*) fb_alloc0(num_ccs * sizeof(uint16_t) * HIST_BINS, FB_ALLOC_NO_HINT);
+    // Maps a set representative to its compact component id.
+    uint16_t *component_ids = (uint16_t*) fb_alloc(width * height * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    uint16_t *labels = (uint16_t*) fb_alloc(width * height * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    memset(component_ids, 0xFF, width * height * sizeof(uint16_t));
 
     // Calc histograms
     for (int y=0; y<height; y++) {
         for (int x = 0; x<width; x++) {
-            int component_id = -1;
             int comp = universe_find(u, y * width + x);
-            for (i=0; i<next_component; i++) {
-                if (components[i] == comp) {
-                    component_id = i;
-                    break;
-                }
+            int component_id = component_ids[comp];
+            if (component_id == UINT16_MAX) {
+                component_id = component_ids[comp] = next_component++;
             }
-            if (i == next_component) {
-                components[next_component] = comp;
-                component_id = next_component;
-                ++next_component;
-            }
-            universe_set_id(u, y * width + x, component_id);
+            labels[y * width + x] = component_id;
             region * r = regions + component_id;
             r->y = min(r->y, y);
             r->h = max(r->h, y);
@@ -312,80 +415,73 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
             int g_bin = min(COLOR_RGB565_TO_G8(p), 240)/10;
             int b_bin = min(COLOR_RGB565_TO_B8(p), 240)/10;
 
-            histogram[75*component_id +  0 + r_bin]++;
-            histogram[75*component_id + 25 + g_bin]++;
-            histogram[75*component_id + 50 + b_bin]++;
+            histogram[HIST_BINS*component_id +  0 + r_bin]++;
+            histogram[HIST_BINS*component_id + 25 + g_bin]++;
+            histogram[HIST_BINS*component_id + 50 + b_bin]++;
             counts[component_id]++;
         }
     }
 
-    // Normalize histograms
-    for (i=0; i<num_ccs; i++) {
-        float max_val = 0;
-        for (j=0; j<75; j++) {
-            max_val = max(max_val, histogram[75*i + j]);
-        }
-        for (j=0; j<75; j++) {
-            histogram[75*i + j] /= max_val;
-        }
-    }
-
     uint8_t * adjacency = (uint8_t*) fb_alloc0(num_ccs * num_ccs * sizeof(uint8_t), FB_ALLOC_NO_HINT);
+    int num_pairs = 0;
     for (int y=0; y<height-1; ++y) {
         for (int x=0; x<width-1; ++x) {
-            int component1 = universe_get_id(u, y * width + x);
-            int component2 = universe_get_id(u, y * width + x + 1);
-            int component3 = universe_get_id(u, y * width + x + width);
+            int component1 = labels[y * width + x];
+            int component2 = labels[y * width + x + 1];
+            int component3 = labels[y * width + x + width];
 
-            if (component1 != component2) {
+            if ((component1 != component2) && !adjacency[component1 * num_ccs + component2]) {
                 adjacency[component1 * num_ccs + component2] = 1;
                 adjacency[component2 * num_ccs + component1] = 1;
+                num_pairs++;
             }
 
-            if (component1 != component3) {
+            if ((component1 != component3) && !adjacency[component1 * num_ccs + component3]) {
                 adjacency[component1 * num_ccs + component3] = 1;
                 adjacency[component3 * num_ccs + component1] = 1;
+                num_pairs++;
             }
         }
     }
 
     int size = height * width;
-    float * similarity_table = (float*) fb_alloc(num_ccs * num_ccs * sizeof(float), FB_ALLOC_NO_HINT);
+    const int weights[3] = {
+        fast_roundf(a1 * (1 << WEIGHT_SHIFT)),
+        fast_roundf(a2 * (1 << WEIGHT_SHIFT)),
+        fast_roundf(a3 * (1 << WEIGHT_SHIFT)),
+    };
+
+    // Every merge re-inserts the merged region's pairs, twice the initial pair
+    // count leaves enough room to amortize the stale entry compaction.
+    uint16_t *version = (uint16_t*) fb_alloc0(num_ccs * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+    pair_heap heap = { .len = 0, .cap = (num_pairs * 2) + num_ccs };
+    heap.data = (pair*) fb_alloc(heap.cap * sizeof(pair), FB_ALLOC_NO_HINT);
+
     for (i = 0; i < num_ccs; ++i) {
         for (j = i + 1; j < num_ccs; ++j) {
-            float color_sim = a1 * color_similarity (histogram + 75 * i, histogram + 75 * j);
-            float size_sim  = a2 * size_similarity (counts[i], counts[j], size);
-            float fill_sim  = a3 * fill_similarity (regions + i, regions + j, counts[i], counts[j], size);
-            float similarity = color_sim + size_sim + fill_sim;
-            similarity_table[i * num_ccs + j] = similarity;
-            similarity_table[j * num_ccs + i] = similarity;
+            if (adjacency[i * num_ccs + j]) {
+                heap.data[heap.len++] = (pair) {
+                    similarity(regions, histogram, counts, i, j, size, weights), i, j, 0, 0
+                };
+            }
         }
     }
 
+    for (i = (heap.len / 2) - 1; i >= 0; i--) {
+        pair_heap_sift_down(&heap, i);
+    }
+
     int remaining = num_ccs;
     while (remaining > 1) {
-        int best_i = -1;
-        int best_j = -1;
-        float best_similarity = 0;
-        for (i=0; i<num_ccs; i++) {
-            for (j=i+1; j<num_ccs; j++) {
-                if (adjacency[i * num_ccs + j] == 0) {
-                    continue;
-                }
-                float similarity = similarity_table[i * num_ccs + j];
-                if (similarity > best_similarity) {
-                    best_similarity = similarity;
-                    best_i = i;
-                    best_j = j;
-                }
-            }
-        }
-
-        if (best_i == -1) {
+        pair best;
+        if (!pair_heap_pop(&heap, &best, version)) {
             printf("failed to build tree\n");
             break;
         }
 
+        int best_i = best.a;
+        int best_j = best.b;
+
         // update regions, histograms, counts, adjacency, similarity
         regions[best_i].x = min(regions[best_i].x, regions[best_j].x);
         regions[best_i].y = min(regions[best_i].y, regions[best_j].y);
@@ -406,10 +502,9 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
                         regions[best_i].y, regions[best_i].w, regions[best_i].h));
         }
 
-
-        for (i=0; i<75; i++) {
-            histogram[75*best_i + i] = (counts[best_i] * histogram[75*best_i + i]
-                    + counts[best_j] * histogram[75*best_j + i])/(counts[best_i] + counts[best_j]);
+        // Raw count histograms merge exactly.
+        for (i=0; i<HIST_BINS; i++) {
+            histogram[HIST_BINS*best_i + i] += histogram[HIST_BINS*best_j + i];
         }
         counts[best_i] += counts[best_j];
 
@@ -420,16 +515,19 @@ array_t *imlib_selective_search(image_t *src, float t, int min_size, float a1, f
         }
         adjacency[best_i * num_ccs + best_i]  = 0;
 
+        // Invalidate all queued pairs of both regions.
+        version[best_i]++;
+        version[best_j]++;
+
         for (i=0; i<num_ccs; i++) {
             if (adjacency[best_i * num_ccs + i] == 0) {
                 continue;
             }
-            float color_sim = a1 * color_similarity (histogram + 75 * i, histogram + 75 * best_i);
-            float size_sim  = a2 * size_similarity (counts[i], counts[best_i], size);
-            float fill_sim  = a3 * fill_similarity (regions + i, regions + best_i, counts[i], counts[best_i], size);
-            float similarity = color_sim + size_sim + fill_sim;
-            similarity_table[i * num_ccs + best_i] = similarity;
-            similarity_table[best_i * num_ccs + i] = similarity;
+            pair p = {
+                similarity(regions, histogram, counts, i, best_i, size, weights),
+                i, best_i, version[i], version[best_i]
+            };
+            pair_heap_push(&heap, &p, version);
         }
         --remaining;
     }
@@ -0,0 +1,287 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Multi-object tracker for generic detections.
+ */
+#include <float.h>
+#include "imlib.h"
+#include "fb_alloc.h"
+
+// Kalman filter noise in pixels. The center is modelled with a constant velocity (white
+// acceleration noise) and the size with a random walk, each axis filtered on its own.
+#define TRACKER_ACCELERATION_NOISE  (1.0f)
+#define TRACKER_SIZE_NOISE          (4.0f)
+#define TRACKER_MEASUREMENT_NOISE   (4.0f)
+#define TRACKER_INITIAL_VARIANCE    (100.0f)
+
+static void tracker_kalman_init(tracker_kalman_t *k, float x)
+{
+    k->x = x;
+    k->v = 0.0f;
+    k->p00 = TRACKER_MEASUREMENT_NOISE;
+    k->p01 = 0.0f;
+    k->p11 = TRACKER_INITIAL_VARIANCE;
+}
+
+static void tracker_kalman_predict(tracker_kalman_t *k)
+{
+    // x = F * x, P = F * P * F' + Q with F = [1 1; 0 1] and Q = q * [1/4 1/2; 1/2 1].
+    k->x += k->v;
+    k->p00 += (2.0f * k->p01) + k->p11 + (TRACKER_ACCELERATION_NOISE * 0.25f);
+    k->p01 += k->p11 + (TRACKER_ACCELERATION_NOISE * 0.5f);
+    k->p11 += TRACKER_ACCELERATION_NOISE;
+}
+
+static void tracker_kalman_correct(tracker_kalman_t *k, float z)
+{
+    // H = [1 0], so the gain is the first column of P over the innovation variance.
+    float s = k->p00 + TRACKER_MEASUREMENT_NOISE;
+    float k0 = k->p00 / s, k1 = k->p01 / s;
+    float y = z - k->x;
+    k->x += k0 * y;
+    k->v += k1 * y;
+    k->p11 -= k1 * k->p01;
+    k->p00 *= 1.0f - k0;
+    k->p01 *= 1.0f - k0;
+}
+
+static void tracker_size_correct(float *size, float *p, float z)
+{
+    float k = *p / (*p + TRACKER_MEASUREMENT_NOISE);
+    *size += k * (z - *size);
+    *p *= 1.0f - k;
+}
+
+void imlib_tracker_get_rect(tracker_track_t *track, rectangle_t *r)
+{
+    int w = IM_MAX(fast_roundf(track->w), 1);
+    int h = IM_MAX(fast_roundf(track->h), 1);
+    rectangle_init(r, fast_roundf(track->kx.x - (w / 2.0f)), fast_roundf(track->ky.x - (h / 2.0f)), w, h);
+}
+
+// Minimum cost assignment of every row of an n x m (n <= m) cost matrix using the
+// O(n^2 * m) shortest augmenting path form of the Hungarian method.
+static void tracker_hungarian(float *cost, int n, int m, int *row_col)
+{
+    float *u = fb_alloc0((n + 1) * sizeof(float), FB_ALLOC_NO_HINT);
+    float *v = fb_alloc0((m + 1) * sizeof(float), FB_ALLOC_NO_HINT);
+    float *min_v = fb_alloc((m + 1) * sizeof(float), FB_ALLOC_NO_HINT);
+    int *p = fb_alloc0((m + 1) * sizeof(int), FB_ALLOC_NO_HINT);
+    int *way = fb_alloc0((m + 1) * sizeof(int), FB_ALLOC_NO_HINT);
+    bool *used = fb_alloc((m + 1) * sizeof(bool), FB_ALLOC_NO_HINT);
+
+    // Columns and rows are 1-based below, column 0 holds the row being inserted.
+    for (int i = 1; i <= n; i++) {
+        p[0] = i;
+        int j0 = 0;
+
+        for (int j = 0; j <= m; j++) {
+            min_v[j] = FLT_MAX;
+            used[j] = false;
+        }
+
+        do {
+            used[j0] = true;
+            int i0 = p[j0], j1 = 0;
+            float delta = FLT_MAX;
+
+            for (int j = 1; j <= m; j++) {
+                if (!used[j]) {
+                    float cur = cost[((i0 - 1) * m) + (j - 1)] - u[i0] - v[j];
+
+                    if (cur < min_v[j]) {
+                        min_v[j] = cur;
+                        way[j] = j0;
+                    }
+
+                    if (min_v[j] < delta) {
+                        delta = min_v[j];
+                        j1 = j;
+                    }
+                }
+            }
+
+            for (int j = 0; j <= m; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    min_v[j] -= delta;
+                }
+            }
+
+            j0 = j1;
+        } while (p[j0]);
+
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0);
+    }
+
+    for (int j = 1; j <= m; j++) {
+        if (p[j]) {
+            row_col[p[j] - 1] = j - 1;
+        }
+    }
+
+    fb_free(); // used
+    fb_free(); // way
+    fb_free(); // p
+    fb_free(); // min_v
+    fb_free(); // v
+    fb_free(); // u
+}
+
+// Greedy assignment, best overlap first.
+static void tracker_greedy(float *cost, int n, int m, int *row_col)
+{
+    bool *col_used = fb_alloc0(m * sizeof(bool), FB_ALLOC_NO_HINT);
+
+    for (int i = 0; i < n; i++) {
+        row_col[i] = -1;
+    }
+
+    for (int k = IM_MIN(n, m); k > 0; k--) {
+        int best_i = -1, best_j = -1;
+        float best = FLT_MAX;
+
+        for (int i = 0; i < n; i++) {
+            if (row_col[i] < 0) {
+                for (int j = 0; j < m; j++) {
+                    if ((!col_used[j]) && (cost[(i * m) + j] < best)) {
+                        best = cost[(i * m) + j];
+                        best_i = i;
+                        best_j = j;
+                    }
+                }
+            }
+        }
+
+        row_col[best_i] = best_j;
+        col_used[best_j] = true;
+    }
+
+    fb_free(); // col_used
+}
+
+void imlib_tracker_init(tracker_t *tracker, int max_tracks, float min_iou, int min_hits, int max_misses, bool hungarian)
+{
+    memset(tracker, 0, sizeof(tracker_t));
+    tracker->max_tracks = IM_MIN(IM_MAX(max_tracks, 1), TRACKER_MAX_TRACKS);
+    tracker->min_iou = min_iou;
+    tracker->min_hits = min_hits;
+    tracker->max_misses = max_misses;
+    tracker->hungarian = hungarian;
+    tracker->next_id = 1;
+}
+
+void imlib_tracker_update(tracker_t *tracker, rectangle_t *dets, int dets_len)
+{
+    rectangle_t pred[TRACKER_MAX_TRACKS];
+
+    for (int i = 0; i < tracker->count; i++) {
+        tracker_track_t *track = &tracker->tracks[i];
+        tracker_kalman_predict(&track->kx);
+        tracker_kalman_predict(&track->ky);
+        track->pw += TRACKER_SIZE_NOISE;
+        track->ph += TRACKER_SIZE_NOISE;
+        track->match = -1;
+        imlib_tracker_get_rect(track, &pred[i]);
+    }
+
+    int *det_track = fb_alloc((dets_len + 1) * sizeof(int), FB_ALLOC_NO_HINT);
+
+    for (int j = 0; j < dets_len; j++) {
+        det_track[j] = -1;
+    }
+
+    if (tracker->count && dets_len) {
+        // The assignment solvers take the shorter side as rows.
+        bool transpose = tracker->count > dets_len;
+        int n = transpose ? dets_len : tracker->count;
+        int m = transpose ? tracker->count : dets_len;
+        float *cost = fb_alloc(n * m * sizeof(float), FB_ALLOC_NO_HINT);
+        int *row_col = fb_alloc(n * sizeof(int), FB_ALLOC_NO_HINT);
+
+        for (int i = 0; i < tracker->count; i++) {
+            for (int j = 0; j < dets_len; j++) {
+                float c = 1.0f - rectangle_iou(&pred[i], &dets[j]);
+                cost[transpose ? ((j * m) + i) : ((i * m) + j)] = c;
+            }
+        }
+
+        if (tracker->hungarian) {
+            tracker_hungarian(cost, n, m, row_col);
+        } else {
+            tracker_greedy(cost, n, m, row_col);
+        }
+
+        // Pairs that barely overlap are not a match even if the solver had to pair them.
+        for (int r = 0; r < n; r++) {
+            int c = row_col[r];
+            int i = transpose ? c : r, j = transpose ? r : c;
+
+            if ((c >= 0) && ((1.0f - cost[(r * m) + c]) >= IM_MAX(tracker->min_iou, FLT_MIN))) {
+                tracker->tracks[i].match = j;
+                det_track[j] = i;
+            }
+        }
+
+        fb_free(); // row_col
+        fb_free(); // cost
+    }
+
+    for (int i = 0; i < tracker->count; i++) {
+        tracker_track_t *track = &tracker->tracks[i];
+        track->age += 1;
+
+        if (track->match >= 0) {
+            rectangle_t *det = &dets[track->match];
+            tracker_kalman_correct(&track->kx, det->x + (det->w / 2.0f));
+            tracker_kalman_correct(&track->ky, det->y + (det->h / 2.0f));
+            tracker_size_correct(&track->w, &track->pw, det->w);
+            tracker_size_correct(&track->h, &track->ph, det->h);
+            track->hits += 1;
+            track->misses = 0;
+        } else {
+            track->misses += 1;
+        }
+    }
+
+    // Drop lost tracks, and tentative tracks on their first miss.
+    int count = 0;
+    for (int i = 0; i < tracker->count; i++) {
+        tracker_track_t *track = &tracker->tracks[i];
+        bool tentative = track->hits < (uint32_t) tracker->min_hits;
+
+        if ((track->misses <= tracker->max_misses) && (!(tentative && track->misses))) {
+            tracker->tracks[count++] = *track;
+        }
+    }
+    tracker->count = count;
+
+    for (int j = 0; j < dets_len; j++) {
+        if ((det_track[j] < 0) && (tracker->count < tracker->max_tracks)) {
+            tracker_track_t *track = &tracker->tracks[tracker->count++];
+            memset(track, 0, sizeof(tracker_track_t));
+            track->id = tracker->next_id++;
+            tracker_kalman_init(&track->kx, dets[j].x + (dets[j].w / 2.0f));
+            tracker_kalman_init(&track->ky, dets[j].y + (dets[j].h / 2.0f));
+            track->w = dets[j].w;
+            track->h = dets[j].h;
+            track->pw = TRACKER_MEASUREMENT_NOISE;
+            track->ph = TRACKER_MEASUREMENT_NOISE;
+            track->hits = 1;
+            track->match = j;
+        }
+    }
+
+    fb_free(); // det_track
+}
@@ -27,6 +27,7 @@
 #include "xalloc.h"
 #include "fb_alloc.h"
 #include "framebuffer.h"
+#include "display_diff.h"
 #include "py_assert.h"
 #include "py_helper.h"
 #include "py_image.h"
@@ -150,6 +151,57 @@ static const mp_obj_type_t py_lbp_type = {
     .print = py_lbp_print,
 };
 
+// LBP gallery: enrolled descriptors stored back to back so a probe can be
+// matched against all of them in a single pass.
+typedef struct _py_lbp_gallery_obj_t {
+    mp_obj_base_t base;
+    uint8_t *descs;
+    size_t count;
+} py_lbp_gallery_obj_t;
+
+static void py_lbp_gallery_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_lbp_gallery_obj_t *self = self_in;
+    mp_printf(print, "{\"size\":%d}", (int) self->count);
+}
+
+static mp_obj_t py_lbp_gallery_unary_op(mp_unary_op_t op, mp_obj_t self_in)
+{
+    py_lbp_gallery_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_LEN:
+            return MP_OBJ_NEW_SMALL_INT(self->count);
+
+        default:
+            return MP_OBJ_NULL; // op not supported
+    }
+}
+
+static mp_obj_t py_lbp_gallery_append(mp_obj_t self_in, mp_obj_t desc_obj)
+{
+    py_lbp_gallery_obj_t *self = self_in;
+    PY_ASSERT_TYPE(desc_obj, &py_lbp_type);
+    self->descs = xrealloc(self->descs, (self->count + 1) * LBP_DESC_SIZE);
+    memcpy(self->descs + (self->count * LBP_DESC_SIZE), ((py_lbp_obj_t *) desc_obj)->hist, LBP_DESC_SIZE);
+    self->count += 1;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(py_lbp_gallery_append_obj, py_lbp_gallery_append);
+
+static const mp_rom_map_elem_t py_lbp_gallery_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_append), MP_ROM_PTR(&py_lbp_gallery_append_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_lbp_gallery_locals_dict, py_lbp_gallery_locals_dict_table);
+
+static const mp_obj_type_t py_lbp_gallery_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_LBPGallery,
+    .print = py_lbp_gallery_print,
+    .unary_op = py_lbp_gallery_unary_op,
+    .locals_dict = (mp_obj_t) &py_lbp_gallery_locals_dict,
+};
+
 #endif // IMLIB_ENABLE_FIND_LBP
 
 // Keypoints Match Object /////////////////////////////////////////////////////
@@ -1311,8 +1363,14 @@ STATIC mp_obj_t py_image_draw_line(uint n_args, const mp_obj_t *args, mp_map_t *
         py_helper_keyword_color(arg_img, n_args, args, offset + 0, kw_args, -1); // White.
     int arg_thickness =
         py_helper_keyword_int(n_args, args, offset + 1, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_thickness), 1);
+    bool arg_antialias =
+        py_helper_keyword_int(n_args, args, offset + 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_antialias), false);
 
-    imlib_draw_line(arg_img, arg_x0, arg_y0, arg_x1, arg_y1, arg_c, arg_thickness);
+    if (arg_antialias && (arg_thickness == 1)) {
+        imlib_draw_line_aa(arg_img, arg_x0, arg_y0, arg_x1, arg_y1, arg_c);
+    } else {
+        imlib_draw_line(arg_img, arg_x0, arg_y0, arg_x1, arg_y1, arg_c, arg_thickness);
+    }
     return args[0];
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_line_obj, 2, py_image_draw_line);
@@ -1386,6 +1444,36 @@ STATIC mp_obj_t py_image_draw_ellipse(uint n_args, const mp_obj_t *args, mp_map_
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_ellipse_obj, 2, py_image_draw_ellipse);
 
+STATIC mp_obj_t py_image_draw_polygon(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    image_t *arg_img = py_helper_arg_to_image_mutable(args[0]);
+
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(args[1], &len, &items);
+
+    int arg_c =
+        py_helper_keyword_color(arg_img, n_args, args, 2, kw_args, -1); // White.
+    int arg_thickness =
+        py_helper_keyword_int(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_thickness), 1);
+    bool arg_fill =
+        py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_fill), false);
+
+    point_t *points = xalloc(len * sizeof(point_t));
+
+    for (size_t i = 0; i < len; i++) {
+        mp_obj_t *point;
+        mp_obj_get_array_fixed_n(items[i], 2, &point);
+        points[i].x = mp_obj_get_int(point[0]);
+        points[i].y = mp_obj_get_int(point[1]);
+    }
+
+    imlib_draw_polygon(arg_img, points, len, arg_c, arg_thickness, arg_fill);
+    xfree(points);
+    return args[0];
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_draw_polygon_obj, 2, py_image_draw_polygon);
+
 STATIC mp_obj_t py_image_draw_string(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
 {
     image_t *arg_img = py_helper_arg_to_image_mutable(args[0]);
@@ -1776,11 +1864,19 @@ STATIC mp_obj_t py_image_flood_fill(uint n_args, const mp_obj_t *args, mp_map_t
     image_t *arg_msk =
         py_helper_keyword_to_image_mutable_mask(n_args, args, offset + 5, kw_args);
 
+    rectangle_t arg_roi;
+    py_helper_keyword_rectangle_roi(arg_img, n_args, args, offset + 6, kw_args, &arg_roi);
+
     fb_alloc_mark();
-    imlib_flood_fill(arg_img, arg_x_off, arg_y_off,
-                     arg_seed_threshold, arg_floating_threshold,
-                     arg_c, arg_invert, clear_background, arg_msk);
+    int dropped = imlib_flood_fill(arg_img, arg_x_off, arg_y_off,
+                                   arg_seed_threshold, arg_floating_threshold,
+                                   arg_c, arg_invert, clear_background, arg_msk, &arg_roi);
     fb_alloc_free_till_mark();
+
+    if (dropped) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of memory, the fill is incomplete!"));
+    }
+
     return args[0];
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_flood_fill_obj, 2, py_image_flood_fill);
@@ -2729,8 +2825,13 @@ STATIC mp_obj_t py_image_cartoon(uint n_args, const mp_obj_t *args, mp_map_t *kw
         py_helper_keyword_to_image_mutable_mask(n_args, args, 3, kw_args);
 
     fb_alloc_mark();
-    imlib_cartoon_filter(arg_img, arg_seed_threshold, arg_floating_threshold, arg_msk);
+    int dropped = imlib_cartoon_filter(arg_img, arg_seed_threshold, arg_floating_threshold, arg_msk);
     fb_alloc_free_till_mark();
+
+    if (dropped) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("Out of memory, the fill is incomplete!"));
+    }
+
     return args[0];
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_cartoon_obj, 1, py_image_cartoon);
@@ -3933,6 +4034,42 @@ static mp_obj_t py_image_get_regression(uint n_args, const mp_obj_t *args, mp_ma
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_get_regression_obj, 2, py_image_get_regression);
 
+static mp_obj_t py_image_get_palette(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    image_t *arg_img = py_helper_arg_to_image_not_compressed(args[0]);
+    PY_ASSERT_TRUE_MSG((arg_img->pixfmt == PIXFORMAT_GRAYSCALE) || (arg_img->pixfmt == PIXFORMAT_RGB565),
+                       "Operation not supported on this image type.");
+
+    int arg_k = py_helper_keyword_int(n_args, args, 1, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_k), 4);
+    PY_ASSERT_TRUE_MSG((arg_k > 0) && (arg_k <= 256), "k must be between 1 and 256.");
+
+    rectangle_t roi;
+    py_helper_keyword_rectangle_roi(arg_img, n_args, args, 2, kw_args, &roi);
+
+    int arg_step = py_helper_keyword_int(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_step), 4);
+    PY_ASSERT_TRUE_MSG(arg_step > 0, "step must not be zero.");
+    uint32_t arg_seed = py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_seed), 1);
+
+    fb_alloc_mark();
+    int32_t *palette = fb_alloc(arg_k * 3 * sizeof(int32_t), FB_ALLOC_NO_HINT);
+    int k = imlib_kmeans_palette(arg_img, &roi, arg_k, arg_step, arg_seed, palette);
+    mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(k, NULL);
+
+    for (int i = 0; i < k; i++) {
+        if (arg_img->pixfmt == PIXFORMAT_GRAYSCALE) {
+            list->items[i] = mp_obj_new_int(palette[i]);
+        } else {
+            list->items[i] = mp_obj_new_tuple(3, (mp_obj_t []) {mp_obj_new_int(palette[(i * 3) + 0]),
+                                                                mp_obj_new_int(palette[(i * 3) + 1]),
+                                                                mp_obj_new_int(palette[(i * 3) + 2])});
+        }
+    }
+
+    fb_alloc_free_till_mark();
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_get_palette_obj, 1, py_image_get_palette);
+
 ///////////////
 // Find Methods
 ///////////////
@@ -4577,6 +4714,469 @@ static mp_obj_t py_image_find_blobs(uint n_args, const mp_obj_t *args, mp_map_t
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_blobs_obj, 2, py_image_find_blobs);
 
+// Blob Tracker Object ////////////////////////////////////////////////////////
+
+typedef struct py_blob_track_obj {
+    mp_obj_base_t base;
+    mp_obj_t id, x, y, w, h, cx, cy, vx, vy, age, misses, blob;
+} py_blob_track_obj_t;
+
+static void py_blob_track_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_blob_track_obj_t *self = self_in;
+    mp_printf(print,
+              "{\"id\":%d, \"x\":%d, \"y\":%d, \"w\":%d, \"h\":%d, \"cx\":%f, \"cy\":%f,"
+              " \"vx\":%f, \"vy\":%f, \"age\":%d, \"misses\":%d}",
+              mp_obj_get_int(self->id),
+              mp_obj_get_int(self->x),
+              mp_obj_get_int(self->y),
+              mp_obj_get_int(self->w),
+              mp_obj_get_int(self->h),
+              (double) mp_obj_get_float(self->cx),
+              (double) mp_obj_get_float(self->cy),
+              (double) mp_obj_get_float(self->vx),
+              (double) mp_obj_get_float(self->vy),
+              mp_obj_get_int(self->age),
+              mp_obj_get_int(self->misses));
+}
+
+mp_obj_t py_blob_track_id(mp_obj_t self_in)     { return ((py_blob_track_obj_t *) self_in)->id;     }
+mp_obj_t py_blob_track_x(mp_obj_t self_in)      { return ((py_blob_track_obj_t *) self_in)->x;      }
+mp_obj_t py_blob_track_y(mp_obj_t self_in)      { return ((py_blob_track_obj_t *) self_in)->y;      }
+mp_obj_t py_blob_track_w(mp_obj_t self_in)      { return ((py_blob_track_obj_t *) self_in)->w;      }
+mp_obj_t py_blob_track_h(mp_obj_t self_in)      { return ((py_blob_track_obj_t *) self_in)->h;      }
+mp_obj_t py_blob_track_cx(mp_obj_t self_in)     { return ((py_blob_track_obj_t *) self_in)->cx;     }
+mp_obj_t py_blob_track_cy(mp_obj_t self_in)     { return ((py_blob_track_obj_t *) self_in)->cy;     }
+mp_obj_t py_blob_track_vx(mp_obj_t self_in)     { return ((py_blob_track_obj_t *) self_in)->vx;     }
+mp_obj_t py_blob_track_vy(mp_obj_t self_in)     { return ((py_blob_track_obj_t *) self_in)->vy;     }
+mp_obj_t py_blob_track_age(mp_obj_t self_in)    { return ((py_blob_track_obj_t *) self_in)->age;    }
+mp_obj_t py_blob_track_misses(mp_obj_t self_in) { return ((py_blob_track_obj_t *) self_in)->misses; }
+mp_obj_t py_blob_track_blob(mp_obj_t self_in)   { return ((py_blob_track_obj_t *) self_in)->blob;   }
+mp_obj_t py_blob_track_rect(mp_obj_t self_in)
+{
+    return mp_obj_new_tuple(4, (mp_obj_t []) {((py_blob_track_obj_t *) self_in)->x,
+                                              ((py_blob_track_obj_t *) self_in)->y,
+                                              ((py_blob_track_obj_t *) self_in)->w,
+                                              ((py_blob_track_obj_t *) self_in)->h});
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_id_obj, py_blob_track_id);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_x_obj, py_blob_track_x);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_y_obj, py_blob_track_y);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_w_obj, py_blob_track_w);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_h_obj, py_blob_track_h);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_cx_obj, py_blob_track_cx);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_cy_obj, py_blob_track_cy);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_vx_obj, py_blob_track_vx);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_vy_obj, py_blob_track_vy);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_age_obj, py_blob_track_age);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_misses_obj, py_blob_track_misses);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_blob_obj, py_blob_track_blob);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_track_rect_obj, py_blob_track_rect);
+
+STATIC const mp_rom_map_elem_t py_blob_track_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_id),      MP_ROM_PTR(&py_blob_track_id_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_rect),    MP_ROM_PTR(&py_blob_track_rect_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_x),       MP_ROM_PTR(&py_blob_track_x_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_y),       MP_ROM_PTR(&py_blob_track_y_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_w),       MP_ROM_PTR(&py_blob_track_w_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_h),       MP_ROM_PTR(&py_blob_track_h_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_cx),      MP_ROM_PTR(&py_blob_track_cx_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_cy),      MP_ROM_PTR(&py_blob_track_cy_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_vx),      MP_ROM_PTR(&py_blob_track_vx_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_vy),      MP_ROM_PTR(&py_blob_track_vy_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_age),     MP_ROM_PTR(&py_blob_track_age_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_misses),  MP_ROM_PTR(&py_blob_track_misses_obj) },
+    { MP_ROM_QSTR(MP_QSTR_blob),    MP_ROM_PTR(&py_blob_track_blob_obj)   }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_blob_track_locals_dict, py_blob_track_locals_dict_table);
+
+static const mp_obj_type_t py_blob_track_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_blob_track,
+    .print = py_blob_track_print,
+    .locals_dict = (mp_obj_t) &py_blob_track_locals_dict
+};
+
+typedef struct py_blob_tracker_obj {
+    mp_obj_base_t base;
+    blob_tracker_t tracker;
+    mp_obj_t tracks; // tracks returned by the last update.
+} py_blob_tracker_obj_t;
+
+static const mp_obj_type_t py_blob_tracker_type;
+
+static mp_obj_t py_blob_tracker_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_max_tracks, ARG_max_distance, ARG_min_iou, ARG_max_misses };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_max_tracks,   MP_ARG_INT, {.u_int = 16} },
+        { MP_QSTR_max_distance, MP_ARG_INT, {.u_int = 32} },
+        { MP_QSTR_min_iou,      MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_max_misses,   MP_ARG_INT, {.u_int = 5} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    float min_iou = (args[ARG_min_iou].u_obj == mp_const_none) ? 0.1f : mp_obj_get_float(args[ARG_min_iou].u_obj);
+    PY_ASSERT_TRUE_MSG((1 <= args[ARG_max_tracks].u_int) && (args[ARG_max_tracks].u_int <= BLOB_TRACKER_MAX_TRACKS),
+                       "Error: 1 <= max_tracks <= 32!");
+    PY_ASSERT_TRUE_MSG((0.0f <= min_iou) && (min_iou <= 1.0f), "Error: 0.0 <= min_iou <= 1.0!");
+    PY_ASSERT_TRUE_MSG(args[ARG_max_distance].u_int >= 0, "Error: max_distance must be >= 0!");
+    PY_ASSERT_TRUE_MSG((args[ARG_max_misses].u_int >= 0) && (args[ARG_max_misses].u_int < UINT16_MAX),
+                       "Error: max_misses must be between 0 and 65534!");
+
+    py_blob_tracker_obj_t *self = m_new_obj(py_blob_tracker_obj_t);
+    self->base.type = &py_blob_tracker_type;
+    self->tracks = mp_obj_new_list(0, NULL);
+    imlib_blob_tracker_init(&self->tracker, args[ARG_max_tracks].u_int, args[ARG_max_distance].u_int,
+                            min_iou, args[ARG_max_misses].u_int);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void py_blob_tracker_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_blob_tracker_obj_t *self = self_in;
+    mp_printf(print, "{\"tracks\":%d, \"max_tracks\":%d, \"next_id\":%d}",
+              self->tracker.count, self->tracker.max_tracks, (int) self->tracker.next_id);
+}
+
+// Takes the list returned by find_blobs() (or a list of rect tuples) and returns
+// the live tracks. Tracks that are coasting on their prediction have no blob.
+static mp_obj_t py_blob_tracker_update(mp_obj_t self_in, mp_obj_t blobs_obj)
+{
+    py_blob_tracker_obj_t *self = self_in;
+    size_t blobs_len;
+    mp_obj_t *blobs;
+    mp_obj_get_array(blobs_obj, &blobs_len, &blobs);
+
+    fb_alloc_mark();
+    blob_tracker_detection_t *dets = fb_alloc((blobs_len * sizeof(blob_tracker_detection_t)) + 1, FB_ALLOC_NO_HINT);
+
+    for (size_t i = 0; i < blobs_len; i++) {
+        if (MP_OBJ_IS_TYPE(blobs[i], &py_blob_type)) {
+            py_blob_obj_t *blob = blobs[i];
+            rectangle_init(&dets[i].rect, mp_obj_get_int(blob->x), mp_obj_get_int(blob->y),
+                           mp_obj_get_int(blob->w), mp_obj_get_int(blob->h));
+            dets[i].cx = mp_obj_get_float(blob->cx);
+            dets[i].cy = mp_obj_get_float(blob->cy);
+        } else {
+            mp_obj_t *rect;
+            mp_obj_get_array_fixed_n(blobs[i], 4, &rect);
+            rectangle_init(&dets[i].rect, mp_obj_get_int(rect[0]), mp_obj_get_int(rect[1]),
+                           mp_obj_get_int(rect[2]), mp_obj_get_int(rect[3]));
+            dets[i].cx = dets[i].rect.x + (dets[i].rect.w / 2.0f);
+            dets[i].cy = dets[i].rect.y + (dets[i].rect.h / 2.0f);
+        }
+    }
+
+    imlib_blob_tracker_update(&self->tracker, dets, blobs_len);
+    fb_alloc_free_till_mark();
+
+    mp_obj_list_t *tracks = mp_obj_new_list(self->tracker.count, NULL);
+
+    for (int i = 0; i < self->tracker.count; i++) {
+        blob_track_t *track = &self->tracker.tracks[i];
+        py_blob_track_obj_t *o = m_new_obj(py_blob_track_obj_t);
+        o->base.type = &py_blob_track_type;
+        o->id = mp_obj_new_int(track->id);
+        o->x = mp_obj_new_int(track->rect.x);
+        o->y = mp_obj_new_int(track->rect.y);
+        o->w = mp_obj_new_int(track->rect.w);
+        o->h = mp_obj_new_int(track->rect.h);
+        o->cx = mp_obj_new_float(track->cx);
+        o->cy = mp_obj_new_float(track->cy);
+        o->vx = mp_obj_new_float(track->vx);
+        o->vy = mp_obj_new_float(track->vy);
+        o->age = mp_obj_new_int_from_uint(track->age);
+        o->misses = mp_obj_new_int(track->misses);
+        o->blob = (track->match >= 0) ? blobs[track->match] : mp_const_none;
+        tracks->items[i] = o;
+    }
+
+    self->tracks = tracks;
+    return tracks;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(py_blob_tracker_update_obj, py_blob_tracker_update);
+
+static mp_obj_t py_blob_tracker_tracks(mp_obj_t self_in)
+{
+    return ((py_blob_tracker_obj_t *) self_in)->tracks;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_tracker_tracks_obj, py_blob_tracker_tracks);
+
+// Returns the non-overlapping search windows where the tracked blobs are expected in
+// the next frame. Pass them as find_blobs() rois to only search around known objects.
+static mp_obj_t py_blob_tracker_rois(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    py_blob_tracker_obj_t *self = args[0];
+    image_t *arg_img = py_helper_arg_to_image_not_compressed(args[1]);
+    int arg_margin = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_margin), 8);
+    PY_ASSERT_TRUE_MSG(arg_margin >= 0, "Error: margin must be >= 0!");
+
+    rectangle_t rois[BLOB_TRACKER_MAX_TRACKS];
+    int rois_len = imlib_blob_tracker_rois(&self->tracker, arg_img, arg_margin, rois);
+    mp_obj_list_t *list = mp_obj_new_list(rois_len, NULL);
+
+    for (int i = 0; i < rois_len; i++) {
+        list->items[i] = mp_obj_new_tuple(4, (mp_obj_t []) {mp_obj_new_int(rois[i].x),
+                                                            mp_obj_new_int(rois[i].y),
+                                                            mp_obj_new_int(rois[i].w),
+                                                            mp_obj_new_int(rois[i].h)});
+    }
+
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_blob_tracker_rois_obj, 2, py_blob_tracker_rois);
+
+static mp_obj_t py_blob_tracker_reset(mp_obj_t self_in)
+{
+    py_blob_tracker_obj_t *self = self_in;
+    imlib_blob_tracker_init(&self->tracker, self->tracker.max_tracks, self->tracker.max_distance,
+                            self->tracker.min_iou, self->tracker.max_misses);
+    self->tracks = mp_obj_new_list(0, NULL);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_blob_tracker_reset_obj, py_blob_tracker_reset);
+
+STATIC const mp_rom_map_elem_t py_blob_tracker_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update),  MP_ROM_PTR(&py_blob_tracker_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_tracks),  MP_ROM_PTR(&py_blob_tracker_tracks_obj) },
+    { MP_ROM_QSTR(MP_QSTR_rois),    MP_ROM_PTR(&py_blob_tracker_rois_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_reset),   MP_ROM_PTR(&py_blob_tracker_reset_obj)  }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_blob_tracker_locals_dict, py_blob_tracker_locals_dict_table);
+
+static const mp_obj_type_t py_blob_tracker_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_BlobTracker,
+    .print = py_blob_tracker_print,
+    .make_new = py_blob_tracker_make_new,
+    .locals_dict = (mp_obj_t) &py_blob_tracker_locals_dict
+};
+
+// Object Tracker Object //////////////////////////////////////////////////////
+
+typedef struct py_track_obj {
+    mp_obj_base_t base;
+    mp_obj_t id, x, y, w, h, vx, vy, age, hits, misses, object;
+} py_track_obj_t;
+
+static void py_track_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_track_obj_t *self = self_in;
+    mp_printf(print,
+              "{\"id\":%d, \"x\":%d, \"y\":%d, \"w\":%d, \"h\":%d, \"vx\":%f, \"vy\":%f,"
+              " \"age\":%d, \"hits\":%d, \"misses\":%d}",
+              mp_obj_get_int(self->id),
+              mp_obj_get_int(self->x),
+              mp_obj_get_int(self->y),
+              mp_obj_get_int(self->w),
+              mp_obj_get_int(self->h),
+              (double) mp_obj_get_float(self->vx),
+              (double) mp_obj_get_float(self->vy),
+              mp_obj_get_int(self->age),
+              mp_obj_get_int(self->hits),
+              mp_obj_get_int(self->misses));
+}
+
+mp_obj_t py_track_id(mp_obj_t self_in)      { return ((py_track_obj_t *) self_in)->id;     }
+mp_obj_t py_track_x(mp_obj_t self_in)       { return ((py_track_obj_t *) self_in)->x;      }
+mp_obj_t py_track_y(mp_obj_t self_in)       { return ((py_track_obj_t *) self_in)->y;      }
+mp_obj_t py_track_w(mp_obj_t self_in)       { return ((py_track_obj_t *) self_in)->w;      }
+mp_obj_t py_track_h(mp_obj_t self_in)       { return ((py_track_obj_t *) self_in)->h;      }
+mp_obj_t py_track_vx(mp_obj_t self_in)      { return ((py_track_obj_t *) self_in)->vx;     }
+mp_obj_t py_track_vy(mp_obj_t self_in)      { return ((py_track_obj_t *) self_in)->vy;     }
+mp_obj_t py_track_age(mp_obj_t self_in)     { return ((py_track_obj_t *) self_in)->age;    }
+mp_obj_t py_track_hits(mp_obj_t self_in)    { return ((py_track_obj_t *) self_in)->hits;   }
+mp_obj_t py_track_misses(mp_obj_t self_in)  { return ((py_track_obj_t *) self_in)->misses; }
+mp_obj_t py_track_object(mp_obj_t self_in)  { return ((py_track_obj_t *) self_in)->object; }
+mp_obj_t py_track_rect(mp_obj_t self_in)
+{
+    return mp_obj_new_tuple(4, (mp_obj_t []) {((py_track_obj_t *) self_in)->x,
+                                              ((py_track_obj_t *) self_in)->y,
+                                              ((py_track_obj_t *) self_in)->w,
+                                              ((py_track_obj_t *) self_in)->h});
+}
+
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_id_obj, py_track_id);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_x_obj, py_track_x);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_y_obj, py_track_y);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_w_obj, py_track_w);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_h_obj, py_track_h);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_vx_obj, py_track_vx);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_vy_obj, py_track_vy);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_age_obj, py_track_age);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_hits_obj, py_track_hits);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_misses_obj, py_track_misses);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_object_obj, py_track_object);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_track_rect_obj, py_track_rect);
+
+STATIC const mp_rom_map_elem_t py_track_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_id),      MP_ROM_PTR(&py_track_id_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_rect),    MP_ROM_PTR(&py_track_rect_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_x),       MP_ROM_PTR(&py_track_x_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_y),       MP_ROM_PTR(&py_track_y_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_w),       MP_ROM_PTR(&py_track_w_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_h),       MP_ROM_PTR(&py_track_h_obj)      },
+    { MP_ROM_QSTR(MP_QSTR_vx),      MP_ROM_PTR(&py_track_vx_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_vy),      MP_ROM_PTR(&py_track_vy_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_age),     MP_ROM_PTR(&py_track_age_obj)    },
+    { MP_ROM_QSTR(MP_QSTR_hits),    MP_ROM_PTR(&py_track_hits_obj)   },
+    { MP_ROM_QSTR(MP_QSTR_misses),  MP_ROM_PTR(&py_track_misses_obj) },
+    { MP_ROM_QSTR(MP_QSTR_object),  MP_ROM_PTR(&py_track_object_obj) }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_track_locals_dict, py_track_locals_dict_table);
+
+static const mp_obj_type_t py_track_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_track,
+    .print = py_track_print,
+    .locals_dict = (mp_obj_t) &py_track_locals_dict
+};
+
+typedef struct py_tracker_obj {
+    mp_obj_base_t base;
+    tracker_t tracker;
+    mp_obj_t tracks; // tracks returned by the last update.
+} py_tracker_obj_t;
+
+static const mp_obj_type_t py_tracker_type;
+
+static mp_obj_t py_tracker_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_max_tracks, ARG_min_iou, ARG_min_hits, ARG_max_misses, ARG_hungarian };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_max_tracks,   MP_ARG_INT,  {.u_int = 32} },
+        { MP_QSTR_min_iou,      MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_min_hits,     MP_ARG_INT,  {.u_int = 3} },
+        { MP_QSTR_max_misses,   MP_ARG_INT,  {.u_int = 5} },
+        { MP_QSTR_hungarian,    MP_ARG_BOOL, {.u_bool = true} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    float min_iou = (args[ARG_min_iou].u_obj == mp_const_none) ? 0.3f : mp_obj_get_float(args[ARG_min_iou].u_obj);
+    PY_ASSERT_TRUE_MSG((1 <= args[ARG_max_tracks].u_int) && (args[ARG_max_tracks].u_int <= TRACKER_MAX_TRACKS),
+                       "Error: 1 <= max_tracks <= 64!");
+    PY_ASSERT_TRUE_MSG((0.0f <= min_iou) && (min_iou <= 1.0f), "Error: 0.0 <= min_iou <= 1.0!");
+    PY_ASSERT_TRUE_MSG(args[ARG_min_hits].u_int >= 1, "Error: min_hits must be >= 1!");
+    PY_ASSERT_TRUE_MSG((args[ARG_max_misses].u_int >= 0) && (args[ARG_max_misses].u_int < UINT16_MAX),
+                       "Error: max_misses must be between 0 and 65534!");
+
+    py_tracker_obj_t *self = m_new_obj(py_tracker_obj_t);
+    self->base.type = &py_tracker_type;
+    self->tracks = mp_obj_new_list(0, NULL);
+    imlib_tracker_init(&self->tracker, args[ARG_max_tracks].u_int, min_iou, args[ARG_min_hits].u_int,
+                       args[ARG_max_misses].u_int, args[ARG_hungarian].u_bool);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void py_tracker_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_tracker_obj_t *self = self_in;
+    mp_printf(print, "{\"tracks\":%d, \"max_tracks\":%d, \"next_id\":%d}",
+              self->tracker.count, self->tracker.max_tracks, (int) self->tracker.next_id);
+}
+
+// Takes a list of rect tuples or of objects with a rect() method (haar cascade, tf,
+// apriltag detections, ...) and returns the confirmed tracks.
+static mp_obj_t py_tracker_update(mp_obj_t self_in, mp_obj_t objects_obj)
+{
+    py_tracker_obj_t *self = self_in;
+    size_t objects_len;
+    mp_obj_t *objects;
+    mp_obj_get_array(objects_obj, &objects_len, &objects);
+
+    fb_alloc_mark();
+    rectangle_t *dets = fb_alloc((objects_len * sizeof(rectangle_t)) + 1, FB_ALLOC_NO_HINT);
+
+    for (size_t i = 0; i < objects_len; i++) {
+        mp_obj_t rect_obj = objects[i];
+
+        if ((!MP_OBJ_IS_TYPE(rect_obj, &mp_type_tuple)) && (!MP_OBJ_IS_TYPE(rect_obj, &mp_type_list))) {
+            rect_obj = mp_call_function_0(mp_load_attr(rect_obj, MP_QSTR_rect));
+        }
+
+        mp_obj_t *rect;
+        mp_obj_get_array_fixed_n(rect_obj, 4, &rect);
+        rectangle_init(&dets[i], mp_obj_get_int(rect[0]), mp_obj_get_int(rect[1]),
+                       mp_obj_get_int(rect[2]), mp_obj_get_int(rect[3]));
+    }
+
+    imlib_tracker_update(&self->tracker, dets, objects_len);
+    fb_alloc_free_till_mark();
+
+    mp_obj_t tracks = mp_obj_new_list(0, NULL);
+
+    for (int i = 0; i < self->tracker.count; i++) {
+        tracker_track_t *track = &self->tracker.tracks[i];
+
+        if (track->hits < (uint32_t) self->tracker.min_hits) {
+            continue;
+        }
+
+        rectangle_t r;
+        imlib_tracker_get_rect(track, &r);
+
+        py_track_obj_t *o = m_new_obj(py_track_obj_t);
+        o->base.type = &py_track_type;
+        o->id = mp_obj_new_int(track->id);
+        o->x = mp_obj_new_int(r.x);
+        o->y = mp_obj_new_int(r.y);
+        o->w = mp_obj_new_int(r.w);
+        o->h = mp_obj_new_int(r.h);
+        o->vx = mp_obj_new_float(track->kx.v);
+        o->vy = mp_obj_new_float(track->ky.v);
+        o->age = mp_obj_new_int_from_uint(track->age);
+        o->hits = mp_obj_new_int_from_uint(track->hits);
+        o->misses = mp_obj_new_int(track->misses);
+        o->object = (track->match >= 0) ? objects[track->match] : mp_const_none;
+        mp_obj_list_append(tracks, o);
+    }
+
+    self->tracks = tracks;
+    return tracks;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(py_tracker_update_obj, py_tracker_update);
+
+static mp_obj_t py_tracker_tracks(mp_obj_t self_in)
+{
+    return ((py_tracker_obj_t *) self_in)->tracks;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_tracker_tracks_obj, py_tracker_tracks);
+
+static mp_obj_t py_tracker_reset(mp_obj_t self_in)
+{
+    py_tracker_obj_t *self = self_in;
+    imlib_tracker_init(&self->tracker, self->tracker.max_tracks, self->tracker.min_iou, self->tracker.min_hits,
+                       self->tracker.max_misses, self->tracker.hungarian);
+    self->tracks = mp_obj_new_list(0, NULL);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_tracker_reset_obj, py_tracker_reset);
+
+STATIC const mp_rom_map_elem_t py_tracker_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update),  MP_ROM_PTR(&py_tracker_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_tracks),  MP_ROM_PTR(&py_tracker_tracks_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset),   MP_ROM_PTR(&py_tracker_reset_obj)  }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_tracker_locals_dict, py_tracker_locals_dict_table);
+
+static const mp_obj_type_t py_tracker_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_Tracker,
+    .print = py_tracker_print,
+    .make_new = py_tracker_make_new,
+    .locals_dict = (mp_obj_t) &py_tracker_locals_dict
+};
+
 #ifdef IMLIB_ENABLE_FIND_LINES
 static mp_obj_t py_image_find_lines(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
 {
@@ -5728,6 +6328,56 @@ static mp_obj_t py_image_find_displacement(uint n_args, const mp_obj_t *args, mp
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_displacement_obj, 2, py_image_find_displacement);
 #endif // IMLIB_ENABLE_FIND_DISPLACEMENT
 
+#ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+// Returns a (x, y, dx, dy, sad) tuple per block of the block_size grid in row-major order,
+// where (dx, dy) is how far the block at (x, y) moved since the previous image.
+static mp_obj_t py_image_find_motion_vectors(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    image_t *arg_img = py_helper_arg_to_image_mutable(args[0]);
+    image_t *arg_prev_img = py_helper_arg_to_image_mutable(args[1]);
+
+    PY_ASSERT_TRUE_MSG((arg_img->pixfmt == PIXFORMAT_GRAYSCALE) || (arg_img->pixfmt == PIXFORMAT_RGB565),
+                       "Image format is not supported!");
+    PY_ASSERT_TRUE_MSG((arg_prev_img->pixfmt == PIXFORMAT_GRAYSCALE) || (arg_prev_img->pixfmt == PIXFORMAT_RGB565),
+                       "Image format is not supported!");
+    PY_ASSERT_FALSE_MSG((arg_img->w != arg_prev_img->w) || (arg_img->h != arg_prev_img->h), "Image sizes differ!");
+
+    int block_size =
+        py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_block_size), 16);
+    PY_ASSERT_TRUE_MSG((block_size == 8) || (block_size == 16), "Error: block_size must be 8 or 16!");
+    int search_range =
+        py_helper_keyword_int(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_search_range), 7);
+    PY_ASSERT_TRUE_MSG((1 <= search_range) && (search_range <= 64), "Error: 1 <= search_range <= 64!");
+    // Blocks whose mean absolute difference to the same block of the previous image is at or
+    // under threshold are static and are not searched.
+    int threshold =
+        py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_threshold), 4);
+    PY_ASSERT_TRUE_MSG(threshold >= 0, "Error: threshold must be >= 0!");
+
+    int blocks_w = arg_img->w / block_size, blocks_h = arg_img->h / block_size;
+
+    fb_alloc_mark();
+    motion_vector_t *vectors = fb_alloc((blocks_w * blocks_h * sizeof(motion_vector_t)) + 1, FB_ALLOC_NO_HINT);
+    imlib_find_motion_vectors(arg_img, arg_prev_img, block_size, search_range, threshold, vectors);
+
+    mp_obj_t objects_list = mp_obj_new_list(0, NULL);
+
+    for (int y = 0, i = 0; y < blocks_h; y++) {
+        for (int x = 0; x < blocks_w; x++, i++) {
+            mp_obj_list_append(objects_list, mp_obj_new_tuple(5, (mp_obj_t []) {mp_obj_new_int(x * block_size),
+                                                                                mp_obj_new_int(y * block_size),
+                                                                                mp_obj_new_int(vectors[i].x),
+                                                                                mp_obj_new_int(vectors[i].y),
+                                                                                mp_obj_new_int(vectors[i].sad)}));
+        }
+    }
+
+    fb_alloc_free_till_mark();
+    return objects_list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_motion_vectors_obj, 2, py_image_find_motion_vectors);
+#endif // IMLIB_ENABLE_FIND_MOTION_VECTORS
+
 #ifdef IMLIB_FIND_TEMPLATE
 static mp_obj_t py_image_find_template(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
 {
@@ -5843,6 +6493,31 @@ static mp_obj_t py_image_find_lbp(uint n_args, const mp_obj_t *args, mp_map_t *k
     return lbp_obj;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_lbp_obj, 2, py_image_find_lbp);
+
+mp_obj_t py_image_load_lbp_gallery(uint n_args, const mp_obj_t *args)
+{
+    py_lbp_gallery_obj_t *gallery = m_new_obj(py_lbp_gallery_obj_t);
+    gallery->base.type = &py_lbp_gallery_type;
+    gallery->descs = NULL;
+    gallery->count = 0;
+
+    if (n_args > 0) {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(args[0], &len, &items);
+        if (len) {
+            gallery->descs = xalloc(len * LBP_DESC_SIZE);
+        }
+        for (size_t i = 0; i < len; i++) {
+            PY_ASSERT_TYPE(items[i], &py_lbp_type);
+            memcpy(gallery->descs + (i * LBP_DESC_SIZE), ((py_lbp_obj_t *) items[i])->hist, LBP_DESC_SIZE);
+        }
+        gallery->count = len;
+    }
+
+    return gallery;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_image_load_lbp_gallery_obj, 0, 1, py_image_load_lbp_gallery);
 #endif // IMLIB_ENABLE_FIND_LBP
 
 #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
@@ -5887,6 +6562,350 @@ static mp_obj_t py_image_find_keypoints(uint n_args, const mp_obj_t *args, mp_ma
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_keypoints_obj, 1, py_image_find_keypoints);
 #endif // IMLIB_ENABLE_FIND_KEYPOINTS
 
+#ifdef IMLIB_ENABLE_OPTICAL_FLOW
+// Lucas-Kanade Optical Flow Object
+typedef struct py_lk_flow_obj {
+    mp_obj_base_t base;
+    int levels, window, iterations, max_error;
+    lk_pyramid_t prev, next;
+    uint8_t *prev_buffer, *next_buffer;
+    size_t buffer_size;
+    int w, h; // Size of the frames the buffers were allocated for.
+    bool valid; // prev holds the last frame.
+} py_lk_flow_obj_t;
+
+static const mp_obj_type_t py_lk_flow_type;
+
+static mp_obj_t py_lk_flow_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_levels, ARG_window, ARG_iterations, ARG_max_error };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_levels,       MP_ARG_INT, {.u_int = 3} },
+        { MP_QSTR_window,       MP_ARG_INT, {.u_int = 15} },
+        { MP_QSTR_iterations,   MP_ARG_INT, {.u_int = 10} },
+        { MP_QSTR_max_error,    MP_ARG_INT, {.u_int = 10} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    PY_ASSERT_TRUE_MSG((1 <= args[ARG_levels].u_int) && (args[ARG_levels].u_int <= LK_MAX_LEVELS),
+                       "Error: 1 <= levels <= 4!");
+    PY_ASSERT_TRUE_MSG((3 <= args[ARG_window].u_int) && (args[ARG_window].u_int <= LK_MAX_WINDOW)
+                       && (args[ARG_window].u_int % 2), "Error: window must be odd and 3 <= window <= 31!");
+    PY_ASSERT_TRUE_MSG(args[ARG_iterations].u_int >= 1, "Error: iterations must be >= 1!");
+    PY_ASSERT_TRUE_MSG(args[ARG_max_error].u_int >= 0, "Error: max_error must be >= 0!");
+
+    py_lk_flow_obj_t *self = m_new_obj(py_lk_flow_obj_t);
+    memset(self, 0, sizeof(py_lk_flow_obj_t));
+    self->base.type = &py_lk_flow_type;
+    self->levels = args[ARG_levels].u_int;
+    self->window = args[ARG_window].u_int;
+    self->iterations = args[ARG_iterations].u_int;
+    self->max_error = args[ARG_max_error].u_int;
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void py_lk_flow_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_lk_flow_obj_t *self = self_in;
+    mp_printf(print, "{\"levels\":%d, \"window\":%d, \"iterations\":%d, \"max_error\":%d}",
+              self->levels, self->window, self->iterations, self->max_error);
+}
+
+// Builds the pyramid of img and tracks points from the previous frame into it. Points are
+// (x, y) tuples or the keypoints returned by find_keypoints(). Returns a list of
+// (x, y, dx, dy, status) tuples where (x, y) is the tracked position in img.
+static mp_obj_t py_lk_flow_track(mp_obj_t self_in, mp_obj_t img_obj, mp_obj_t points_obj)
+{
+    py_lk_flow_obj_t *self = self_in;
+    image_t *img = py_helper_arg_to_image_mutable(img_obj);
+    PY_ASSERT_TRUE_MSG((img->pixfmt == PIXFORMAT_GRAYSCALE) || (img->pixfmt == PIXFORMAT_RGB565),
+                       "Image format is not supported!");
+
+    size_t buffer_size = imlib_lk_pyramid_size(img->w, img->h, self->levels);
+
+    if ((buffer_size != self->buffer_size) || (img->w != self->w) || (img->h != self->h)) {
+        // Both pyramids live in frame buffer memory until close(), like alloc_extra_fb().
+        if (self->buffer_size) {
+            fb_alloc_free_till_mark_past_mark_permanent();
+            self->prev_buffer = NULL;
+            self->next_buffer = NULL;
+            self->buffer_size = 0;
+        }
+
+        self->valid = false;
+        fb_alloc_mark();
+        self->prev_buffer = fb_alloc(buffer_size * 2, FB_ALLOC_NO_HINT);
+        fb_alloc_mark_permanent();
+        self->next_buffer = self->prev_buffer + buffer_size;
+        self->buffer_size = buffer_size;
+        self->w = img->w;
+        self->h = img->h;
+    }
+
+    imlib_lk_pyramid_build(&self->next, img, self->levels, self->next_buffer);
+
+    size_t points_len = 0;
+    mp_obj_t *points = NULL;
+    float *prev_xy = NULL;
+
+    fb_alloc_mark();
+
+    #ifdef IMLIB_ENABLE_FIND_KEYPOINTS
+    if (MP_OBJ_IS_TYPE(points_obj, &py_kp_type)) {
+        array_t *kpts = py_kpts_obj(points_obj)->kpts;
+        points_len = array_length(kpts);
+        prev_xy = fb_alloc((points_len * 2 * sizeof(float)) + 1, FB_ALLOC_NO_HINT);
+
+        for (size_t i = 0; i < points_len; i++) {
+            kp_t *kp = array_at(kpts, i);
+            prev_xy[i * 2] = kp->x;
+            prev_xy[(i * 2) + 1] = kp->y;
+        }
+    } else
+    #endif // IMLIB_ENABLE_FIND_KEYPOINTS
+    {
+        mp_obj_get_array(points_obj, &points_len, &points);
+        prev_xy = fb_alloc((points_len * 2 * sizeof(float)) + 1, FB_ALLOC_NO_HINT);
+
+        for (size_t i = 0; i < points_len; i++) {
+            mp_obj_t *point;
+            mp_obj_get_array_fixed_n(points[i], 2, &point);
+            prev_xy[i * 2] = mp_obj_get_float(point[0]);
+            prev_xy[(i * 2) + 1] = mp_obj_get_float(point[1]);
+        }
+    }
+
+    float *next_xy = fb_alloc((points_len * 2 * sizeof(float)) + 1, FB_ALLOC_NO_HINT);
+    bool *status = fb_alloc0(points_len + 1, FB_ALLOC_NO_HINT);
+
+    if (self->valid) {
+        imlib_lk_flow(&self->prev, &self->next, self->window, self->iterations, self->max_error,
+                      points_len, prev_xy, next_xy, status);
+    } else {
+        memcpy(next_xy, prev_xy, points_len * 2 * sizeof(float));
+    }
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+
+    for (size_t i = 0; i < points_len; i++) {
+        mp_obj_list_append(list, mp_obj_new_tuple(5, (mp_obj_t []) {mp_obj_new_float(next_xy[i * 2]),
+                                                                     mp_obj_new_float(next_xy[(i * 2) + 1]),
+                                                                     mp_obj_new_float(next_xy[i * 2] - prev_xy[i * 2]),
+                                                                     mp_obj_new_float(next_xy[(i * 2) + 1] - prev_xy[(i * 2) + 1]),
+                                                                     mp_obj_new_bool(status[i])}));
+    }
+
+    fb_alloc_free_till_mark();
+
+    // The new frame becomes the previous frame of the next call.
+    lk_pyramid_t pyramid = self->prev;
+    uint8_t *buffer = self->prev_buffer;
+    self->prev = self->next;
+    self->prev_buffer = self->next_buffer;
+    self->next = pyramid;
+    self->next_buffer = buffer;
+    self->valid = true;
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(py_lk_flow_track_obj, py_lk_flow_track);
+
+static mp_obj_t py_lk_flow_reset(mp_obj_t self_in)
+{
+    ((py_lk_flow_obj_t *) self_in)->valid = false;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_lk_flow_reset_obj, py_lk_flow_reset);
+
+// Releases the pyramids. Frame buffer memory is a stack so, like dealloc_extra_fb(),
+// this must be called before anything allocated after the first track() is released.
+static mp_obj_t py_lk_flow_close(mp_obj_t self_in)
+{
+    py_lk_flow_obj_t *self = self_in;
+
+    if (self->buffer_size) {
+        fb_alloc_free_till_mark_past_mark_permanent();
+        self->prev_buffer = NULL;
+        self->next_buffer = NULL;
+        self->buffer_size = 0;
+        self->w = 0;
+        self->h = 0;
+    }
+
+    self->valid = false;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_lk_flow_close_obj, py_lk_flow_close);
+
+STATIC const mp_rom_map_elem_t py_lk_flow_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_track),   MP_ROM_PTR(&py_lk_flow_track_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset),   MP_ROM_PTR(&py_lk_flow_reset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close),   MP_ROM_PTR(&py_lk_flow_close_obj) }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_lk_flow_locals_dict, py_lk_flow_locals_dict_table);
+
+static const mp_obj_type_t py_lk_flow_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_LKFlow,
+    .print = py_lk_flow_print,
+    .make_new = py_lk_flow_make_new,
+    .locals_dict = (mp_obj_t) &py_lk_flow_locals_dict
+};
+#endif // IMLIB_ENABLE_OPTICAL_FLOW
+
+#ifdef IMLIB_ENABLE_BACKGROUND_MODEL
+// Background Model Object
+typedef struct py_bg_model_obj {
+    mp_obj_base_t base;
+    bg_model_t model;
+    float rate, threshold, min_sigma;
+    mp_obj_t mask; // mask returned when update() is not given one.
+    int count;
+} py_bg_model_obj_t;
+
+static const mp_obj_type_t py_bg_model_type;
+
+static mp_obj_t py_bg_model_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_rate, ARG_threshold, ARG_min_sigma, ARG_selective };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_rate,         MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_threshold,    MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_min_sigma,    MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_selective,    MP_ARG_BOOL, {.u_bool = true} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    py_bg_model_obj_t *self = m_new_obj(py_bg_model_obj_t);
+    memset(self, 0, sizeof(py_bg_model_obj_t));
+    self->base.type = &py_bg_model_type;
+    self->rate = (args[ARG_rate].u_obj == mp_const_none) ? 0.05f : mp_obj_get_float(args[ARG_rate].u_obj);
+    self->threshold = (args[ARG_threshold].u_obj == mp_const_none) ? 2.5f : mp_obj_get_float(args[ARG_threshold].u_obj);
+    self->min_sigma = (args[ARG_min_sigma].u_obj == mp_const_none) ? 4.0f : mp_obj_get_float(args[ARG_min_sigma].u_obj);
+    self->model.selective = args[ARG_selective].u_bool;
+    self->mask = mp_const_none;
+
+    PY_ASSERT_TRUE_MSG((0.0f < self->rate) && (self->rate <= 0.5f), "Error: 0.0 < rate <= 0.5!");
+    PY_ASSERT_TRUE_MSG((0.0f < self->threshold) && (self->threshold <= 64.0f), "Error: 0.0 < threshold <= 64.0!");
+    PY_ASSERT_TRUE_MSG((0.0f <= self->min_sigma) && (self->min_sigma <= 64.0f), "Error: 0.0 <= min_sigma <= 64.0!");
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static void py_bg_model_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_bg_model_obj_t *self = self_in;
+    mp_printf(print, "{\"w\":%d, \"h\":%d, \"rate\":%f, \"threshold\":%f, \"min_sigma\":%f, \"selective\":%d}",
+              self->model.w, self->model.h, (double) self->rate, (double) self->threshold,
+              (double) self->min_sigma, self->model.selective);
+}
+
+// Classifies img against the background and learns it in one pass. Returns a BINARY
+// foreground mask, written to mask if given. The first image only initializes the model.
+static mp_obj_t py_bg_model_update(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    py_bg_model_obj_t *self = args[0];
+    image_t *arg_img = py_helper_arg_to_image_mutable(args[1]);
+    PY_ASSERT_TRUE_MSG((arg_img->pixfmt == PIXFORMAT_GRAYSCALE) || (arg_img->pixfmt == PIXFORMAT_RGB565),
+                       "Image format is not supported!");
+
+    if ((arg_img->w != self->model.w) || (arg_img->h != self->model.h)) {
+        // The model lives in frame buffer memory until close(), like alloc_extra_fb().
+        if (self->model.mean) {
+            fb_alloc_free_till_mark_past_mark_permanent();
+            self->model.mean = NULL;
+            self->model.variance = NULL;
+        }
+
+        fb_alloc_mark();
+        uint16_t *buffer = fb_alloc(imlib_bg_model_size(arg_img->w, arg_img->h), FB_ALLOC_NO_HINT);
+        fb_alloc_mark_permanent();
+        imlib_bg_model_init(&self->model, arg_img->w, arg_img->h, self->rate, self->threshold,
+                            self->min_sigma, self->model.selective, buffer);
+        self->mask = mp_const_none;
+    }
+
+    mp_obj_t mask_obj = py_helper_keyword_object(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_mask), NULL);
+
+    if (!mask_obj) {
+        if (self->mask == mp_const_none) {
+            image_t mask;
+            mask.w = arg_img->w;
+            mask.h = arg_img->h;
+            mask.pixfmt = PIXFORMAT_BINARY;
+            mask.pixels = xalloc(image_size(&mask));
+            self->mask = py_image_from_struct(&mask);
+        }
+
+        mask_obj = self->mask;
+    }
+
+    image_t *arg_mask = py_helper_arg_to_image_mutable(mask_obj);
+    PY_ASSERT_TRUE_MSG(arg_mask->pixfmt == PIXFORMAT_BINARY, "Mask must be a binary image!");
+    PY_ASSERT_FALSE_MSG((arg_mask->w != arg_img->w) || (arg_mask->h != arg_img->h), "Mask size differs!");
+
+    self->count = imlib_bg_model_update(&self->model, arg_img, arg_mask);
+    return mask_obj;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_bg_model_update_obj, 2, py_bg_model_update);
+
+static mp_obj_t py_bg_model_count(mp_obj_t self_in)
+{
+    return mp_obj_new_int(((py_bg_model_obj_t *) self_in)->count);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_bg_model_count_obj, py_bg_model_count);
+
+static mp_obj_t py_bg_model_reset(mp_obj_t self_in)
+{
+    py_bg_model_obj_t *self = self_in;
+    self->model.valid = false;
+    self->count = 0;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_bg_model_reset_obj, py_bg_model_reset);
+
+// Releases the model. Frame buffer memory is a stack so, like dealloc_extra_fb(), this
+// must be called before anything allocated after the first update() is released.
+static mp_obj_t py_bg_model_close(mp_obj_t self_in)
+{
+    py_bg_model_obj_t *self = self_in;
+
+    if (self->model.mean) {
+        fb_alloc_free_till_mark_past_mark_permanent();
+        self->model.mean = NULL;
+        self->model.variance = NULL;
+        self->model.w = 0;
+        self->model.h = 0;
+        self->mask = mp_const_none;
+    }
+
+    self->model.valid = false;
+    self->count = 0;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_bg_model_close_obj, py_bg_model_close);
+
+STATIC const mp_rom_map_elem_t py_bg_model_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_update),  MP_ROM_PTR(&py_bg_model_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_count),   MP_ROM_PTR(&py_bg_model_count_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_reset),   MP_ROM_PTR(&py_bg_model_reset_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_close),   MP_ROM_PTR(&py_bg_model_close_obj)  }
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_bg_model_locals_dict, py_bg_model_locals_dict_table);
+
+static const mp_obj_type_t py_bg_model_type = {
+    { &mp_type_type },
+    .name  = MP_QSTR_BackgroundModel,
+    .print = py_bg_model_print,
+    .make_new = py_bg_model_make_new,
+    .locals_dict = (mp_obj_t) &py_bg_model_locals_dict
+};
+#endif // IMLIB_ENABLE_BACKGROUND_MODEL
+
 #ifdef IMLIB_ENABLE_BINARY_OPS
 static mp_obj_t py_image_find_edges(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
 {
@@ -5936,6 +6955,8 @@ static mp_obj_t py_image_find_hog(uint n_args, const mp_obj_t *args, mp_map_t *k
     py_helper_keyword_rectangle_roi(arg_img, n_args, args, 1, kw_args, &roi);
 
     int size = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_size), 8);
+    PY_ASSERT_TRUE_MSG(size > 0, "Cell size must be > 0!");
+    PY_ASSERT_TRUE_MSG((roi.w >= (size * 2)) && (roi.h >= (size * 2)), "ROI must be at least 2x2 cells!");
 
     fb_alloc_mark();
     imlib_find_hog(arg_img, &roi, size);
@@ -5944,6 +6965,104 @@ static mp_obj_t py_image_find_hog(uint n_args, const mp_obj_t *args, mp_map_t *k
     return args[0];
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_hog_obj, 1, py_image_find_hog);
+
+// Returns the HoG descriptor of the ROI (2x2 cell blocks, one cell stride, each
+// block L2-Hys normalized to 0-255), in the block order find_hog_objects() uses.
+static mp_obj_t py_image_hog_descriptor(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    image_t *arg_img = py_helper_arg_to_image_grayscale(args[0]);
+
+    rectangle_t roi;
+    py_helper_keyword_rectangle_roi(arg_img, n_args, args, 1, kw_args, &roi);
+
+    int size = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_size), 8);
+    PY_ASSERT_TRUE_MSG(size > 0, "Cell size must be > 0!");
+    PY_ASSERT_TRUE_MSG((roi.w >= (size * 2)) && (roi.h >= (size * 2)), "ROI must be at least 2x2 cells!");
+
+    hog_t hog;
+    int cells_w = roi.w / size, cells_h = roi.h / size;
+    mp_obj_t desc = mp_obj_new_bytearray(imlib_hog_descriptor_size(cells_w, cells_h), NULL);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(desc, &bufinfo, MP_BUFFER_WRITE);
+
+    fb_alloc_mark();
+    imlib_hog_compute(&hog, arg_img, &roi, size);
+    imlib_hog_descriptor(&hog, 0, 0, cells_w, cells_h, bufinfo.buf);
+    fb_alloc_free_till_mark();
+
+    return desc;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_hog_descriptor_obj, 1, py_image_hog_descriptor);
+
+// Linear SVM sliding window detector. The weights are applied to descriptors
+// scaled to [0, 1] (i.e. hog_descriptor() / 255) of window_size sized windows.
+static mp_obj_t py_image_find_hog_objects(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    image_t *arg_img = py_helper_arg_to_image_grayscale(args[0]);
+    float bias = mp_obj_get_float(args[2]);
+
+    int window[2] = {64, 128};
+    py_helper_keyword_int_array(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_window_size), window, 2);
+
+    int size = py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_size), 8);
+    PY_ASSERT_TRUE_MSG(size > 0, "Cell size must be > 0!");
+
+    float threshold = py_helper_keyword_float(n_args, args, 5, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_threshold), 0.0f);
+    float overlap = py_helper_keyword_float(n_args, args, 6, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_overlap), 0.3f);
+
+    rectangle_t roi;
+    py_helper_keyword_rectangle_roi(arg_img, n_args, args, 7, kw_args, &roi);
+
+    int cells_w = window[0] / size, cells_h = window[1] / size;
+    PY_ASSERT_TRUE_MSG((cells_w >= 2) && (cells_h >= 2), "Window must be at least 2x2 cells!");
+    PY_ASSERT_TRUE_MSG((roi.w >= window[0]) && (roi.h >= window[1]),
+            "Region of interest is smaller than detector window!");
+
+    int n_weights = imlib_hog_descriptor_size(cells_w, cells_h);
+
+    fb_alloc_mark();
+    float *weights;
+    mp_buffer_info_t bufinfo;
+
+    // Accepts array('f') weights as is, otherwise any sequence of numbers.
+    if (mp_get_buffer(args[1], &bufinfo, MP_BUFFER_READ) && (bufinfo.typecode == 'f')) {
+        PY_ASSERT_TRUE_MSG((int) (bufinfo.len / sizeof(float)) == n_weights, "Weights don't match the window size!");
+        weights = bufinfo.buf;
+    } else {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(args[1], &len, &items);
+        PY_ASSERT_TRUE_MSG((int) len == n_weights, "Weights don't match the window size!");
+        weights = fb_alloc(len * sizeof(float), FB_ALLOC_NO_HINT);
+        for (size_t i = 0; i < len; i++) {
+            weights[i] = mp_obj_get_float(items[i]);
+        }
+    }
+
+    hog_t hog;
+    list_t out;
+    imlib_hog_compute(&hog, arg_img, &roi, size);
+    imlib_hog_detect(&out, &hog, cells_w, cells_h, weights, bias, threshold, overlap);
+    fb_alloc_free_till_mark();
+
+    mp_obj_t objects_list = mp_obj_new_list(0, NULL);
+    while (list_size(&out)) {
+        find_hog_list_lnk_data_t lnk_data;
+        list_pop_front(&out, &lnk_data);
+
+        mp_obj_t det_obj[5] = {
+            mp_obj_new_int(lnk_data.rect.x),
+            mp_obj_new_int(lnk_data.rect.y),
+            mp_obj_new_int(lnk_data.rect.w),
+            mp_obj_new_int(lnk_data.rect.h),
+            mp_obj_new_float(lnk_data.score),
+        };
+        mp_obj_list_append(objects_list, mp_obj_new_tuple(5, det_obj));
+    }
+
+    return objects_list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_find_hog_objects_obj, 3, py_image_find_hog_objects);
 #endif // IMLIB_ENABLE_HOG
 
 #ifdef IMLIB_ENABLE_SELECTIVE_SEARCH
@@ -5953,8 +7072,8 @@ static mp_obj_t py_image_selective_search(uint n_args, const mp_obj_t *args, mp_
     int t = py_helper_keyword_int(n_args, args, 1, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_threshold), 500);
     int s = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_size), 20);
     float a1 = py_helper_keyword_float(n_args, args, 3, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_a1), 1.0f);
-    float a2 = py_helper_keyword_float(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_a1), 1.0f);
-    float a3 = py_helper_keyword_float(n_args, args, 5, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_a1), 1.0f);
+    float a2 = py_helper_keyword_float(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_a2), 1.0f);
+    float a3 = py_helper_keyword_float(n_args, args, 5, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_a3), 1.0f);
     array_t *proposals_array = imlib_selective_search(img, t, s, a1, a2, a3);
 
     // Add proposals to a new Python list...
@@ -6057,6 +7176,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_draw_rectangle),      MP_ROM_PTR(&py_image_draw_rectangle_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_circle),         MP_ROM_PTR(&py_image_draw_circle_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_ellipse),        MP_ROM_PTR(&py_image_draw_ellipse_obj)},
+    {MP_ROM_QSTR(MP_QSTR_draw_polygon),        MP_ROM_PTR(&py_image_draw_polygon_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_string),         MP_ROM_PTR(&py_image_draw_string_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_cross),          MP_ROM_PTR(&py_image_draw_cross_obj)},
     {MP_ROM_QSTR(MP_QSTR_draw_arrow),          MP_ROM_PTR(&py_image_draw_arrow_obj)},
@@ -6232,6 +7352,7 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_get_statistics),      MP_ROM_PTR(&py_image_get_statistics_obj)},
     {MP_ROM_QSTR(MP_QSTR_statistics),          MP_ROM_PTR(&py_image_get_statistics_obj)},
     {MP_ROM_QSTR(MP_QSTR_get_regression),      MP_ROM_PTR(&py_image_get_regression_obj)},
+    {MP_ROM_QSTR(MP_QSTR_get_palette),         MP_ROM_PTR(&py_image_get_palette_obj)},
     /* Find Methods */
     {MP_ROM_QSTR(MP_QSTR_find_blobs),          MP_ROM_PTR(&py_image_find_blobs_obj)},
 #ifdef IMLIB_ENABLE_FIND_LINES
@@ -6279,6 +7400,11 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
 #else
     {MP_ROM_QSTR(MP_QSTR_find_displacement),   MP_ROM_PTR(&py_func_unavailable_obj)},
 #endif
+#ifdef IMLIB_ENABLE_FIND_MOTION_VECTORS
+    {MP_ROM_QSTR(MP_QSTR_find_motion_vectors), MP_ROM_PTR(&py_image_find_motion_vectors_obj)},
+#else
+    {MP_ROM_QSTR(MP_QSTR_find_motion_vectors), MP_ROM_PTR(&py_func_unavailable_obj)},
+#endif
 #ifdef IMLIB_FIND_TEMPLATE
     {MP_ROM_QSTR(MP_QSTR_find_template),       MP_ROM_PTR(&py_image_find_template_obj)},
 #else
@@ -6303,8 +7429,12 @@ static const mp_rom_map_elem_t locals_dict_table[] = {
 #endif
 #ifdef IMLIB_ENABLE_HOG
     {MP_ROM_QSTR(MP_QSTR_find_hog),            MP_ROM_PTR(&py_image_find_hog_obj)},
+    {MP_ROM_QSTR(MP_QSTR_find_hog_objects),    MP_ROM_PTR(&py_image_find_hog_objects_obj)},
+    {MP_ROM_QSTR(MP_QSTR_hog_descriptor),      MP_ROM_PTR(&py_image_hog_descriptor_obj)},
 #else
     {MP_ROM_QSTR(MP_QSTR_find_hog),            MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_find_hog_objects),    MP_ROM_PTR(&py_func_unavailable_obj)},
+    {MP_ROM_QSTR(MP_QSTR_hog_descriptor),      MP_ROM_PTR(&py_func_unavailable_obj)},
 #endif
 #ifdef IMLIB_ENABLE_SELECTIVE_SEARCH
     {MP_ROM_QSTR(MP_QSTR_selective_search),    MP_ROM_PTR(&py_image_selective_search_obj)},
@@ -6857,6 +7987,23 @@ static mp_obj_t py_image_match_descriptor(uint n_args, const mp_obj_t *args, mp_
     mp_obj_t match_obj = mp_const_none;
     const mp_obj_type_t *desc1_type = mp_obj_get_type(args[0]);
     const mp_obj_type_t *desc2_type = mp_obj_get_type(args[1]);
+
+    #if defined(IMLIB_ENABLE_FIND_LBP)
+    if (desc2_type == &py_lbp_gallery_type) {
+        py_lbp_obj_t *lbp = ((py_lbp_obj_t*)args[0]);
+        py_lbp_gallery_obj_t *gallery = ((py_lbp_gallery_obj_t*)args[1]);
+        PY_ASSERT_TYPE(lbp, &py_lbp_type);
+
+        // Returns (index, distance) of the closest enrolled descriptor.
+        int distance;
+        int index = imlib_lbp_desc_match(lbp->hist, gallery->descs, gallery->count, &distance);
+        if (index < 0) {
+            return mp_const_none;
+        }
+        return mp_obj_new_tuple(2, (mp_obj_t []) {mp_obj_new_int(index), mp_obj_new_int(distance)});
+    }
+    #endif //IMLIB_ENABLE_FIND_LBP
+
     PY_ASSERT_TRUE_MSG((desc1_type == desc2_type), "Descriptors have different types!");
 
     if (0) {
@@ -6937,6 +8084,105 @@ static mp_obj_t py_image_match_descriptor(uint n_args, const mp_obj_t *args, mp_
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_match_descriptor_obj, 2, py_image_match_descriptor);
 #endif //IMLIB_ENABLE_DESCRIPTOR
 
+#if defined(IMLIB_ENABLE_FIND_KEYPOINTS)
+static mp_obj_t py_image_cluster_keypoints(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    py_kp_obj_t *kpts = py_kpts_obj(args[0]);
+    int arg_k = py_helper_keyword_int(n_args, args, 1, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_k), 2);
+    PY_ASSERT_TRUE_MSG(arg_k > 0, "k must be greater than zero.");
+    uint32_t arg_seed = py_helper_keyword_int(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_seed), 1);
+
+    array_t *clusters = cluster_kmeans(kpts->kpts, arg_k, arg_seed);
+    mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(array_length(clusters), NULL);
+
+    for (int i = 0; i < array_length(clusters); i++) {
+        cluster_t *cl = array_at(clusters, i);
+        list->items[i] = mp_obj_new_tuple(5, (mp_obj_t []) {mp_obj_new_int(cl->x),
+                                                            mp_obj_new_int(cl->y),
+                                                            mp_obj_new_int(cl->w),
+                                                            mp_obj_new_int(cl->h),
+                                                            mp_obj_new_int(array_length(cl->points))});
+    }
+
+    array_free(clusters);
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_cluster_keypoints_obj, 1, py_image_cluster_keypoints);
+#endif // IMLIB_ENABLE_FIND_KEYPOINTS
+
+// Memory sink that also records the windows it is sent.
+typedef struct py_display_sink {
+    display_sink_memory_t mem;
+    void (*set_window)(display_sink_t *sink, int x, int y, int w, int h);
+    mp_obj_t windows;
+} py_display_sink_t;
+
+static void py_display_sink_set_window(display_sink_t *sink, int x, int y, int w, int h)
+{
+    py_display_sink_t *py_sink = (py_display_sink_t *) sink;
+    mp_obj_list_append(py_sink->windows, mp_obj_new_tuple(4, (mp_obj_t []) {mp_obj_new_int(x),
+                                                                              mp_obj_new_int(y),
+                                                                              mp_obj_new_int(w),
+                                                                              mp_obj_new_int(h)}));
+    py_sink->set_window(sink, x, y, w, h);
+}
+
+// Sends the frames through the dirty rectangle display update into an in-memory
+// panel and returns the windows and pixel bytes sent for each frame. If given,
+// panel receives what the display shows after the last frame.
+static mp_obj_t py_image_display_diff(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    size_t n_frames;
+    mp_obj_t *frames;
+    mp_obj_get_array(args[0], &n_frames, &frames);
+    PY_ASSERT_TRUE_MSG(n_frames > 0, "Expected at least one frame!");
+
+    image_t *img = py_helper_arg_to_image_not_compressed(frames[0]);
+    PY_ASSERT_TRUE_MSG((img->pixfmt == PIXFORMAT_GRAYSCALE) || (img->pixfmt == PIXFORMAT_RGB565),
+                       "Operation not supported on this image type.");
+
+    int tile_size = py_helper_keyword_int(n_args, args, 1, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_tile_size), 16);
+    PY_ASSERT_TRUE_MSG(tile_size > 0, "Tile size must be > 0!");
+
+    image_t *panel = py_helper_keyword_to_image_mutable(n_args, args, 2, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_panel), NULL);
+    PY_ASSERT_TRUE_MSG((!panel) || ((panel->w == img->w) && (panel->h == img->h) && (panel->pixfmt == img->pixfmt)),
+                       "Panel doesn't match the frames!");
+
+    fb_alloc_mark();
+    display_diff_t diff;
+    display_diff_init(&diff, img->w, img->h, img->bpp, tile_size, tile_size,
+                      fb_alloc(img->w * img->h * img->bpp, FB_ALLOC_NO_HINT),
+                      fb_alloc(DISPLAY_DIFF_TILES(img->w, tile_size) * DISPLAY_DIFF_TILES(img->h, tile_size),
+                               FB_ALLOC_NO_HINT));
+
+    py_display_sink_t sink;
+    display_sink_memory_init(&sink.mem, panel ? panel->data : fb_alloc(img->w * img->h * img->bpp, FB_ALLOC_NO_HINT),
+                             img->w, img->h, img->bpp);
+    sink.set_window = sink.mem.base.set_window;
+    sink.mem.base.set_window = py_display_sink_set_window;
+
+    mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(n_frames, NULL);
+
+    for (size_t i = 0; i < n_frames; i++) {
+        image_t *frame = py_helper_arg_to_image_not_compressed(frames[i]);
+        PY_ASSERT_TRUE_MSG((frame->w == img->w) && (frame->h == img->h) && (frame->pixfmt == img->pixfmt),
+                           "Frames must have the same size and format!");
+
+        for (int y = 0; y < frame->h; y++) {
+            display_diff_row(&diff, y, frame->data + (y * frame->w * frame->bpp));
+        }
+
+        sink.windows = mp_obj_new_list(0, NULL);
+        display_sink_reset_stats(&sink.mem.base);
+        display_diff_flush(&diff, &sink.mem.base);
+        list->items[i] = mp_obj_new_tuple(2, (mp_obj_t []) {sink.windows, mp_obj_new_int(sink.mem.base.bytes)});
+    }
+
+    fb_alloc_free_till_mark();
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_image_display_diff_obj, 1, py_image_display_diff);
+
 #if defined(IMLIB_ENABLE_FIND_KEYPOINTS) && defined(IMLIB_ENABLE_IMAGE_FILE_IO)
 int py_image_descriptor_from_roi(image_t *img, const char *path, rectangle_t *roi)
 {
@@ -7016,6 +8262,18 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     #else
     {MP_ROM_QSTR(MP_QSTR_ImageIO),             MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
+    {MP_ROM_QSTR(MP_QSTR_BlobTracker),         MP_ROM_PTR(&py_blob_tracker_type) },
+    {MP_ROM_QSTR(MP_QSTR_Tracker),             MP_ROM_PTR(&py_tracker_type) },
+    #if defined(IMLIB_ENABLE_OPTICAL_FLOW)
+    {MP_ROM_QSTR(MP_QSTR_LKFlow),              MP_ROM_PTR(&py_lk_flow_type) },
+    #else
+    {MP_ROM_QSTR(MP_QSTR_LKFlow),              MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif
+    #if defined(IMLIB_ENABLE_BACKGROUND_MODEL)
+    {MP_ROM_QSTR(MP_QSTR_BackgroundModel),     MP_ROM_PTR(&py_bg_model_type) },
+    #else
+    {MP_ROM_QSTR(MP_QSTR_BackgroundModel),     MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif
     {MP_ROM_QSTR(MP_QSTR_binary_to_grayscale), MP_ROM_PTR(&py_image_binary_to_grayscale_obj)},
     {MP_ROM_QSTR(MP_QSTR_binary_to_rgb),       MP_ROM_PTR(&py_image_binary_to_rgb_obj)},
     {MP_ROM_QSTR(MP_QSTR_binary_to_lab),       MP_ROM_PTR(&py_image_binary_to_lab_obj)},
@@ -7038,6 +8296,11 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_yuv_to_lab),          MP_ROM_PTR(&py_image_yuv_to_lab_obj)},
     {MP_ROM_QSTR(MP_QSTR_Image),               MP_ROM_PTR(&py_image_load_image_obj)},
     {MP_ROM_QSTR(MP_QSTR_HaarCascade),         MP_ROM_PTR(&py_image_load_cascade_obj)},
+    #if defined(IMLIB_ENABLE_FIND_LBP)
+    {MP_ROM_QSTR(MP_QSTR_LBPGallery),          MP_ROM_PTR(&py_image_load_lbp_gallery_obj)},
+    #else
+    {MP_ROM_QSTR(MP_QSTR_LBPGallery),          MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif // IMLIB_ENABLE_FIND_LBP
     #if defined(IMLIB_ENABLE_DESCRIPTOR) && defined(IMLIB_ENABLE_IMAGE_FILE_IO)
     {MP_ROM_QSTR(MP_QSTR_load_descriptor),     MP_ROM_PTR(&py_image_load_descriptor_obj)},
     {MP_ROM_QSTR(MP_QSTR_save_descriptor),     MP_ROM_PTR(&py_image_save_descriptor_obj)},
@@ -7046,10 +8309,16 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     {MP_ROM_QSTR(MP_QSTR_save_descriptor),     MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif //IMLIB_ENABLE_DESCRIPTOR && IMLIB_ENABLE_IMAGE_FILE_IO
     #if defined(IMLIB_ENABLE_DESCRIPTOR)
-    {MP_ROM_QSTR(MP_QSTR_match_descriptor),    MP_ROM_PTR(&py_image_match_descriptor_obj)}
+    {MP_ROM_QSTR(MP_QSTR_match_descriptor),    MP_ROM_PTR(&py_image_match_descriptor_obj)},
+    #else
+    {MP_ROM_QSTR(MP_QSTR_match_descriptor),    MP_ROM_PTR(&py_func_unavailable_obj)},
+    #endif
+    #if defined(IMLIB_ENABLE_FIND_KEYPOINTS)
+    {MP_ROM_QSTR(MP_QSTR_cluster_keypoints),   MP_ROM_PTR(&py_image_cluster_keypoints_obj)},
     #else
-    {MP_ROM_QSTR(MP_QSTR_match_descriptor),    MP_ROM_PTR(&py_func_unavailable_obj)}
+    {MP_ROM_QSTR(MP_QSTR_cluster_keypoints),   MP_ROM_PTR(&py_func_unavailable_obj)},
     #endif
+    {MP_ROM_QSTR(MP_QSTR_display_diff),        MP_ROM_PTR(&py_image_display_diff_obj)}
 };
 
 STATIC MP_DEFINE_CONST_DICT(globals_dict, globals_dict_table);
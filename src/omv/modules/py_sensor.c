@@ -11,6 +11,7 @@
 #include <stdarg.h>
 #include "py/mphal.h"
 #include "py/runtime.h"
+#include "py/objlist.h"
 
 #if MICROPY_PY_SENSOR
 
@@ -108,7 +109,7 @@ static mp_obj_t py_sensor_flush()
     return mp_const_none;
 }
 
-static mp_obj_t py_sensor_snapshot(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+static mp_obj_t py_sensor_get_snapshot(uint32_t flags)
 {
 #if MICROPY_PY_IMU
     // +-10 degree dead-zone around pitch 90/270.
@@ -119,13 +120,53 @@ static mp_obj_t py_sensor_snapshot(uint n_args, const mp_obj_t *args, mp_map_t *
 #endif // MICROPY_PY_IMU
 
     mp_obj_t image = py_image(0, 0, 0, 0, 0);
-    int error = sensor.snapshot(&sensor, (image_t *) py_image_cobj(image), 0);
-    if (error != 0) {
+    int error = sensor.hdr.enabled
+        ? sensor_hdr_snapshot(&sensor, (image_t *) py_image_cobj(image), flags)
+        : sensor.snapshot(&sensor, (image_t *) py_image_cobj(image), flags);
+    if (error == SENSOR_ERROR_FRAME_NOT_READY) {
+        return mp_const_none;
+    } else if (error != 0) {
         sensor_raise_error(error);
     }
+
+    // Update the software AE/AWB controller (if enabled) before the next frame.
+    sensor_software_ae_update((image_t *) py_image_cobj(image));
+
+    // Return one image per region of interest. The regions are stored one after the other in
+    // the frame buffer and the first one is the frame buffer image.
+    if (sensor.n_rois) {
+        image_t *img = (image_t *) py_image_cobj(image);
+        mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(sensor.n_rois, NULL);
+        uint8_t *pixels = img->pixels;
+
+        for (int i = 0; i < sensor.n_rois; i++) {
+            image_t roi = {.w = sensor.rois[i].w, .h = sensor.rois[i].h, .pixfmt = img->pixfmt, .pixels = pixels};
+            list->items[i] = (i == 0) ? image : py_image(roi.w, roi.h, roi.pixfmt, 0, roi.pixels);
+            pixels += image_size(&roi);
+        }
+
+        return list;
+    }
+
     return image;
 }
 
+static mp_obj_t py_sensor_snapshot(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
+{
+    return py_sensor_get_snapshot(0);
+}
+
+static mp_obj_t py_sensor_snapshot_async()
+{
+    // Returns None if no new frame is ready yet, waits for it in single buffer mode.
+    return py_sensor_get_snapshot(SENSOR_SNAPSHOT_NO_WAIT);
+}
+
+static mp_obj_t py_sensor_frame_ready()
+{
+    return mp_obj_new_bool(sensor_frame_ready());
+}
+
 static mp_obj_t py_sensor_skip_frames(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
 {
     mp_map_elem_t *kw_arg = mp_map_lookup(kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_time), MP_MAP_LOOKUP);
@@ -247,6 +288,26 @@ static mp_obj_t py_sensor_get_framesize()
     return mp_obj_new_int(sensor.framesize);
 }
 
+// Returns the frame size auto_scale switches framesize to for frames with bpp bytes per pixel to
+// fit in size bytes and have less than max_pixels pixels, or None if no frame size fits.
+static mp_obj_t py_sensor_get_scaled_framesize(uint n_args, const mp_obj_t *args)
+{
+    int framesize = mp_obj_get_int(args[0]);
+    int bpp = mp_obj_get_int(args[1]);
+    int size = mp_obj_get_int(args[2]);
+    uint32_t max_pixels = (n_args > 3) ? mp_obj_get_int(args[3]) : UINT32_MAX;
+
+    if ((framesize <= FRAMESIZE_INVALID) || (framesize > FRAMESIZE_WQXGA2)) {
+        sensor_raise_error(SENSOR_ERROR_INVALID_FRAMESIZE);
+    }
+
+    PY_ASSERT_TRUE_MSG(bpp > 0, "Bytes per pixel must be > 0");
+    PY_ASSERT_TRUE_MSG(size >= 0, "Size must be >= 0");
+
+    framesize = sensor_get_scaled_framesize(framesize, bpp, size, max_pixels);
+    return (framesize == FRAMESIZE_INVALID) ? mp_const_none : mp_obj_new_int(framesize);
+}
+
 static mp_obj_t py_sensor_set_framerate(mp_obj_t framerate)
 {
     int error = sensor_set_framerate(mp_obj_get_int(framerate));
@@ -317,6 +378,89 @@ static mp_obj_t py_sensor_set_windowing(uint n_args, const mp_obj_t *args)
     return mp_const_none;
 }
 
+static mp_obj_t py_sensor_set_rois(mp_obj_t rois_obj)
+{
+    mp_obj_t *array;
+    mp_uint_t array_len;
+    mp_obj_get_array(rois_obj, &array_len, &array);
+
+    if (array_len > SENSOR_MAX_ROIS) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Too many ROIs!"));
+    }
+
+    rectangle_t rois[SENSOR_MAX_ROIS];
+
+    for (mp_uint_t i = 0; i < array_len; i++) {
+        mp_obj_t *roi;
+        mp_obj_get_array_fixed_n(array[i], 4, &roi);
+        rois[i].x = mp_obj_get_int(roi[0]);
+        rois[i].y = mp_obj_get_int(roi[1]);
+        rois[i].w = mp_obj_get_int(roi[2]);
+        rois[i].h = mp_obj_get_int(roi[3]);
+    }
+
+    int error = sensor_set_rois(rois, array_len);
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+
+    return mp_const_none;
+}
+
+static mp_obj_t py_sensor_get_rois()
+{
+    mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(sensor.n_rois, NULL);
+
+    for (int i = 0; i < sensor.n_rois; i++) {
+        list->items[i] = mp_obj_new_tuple(4, (mp_obj_t []) {mp_obj_new_int(sensor.rois[i].x),
+                                                            mp_obj_new_int(sensor.rois[i].y),
+                                                            mp_obj_new_int(sensor.rois[i].w),
+                                                            mp_obj_new_int(sensor.rois[i].h)});
+    }
+
+    return list;
+}
+
+static mp_obj_t py_sensor_set_linescan(mp_obj_t rows_obj, mp_obj_t height_obj)
+{
+    mp_obj_t *array;
+    mp_uint_t array_len;
+    mp_obj_get_array(rows_obj, &array_len, &array);
+
+    if (array_len > SENSOR_MAX_LINESCAN_ROWS) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Too many rows!"));
+    }
+
+    uint16_t rows[SENSOR_MAX_LINESCAN_ROWS];
+
+    for (mp_uint_t i = 0; i < array_len; i++) {
+        rows[i] = mp_obj_get_int(array[i]);
+    }
+
+    int error = sensor_set_linescan(rows, array_len, mp_obj_get_int(height_obj));
+    if (error != 0) {
+        sensor_raise_error(error);
+    }
+
+    return mp_const_none;
+}
+
+static mp_obj_t py_sensor_get_linescan_timestamps()
+{
+    int height = sensor.n_linescan_rows ? sensor.linescan_height : 0;
+    mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(height, NULL);
+
+    // Timestamps of the strip returned by the last snapshot.
+    if (height) {
+        uint32_t *timestamps = sensor_get_linescan_timestamps(framebuffer_get_buffer(framebuffer->head));
+        for (int i = 0; i < height; i++) {
+            list->items[i] = mp_obj_new_int_from_uint(timestamps[i]);
+        }
+    }
+
+    return list;
+}
+
 static mp_obj_t py_sensor_get_windowing()
 {
     if (sensor.framesize == FRAMESIZE_INVALID) {
@@ -570,6 +714,16 @@ static mp_obj_t py_sensor_disable_full_flush(uint n_args, const mp_obj_t *args)
     return mp_const_none;
 }
 
+static mp_obj_t py_sensor_auto_scale(uint n_args, const mp_obj_t *args)
+{
+    if (!n_args) {
+        return mp_obj_new_bool(sensor.auto_scale);
+    }
+
+    sensor.auto_scale = mp_obj_get_int(args[0]);
+    return mp_const_none;
+}
+
 static mp_obj_t py_sensor_set_special_effect(mp_obj_t sde)
 {
     if (sensor_set_special_effect(mp_obj_get_int(sde)) != 0) {
@@ -673,6 +827,69 @@ static mp_obj_t py_sensor_ioctl(uint n_args, const mp_obj_t *args)
             break;
         }
 
+        case IOCTL_GET_BUS_STATS: {
+            int count, bytes;
+            error = sensor_ioctl(request, &count, &bytes);
+            if (error == 0) {
+                ret_obj = mp_obj_new_tuple(2, (mp_obj_t []) {mp_obj_new_int(count), mp_obj_new_int(bytes)});
+            }
+            break;
+        }
+
+        case IOCTL_RESET_BUS_STATS: {
+            error = sensor_ioctl(request);
+            break;
+        }
+
+        case IOCTL_SET_SOFTWARE_AE: {
+            if (n_args >= 2) {
+                int target = (n_args < 3) ? 128 : mp_obj_get_int(args[2]);
+                int max_exposure_us = (n_args < 4) ? 0 : mp_obj_get_int(args[3]);
+                // GCC will not let us pass floats to ... so we have to pass float pointers instead.
+                float max_gain_db = (n_args < 5) ? 0.0f : mp_obj_get_float(args[4]);
+                error = sensor_ioctl(request, mp_obj_is_true(args[1]), target, max_exposure_us, &max_gain_db);
+            }
+            break;
+        }
+
+        case IOCTL_SET_SOFTWARE_AWB: {
+            if (n_args >= 2) {
+                int mode = (n_args < 3) ? SENSOR_AWB_GRAY_WORLD : mp_obj_get_int(args[2]);
+                error = sensor_ioctl(request, mp_obj_is_true(args[1]), mode);
+            }
+            break;
+        }
+
+        case IOCTL_SET_HDR: {
+            if (n_args >= 2) {
+                int long_exposure_us = (n_args < 3) ? 0 : mp_obj_get_int(args[2]);
+                int short_exposure_us = (n_args < 4) ? 0 : mp_obj_get_int(args[3]);
+                int skip = (n_args < 5) ? 1 : mp_obj_get_int(args[4]);
+                error = sensor_ioctl(request, mp_obj_is_true(args[1]), long_exposure_us, short_exposure_us, skip);
+            }
+            break;
+        }
+
+        case IOCTL_SET_CAPTURE_HISTOGRAM: {
+            if (n_args >= 2) {
+                error = sensor_ioctl(request, mp_obj_is_true(args[1]));
+            }
+            break;
+        }
+
+        case IOCTL_GET_CAPTURE_HISTOGRAM: {
+            uint32_t bins[SENSOR_CAPTURE_HIST_BINS];
+            error = sensor_ioctl(request, bins);
+            if (error == 0) {
+                mp_obj_list_t *list = (mp_obj_list_t *) mp_obj_new_list(SENSOR_CAPTURE_HIST_BINS, NULL);
+                for (int i = 0; i < SENSOR_CAPTURE_HIST_BINS; i++) {
+                    list->items[i] = mp_obj_new_int(bins[i]);
+                }
+                ret_obj = list;
+            }
+            break;
+        }
+
         case IOCTL_SET_TRIGGERED_MODE: {
             if (n_args >= 2) {
                 error = sensor_ioctl(request, mp_obj_get_int(args[1]));
@@ -879,6 +1096,26 @@ static mp_obj_t py_sensor_ioctl(uint n_args, const mp_obj_t *args)
 
         #endif // (OMV_ENABLE_HM01B0 == 1)
 
+        #if (OMV_ENABLE_VSENSOR == 1)
+        case IOCTL_VSENSOR_SET_SOURCE: {
+            if (n_args >= 2) {
+                int loop = (n_args < 3) ? true : mp_obj_is_true(args[2]);
+                int realtime = (n_args < 4) ? false : mp_obj_is_true(args[3]);
+                error = sensor_ioctl(request, mp_obj_str_get_str(args[1]), loop, realtime);
+            }
+            break;
+        }
+
+        case IOCTL_VSENSOR_GET_FRAME_INFO: {
+            int frame, timestamp_ms;
+            error = sensor_ioctl(request, &frame, &timestamp_ms);
+            if (error == 0) {
+                ret_obj = mp_obj_new_tuple(2, (mp_obj_t []) {mp_obj_new_int(frame), mp_obj_new_int(timestamp_ms)});
+            }
+            break;
+        }
+        #endif // (OMV_ENABLE_VSENSOR == 1)
+
         default: {
             sensor_raise_error(SENSOR_ERROR_CTL_UNSUPPORTED);
             break;
@@ -937,6 +1174,8 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_sleep_obj,               py_sensor_sl
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_shutdown_obj,            py_sensor_shutdown);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_flush_obj,               py_sensor_flush);
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_snapshot_obj, 0,        py_sensor_snapshot);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_snapshot_async_obj,      py_sensor_snapshot_async);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_frame_ready_obj,         py_sensor_frame_ready);
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(py_sensor_skip_frames_obj, 0,     py_sensor_skip_frames);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_width_obj,               py_sensor_width);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_height_obj,              py_sensor_height);
@@ -949,10 +1188,15 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_pixformat_obj,       py_sensor_se
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_pixformat_obj,       py_sensor_get_pixformat);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_framesize_obj,       py_sensor_set_framesize);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_framesize_obj,       py_sensor_get_framesize);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_sensor_get_scaled_framesize_obj, 3, 4, py_sensor_get_scaled_framesize);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_framerate_obj,       py_sensor_set_framerate);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_framerate_obj,       py_sensor_get_framerate);
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_sensor_set_windowing_obj, 1, 4, py_sensor_set_windowing);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_windowing_obj, py_sensor_get_windowing);
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_rois_obj, py_sensor_set_rois);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_rois_obj, py_sensor_get_rois);
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(py_sensor_set_linescan_obj, py_sensor_set_linescan);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_linescan_timestamps_obj, py_sensor_get_linescan_timestamps);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_gainceiling_obj,     py_sensor_set_gainceiling);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_contrast_obj,        py_sensor_set_contrast);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_brightness_obj,      py_sensor_set_brightness);
@@ -976,6 +1220,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_auto_rotation_obj,   py_sensor_ge
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_framebuffers_obj,    py_sensor_set_framebuffers);
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_sensor_get_framebuffers_obj,    py_sensor_get_framebuffers);
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_sensor_disable_full_flush_obj, 0, 1, py_sensor_disable_full_flush);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(py_sensor_auto_scale_obj, 0, 1, py_sensor_auto_scale);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_special_effect_obj,  py_sensor_set_special_effect);
 STATIC MP_DEFINE_CONST_FUN_OBJ_3(py_sensor_set_lens_correction_obj, py_sensor_set_lens_correction);
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_sensor_set_vsync_callback_obj,  py_sensor_set_vsync_callback);
@@ -1014,6 +1259,7 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_GC2145),              MP_OBJ_NEW_SMALL_INT(GC2145_ID)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_PAJ6100),             MP_OBJ_NEW_SMALL_INT(PAJ6100_ID)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_FROGEYE2020),         MP_OBJ_NEW_SMALL_INT(FROGEYE2020_ID)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_VSENSOR),             MP_OBJ_NEW_SMALL_INT(VSENSOR_ID)},
 
     // Special effects
     { MP_OBJ_NEW_QSTR(MP_QSTR_NORMAL),              MP_OBJ_NEW_SMALL_INT(SDE_NORMAL)},          /* Normal/No SDE */
@@ -1067,11 +1313,22 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_PALETTE_RAINBOW),     MP_OBJ_NEW_SMALL_INT(COLOR_PALETTE_RAINBOW)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_PALETTE_IRONBOW),     MP_OBJ_NEW_SMALL_INT(COLOR_PALETTE_IRONBOW)},
 
+    // Software AWB modes
+    { MP_OBJ_NEW_QSTR(MP_QSTR_AWB_GRAY_WORLD),      MP_OBJ_NEW_SMALL_INT(SENSOR_AWB_GRAY_WORLD)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_AWB_WHITE_PATCH),     MP_OBJ_NEW_SMALL_INT(SENSOR_AWB_WHITE_PATCH)},
+
     // IOCTLs
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_READOUT_WINDOW),            MP_OBJ_NEW_SMALL_INT(IOCTL_SET_READOUT_WINDOW)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_GET_READOUT_WINDOW),            MP_OBJ_NEW_SMALL_INT(IOCTL_GET_READOUT_WINDOW)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_TRIGGERED_MODE),            MP_OBJ_NEW_SMALL_INT(IOCTL_SET_TRIGGERED_MODE)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_GET_TRIGGERED_MODE),            MP_OBJ_NEW_SMALL_INT(IOCTL_GET_TRIGGERED_MODE)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_GET_BUS_STATS),                 MP_OBJ_NEW_SMALL_INT(IOCTL_GET_BUS_STATS)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_RESET_BUS_STATS),               MP_OBJ_NEW_SMALL_INT(IOCTL_RESET_BUS_STATS)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_SOFTWARE_AE),               MP_OBJ_NEW_SMALL_INT(IOCTL_SET_SOFTWARE_AE)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_SOFTWARE_AWB),              MP_OBJ_NEW_SMALL_INT(IOCTL_SET_SOFTWARE_AWB)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_CAPTURE_HISTOGRAM),         MP_OBJ_NEW_SMALL_INT(IOCTL_SET_CAPTURE_HISTOGRAM)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_GET_CAPTURE_HISTOGRAM),         MP_OBJ_NEW_SMALL_INT(IOCTL_GET_CAPTURE_HISTOGRAM)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_SET_HDR),                       MP_OBJ_NEW_SMALL_INT(IOCTL_SET_HDR)},
     #if (OMV_ENABLE_OV5640_AF == 1)
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_TRIGGER_AUTO_FOCUS),            MP_OBJ_NEW_SMALL_INT(IOCTL_TRIGGER_AUTO_FOCUS)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_PAUSE_AUTO_FOCUS),              MP_OBJ_NEW_SMALL_INT(IOCTL_PAUSE_AUTO_FOCUS)},
@@ -1099,6 +1356,10 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_HIMAX_MD_CLEAR),                MP_OBJ_NEW_SMALL_INT(IOCTL_HIMAX_MD_CLEAR)},
     { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_HIMAX_OSC_ENABLE),              MP_OBJ_NEW_SMALL_INT(IOCTL_HIMAX_OSC_ENABLE)},
     #endif
+    #if (OMV_ENABLE_VSENSOR == 1)
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_VSENSOR_SET_SOURCE),            MP_OBJ_NEW_SMALL_INT(IOCTL_VSENSOR_SET_SOURCE)},
+    { MP_OBJ_NEW_QSTR(MP_QSTR_IOCTL_VSENSOR_GET_FRAME_INFO),        MP_OBJ_NEW_SMALL_INT(IOCTL_VSENSOR_GET_FRAME_INFO)},
+    #endif
 
     // Framebuffer Sizes
     { MP_OBJ_NEW_QSTR(MP_QSTR_SINGLE_BUFFER),                       MP_OBJ_NEW_SMALL_INT(1)},
@@ -1113,6 +1374,8 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_shutdown),            (mp_obj_t)&py_sensor_shutdown_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_flush),               (mp_obj_t)&py_sensor_flush_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_snapshot),            (mp_obj_t)&py_sensor_snapshot_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_snapshot_async),      (mp_obj_t)&py_sensor_snapshot_async_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_frame_ready),         (mp_obj_t)&py_sensor_frame_ready_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_skip_frames),         (mp_obj_t)&py_sensor_skip_frames_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_width),               (mp_obj_t)&py_sensor_width_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_height),              (mp_obj_t)&py_sensor_height_obj },
@@ -1125,10 +1388,15 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_pixformat),       (mp_obj_t)&py_sensor_get_pixformat_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_framesize),       (mp_obj_t)&py_sensor_set_framesize_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_framesize),       (mp_obj_t)&py_sensor_get_framesize_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_get_scaled_framesize),(mp_obj_t)&py_sensor_get_scaled_framesize_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_framerate),       (mp_obj_t)&py_sensor_set_framerate_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_framerate),       (mp_obj_t)&py_sensor_get_framerate_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_windowing),       (mp_obj_t)&py_sensor_set_windowing_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_windowing),       (mp_obj_t)&py_sensor_get_windowing_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_set_rois),            (mp_obj_t)&py_sensor_set_rois_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_get_rois),            (mp_obj_t)&py_sensor_get_rois_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_set_linescan),        (mp_obj_t)&py_sensor_set_linescan_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_get_linescan_timestamps), (mp_obj_t)&py_sensor_get_linescan_timestamps_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_gainceiling),     (mp_obj_t)&py_sensor_set_gainceiling_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_contrast),        (mp_obj_t)&py_sensor_set_contrast_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_brightness),      (mp_obj_t)&py_sensor_set_brightness_obj },
@@ -1152,6 +1420,7 @@ STATIC const mp_map_elem_t globals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_framebuffers),    (mp_obj_t)&py_sensor_set_framebuffers_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_get_framebuffers),    (mp_obj_t)&py_sensor_get_framebuffers_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_disable_full_flush),  (mp_obj_t)&py_sensor_disable_full_flush_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_auto_scale),          (mp_obj_t)&py_sensor_auto_scale_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_special_effect),  (mp_obj_t)&py_sensor_set_special_effect_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_lens_correction), (mp_obj_t)&py_sensor_set_lens_correction_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_set_vsync_callback),  (mp_obj_t)&py_sensor_set_vsync_callback_obj },
@@ -118,6 +118,7 @@ int cambus_enable(cambus_t *bus, bool enable)
 
 int cambus_gencall(cambus_t *bus, uint8_t cmd)
 {
+    cambus_update_stats(bus, 1, 1);
     uint32_t xfer_flags = 0;
     nrfx_twi_xfer_desc_t desc = NRFX_TWI_XFER_DESC_TX(0x00, &cmd, 1);
     if (nrfx_twi_xfer(&bus->i2c, &desc, xfer_flags) != NRFX_SUCCESS) {
@@ -128,6 +129,7 @@ int cambus_gencall(cambus_t *bus, uint8_t cmd)
 
 int cambus_readb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t *reg_data)
 {
+    cambus_update_stats(bus, 2, 2);
     int ret = 0;
     slv_addr = slv_addr >> 1;
 
@@ -150,6 +152,7 @@ i2c_error:
 
 int cambus_writeb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t reg_data)
 {
+    cambus_update_stats(bus, 1, 2);
     int ret = 0;
     slv_addr = slv_addr >> 1;
 
@@ -172,6 +175,7 @@ i2c_error:
 
 int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int ret = 0;
     slv_addr = slv_addr >> 1;
     uint32_t xfer_flags = 0;
@@ -188,6 +192,7 @@ int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, ui
 
 int cambus_write_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int ret = 0;
     slv_addr = slv_addr >> 1;
     uint32_t xfer_flags = 0;
@@ -108,6 +108,9 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/common/, \
 	usbdbg.o                    \
 	tinyusb_debug.o             \
 	sensor_utils.o              \
+	sensor_ae.o                 \
+	sensor_hdr.o                \
+	display_diff.o              \
    )
 
 FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/,   \
@@ -121,14 +124,17 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/,   \
 	mt9m114.o                   \
 	lepton.o                    \
 	hm01b0.o                    \
+	vsensor.o                   \
    )
 
 FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	agast.o                     \
 	apriltag.o                  \
+	background.o                \
 	bayer.o                     \
 	binary.o                    \
 	blob.o                      \
+	blob_tracker.o              \
 	bmp.o                       \
 	clahe.o                     \
 	collections.o               \
@@ -161,6 +167,8 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	lsd.o                       \
 	mathop.o                    \
 	mjpeg.o                     \
+	motion.o                    \
+	optflow.o                   \
 	orb.o                       \
 	phasecorrelation.o          \
 	point.o                     \
@@ -174,6 +182,7 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	sincos_tab.o                \
 	stats.o                     \
 	stereo.o                    \
+	tracker.o                   \
 	template.o                  \
 	xyz_tab.o                   \
 	yuv.o                       \
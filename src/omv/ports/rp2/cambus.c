@@ -88,6 +88,7 @@ int cambus_enable(cambus_t *bus, bool enable)
 
 int cambus_gencall(cambus_t *bus, uint8_t cmd)
 {
+    cambus_update_stats(bus, 1, 1);
     int bytes = 0;
     bytes += i2c_write_timeout_us(bus->i2c, 0x00, &cmd, 1, false, I2C_TIMEOUT);
     return (bytes == 1) ? 0 : -1;
@@ -95,6 +96,7 @@ int cambus_gencall(cambus_t *bus, uint8_t cmd)
 
 int cambus_readb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr,  uint8_t *reg_data)
 {
+    cambus_update_stats(bus, 2, 2);
     int bytes = 0;
     slv_addr = slv_addr >> 1;
 
@@ -106,6 +108,7 @@ int cambus_readb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr,  uint8_t *re
 
 int cambus_writeb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t reg_data)
 {
+    cambus_update_stats(bus, 1, 2);
     int bytes = 0;
     slv_addr = slv_addr >> 1;
 
@@ -117,6 +120,7 @@ int cambus_writeb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t reg
 
 int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int bytes = 0;
     slv_addr = slv_addr >> 1;
     bool nostop = false;
@@ -132,6 +136,7 @@ int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, ui
 
 int cambus_write_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int bytes = 0;
     slv_addr = slv_addr >> 1;
     bool nostop = false;
@@ -102,7 +102,10 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/common/usbdbg.c
     ${TOP_DIR}/${OMV_DIR}/common/tinyusb_debug.c
     ${TOP_DIR}/${OMV_DIR}/common/sensor_utils.c
+    ${TOP_DIR}/${OMV_DIR}/common/sensor_ae.c
+    ${TOP_DIR}/${OMV_DIR}/common/sensor_hdr.c
     ${TOP_DIR}/${OMV_DIR}/common/factoryreset.c
+    ${TOP_DIR}/${OMV_DIR}/common/display_diff.c
 
     ${TOP_DIR}/${OMV_DIR}/sensors/ov2640.c
     ${TOP_DIR}/${OMV_DIR}/sensors/ov5640.c
@@ -115,12 +118,15 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/sensors/lepton.c
     ${TOP_DIR}/${OMV_DIR}/sensors/hm01b0.c
     ${TOP_DIR}/${OMV_DIR}/sensors/gc2145.c
+    ${TOP_DIR}/${OMV_DIR}/sensors/vsensor.c
 
     ${TOP_DIR}/${OMV_DIR}/imlib/agast.c
     ${TOP_DIR}/${OMV_DIR}/imlib/apriltag.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/background.c
     ${TOP_DIR}/${OMV_DIR}/imlib/bayer.c
     ${TOP_DIR}/${OMV_DIR}/imlib/binary.c
     ${TOP_DIR}/${OMV_DIR}/imlib/blob.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/blob_tracker.c
     ${TOP_DIR}/${OMV_DIR}/imlib/bmp.c
     ${TOP_DIR}/${OMV_DIR}/imlib/clahe.c
     ${TOP_DIR}/${OMV_DIR}/imlib/collections.c
@@ -153,6 +159,8 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/imlib/lsd.c
     ${TOP_DIR}/${OMV_DIR}/imlib/mathop.c
     ${TOP_DIR}/${OMV_DIR}/imlib/mjpeg.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/motion.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/optflow.c
     ${TOP_DIR}/${OMV_DIR}/imlib/orb.c
     ${TOP_DIR}/${OMV_DIR}/imlib/phasecorrelation.c
     ${TOP_DIR}/${OMV_DIR}/imlib/point.c
@@ -166,6 +174,7 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${TOP_DIR}/${OMV_DIR}/imlib/sincos_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/stats.c
     ${TOP_DIR}/${OMV_DIR}/imlib/stereo.c
+    ${TOP_DIR}/${OMV_DIR}/imlib/tracker.c
     ${TOP_DIR}/${OMV_DIR}/imlib/template.c
     ${TOP_DIR}/${OMV_DIR}/imlib/xyz_tab.c
     ${TOP_DIR}/${OMV_DIR}/imlib/yuv.c
@@ -210,6 +210,19 @@ static void dma_irq_handler()
 // This is the default snapshot function, which can be replaced in sensor_init functions.
 int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
 {
+    // In single buffer mode the capture stops after each frame and would be restarted into the
+    // buffer the last image points to, so wait for the frame instead.
+    if (MAIN_FB()->n_buffers == 1) {
+        flags &= ~SENSOR_SNAPSHOT_NO_WAIT;
+    }
+
+    // If a transfer is running and no frame has been received yet return without touching the
+    // current frame buffer, so the last image stays valid until the next one is ready.
+    if ((flags & SENSOR_SNAPSHOT_NO_WAIT)
+            && dma_channel_is_busy(DCMI_DMA_CHANNEL) && !framebuffer_get_head(FB_PEEK)) {
+        return SENSOR_ERROR_FRAME_NOT_READY;
+    }
+
     // Compress the framebuffer for the IDE preview.
     framebuffer_update_jpeg_buffer();
 
@@ -220,11 +233,9 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
     // Free the current FB head.
     framebuffer_free_current_buffer();
 
-    // Set framebuffer pixel format.
     if (sensor->pixformat == PIXFORMAT_INVALID) {
         return SENSOR_ERROR_INVALID_PIXFORMAT;
     }
-    MAIN_FB()->pixfmt = sensor->pixformat;
 
     vbuffer_t *buffer = framebuffer_get_head(FB_NO_FLAGS);
 
@@ -255,12 +266,18 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
     // Wait for the DMA to finish the transfer.
     for (mp_uint_t ticks = mp_hal_ticks_ms(); buffer == NULL;) {
         buffer = framebuffer_get_head(FB_NO_FLAGS);
+        // The transfer keeps running in the background and the frame is returned by a later call.
+        if ((buffer == NULL) && (flags & SENSOR_SNAPSHOT_NO_WAIT)) {
+            return SENSOR_ERROR_FRAME_NOT_READY;
+        }
         if ((mp_hal_ticks_ms() - ticks) > 3000) {
             sensor_abort();
             return SENSOR_ERROR_CAPTURE_TIMEOUT;
         }
     }
 
+    // Set framebuffer pixel format.
+    MAIN_FB()->pixfmt = sensor->pixformat;
     MAIN_FB()->w = MAIN_FB()->u;
     MAIN_FB()->h = MAIN_FB()->v;
 
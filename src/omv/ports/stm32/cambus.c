@@ -308,6 +308,7 @@ int cambus_enable(cambus_t *bus, bool enable)
 
 int cambus_gencall(cambus_t *bus, uint8_t cmd)
 {
+    cambus_update_stats(bus, 1, 1);
     if (HAL_I2C_Master_Transmit(bus->i2c, 0x00, &cmd, 1, I2C_TIMEOUT) != HAL_OK) {
         return -1;
     }
@@ -316,6 +317,7 @@ int cambus_gencall(cambus_t *bus, uint8_t cmd)
 
 int cambus_readb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t *reg_data)
 {
+    cambus_update_stats(bus, 2, 2);
     int ret = 0;
 
     if((HAL_I2C_Master_Transmit(bus->i2c, slv_addr, &reg_addr, 1, I2C_TIMEOUT) != HAL_OK)
@@ -327,6 +329,7 @@ int cambus_readb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t *reg
 
 int cambus_writeb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t reg_data)
 {
+    cambus_update_stats(bus, 1, 2);
     int ret=0;
     uint8_t buf[] = {reg_addr, reg_data};
 
@@ -338,6 +341,7 @@ int cambus_writeb(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint8_t reg
 
 int cambus_readb2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint8_t *reg_data)
 {
+    cambus_update_stats(bus, 1, 3);
     int ret=0;
     if (HAL_I2C_Mem_Read(bus->i2c, slv_addr, reg_addr,
                 I2C_MEMADD_SIZE_16BIT, reg_data, 1, I2C_TIMEOUT) != HAL_OK) {
@@ -348,6 +352,7 @@ int cambus_readb2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint8_t *r
 
 int cambus_writeb2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint8_t reg_data)
 {
+    cambus_update_stats(bus, 1, 3);
     int ret=0;
     if (HAL_I2C_Mem_Write(bus->i2c, slv_addr, reg_addr,
                 I2C_MEMADD_SIZE_16BIT, &reg_data, 1, I2C_TIMEOUT) != HAL_OK) {
@@ -358,6 +363,7 @@ int cambus_writeb2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint8_t r
 
 int cambus_readw(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint16_t *reg_data)
 {
+    cambus_update_stats(bus, 1, 3);
     int ret=0;
     if (HAL_I2C_Mem_Read(bus->i2c, slv_addr, reg_addr,
                 I2C_MEMADD_SIZE_8BIT, (uint8_t*) reg_data, 2, I2C_TIMEOUT) != HAL_OK) {
@@ -369,6 +375,7 @@ int cambus_readw(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint16_t *re
 
 int cambus_writew(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint16_t reg_data)
 {
+    cambus_update_stats(bus, 1, 3);
     int ret=0;
     reg_data = (reg_data >> 8) | (reg_data << 8);
     if (HAL_I2C_Mem_Write(bus->i2c, slv_addr, reg_addr,
@@ -380,6 +387,7 @@ int cambus_writew(cambus_t *bus, uint8_t slv_addr, uint8_t reg_addr, uint16_t re
 
 int cambus_readw2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint16_t *reg_data)
 {
+    cambus_update_stats(bus, 1, 4);
     int ret=0;
     if (HAL_I2C_Mem_Read(bus->i2c, slv_addr, reg_addr,
                 I2C_MEMADD_SIZE_16BIT, (uint8_t*) reg_data, 2, I2C_TIMEOUT) != HAL_OK) {
@@ -391,6 +399,7 @@ int cambus_readw2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint16_t *
 
 int cambus_writew2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint16_t reg_data)
 {
+    cambus_update_stats(bus, 1, 4);
     int ret=0;
     reg_data = (reg_data >> 8) | (reg_data << 8);
     if (HAL_I2C_Mem_Write(bus->i2c, slv_addr, reg_addr,
@@ -402,6 +411,7 @@ int cambus_writew2(cambus_t *bus, uint8_t slv_addr, uint16_t reg_addr, uint16_t
 
 int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int ret = 0;
     uint32_t xfer_flags = 0;
     if (flags & CAMBUS_XFER_NO_STOP) {
@@ -425,6 +435,7 @@ int cambus_read_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, ui
 
 int cambus_write_bytes(cambus_t *bus, uint8_t slv_addr, uint8_t *buf, int len, uint32_t flags)
 {
+    cambus_update_stats(bus, 1, len);
     int ret = 0;
     uint32_t xfer_flags = 0;
     if (flags & CAMBUS_XFER_NO_STOP) {
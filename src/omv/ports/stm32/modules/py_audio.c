@@ -19,6 +19,9 @@
 #include "runtime.h"
 
 #include "py_audio.h"
+#if MICROPY_PY_AUDIO_FEATURES
+#include "audio_features.h"
+#endif
 #include "py_assert.h"
 #include "py_helper.h"
 #include "pdm2pcm_glo.h"
@@ -524,6 +527,11 @@ static const mp_rom_map_elem_t globals_dict_table[] = {
     #if defined(AUDIO_SAI)
     { MP_ROM_QSTR(MP_QSTR_read_pdm),        MP_ROM_PTR(&py_audio_read_pdm_obj)       },
     #endif
+    #if MICROPY_PY_AUDIO_FEATURES
+    { MP_ROM_QSTR(MP_QSTR_Features),        MP_ROM_PTR(&py_audio_features_type)      },
+    { MP_ROM_QSTR(MP_QSTR_LOG_MEL),         MP_ROM_INT(AUDIO_FEATURES_LOG_MEL)       },
+    { MP_ROM_QSTR(MP_QSTR_MFCC),            MP_ROM_INT(AUDIO_FEATURES_MFCC)          },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(globals_dict, globals_dict_table);
@@ -11,4 +11,7 @@
 #ifndef __PY_AUDIO_H__
 #define __PY_AUDIO_H__
 void py_audio_deinit();
+#if MICROPY_PY_AUDIO_FEATURES
+extern const mp_obj_type_t py_audio_features_type;
+#endif
 #endif // __PY_AUDIO_H__
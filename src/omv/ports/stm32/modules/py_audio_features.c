@@ -0,0 +1,210 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Audio features Python module.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "py/obj.h"
+#include "py/runtime.h"
+#include "py/binary.h"
+#include "irq.h"
+
+#include "py_audio.h"
+#include "py_assert.h"
+#include "py_helper.h"
+#include "py_image.h"
+#include "xalloc.h"
+#include "audio_features.h"
+#include "omv_boardconfig.h"
+#include "common.h"
+
+#if MICROPY_PY_AUDIO && MICROPY_PY_AUDIO_FEATURES
+#define RAISE_OS_EXCEPTION(msg) mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT(msg))
+
+typedef struct _py_audio_features_obj {
+    mp_obj_base_t base;
+    audio_features_t af;
+    uint32_t n_frames;      // spectrogram height.
+    uint32_t n_valid;       // frames written since the last reset.
+    volatile bool new_frames;
+    int8_t *frame_buf;      // n_outputs scratch for the last computed frame.
+    int8_t *spectrogram;    // n_frames * af.n_outputs, oldest frame first.
+} py_audio_features_obj_t;
+
+static void py_audio_features_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind)
+{
+    py_audio_features_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "{\"type\":%s, \"frequency\":%u, \"frame_length\":%u, \"frame_step\":%u, "
+              "\"fft_length\":%u, \"outputs\":%u, \"frames\":%u}",
+              (self->af.cfg.type == AUDIO_FEATURES_MFCC) ? "\"mfcc\"" : "\"log_mel\"",
+              self->af.cfg.sample_rate, self->af.cfg.frame_length, self->af.cfg.frame_step,
+              self->af.cfg.fft_length, self->af.n_outputs, self->n_frames);
+}
+
+static mp_obj_t py_audio_features_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+    enum { ARG_type, ARG_frequency, ARG_frame_length, ARG_frame_step, ARG_fft_length,
+           ARG_n_mels, ARG_n_mfcc, ARG_fmin, ARG_fmax, ARG_scale, ARG_zero_point, ARG_n_frames };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_type,         MP_ARG_INT,  {.u_int = AUDIO_FEATURES_LOG_MEL} },
+        { MP_QSTR_frequency,    MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 16000} },
+        { MP_QSTR_frame_length, MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 480} },
+        { MP_QSTR_frame_step,   MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 320} },
+        { MP_QSTR_fft_length,   MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 512} },
+        { MP_QSTR_n_mels,       MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 40} },
+        { MP_QSTR_n_mfcc,       MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 13} },
+        { MP_QSTR_fmin,         MP_ARG_KW_ONLY | MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_fmax,         MP_ARG_KW_ONLY | MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_scale,        MP_ARG_KW_ONLY | MP_ARG_OBJ,  {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_zero_point,   MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 0} },
+        { MP_QSTR_n_frames,     MP_ARG_KW_ONLY | MP_ARG_INT,  {.u_int = 49} },
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    audio_features_config_t cfg = {
+        .type = args[ARG_type].u_int,
+        .sample_rate = args[ARG_frequency].u_int,
+        .frame_length = args[ARG_frame_length].u_int,
+        .frame_step = args[ARG_frame_step].u_int,
+        .fft_length = args[ARG_fft_length].u_int,
+        .n_mels = args[ARG_n_mels].u_int,
+        .n_mfcc = args[ARG_n_mfcc].u_int,
+        .fmin = (args[ARG_fmin].u_obj == mp_const_none) ? 20.0f : mp_obj_get_float(args[ARG_fmin].u_obj),
+        .fmax = (args[ARG_fmax].u_obj == mp_const_none) ?
+                (args[ARG_frequency].u_int / 2.0f) : mp_obj_get_float(args[ARG_fmax].u_obj),
+        // Log-mel energies span roughly [-14, 14] and MFCCs a few times that,
+        // the default scales map those ranges onto int8.
+        .scale = (args[ARG_scale].u_obj == mp_const_none) ?
+                 ((args[ARG_type].u_int == AUDIO_FEATURES_MFCC) ? 0.5f : 0.125f) :
+                 mp_obj_get_float(args[ARG_scale].u_obj),
+        .zero_point = args[ARG_zero_point].u_int,
+    };
+
+    if ((cfg.type != AUDIO_FEATURES_LOG_MEL) && (cfg.type != AUDIO_FEATURES_MFCC)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid feature type!"));
+    }
+
+    if (args[ARG_n_frames].u_int <= 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("n_frames must be > 0!"));
+    }
+
+    py_audio_features_obj_t *self = m_new_obj(py_audio_features_obj_t);
+    self->base.type = &py_audio_features_type;
+
+    if (audio_features_init(&self->af, &cfg) != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("Invalid audio features configuration!"));
+    }
+
+    self->n_frames = args[ARG_n_frames].u_int;
+    self->n_valid = 0;
+    self->new_frames = false;
+    self->frame_buf = xalloc(self->af.n_outputs);
+    self->spectrogram = xalloc0(self->n_frames * self->af.n_outputs);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Can be passed the PCM buffer from the audio streaming callback.
+static mp_obj_t py_audio_features_process(mp_obj_t self_in, mp_obj_t buf_in)
+{
+    py_audio_features_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t pcmbuf;
+    mp_get_buffer_raise(buf_in, &pcmbuf, MP_BUFFER_READ);
+
+    // The audio streaming callback passes a bytearray, which is read as int16 samples.
+    size_t typesize = mp_binary_get_size('@', pcmbuf.typecode, NULL);
+    if (((typesize != sizeof(int16_t)) && (typesize != sizeof(uint8_t)))
+    ||  (pcmbuf.len % sizeof(int16_t))) {
+        RAISE_OS_EXCEPTION("Expected a 16-bit PCM buffer!");
+    }
+
+    const int16_t *pcm = pcmbuf.buf;
+    size_t n_samples = pcmbuf.len / sizeof(int16_t);
+    uint32_t n_outputs = self->af.n_outputs;
+    uint32_t n = 0;
+
+    // NOTE: Nothing is allocated here so this is safe to call from the audio callback.
+    while (n_samples) {
+        bool frame_ready;
+        size_t consumed = audio_features_process(&self->af, pcm, n_samples, self->frame_buf, &frame_ready);
+        pcm += consumed;
+        n_samples -= consumed;
+
+        if (frame_ready) {
+            // Scroll the spectrogram up and append the new frame at the bottom.
+            memmove(self->spectrogram, self->spectrogram + n_outputs, (self->n_frames - 1) * n_outputs);
+            memcpy(self->spectrogram + ((self->n_frames - 1) * n_outputs), self->frame_buf, n_outputs);
+            self->n_valid = OMV_MIN(self->n_valid + 1, self->n_frames);
+            self->new_frames = true;
+            n += 1;
+        }
+    }
+
+    return mp_obj_new_int(n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(py_audio_features_process_obj, py_audio_features_process);
+
+// Returns the spectrogram as a GRAYSCALE image (one row per frame) that can be
+// passed directly to tf.classify(). Pixels are the int8 features offset by 128
+// so int8 models receive the exact quantized values.
+static mp_obj_t py_audio_features_spectrogram(mp_obj_t self_in)
+{
+    py_audio_features_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t size = self->n_frames * self->af.n_outputs;
+    uint8_t *pixels = xalloc(size);
+
+    uint32_t irq_state = disable_irq();
+    memcpy(pixels, self->spectrogram, size);
+    self->new_frames = false;
+    enable_irq(irq_state);
+
+    for (uint32_t i = 0; i < size; i++) {
+        pixels[i] ^= 0x80;
+    }
+
+    return py_image(self->af.n_outputs, self->n_frames, PIXFORMAT_GRAYSCALE, size, pixels);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_audio_features_spectrogram_obj, py_audio_features_spectrogram);
+
+static mp_obj_t py_audio_features_new_frames(mp_obj_t self_in)
+{
+    py_audio_features_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_bool(self->new_frames && (self->n_valid == self->n_frames));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_audio_features_new_frames_obj, py_audio_features_new_frames);
+
+static mp_obj_t py_audio_features_reset(mp_obj_t self_in)
+{
+    py_audio_features_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    audio_features_reset(&self->af);
+    memset(self->spectrogram, 0, self->n_frames * self->af.n_outputs);
+    self->n_valid = 0;
+    self->new_frames = false;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(py_audio_features_reset_obj, py_audio_features_reset);
+
+static const mp_rom_map_elem_t py_audio_features_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_process),         MP_ROM_PTR(&py_audio_features_process_obj)     },
+    { MP_ROM_QSTR(MP_QSTR_spectrogram),     MP_ROM_PTR(&py_audio_features_spectrogram_obj) },
+    { MP_ROM_QSTR(MP_QSTR_new_frames),      MP_ROM_PTR(&py_audio_features_new_frames_obj)  },
+    { MP_ROM_QSTR(MP_QSTR_reset),           MP_ROM_PTR(&py_audio_features_reset_obj)       },
+};
+
+STATIC MP_DEFINE_CONST_DICT(py_audio_features_locals_dict, py_audio_features_locals_dict_table);
+
+const mp_obj_type_t py_audio_features_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Features,
+    .print = py_audio_features_print,
+    .make_new = py_audio_features_make_new,
+    .locals_dict = (mp_obj_dict_t *) &py_audio_features_locals_dict,
+};
+#endif // MICROPY_PY_AUDIO && MICROPY_PY_AUDIO_FEATURES
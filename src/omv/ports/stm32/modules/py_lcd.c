@@ -21,6 +21,7 @@
 #include "py_image.h"
 #include "extmod/machine_i2c.h"
 #include "omv_boardconfig.h"
+#include "display_diff.h"
 #include STM32_HAL_H
 
 #if MICROPY_PY_LCD
@@ -42,6 +43,7 @@ static enum {
 } lcd_type = LCD_NONE;
 
 static bool lcd_triple_buffer = false;
+static bool lcd_dirty_rects = false;
 static bool lcd_bgr = false;
 
 static enum {
@@ -70,7 +72,12 @@ static int lcd_refresh = 0;
 static int lcd_intensity = 0;
 
 #ifdef OMV_SPI_LCD_CONTROLLER
+#define SPI_LCD_TILE_SIZE 16
+// Rows are only sent with DMA when they are a multiple of the DMA burst size.
+#define SPI_LCD_DMA_ROW_ALIGN 8
 static DMA_HandleTypeDef spi_tx_dma = {};
+static display_diff_t spi_lcd_diff = {};
+static display_sink_t spi_lcd_sink;
 
 static volatile enum {
     SPI_TX_CB_IDLE,
@@ -86,6 +93,8 @@ static void spi_config_deinit()
         HAL_SPI_Abort(OMV_SPI_LCD_CONTROLLER->spi);
         spi_tx_cb_state = SPI_TX_CB_IDLE;
         fb_alloc_free_till_mark_past_mark_permanent();
+    } else if (lcd_dirty_rects) {
+        fb_alloc_free_till_mark_past_mark_permanent();
     }
 
     spi_deinit(OMV_SPI_LCD_CONTROLLER);
@@ -104,7 +113,50 @@ static void spi_config_deinit()
 
 static void spi_lcd_callback(SPI_HandleTypeDef *hspi);
 
-static void spi_config_init(int w, int h, int refresh_rate, bool triple_buffer, bool bgr)
+static void spi_lcd_dma_init()
+{
+    dma_init(&spi_tx_dma, OMV_SPI_LCD_CONTROLLER->tx_dma_descr, DMA_MEMORY_TO_PERIPH, OMV_SPI_LCD_CONTROLLER->spi);
+    OMV_SPI_LCD_CONTROLLER->spi->hdmatx = &spi_tx_dma;
+    OMV_SPI_LCD_CONTROLLER->spi->hdmarx = NULL;
+#if defined(MCU_SERIES_H7)
+    spi_tx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+#else
+    spi_tx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+#endif
+    spi_tx_dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    spi_tx_dma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+    spi_tx_dma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    spi_tx_dma.Init.MemBurst = DMA_MBURST_INC4;
+#if defined(MCU_SERIES_H7)
+    spi_tx_dma.Init.PeriphBurst = DMA_PBURST_INC4;
+#else
+    spi_tx_dma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+#endif
+#if defined(MCU_SERIES_H7)
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PSIZE_Msk) | DMA_PDATAALIGN_WORD;
+#else
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PSIZE_Msk) | DMA_PDATAALIGN_HALFWORD;
+#endif
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_MSIZE_Msk) | DMA_MDATAALIGN_WORD;
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR & ~DMA_SxFCR_DMDIS_Msk) | DMA_FIFOMODE_ENABLE;
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR & ~DMA_SxFCR_FTH_Msk) | DMA_FIFO_THRESHOLD_FULL;
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_MBURST_Msk) | DMA_MBURST_INC4;
+#if defined(MCU_SERIES_H7)
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PBURST_Msk) | DMA_PBURST_INC4;
+#else
+    ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
+        (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PBURST_Msk) | DMA_PBURST_SINGLE;
+#endif
+}
+
+static void spi_config_init(int w, int h, int refresh_rate, bool triple_buffer, bool dirty_rects, bool bgr)
 {
     OMV_SPI_LCD_CONTROLLER->spi->Init.Mode = SPI_MODE_MASTER;
     OMV_SPI_LCD_CONTROLLER->spi->Init.Direction = SPI_DIRECTION_1LINE;
@@ -188,45 +240,18 @@ static void spi_config_init(int w, int h, int refresh_rate, bool triple_buffer,
             framebuffers[i] = (uint16_t *) fb_alloc0(w * h * sizeof(uint16_t), FB_ALLOC_CACHE_ALIGN);
         }
 
-        dma_init(&spi_tx_dma, OMV_SPI_LCD_CONTROLLER->tx_dma_descr, DMA_MEMORY_TO_PERIPH, OMV_SPI_LCD_CONTROLLER->spi);
-        OMV_SPI_LCD_CONTROLLER->spi->hdmatx = &spi_tx_dma;
-        OMV_SPI_LCD_CONTROLLER->spi->hdmarx = NULL;
-#if defined(MCU_SERIES_H7)
-        spi_tx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
-#else
-        spi_tx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
-#endif
-        spi_tx_dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
-        spi_tx_dma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
-        spi_tx_dma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
-        spi_tx_dma.Init.MemBurst = DMA_MBURST_INC4;
-#if defined(MCU_SERIES_H7)
-        spi_tx_dma.Init.PeriphBurst = DMA_PBURST_INC4;
-#else
-        spi_tx_dma.Init.PeriphBurst = DMA_PBURST_SINGLE;
-#endif
-#if defined(MCU_SERIES_H7)
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-                (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PSIZE_Msk) | DMA_PDATAALIGN_WORD;
-#else
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-                (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PSIZE_Msk) | DMA_PDATAALIGN_HALFWORD;
-#endif
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_MSIZE_Msk) | DMA_MDATAALIGN_WORD;
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR & ~DMA_SxFCR_DMDIS_Msk) | DMA_FIFOMODE_ENABLE;
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->FCR & ~DMA_SxFCR_FTH_Msk) | DMA_FIFO_THRESHOLD_FULL;
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_MBURST_Msk) | DMA_MBURST_INC4;
-#if defined(MCU_SERIES_H7)
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PBURST_Msk) | DMA_PBURST_INC4;
-#else
-        ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
-            (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PBURST_Msk) | DMA_PBURST_SINGLE;
-#endif
+        spi_lcd_dma_init();
+        fb_alloc_mark_permanent();
+    } else if (dirty_rects) {
+        fb_alloc_mark();
+
+        // Shadow copy of the panel memory, the first display() call sends everything.
+        uint8_t *shadow = fb_alloc(w * h * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+        uint8_t *dirty = fb_alloc(DISPLAY_DIFF_TILES(w, SPI_LCD_TILE_SIZE) *
+                                  DISPLAY_DIFF_TILES(h, SPI_LCD_TILE_SIZE), FB_ALLOC_NO_HINT);
+        display_diff_init(&spi_lcd_diff, w, h, sizeof(uint16_t), SPI_LCD_TILE_SIZE, SPI_LCD_TILE_SIZE, shadow, dirty);
+        display_sink_reset_stats(&spi_lcd_sink);
+
         fb_alloc_mark_permanent();
     }
 }
@@ -236,6 +261,60 @@ static bool spi_tx_cb_state_on[FRAMEBUFFER_COUNT] = {};
 static const uint8_t display_off[] = {0x28};
 static const uint8_t display_on[] = {0x29};
 static const uint8_t memory_write[] = {0x2C};
+static const uint8_t column_address_set[] = {0x2A};
+static const uint8_t page_address_set[] = {0x2B};
+
+static void spi_lcd_set_data_size(uint32_t data_size)
+{
+    OMV_SPI_LCD_CONTROLLER->spi->Init.DataSize = data_size;
+#if defined(MCU_SERIES_H7)
+    OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 = (OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 & ~SPI_CFG1_DSIZE_Msk) | data_size;
+#elif defined(MCU_SERIES_F7)
+    OMV_SPI_LCD_CONTROLLER->spi->Instance->CR2 = (OMV_SPI_LCD_CONTROLLER->spi->Instance->CR2 & ~SPI_CR2_DS_Msk) | data_size;
+#elif defined(MCU_SERIES_F4)
+    OMV_SPI_LCD_CONTROLLER->spi->Instance->CR1 = (OMV_SPI_LCD_CONTROLLER->spi->Instance->CR1 & ~SPI_CR1_DFF_Msk) | data_size;
+#endif
+}
+
+static void spi_lcd_write_command(const uint8_t *cmd, const uint8_t *args, size_t args_len)
+{
+    OMV_SPI_LCD_RS_ON();
+    OMV_SPI_LCD_CS_LOW();
+    HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, (uint8_t *) cmd, 1, HAL_MAX_DELAY);
+    OMV_SPI_LCD_CS_HIGH();
+    OMV_SPI_LCD_RS_OFF();
+
+    if (args_len) {
+        OMV_SPI_LCD_CS_LOW();
+        HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, (uint8_t *) args, args_len, HAL_MAX_DELAY);
+        OMV_SPI_LCD_CS_HIGH();
+    }
+}
+
+// Dirty rectangle sink: each window is selected with column/page address set
+// and filled with a memory write (rows are sent as 16-bit pixels).
+static void spi_lcd_sink_set_window(display_sink_t *sink, int x, int y, int w, int h)
+{
+    int x_end = x + w - 1, y_end = y + h - 1;
+
+    OMV_SPI_LCD_CS_HIGH(); // ends the previous memory write
+    spi_lcd_set_data_size(SPI_DATASIZE_8BIT);
+    spi_lcd_write_command(column_address_set, (uint8_t []) {x >> 8, x, x_end >> 8, x_end}, 4);
+    spi_lcd_write_command(page_address_set, (uint8_t []) {y >> 8, y, y_end >> 8, y_end}, 4);
+    spi_lcd_write_command(memory_write, NULL, 0);
+    spi_lcd_set_data_size(SPI_DATASIZE_16BIT);
+    OMV_SPI_LCD_CS_LOW();
+}
+
+static void spi_lcd_sink_write_row(display_sink_t *sink, const uint8_t *data, int w)
+{
+    HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, (uint8_t *) data, w, HAL_MAX_DELAY);
+}
+
+static display_sink_t spi_lcd_sink = {
+    .set_window = spi_lcd_sink_set_window,
+    .write_row = spi_lcd_sink_write_row,
+};
 
 static void spi_lcd_callback(SPI_HandleTypeDef *hspi)
 {
@@ -356,6 +435,125 @@ static void spi_lcd_draw_image_cb(int x_start, int x_end, int y_row, imlib_draw_
     HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, data->dst_row_override, lcd_width, HAL_MAX_DELAY);
 }
 
+// Row pipeline: while a row is sent by DMA the next one is drawn into the other row buffer.
+static uint16_t *spi_lcd_row_buffer[2] = {};
+static int spi_lcd_row_toggle = 0;
+
+static void spi_lcd_dma_row_wait()
+{
+    while (HAL_SPI_GetState(OMV_SPI_LCD_CONTROLLER->spi) != HAL_SPI_STATE_READY);
+}
+
+static void spi_lcd_dma_row(uint16_t *row)
+{
+    spi_lcd_dma_row_wait();
+#if defined(MCU_SERIES_F7) || defined(MCU_SERIES_H7)
+    SCB_CleanDCache_by_Addr((uint32_t *) row, lcd_width * sizeof(uint16_t));
+#endif
+    HAL_SPI_Transmit_DMA(OMV_SPI_LCD_CONTROLLER->spi, (uint8_t *) row, lcd_width);
+}
+
+static void spi_lcd_dma_draw_image_cb(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data)
+{
+    spi_lcd_dma_row(data->dst_row_override);
+    spi_lcd_row_toggle = !spi_lcd_row_toggle;
+    data->dst_row_override = spi_lcd_row_buffer[spi_lcd_row_toggle];
+}
+
+static void spi_lcd_display_dma(bool black, int y0, int y1,
+                                image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale, rectangle_t *roi,
+                                int rgb_channel, int alpha, const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint)
+{
+    image_t dst_img;
+    dst_img.w = lcd_width;
+    dst_img.h = lcd_height;
+    dst_img.pixfmt = PIXFORMAT_RGB565;
+
+    // Both buffers start zeroed and only the image columns are drawn so the left/right parts stay zero.
+    spi_lcd_row_buffer[0] = fb_alloc0(lcd_width * sizeof(uint16_t), FB_ALLOC_CACHE_ALIGN);
+    spi_lcd_row_buffer[1] = fb_alloc0(lcd_width * sizeof(uint16_t), FB_ALLOC_CACHE_ALIGN);
+    spi_lcd_row_toggle = 0;
+    dst_img.data = (uint8_t *) spi_lcd_row_buffer[0];
+
+    spi_lcd_dma_init();
+
+    spi_lcd_write_command(memory_write, NULL, 0);
+    spi_lcd_set_data_size(SPI_DATASIZE_16BIT);
+#if defined(MCU_SERIES_H7)
+    OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 =
+        (OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 & ~SPI_CFG1_FTHLV_Msk) | SPI_FIFO_THRESHOLD_08DATA;
+#endif
+    OMV_SPI_LCD_CS_LOW();
+
+    if (black) { // zero the whole image
+        for (int i = 0; i < lcd_height; i++) spi_lcd_dma_row(spi_lcd_row_buffer[0]);
+    } else {
+        // Zero the top rows from the second buffer since the first row of the image is drawn into
+        // the first buffer while the last zero row is still being transmitted.
+        for (int i = 0; i < y0; i++) spi_lcd_dma_row(spi_lcd_row_buffer[1]);
+
+        imlib_draw_image(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                         rgb_channel, alpha, color_palette, alpha_palette, hint | IMAGE_HINT_BLACK_BACKGROUND, spi_lcd_dma_draw_image_cb, dst_img.data);
+
+        // Zero the bottom rows (the current buffer is not being transmitted).
+        uint16_t *row = spi_lcd_row_buffer[spi_lcd_row_toggle];
+        if (y1 < lcd_height) memset(row, 0, lcd_width * sizeof(uint16_t));
+        for (int i = y1; i < lcd_height; i++) spi_lcd_dma_row(row);
+    }
+
+    spi_lcd_dma_row_wait();
+    OMV_SPI_LCD_CS_HIGH();
+
+#if defined(MCU_SERIES_H7)
+    OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 =
+        (OMV_SPI_LCD_CONTROLLER->spi->Instance->CFG1 & ~SPI_CFG1_FTHLV_Msk) | SPI_FIFO_THRESHOLD_01DATA;
+#endif
+    spi_lcd_set_data_size(SPI_DATASIZE_8BIT);
+    spi_lcd_write_command(display_on, NULL, 0);
+
+    // The DMA stream is only held while drawing, other modules share the SPI bus.
+    dma_deinit(OMV_SPI_LCD_CONTROLLER->tx_dma_descr);
+    OMV_SPI_LCD_CONTROLLER->spi->hdmatx = NULL;
+
+    fb_free();
+    fb_free();
+}
+
+static void spi_lcd_dirty_draw_image_cb(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data)
+{
+    display_diff_row(&spi_lcd_diff, y_row, data->dst_row_override);
+}
+
+// Composed rows (including the zero rows around the image) are only compared
+// against the shadow, then just the windows that changed are transmitted.
+static void spi_lcd_display_dirty(image_t *dst_img, bool black, int y0, int y1,
+                                  image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale, rectangle_t *roi,
+                                  int rgb_channel, int alpha, const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint)
+{
+    if (black) { // zero the whole image
+        for (int i = 0; i < lcd_height; i++) display_diff_row(&spi_lcd_diff, i, dst_img->data);
+    } else {
+        // Zero the top rows
+        for (int i = 0; i < y0; i++) display_diff_row(&spi_lcd_diff, i, dst_img->data);
+
+        imlib_draw_image(dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                         rgb_channel, alpha, color_palette, alpha_palette, hint | IMAGE_HINT_BLACK_BACKGROUND, spi_lcd_dirty_draw_image_cb, dst_img->data);
+
+        // Zero the bottom rows
+        if (y1 < lcd_height) memset(dst_img->data, 0, lcd_width * sizeof(uint16_t));
+        for (int i = y1; i < lcd_height; i++) display_diff_row(&spi_lcd_diff, i, dst_img->data);
+    }
+
+    display_sink_reset_stats(&spi_lcd_sink);
+
+    if (display_diff_flush(&spi_lcd_diff, &spi_lcd_sink)) {
+        OMV_SPI_LCD_CS_HIGH();
+        spi_lcd_set_data_size(SPI_DATASIZE_8BIT);
+    }
+
+    spi_lcd_write_command(display_on, NULL, 0);
+}
+
 static void spi_lcd_display(image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale, rectangle_t *roi,
                             int rgb_channel, int alpha, const uint16_t *color_palette, const uint8_t *alpha_palette, image_hint_t hint)
 {
@@ -367,7 +565,15 @@ static void spi_lcd_display(image_t *src_img, int dst_x_start, int dst_y_start,
     int x0, x1, y0, y1;
     bool black = !imlib_draw_image_rectangle(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi, alpha, alpha_palette, hint, &x0, &x1, &y0, &y1);
 
-    if (!lcd_triple_buffer) {
+    if (lcd_dirty_rects) {
+        dst_img.data = fb_alloc0(lcd_width * sizeof(uint16_t), FB_ALLOC_NO_HINT);
+        spi_lcd_display_dirty(&dst_img, black, y0, y1, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                              rgb_channel, alpha, color_palette, alpha_palette, hint);
+        fb_free();
+    } else if ((!lcd_triple_buffer) && (!(lcd_width % SPI_LCD_DMA_ROW_ALIGN))) {
+        spi_lcd_display_dma(black, y0, y1, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                            rgb_channel, alpha, color_palette, alpha_palette, hint);
+    } else if (!lcd_triple_buffer) {
         dst_img.data = fb_alloc0(lcd_width * sizeof(uint16_t), FB_ALLOC_NO_HINT);
 
         OMV_SPI_LCD_RS_ON();
@@ -1335,6 +1541,7 @@ STATIC mp_obj_t py_lcd_deinit()
     lcd_height = 0;
     lcd_type = LCD_NONE;
     lcd_triple_buffer = false;
+    lcd_dirty_rects = false;
     lcd_bgr = false;
     lcd_resolution = 0;
     lcd_refresh = 0;
@@ -1360,7 +1567,9 @@ STATIC mp_obj_t py_lcd_init(uint n_args, const mp_obj_t *args, mp_map_t *kw_args
             if ((refresh_rate < 30) || (120 < refresh_rate)) mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid Refresh Rate!"));
             bool triple_buffer = py_helper_keyword_int(n_args, args, 4, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_triple_buffer), false);
             bool bgr = py_helper_keyword_int(n_args, args, 5, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_bgr), false);
-            spi_config_init(w, h, refresh_rate, triple_buffer, bgr);
+            bool dirty_rects = py_helper_keyword_int(n_args, args, 6, kw_args, MP_OBJ_NEW_QSTR(MP_QSTR_dirty_rects), false);
+            if (triple_buffer && dirty_rects) mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Choose either triple_buffer or dirty_rects not both!"));
+            spi_config_init(w, h, refresh_rate, triple_buffer, dirty_rects, bgr);
             #ifdef OMV_SPI_LCD_BL_PIN
             spi_lcd_set_backlight(255); // to on state
             #endif
@@ -1368,6 +1577,7 @@ STATIC mp_obj_t py_lcd_init(uint n_args, const mp_obj_t *args, mp_map_t *kw_args
             lcd_height = h;
             lcd_type = LCD_SHIELD;
             lcd_triple_buffer = triple_buffer;
+            lcd_dirty_rects = dirty_rects;
             lcd_bgr = bgr;
             lcd_resolution = 0;
             lcd_refresh = refresh_rate;
@@ -1442,6 +1652,25 @@ STATIC mp_obj_t py_lcd_triple_buffer()
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_lcd_triple_buffer_obj, py_lcd_triple_buffer);
 
+STATIC mp_obj_t py_lcd_dirty_rects()
+{
+    if (lcd_type == LCD_NONE) return mp_const_none;
+    return mp_obj_new_int(lcd_dirty_rects);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_lcd_dirty_rects_obj, py_lcd_dirty_rects);
+
+// Returns the (windows, bytes) sent by the last display() call in dirty_rects mode.
+STATIC mp_obj_t py_lcd_dirty_stats()
+{
+    if (!lcd_dirty_rects) return mp_const_none;
+    #ifdef OMV_SPI_LCD_CONTROLLER
+    return mp_obj_new_tuple(2, (mp_obj_t []) {mp_obj_new_int(spi_lcd_sink.windows), mp_obj_new_int(spi_lcd_sink.bytes)});
+    #else
+    return mp_const_none;
+    #endif
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_lcd_dirty_stats_obj, py_lcd_dirty_stats);
+
 STATIC mp_obj_t py_lcd_bgr()
 {
     if (lcd_type == LCD_NONE) return mp_const_none;
@@ -1779,6 +2008,8 @@ STATIC const mp_rom_map_elem_t globals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_height),                  MP_ROM_PTR(&py_lcd_height_obj)                  },
     { MP_ROM_QSTR(MP_QSTR_type),                    MP_ROM_PTR(&py_lcd_type_obj)                    },
     { MP_ROM_QSTR(MP_QSTR_triple_buffer),           MP_ROM_PTR(&py_lcd_triple_buffer_obj)           },
+    { MP_ROM_QSTR(MP_QSTR_dirty_rects),             MP_ROM_PTR(&py_lcd_dirty_rects_obj)             },
+    { MP_ROM_QSTR(MP_QSTR_dirty_stats),             MP_ROM_PTR(&py_lcd_dirty_stats_obj)             },
     { MP_ROM_QSTR(MP_QSTR_bgr),                     MP_ROM_PTR(&py_lcd_bgr_obj)                     },
     { MP_ROM_QSTR(MP_QSTR_framesize),               MP_ROM_PTR(&py_lcd_framesize_obj)               },
     { MP_ROM_QSTR(MP_QSTR_refresh),                 MP_ROM_PTR(&py_lcd_refresh_obj)                 },
@@ -17,6 +17,7 @@
 #include "py_helper.h"
 #include "py_image.h"
 #include "omv_boardconfig.h"
+#include "display_diff.h"
 #include STM32_HAL_H
 
 #if MICROPY_PY_TV
@@ -412,9 +413,18 @@ static enum {
 } tv_type = TV_NONE;
 
 static bool tv_triple_buffer = false;
+static bool tv_dirty_rects = false;
 
 #ifdef OMV_SPI_LCD_CONTROLLER
+// Dirty rectangles are tracked on the converted YUV lines, a diff pixel is a
+// pair of TV pixels (3 bytes).
+#define TV_DIFF_PIXEL_SIZE 3
+#define TV_DIFF_WIDTH ((TV_WIDTH) / 2)
+#define TV_DIFF_TILE_WIDTH 8
+#define TV_DIFF_TILE_HEIGHT 16
 static DMA_HandleTypeDef spi_tx_dma = {};
+static display_diff_t spi_tv_diff = {};
+static display_sink_t spi_tv_sink;
 
 static volatile enum {
     SPI_TX_CB_IDLE,
@@ -428,6 +438,8 @@ static void spi_config_deinit()
         HAL_SPI_Abort(OMV_SPI_LCD_CONTROLLER->spi);
         spi_tx_cb_state = SPI_TX_CB_IDLE;
         fb_alloc_free_till_mark_past_mark_permanent();
+    } else if (tv_dirty_rects) {
+        fb_alloc_free_till_mark_past_mark_permanent();
     }
 
     spi_deinit(OMV_SPI_LCD_CONTROLLER);
@@ -445,7 +457,7 @@ static void spi_config_deinit()
 
 static void spi_tv_callback(SPI_HandleTypeDef *hspi);
 
-static void spi_config_init(bool triple_buffer)
+static void spi_config_init(bool triple_buffer, bool dirty_rects)
 {
     OMV_SPI_LCD_CONTROLLER->spi->Init.Mode = SPI_MODE_MASTER;
     OMV_SPI_LCD_CONTROLLER->spi->Init.Direction = SPI_DIRECTION_2LINES;
@@ -540,6 +552,18 @@ static void spi_config_init(bool triple_buffer)
         ((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR =
             (((DMA_Stream_TypeDef *) spi_tx_dma.Instance)->CR & ~DMA_SxCR_PBURST_Msk) | DMA_PBURST_SINGLE;
 #endif
+        fb_alloc_mark_permanent();
+    } else if (dirty_rects) {
+        fb_alloc_mark();
+
+        // Shadow copy of the SPI RAM picture lines, the first display() call sends everything.
+        uint8_t *shadow = fb_alloc(PICLINE_LENGTH_BYTES * TV_HEIGHT, FB_ALLOC_NO_HINT);
+        uint8_t *dirty = fb_alloc(DISPLAY_DIFF_TILES(TV_DIFF_WIDTH, TV_DIFF_TILE_WIDTH) *
+                                  DISPLAY_DIFF_TILES(TV_HEIGHT, TV_DIFF_TILE_HEIGHT), FB_ALLOC_NO_HINT);
+        display_diff_init(&spi_tv_diff, TV_DIFF_WIDTH, TV_HEIGHT, TV_DIFF_PIXEL_SIZE,
+                          TV_DIFF_TILE_WIDTH, TV_DIFF_TILE_HEIGHT, shadow, dirty);
+        display_sink_reset_stats(&spi_tv_sink);
+
         fb_alloc_mark_permanent();
     }
 }
@@ -675,6 +699,82 @@ static void spi_tv_draw_image_cb_rgb565(int x_start, int x_end, int y_row, imlib
     HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, data->dst_row_override, PICLINE_LENGTH_BYTES, HAL_MAX_DELAY);
 }
 
+static void spi_tv_dirty_draw_image_cb_grayscale(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data)
+{
+    spi_tv_draw_image_cb_convert_grayscale((uint8_t *) data->dst_row_override, (uint8_t *) data->dst_row_override);
+    display_diff_row(&spi_tv_diff, y_row, data->dst_row_override);
+}
+
+static void spi_tv_dirty_draw_image_cb_rgb565(int x_start, int x_end, int y_row, imlib_draw_row_data_t *data)
+{
+    spi_tv_draw_image_cb_convert_rgb565((uint16_t *) data->dst_row_override, (uint8_t *) data->dst_row_override);
+    display_diff_row(&spi_tv_diff, y_row, data->dst_row_override);
+}
+
+// The SPI RAM has no address window so every row of a window is written with
+// its own WRITE_SRAM packet at the matching picture line offset.
+static int spi_tv_sink_x = 0;
+static int spi_tv_sink_y = 0;
+
+static void spi_tv_sink_set_window(display_sink_t *sink, int x, int y, int w, int h)
+{
+    spi_tv_sink_x = x;
+    spi_tv_sink_y = y;
+}
+
+static void spi_tv_sink_write_row(display_sink_t *sink, const uint8_t *data, int w)
+{
+    int address = PICLINE_BYTE_ADDRESS(spi_tv_sink_y++) + (spi_tv_sink_x * TV_DIFF_PIXEL_SIZE);
+    uint8_t packet[4] = {WRITE_SRAM, address >> 16, address >> 8, address};
+
+    OMV_SPI_LCD_CS_LOW();
+    HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, packet, sizeof(packet), HAL_MAX_DELAY);
+    HAL_SPI_Transmit(OMV_SPI_LCD_CONTROLLER->spi, (uint8_t *) data, w * TV_DIFF_PIXEL_SIZE, HAL_MAX_DELAY);
+    OMV_SPI_LCD_CS_HIGH();
+}
+
+static display_sink_t spi_tv_sink = {
+    .set_window = spi_tv_sink_set_window,
+    .write_row = spi_tv_sink_write_row,
+};
+
+static void spi_tv_display_dirty(image_t *dst_img, bool black, int y0, int y1, bool rgb565,
+                                 image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale,
+                                 rectangle_t *roi, int rgb_channel, int alpha,
+                                 const uint16_t *color_palette, const uint8_t *alpha_palette,
+                                 image_hint_t hint)
+{
+    imlib_draw_row_callback_t cb = rgb565 ? spi_tv_dirty_draw_image_cb_rgb565 : spi_tv_dirty_draw_image_cb_grayscale;
+
+    // Zero pixels convert to zero YUV bytes.
+    if (black) { // zero the whole image
+        for (int i = 0; i < TV_HEIGHT; i++) {
+            display_diff_row(&spi_tv_diff, i, dst_img->data);
+        }
+    } else {
+        // Zero the top rows
+        for (int i = 0; i < y0; i++) {
+            display_diff_row(&spi_tv_diff, i, dst_img->data);
+        }
+
+        imlib_draw_image(dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale, roi,
+                         rgb_channel, alpha, color_palette, alpha_palette, hint | IMAGE_HINT_BLACK_BACKGROUND,
+                         cb, dst_img->data);
+
+        // Zero the bottom rows
+        if (y1 < TV_HEIGHT) {
+            memset(dst_img->data, 0, TV_WIDTH_RGB565);
+        }
+
+        for (int i = y1; i < TV_HEIGHT; i++) {
+            display_diff_row(&spi_tv_diff, i, dst_img->data);
+        }
+    }
+
+    display_sink_reset_stats(&spi_tv_sink);
+    display_diff_flush(&spi_tv_diff, &spi_tv_sink);
+}
+
 static void spi_tv_display(image_t *src_img, int dst_x_start, int dst_y_start, float x_scale, float y_scale,
                            rectangle_t *roi, int rgb_channel, int alpha,
                            const uint16_t *color_palette, const uint8_t *alpha_palette,
@@ -692,7 +792,12 @@ static void spi_tv_display(image_t *src_img, int dst_x_start, int dst_y_start, f
     bool black = !imlib_draw_image_rectangle(&dst_img, src_img, dst_x_start, dst_y_start, x_scale, y_scale,
                                              roi, alpha, alpha_palette, hint, &x0, &x1, &y0, &y1);
 
-    if (!tv_triple_buffer) {
+    if (tv_dirty_rects) {
+        dst_img.data = fb_alloc0(TV_WIDTH_RGB565, FB_ALLOC_NO_HINT);
+        spi_tv_display_dirty(&dst_img, black, y0, y1, rgb565, src_img, dst_x_start, dst_y_start, x_scale, y_scale,
+                             roi, rgb_channel, alpha, color_palette, alpha_palette, hint);
+        fb_free();
+    } else if (!tv_triple_buffer) {
         dst_img.data = fb_alloc0(TV_WIDTH_RGB565, FB_ALLOC_NO_HINT);
         OMV_SPI_LCD_CS_LOW();
 
@@ -843,6 +948,7 @@ STATIC mp_obj_t py_tv_deinit()
     }
 
     tv_triple_buffer = false;
+    tv_dirty_rects = false;
 
     return mp_const_none;
 }
@@ -860,9 +966,15 @@ STATIC mp_obj_t py_tv_init(uint n_args, const mp_obj_t *args, mp_map_t *kw_args)
         case TV_SHIELD: {
             bool triple_buffer = py_helper_keyword_int(n_args, args, 1, kw_args,
                                                        MP_OBJ_NEW_QSTR(MP_QSTR_triple_buffer), false);
-            spi_config_init(triple_buffer);
+            bool dirty_rects = py_helper_keyword_int(n_args, args, 2, kw_args,
+                                                     MP_OBJ_NEW_QSTR(MP_QSTR_dirty_rects), false);
+            if (triple_buffer && dirty_rects) {
+                mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("Choose either triple_buffer or dirty_rects not both!"));
+            }
+            spi_config_init(triple_buffer, dirty_rects);
             tv_type = TV_SHIELD;
             tv_triple_buffer = triple_buffer;
+            tv_dirty_rects = dirty_rects;
             break;
         }
         #endif
@@ -915,6 +1027,31 @@ STATIC mp_obj_t py_tv_triple_buffer()
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_tv_triple_buffer_obj, py_tv_triple_buffer);
 
+STATIC mp_obj_t py_tv_dirty_rects()
+{
+    if (tv_type == TV_NONE) {
+        return mp_const_none;
+    }
+
+    return mp_obj_new_int(tv_dirty_rects);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_tv_dirty_rects_obj, py_tv_dirty_rects);
+
+// Returns the (windows, bytes) sent by the last display() call in dirty_rects mode.
+STATIC mp_obj_t py_tv_dirty_stats()
+{
+    if (!tv_dirty_rects) {
+        return mp_const_none;
+    }
+
+    #ifdef OMV_SPI_LCD_CONTROLLER
+    return mp_obj_new_tuple(2, (mp_obj_t []) {mp_obj_new_int(spi_tv_sink.windows), mp_obj_new_int(spi_tv_sink.bytes)});
+    #else
+    return mp_const_none;
+    #endif
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(py_tv_dirty_stats_obj, py_tv_dirty_stats);
+
 STATIC mp_obj_t py_tv_refresh()
 {
     if (tv_type == TV_NONE) {
@@ -1091,6 +1228,8 @@ STATIC const mp_rom_map_elem_t globals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_height),                  MP_ROM_PTR(&py_tv_height_obj)                   },
     { MP_ROM_QSTR(MP_QSTR_type),                    MP_ROM_PTR(&py_tv_type_obj)                     },
     { MP_ROM_QSTR(MP_QSTR_triple_buffer),           MP_ROM_PTR(&py_tv_triple_buffer_obj)            },
+    { MP_ROM_QSTR(MP_QSTR_dirty_rects),             MP_ROM_PTR(&py_tv_dirty_rects_obj)              },
+    { MP_ROM_QSTR(MP_QSTR_dirty_stats),             MP_ROM_PTR(&py_tv_dirty_stats_obj)              },
     { MP_ROM_QSTR(MP_QSTR_refresh),                 MP_ROM_PTR(&py_tv_refresh_obj)                  },
     { MP_ROM_QSTR(MP_QSTR_channel),                 MP_ROM_PTR(&py_tv_channel_obj)                  },
     { MP_ROM_QSTR(MP_QSTR_display),                 MP_ROM_PTR(&py_tv_display_obj)                  },
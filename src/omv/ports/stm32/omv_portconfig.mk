@@ -109,6 +109,9 @@ endif
 #------------- Firmware Objects ----------------#
 FIRM_OBJ += $(wildcard $(BUILD)/$(CMSIS_DIR)/src/dsp/CommonTables/*.o)
 FIRM_OBJ += $(wildcard $(BUILD)/$(CMSIS_DIR)/src/dsp/FastMathFunctions/*.o)
+ifeq ($(MICROPY_PY_AUDIO_FEATURES), 1)
+FIRM_OBJ += $(wildcard $(BUILD)/$(CMSIS_DIR)/src/dsp/TransformFunctions/*.o)
+endif
 
 FIRM_OBJ += $(wildcard $(BUILD)/$(HAL_DIR)/src/*.o)
 FIRM_OBJ += $(wildcard $(BUILD)/$(LEPTON_DIR)/src/*.o)
@@ -148,7 +151,11 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/common/, \
 	mutex.o                     \
 	usbdbg.o                    \
 	sensor_utils.o              \
+	sensor_ae.o                 \
+	sensor_hdr.o                \
 	factoryreset.o              \
+	audio_features.o            \
+	display_diff.o              \
    )
 
 FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/,   \
@@ -166,14 +173,17 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/,   \
 	gc2145.o                    \
 	paj6100.o                   \
 	frogeye2020.o               \
+	vsensor.o                   \
    )
 
 FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	agast.o                     \
 	apriltag.o                  \
+	background.o                \
 	bayer.o                     \
 	binary.o                    \
 	blob.o                      \
+	blob_tracker.o              \
 	bmp.o                       \
 	clahe.o                     \
 	collections.o               \
@@ -206,6 +216,8 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	lsd.o                       \
 	mathop.o                    \
 	mjpeg.o                     \
+	motion.o                    \
+	optflow.o                   \
 	orb.o                       \
 	phasecorrelation.o          \
 	point.o                     \
@@ -219,6 +231,7 @@ FIRM_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/imlib/, \
 	sincos_tab.o                \
 	stats.o                     \
 	stereo.o                    \
+	tracker.o                   \
 	template.o                  \
 	xyz_tab.o                   \
 	yuv.o                       \
@@ -530,6 +543,8 @@ UVC_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/common/, \
 	trace.o                                 \
 	mutex.o                                 \
 	sensor_utils.o                          \
+	sensor_ae.o                             \
+	sensor_hdr.o                            \
 	)
 
 UVC_OBJ += $(addprefix $(BUILD)/$(OMV_DIR)/sensors/, \
@@ -614,6 +629,7 @@ export FROZEN_MANIFEST
 export PORT
 export HAL_DIR
 export CMSIS_DIR
+export MICROPY_PY_AUDIO_FEATURES
 export PYTHON
 export TFLITE2C
 ###################################################
@@ -41,6 +41,7 @@ SPI_HandleTypeDef ISC_SPIHandle = {.Instance = ISC_SPI};
 
 static bool first_line = false;
 static bool drop_frame = false;
+static uint32_t linescan_line = 0;
 
 extern uint8_t _line_buf;
 extern uint32_t hal_get_exti_gpio(uint32_t line);
@@ -355,6 +356,139 @@ int sensor_set_vsync_callback(vsync_cb_t vsync_cb)
     return 0;
 }
 
+int sensor_set_rois(const rectangle_t *rois, int n_rois)
+{
+    if ((n_rois < 0) || (n_rois > SENSOR_MAX_ROIS)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (sensor.framesize == FRAMESIZE_INVALID) {
+        return SENSOR_ERROR_INVALID_FRAMESIZE;
+    }
+
+    if (sensor.pixformat == PIXFORMAT_JPEG) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    // Regions are copied line by line and are never transposed.
+    if (n_rois && (sensor.transpose || sensor.auto_rotation)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    // The DCMI captures the bounding box of all regions and the line copy drops everything else.
+    rectangle_t bounds = {0, 0, resolution[sensor.framesize][0], resolution[sensor.framesize][1]};
+    uint32_t pixels = 0;
+
+    for (int i = 0; i < n_rois; i++) {
+        rectangle_t r = rois[i];
+
+        if ((r.x < 0) || (r.y < 0) || (r.w < 2) || (r.h < 1) || (r.x % 2) || (r.w % 2)
+        ||  ((r.x + r.w) > resolution[sensor.framesize][0])
+        ||  ((r.y + r.h) > resolution[sensor.framesize][1])) {
+            return SENSOR_ERROR_INVALID_WINDOW;
+        }
+
+        if (i == 0) {
+            bounds = r;
+        } else {
+            rectangle_united(&bounds, &r);
+        }
+
+        pixels += r.w * r.h;
+    }
+
+    // Overlapping regions are stored once each, the frame buffer is sized for the bounding box.
+    if (pixels > (bounds.w * bounds.h)) {
+        return SENSOR_ERROR_INVALID_WINDOW;
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort();
+
+    // Flush previous frame.
+    framebuffer_update_jpeg_buffer();
+
+    // Skip the first frame.
+    MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
+
+    memcpy(sensor.rois, rois, n_rois * sizeof(rectangle_t));
+    sensor.n_rois = n_rois;
+    sensor.n_linescan_rows = 0;
+    MAIN_FB()->trailer_size = 0;
+
+    MAIN_FB()->x = bounds.x;
+    MAIN_FB()->y = bounds.y;
+    MAIN_FB()->w = MAIN_FB()->u = bounds.w;
+    MAIN_FB()->h = MAIN_FB()->v = bounds.h;
+
+    // Pickout a good buffer count for the user.
+    framebuffer_auto_adjust_buffers();
+    return 0;
+}
+
+int sensor_set_linescan(const uint16_t *rows, int n_rows, int height)
+{
+    if ((n_rows < 0) || (n_rows > SENSOR_MAX_LINESCAN_ROWS) || (n_rows && (height < n_rows))) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (sensor.framesize == FRAMESIZE_INVALID) {
+        return SENSOR_ERROR_INVALID_FRAMESIZE;
+    }
+
+    if (sensor.pixformat == PIXFORMAT_JPEG) {
+        return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+    }
+
+    // Rows are copied line by line and are never transposed.
+    if (n_rows && (sensor.transpose || sensor.auto_rotation)) {
+        return SENSOR_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < n_rows; i++) {
+        if ((rows[i] >= resolution[sensor.framesize][1]) || (i && (rows[i] <= rows[i - 1]))) {
+            return SENSOR_ERROR_INVALID_WINDOW;
+        }
+    }
+
+    // Disable any ongoing frame capture.
+    sensor_abort();
+
+    // Flush previous frame.
+    framebuffer_update_jpeg_buffer();
+
+    // Skip the first frame.
+    MAIN_FB()->pixfmt = PIXFORMAT_INVALID;
+
+    memcpy(sensor.linescan_rows, rows, n_rows * sizeof(uint16_t));
+    sensor.n_linescan_rows = n_rows;
+    sensor.linescan_height = n_rows ? height : 0;
+    sensor.n_rois = 0;
+
+    // The DCMI captures the rows between the first and the last line scan row and the line copy
+    // drops everything else. The horizontal window is kept.
+    MAIN_FB()->y = n_rows ? rows[0] : 0;
+    MAIN_FB()->v = n_rows ? (rows[n_rows - 1] - rows[0] + 1) : resolution[sensor.framesize][1];
+    MAIN_FB()->w = MAIN_FB()->u;
+    MAIN_FB()->h = n_rows ? height : MAIN_FB()->v;
+    // The row timestamps are stored after the strip.
+    MAIN_FB()->trailer_size = n_rows ? (height * sizeof(uint32_t)) : 0;
+
+    // Pickout a good buffer count for the user.
+    framebuffer_auto_adjust_buffers();
+    return 0;
+}
+
+int sensor_set_line_callback(line_cb_t line_cb, void *arg)
+{
+    // Per-line interrupts are disabled in full MDMA offload mode so the capture must be
+    // reconfigured by the next snapshot.
+    sensor_abort();
+    sensor.line_callback = line_cb;
+    sensor.line_callback_arg = arg;
+    return 0;
+}
+
 void DCMI_VsyncExtiCallback()
 {
     if (__HAL_GPIO_EXTI_GET_FLAG(1 << DCMI_VSYNC_EXTI_LINE)) {
@@ -404,6 +538,14 @@ void HAL_DCMI_FrameEventCallback(DCMI_HandleTypeDef *hdcmi)
         return;
     }
 
+    // A line scan strip is filled over multiple frames and only released once it's full.
+    if (sensor.n_linescan_rows) {
+        vbuffer_t *buffer = framebuffer_get_tail(FB_PEEK);
+        if (buffer && (buffer->offset < sensor.linescan_height)) {
+            return;
+        }
+    }
+
     framebuffer_get_tail(FB_NO_FLAGS);
 
     if (sensor.frame_callback) {
@@ -412,6 +554,13 @@ void HAL_DCMI_FrameEventCallback(DCMI_HandleTypeDef *hdcmi)
 }
 
 #if (OMV_ENABLE_SENSOR_MDMA == 1)
+// Returns true if MDMA can capture the whole frame without per-line interrupts.
+static bool mdma_full_offload()
+{
+    return (!sensor.transpose) && (sensor.line_callback == NULL)
+        && (!sensor.n_rois) && (!sensor.n_linescan_rows);
+}
+
 static void mdma_memcpy(vbuffer_t *buffer, void *dst, void *src, int bpp, bool transposed)
 {
     // We're using two handles to give each channel the maximum amount of time possible to do the line
@@ -431,6 +580,33 @@ static void mdma_memcpy(vbuffer_t *buffer, void *dst, void *src, int bpp, bool t
 }
 #endif
 
+// Copies part of a line (w pixels) from the line buffer to the frame buffer using the CPU.
+static void cpu_line_copy(uint8_t *dst, uint8_t *src, uint32_t w)
+{
+    switch (sensor.pixformat) {
+        case PIXFORMAT_GRAYSCALE:
+            if (sensor.hw_flags.gs_bpp == 2) {
+                unaligned_2_to_1_memcpy(dst, src, w);
+                break;
+            }
+            // Fall through (1BPP GRAYSCALE).
+        case PIXFORMAT_BAYER:
+            unaligned_memcpy(dst, src, w);
+            break;
+        case PIXFORMAT_RGB565:
+        case PIXFORMAT_YUV422:
+            if ((sensor.pixformat == PIXFORMAT_RGB565 && sensor.hw_flags.rgb_swap)
+            ||  (sensor.pixformat == PIXFORMAT_YUV422 && sensor.hw_flags.yuv_swap)) {
+                unaligned_memcpy_rev16(dst, src, w);
+            } else {
+                unaligned_memcpy(dst, src, w * sizeof(uint16_t));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
 // This function is called back after each line transfer is complete,
 // with a pointer to the line buffer that was used. At this point the
 // DMA transfers the next line to the other half of the line buffer.
@@ -438,6 +614,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
 {
     if (!first_line) {
         first_line = true;
+        linescan_line = 0;
         uint32_t tick = HAL_GetTick();
         uint32_t framerate_ms = IM_DIV(1000, sensor.framerate);
 
@@ -458,7 +635,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
         // If we're dropping a frame in full offload mode it's safe to disable this interrupt saving
         // ourselves from having to service the DMA complete callback.
         #if (OMV_ENABLE_SENSOR_MDMA == 1)
-        if (!sensor.transpose) {
+        if (mdma_full_offload()) {
             HAL_NVIC_DisableIRQ(DMA2_Stream1_IRQn);
         }
         #endif
@@ -542,7 +719,7 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
     // DCMI_DMAXferCplt in the HAL DCMI driver always calls DCMI_DMAConvCpltUser with the other
     // MAR register. So, we have to fix the address in full MDMA offload mode...
     #if (OMV_ENABLE_SENSOR_MDMA == 1)
-    if (!sensor.transpose) {
+    if (mdma_full_offload()) {
         addr = (uint32_t) &_line_buf;
     }
     #endif
@@ -556,9 +733,10 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
     }
 
     // For all non-JPEG and non-transposed modes we can completely offload image catpure to MDMA
-    // and we do not need to receive any line interrupts for the rest of the frame until it ends.
+    // and we do not need to receive any line interrupts for the rest of the frame until it ends
+    // (unless there's a line callback).
     #if (OMV_ENABLE_SENSOR_MDMA == 1)
-    if (!sensor.transpose) {
+    if (mdma_full_offload()) {
         // NOTE: We're starting MDMA here because it gives the maximum amount of time before we
         // have to drop the frame if there's no space. If you use the FRAME/VSYNC callbacks then
         // you will have to drop the frame earlier than necessary if there's no space resulting
@@ -579,6 +757,54 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
     }
     #endif
 
+    // Append the line scan rows to the strip, which is filled over multiple frames. Each row's
+    // capture time is stored after the strip.
+    if (sensor.n_linescan_rows) {
+        uint32_t line = linescan_line++;
+        uint32_t y = MAIN_FB()->y + line;
+
+        for (int i = 0; i < sensor.n_linescan_rows; i++) {
+            if ((y == sensor.linescan_rows[i]) && (buffer->offset < sensor.linescan_height)) {
+                uint32_t *timestamps = sensor_get_linescan_timestamps(buffer);
+                timestamps[buffer->offset] = mp_hal_ticks_us();
+                dst += MAIN_FB()->u * bytes_per_pixel * buffer->offset++;
+                cpu_line_copy(dst, src, MAIN_FB()->u);
+                break;
+            }
+        }
+
+        if (sensor.line_callback) {
+            sensor.line_callback(sensor.line_callback_arg, line, src, MAIN_FB()->u);
+        }
+        return;
+    }
+
+    // Copy the parts of the line inside the regions of interest, which are stored one after the
+    // other in the frame buffer. Regions are small so they are copied by the CPU.
+    if (sensor.n_rois) {
+        int line = buffer->offset++;
+        int y = MAIN_FB()->y + line;
+        uint32_t src_bpp = sensor_get_src_bpp();
+
+        for (int i = 0; i < sensor.n_rois; i++) {
+            rectangle_t *roi = &sensor.rois[i];
+            uint32_t roi_line_bytes = roi->w * bytes_per_pixel;
+
+            if ((y >= roi->y) && (y < (roi->y + roi->h))) {
+                uint8_t *roi_src = src + ((roi->x - MAIN_FB()->x) * src_bpp);
+                uint8_t *roi_dst = dst + ((y - roi->y) * roi_line_bytes);
+                cpu_line_copy(roi_dst, roi_src, roi->w);
+            }
+
+            dst += roi_line_bytes * roi->h;
+        }
+
+        if (sensor.line_callback) {
+            sensor.line_callback(sensor.line_callback_arg, line, src, MAIN_FB()->u);
+        }
+        return;
+    }
+
     if (!sensor.transpose) {
         dst += MAIN_FB()->u * bytes_per_pixel * buffer->offset++;
     } else {
@@ -662,6 +888,11 @@ void DCMI_DMAConvCpltUser(uint32_t addr)
         default:
             break;
     }
+
+    // The line is still in the line buffer while it's being copied (by MDMA) to the frame buffer.
+    if (sensor.line_callback) {
+        sensor.line_callback(sensor.line_callback_arg, buffer->offset - 1, src, MAIN_FB()->u);
+    }
 }
 
 #if (OMV_ENABLE_SENSOR_MDMA == 1)
@@ -745,14 +976,29 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
 {
     uint32_t length = 0;
 
+    // The OV2640 JPEG transfer length is only known to the call that started the transfer, and in
+    // single buffer mode the capture stops after each frame and would be restarted into the buffer
+    // the last image points to, so both wait for the frame instead.
+    bool no_wait = (flags & SENSOR_SNAPSHOT_NO_WAIT) && (MAIN_FB()->n_buffers != 1)
+                && !((sensor->pixformat == PIXFORMAT_JPEG) && (sensor->chip_id == OV2640_ID));
+
+    // If a transfer is running and no frame has been received yet return without touching the
+    // current frame buffer, so the last image stays valid until the next one is ready.
+    if (no_wait && (DCMI->CR & DCMI_CR_ENABLE) && !framebuffer_get_head(FB_PEEK)) {
+        return SENSOR_ERROR_FRAME_NOT_READY;
+    }
+
     // Compress the framebuffer for the IDE preview, only if it's not the first frame,
     // the framebuffer is enabled and the image sensor does not support JPEG encoding.
     // Note: This doesn't run unless the IDE is connected and the framebuffer is enabled.
     framebuffer_update_jpeg_buffer();
 
     // Make sure the raw frame fits into the FB. It will be switched from RGB565 to BAYER
-    // first to save space before being cropped until it fits.
-    sensor_auto_crop_framebuffer();
+    // first to save space before being cropped until it fits. Regions of interest and line
+    // scan strips can't be cropped, so fail instead of letting the capture overflow the FB.
+    if (sensor_auto_crop_framebuffer() != 0) {
+        return SENSOR_ERROR_FRAMEBUFFER_OVERFLOW;
+    }
 
     // The user may have changed the MAIN_FB width or height on the last image so we need
     // to restore that here. We don't have to restore bpp because that's taken care of
@@ -821,7 +1067,7 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
             HAL_MDMA_Init(&DCMI_MDMA_Handle0);
 
             // If we are not transposing the image we can fully offload image capture from the CPU.
-            if (!sensor->transpose) {
+            if (mdma_full_offload()) {
                 // MDMA will trigger on each TC from DMA and transfer one line to the frame buffer.
                 DCMI_MDMA_Handle1.Init.Request = MDMA_REQUEST_DMA2_Stream1_TC;
                 DCMI_MDMA_Handle1.Init.TransferTriggerMode = MDMA_BLOCK_TRANSFER;
@@ -880,7 +1126,7 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
             }
         #if (OMV_ENABLE_SENSOR_MDMA == 1)
         // Special transfer mode with MDMA that completely offloads the line capture load.
-        } else if ((sensor->pixformat != PIXFORMAT_JPEG) && (!sensor->transpose)) {
+        } else if ((sensor->pixformat != PIXFORMAT_JPEG) && mdma_full_offload()) {
             // DMA to circular mode writing the same line over and over again.
             ((DMA_Stream_TypeDef *) DMAHandle.Instance)->CR |= DMA_SxCR_CIRC;
             // DCMI will transfer to same line and MDMA will move to final location.
@@ -914,14 +1160,25 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
         __HAL_DCMI_ENABLE_IT(&DCMIHandle, DCMI_IT_FRAME);
     }
 
+    // A line scan strip is filled over multiple frames.
+    uint32_t timeout_ms = SENSOR_TIMEOUT_MS;
+    if (sensor->n_linescan_rows) {
+        timeout_ms *= (sensor->linescan_height + sensor->n_linescan_rows - 1) / sensor->n_linescan_rows;
+    }
+
     vbuffer_t *buffer = NULL;
     // Wait for the frame data. __WFI() below will exit right on time because of DCMI_IT_FRAME.
     // While waiting SysTick will trigger allowing us to timeout.
     for (uint32_t tick_start = HAL_GetTick(); !(buffer = framebuffer_get_head(FB_NO_FLAGS)); ) {
+        // The transfer keeps running in the background and the frame is returned by a later call.
+        if (no_wait) {
+            return SENSOR_ERROR_FRAME_NOT_READY;
+        }
+
         __WFI();
 
         // If we haven't exited this loop before the timeout then we need to abort the transfer.
-        if ((HAL_GetTick() - tick_start) > SENSOR_TIMEOUT_MS) {
+        if ((HAL_GetTick() - tick_start) > timeout_ms) {
             sensor_abort();
 
             #if defined(DCMI_FSYNC_PIN)
@@ -955,7 +1212,18 @@ int sensor_snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
 
     // Prepare the frame buffer w/h/bpp values given the image type.
 
-    if (!sensor->transpose) {
+    // The line scan row timestamps are stored after the strip.
+    MAIN_FB()->trailer_size = sensor->n_linescan_rows ? (sensor->linescan_height * sizeof(uint32_t)) : 0;
+
+    if (sensor->n_rois) {
+        // The frame buffer image is the first region of interest.
+        MAIN_FB()->w = sensor->rois[0].w;
+        MAIN_FB()->h = sensor->rois[0].h;
+    } else if (sensor->n_linescan_rows) {
+        // The frame buffer image is the line scan strip.
+        MAIN_FB()->w = w;
+        MAIN_FB()->h = sensor->linescan_height;
+    } else if (!sensor->transpose) {
         MAIN_FB()->w = w;
         MAIN_FB()->h = h;
     } else {
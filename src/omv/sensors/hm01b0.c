@@ -122,18 +122,29 @@ static const uint16_t default_regs[][2] = {
     {0x0000,            0x00},
 };
 
+// Registers updated by the sensor itself or self-clearing.
+static const uint16_t volatile_regs[][2] = {
+    {MODEL_ID_H,        PIXEL_ORDER},
+    {MODE_SELECT,       MODE_SELECT},
+    {SW_RESET,          GRP_PARAM_HOLD},
+    {INTEGRATION_H,     DIGITAL_GAIN_L},
+    {I2C_CLEAR,         I2C_CLEAR},
+    {MD_INTERRUPT,      MD_INTERRUPT},
+    {0x0000,            0x0000},
+};
+
 static int reset(sensor_t *sensor)
 {
     // Reset sensor.
     uint8_t reg=0xff;
     for (int retry=HIMAX_BOOT_RETRY; retry >= 0 && reg != HIMAX_MODE_STANDBY; retry--) {
-        if (cambus_writeb2(&sensor->bus, sensor->slv_addr, SW_RESET, HIMAX_RESET) != 0) {
+        if (sensor_writeb2(sensor, SW_RESET, HIMAX_RESET) != 0) {
             return -1;
         }
 
         mp_hal_delay_ms(1);
 
-        if (cambus_readb2(&sensor->bus, sensor->slv_addr, MODE_SELECT, &reg) != 0) {
+        if (sensor_readb2(sensor, MODE_SELECT, &reg) != 0) {
             return -1;
         }
 
@@ -149,14 +160,14 @@ static int reset(sensor_t *sensor)
     // Write default regsiters
     int ret = 0;
     for (int i=0; default_regs[i][0] && ret == 0; i++) {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, default_regs[i][0], default_regs[i][1]);
+        ret |= sensor_writeb2(sensor, default_regs[i][0], default_regs[i][1]);
     }
 
     // Set PCLK polarity.
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, PCLK_POLARITY, (0x20 | PCLK_FALLING_EDGE));
+    ret |= sensor_writeb2(sensor, PCLK_POLARITY, (0x20 | PCLK_FALLING_EDGE));
 
     // Set mode to streaming
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MODE_SELECT, HIMAX_MODE_STREAMING);
+    ret |= sensor_writeb2(sensor, MODE_SELECT, HIMAX_MODE_STREAMING);
 
     return ret;
 }
@@ -164,7 +175,7 @@ static int reset(sensor_t *sensor)
 static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 {
     uint8_t reg_data;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, reg_addr, &reg_data) != 0) {
+    if (sensor_readb2(sensor, reg_addr, &reg_data) != 0) {
         return -1;
     }
     return reg_data;
@@ -172,7 +183,7 @@ static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 
 static int write_reg(sensor_t *sensor, uint16_t reg_addr, uint16_t reg_data)
 {
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, reg_addr, reg_data);
+    return sensor_writeb2(sensor, reg_addr, reg_data);
 }
 
 static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
@@ -248,17 +259,17 @@ static int set_framesize(sensor_t *sensor, framesize_t framesize)
     switch (framesize) {
         case FRAMESIZE_320X320:
             for (int i=0; FULL_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FULL_regs[i][0], FULL_regs[i][1]);
+                ret |= sensor_writeb2(sensor, FULL_regs[i][0], FULL_regs[i][1]);
             }
             break;
         case FRAMESIZE_QVGA:
             for (int i=0; QVGA_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, QVGA_regs[i][0], QVGA_regs[i][1]);
+                ret |= sensor_writeb2(sensor, QVGA_regs[i][0], QVGA_regs[i][1]);
             }
             break;
         case FRAMESIZE_QQVGA:
             for (int i=0; QQVGA_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, QQVGA_regs[i][0], QQVGA_regs[i][1]);
+                ret |= sensor_writeb2(sensor, QQVGA_regs[i][0], QQVGA_regs[i][1]);
             }
             break;
         default:
@@ -290,7 +301,7 @@ static int set_framerate(sensor_t *sensor, int framerate)
     } else {
         osc_div = 0x03; // Set to the max possible FPS at this resolution.
     }
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, OSC_CLK_DIV, 0x08 | osc_div);
+    return sensor_writeb2(sensor, OSC_CLK_DIV, 0x08 | osc_div);
 }
 
 static int set_brightness(sensor_t *sensor, int level)
@@ -313,7 +324,7 @@ static int set_brightness(sensor_t *sensor, int level)
         default:
             ae_mean = 60;
     }
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_TARGET_MEAN, ae_mean);
+    return sensor_writeb2(sensor, AE_TARGET_MEAN, ae_mean);
 }
 
 static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
@@ -336,14 +347,14 @@ static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
         default:
             return -1;
     }
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN_FULL, gain);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN_BIN2, gain);
+    ret |= sensor_writeb2(sensor, MAX_AGAIN_FULL, gain);
+    ret |= sensor_writeb2(sensor, MAX_AGAIN_BIN2, gain);
     return ret;
 }
 
 static int set_colorbar(sensor_t *sensor, int enable)
 {
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, TEST_PATTERN_MODE, enable & 0x1);
+    return sensor_writeb2(sensor, TEST_PATTERN_MODE, enable & 0x1);
 }
 
 static int set_auto_gain(sensor_t *sensor, int enable, float gain_db, float gain_db_ceiling)
@@ -352,15 +363,15 @@ static int set_auto_gain(sensor_t *sensor, int enable, float gain_db, float gain
     if ((enable == 0) && (!isnanf(gain_db)) && (!isinff(gain_db))) {
         gain_db = IM_MAX(IM_MIN(gain_db, 24.0f), 0.0f);
         int gain = fast_ceilf(fast_log2(fast_expf((gain_db / 20.0f) * fast_log(10.0f))));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, 0); // Must disable AE
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, ANALOG_GAIN, ((gain&0x7)<<4));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, GRP_PARAM_HOLD, 0x01);
+        ret |= sensor_writeb2(sensor, AE_CTRL, 0); // Must disable AE
+        ret |= sensor_writeb2(sensor, ANALOG_GAIN, ((gain&0x7)<<4));
+        ret |= sensor_writeb2(sensor, GRP_PARAM_HOLD, 0x01);
     } else if ((enable != 0) && (!isnanf(gain_db_ceiling)) && (!isinff(gain_db_ceiling))) {
         gain_db_ceiling = IM_MAX(IM_MIN(gain_db_ceiling, 24.0f), 0.0f);
         int gain = fast_ceilf(fast_log2(fast_expf((gain_db_ceiling / 20.0f) * fast_log(10.0f))));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN_FULL, (gain&0x7));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN_BIN2, (gain&0x7));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, 1);
+        ret |= sensor_writeb2(sensor, MAX_AGAIN_FULL, (gain&0x7));
+        ret |= sensor_writeb2(sensor, MAX_AGAIN_BIN2, (gain&0x7));
+        ret |= sensor_writeb2(sensor, AE_CTRL, 1);
     }
     return ret;
 }
@@ -368,7 +379,7 @@ static int set_auto_gain(sensor_t *sensor, int enable, float gain_db, float gain
 static int get_gain_db(sensor_t *sensor, float *gain_db)
 {
     uint8_t gain;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, ANALOG_GAIN, &gain) != 0) {
+    if (sensor_readb2(sensor, ANALOG_GAIN, &gain) != 0) {
         return -1;
     }
     *gain_db = fast_floorf(fast_log(1 << (gain>>4)) / fast_log(10.0f) * 20.0f);
@@ -378,7 +389,7 @@ static int get_gain_db(sensor_t *sensor, float *gain_db)
 static int get_vt_pix_clk(sensor_t *sensor, uint32_t *vt_pix_clk)
 {
     uint8_t reg;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, OSC_CLK_DIV, &reg) != 0) {
+    if (sensor_readb2(sensor, OSC_CLK_DIV, &reg) != 0) {
         return -1;
     }
     // 00 -> MCLK / 8
@@ -397,7 +408,7 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
     int ret=0;
 
     if (enable) {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, 1);
+        ret |= sensor_writeb2(sensor, AE_CTRL, 1);
     } else {
         uint32_t line_len;
         uint32_t frame_len;
@@ -430,10 +441,10 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
             coarse_int = frame_len-2;
         }
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, 0);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, INTEGRATION_H, coarse_int>>8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, INTEGRATION_L, coarse_int&0xff);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, GRP_PARAM_HOLD, 0x01);
+        ret |= sensor_writeb2(sensor, AE_CTRL, 0);
+        ret |= sensor_writeb2(sensor, INTEGRATION_H, coarse_int>>8);
+        ret |= sensor_writeb2(sensor, INTEGRATION_L, coarse_int&0xff);
+        ret |= sensor_writeb2(sensor, GRP_PARAM_HOLD, 0x01);
     }
 
     return ret;
@@ -451,27 +462,23 @@ static int get_exposure_us(sensor_t *sensor, int *exposure_us)
         line_len = HIMAX_LINE_LEN_PCK_QQVGA;
     }
     ret |= get_vt_pix_clk(sensor, &vt_pix_clk);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, INTEGRATION_H, &((uint8_t*)&coarse_int)[1]);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, INTEGRATION_L, &((uint8_t*)&coarse_int)[0]);
+    ret |= sensor_readb2(sensor, INTEGRATION_H, &((uint8_t*)&coarse_int)[1]);
+    ret |= sensor_readb2(sensor, INTEGRATION_L, &((uint8_t*)&coarse_int)[0]);
     *exposure_us = fast_roundf(coarse_int * line_len / (vt_pix_clk / 1000000.0f));
     return ret;
 }
 
 static int set_hmirror(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, HIMAX_SET_HMIRROR(reg, enable)) ;
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, GRP_PARAM_HOLD, 0x01);
+    int ret = sensor_update_reg_bits(sensor, IMG_ORIENTATION, 0x01, enable ? 0x01 : 0x00);
+    ret |= sensor_writeb2(sensor, GRP_PARAM_HOLD, 0x01);
     return ret;
 }
 
 static int set_vflip(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, HIMAX_SET_VMIRROR(reg, enable)) ;
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, GRP_PARAM_HOLD, 0x01);
+    int ret = sensor_update_reg_bits(sensor, IMG_ORIENTATION, 0x02, enable ? 0x02 : 0x00);
+    ret |= sensor_writeb2(sensor, GRP_PARAM_HOLD, 0x01);
     return ret;
 }
 
@@ -482,14 +489,14 @@ static int ioctl(sensor_t *sensor, int request, va_list ap)
     switch (request) {
         case IOCTL_HIMAX_OSC_ENABLE: {
             uint32_t enable = va_arg(ap, uint32_t);
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, ANA_Register_17, enable ? 1:0);
+            ret = sensor_writeb2(sensor, ANA_Register_17, enable ? 1:0);
             mp_hal_delay_ms(100);
             break;
         }
 
         case IOCTL_HIMAX_MD_ENABLE: {
             uint32_t enable = va_arg(ap, uint32_t);
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_CTRL, enable ? 1:0);
+            ret = sensor_writeb2(sensor, MD_CTRL, enable ? 1:0);
             break;
         }
 
@@ -498,25 +505,25 @@ static int ioctl(sensor_t *sensor, int request, va_list ap)
             uint32_t y1 = va_arg(ap, uint32_t);
             uint32_t x2 = va_arg(ap, uint32_t) + x1;
             uint32_t y2 = va_arg(ap, uint32_t) + y1;
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_X_START_H, (x1>>8));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_X_START_L, (x1&0xff));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_Y_START_H, (y1>>8));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_Y_START_L, (y1&0xff));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_X_END_H,   (x2>>8));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_X_END_L,   (x2&0xff));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_Y_END_H,   (y2>>8));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LROI_Y_END_L,   (y2&0xff));
+            ret |= sensor_writeb2(sensor, MD_LROI_X_START_H, (x1>>8));
+            ret |= sensor_writeb2(sensor, MD_LROI_X_START_L, (x1&0xff));
+            ret |= sensor_writeb2(sensor, MD_LROI_Y_START_H, (y1>>8));
+            ret |= sensor_writeb2(sensor, MD_LROI_Y_START_L, (y1&0xff));
+            ret |= sensor_writeb2(sensor, MD_LROI_X_END_H,   (x2>>8));
+            ret |= sensor_writeb2(sensor, MD_LROI_X_END_L,   (x2&0xff));
+            ret |= sensor_writeb2(sensor, MD_LROI_Y_END_H,   (y2>>8));
+            ret |= sensor_writeb2(sensor, MD_LROI_Y_END_L,   (y2&0xff));
             break;
         }
 
         case IOCTL_HIMAX_MD_THRESHOLD: {
             uint32_t threshold = va_arg(ap, uint32_t);
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_THL, threshold);
+            ret = sensor_writeb2(sensor, MD_THL, threshold);
             break;
         }
 
         case IOCTL_HIMAX_MD_CLEAR: {
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, I2C_CLEAR, 1);
+            ret = sensor_writeb2(sensor, I2C_CLEAR, 1);
             break;
         }
 
@@ -548,6 +555,7 @@ int hm01b0_init(sensor_t *sensor)
     sensor->set_hmirror         = set_hmirror;
     sensor->set_vflip           = set_vflip;
     sensor->ioctl               = ioctl;
+    sensor->volatile_regs       = volatile_regs;
 
     // Set sensor flags
     sensor->hw_flags.vsync      = 0;
@@ -323,18 +323,28 @@ static const uint16_t default_regs[][2] = {
     {0x0000,            0x00},
 };
 
+// Registers updated by the sensor itself or self-clearing.
+static const uint16_t volatile_regs[][2] = {
+    {MODEL_ID_H,        PIXEL_ORDER},
+    {MODE_SELECT,       MODE_SELECT},
+    {SW_RESET,          COMMAND_UPDATE},
+    {INTEGRATION_H,     DIGITAL_GAIN_L},
+    {INT_INDIC,         INT_CLEAR},
+    {0x0000,            0x0000},
+};
+
 static int reset(sensor_t *sensor)
 {
     // Reset sensor.
     uint8_t reg=0xff;
     for (int retry=HIMAX_BOOT_RETRY; retry >= 0 && reg != HIMAX_MODE_STANDBY; retry--) {
-        if (cambus_writeb2(&sensor->bus, sensor->slv_addr, SW_RESET, HIMAX_RESET) != 0) {
+        if (sensor_writeb2(sensor, SW_RESET, HIMAX_RESET) != 0) {
             return -1;
         }
 
         mp_hal_delay_ms(1);
 
-        if (cambus_readb2(&sensor->bus, sensor->slv_addr, MODE_SELECT, &reg) != 0) {
+        if (sensor_readb2(sensor, MODE_SELECT, &reg) != 0) {
             return -1;
         }
 
@@ -350,11 +360,11 @@ static int reset(sensor_t *sensor)
     // Write default regsiters
     int ret = 0;
     for (int i=0; default_regs[i][0] && ret == 0; i++) {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, default_regs[i][0], default_regs[i][1]);
+        ret |= sensor_writeb2(sensor, default_regs[i][0], default_regs[i][1]);
     }
 
     // Set mode to streaming
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MODE_SELECT, HIMAX_MODE_STREAMING);
+    ret |= sensor_writeb2(sensor, MODE_SELECT, HIMAX_MODE_STREAMING);
 
     return ret;
 }
@@ -362,7 +372,7 @@ static int reset(sensor_t *sensor)
 static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 {
     uint8_t reg_data;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, reg_addr, &reg_data) != 0) {
+    if (sensor_readb2(sensor, reg_addr, &reg_data) != 0) {
         return -1;
     }
     return reg_data;
@@ -370,7 +380,7 @@ static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 
 static int write_reg(sensor_t *sensor, uint16_t reg_addr, uint16_t reg_data)
 {
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, reg_addr, reg_data);
+    return sensor_writeb2(sensor, reg_addr, reg_data);
 }
 
 static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
@@ -444,17 +454,17 @@ static int set_framesize(sensor_t *sensor, framesize_t framesize)
     switch (framesize) {
         case FRAMESIZE_VGA:
             for (int i=0; VGA_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, VGA_regs[i][0], VGA_regs[i][1]);
+                ret |= sensor_writeb2(sensor, VGA_regs[i][0], VGA_regs[i][1]);
             }
             break;
         case FRAMESIZE_QVGA:
             for (int i=0; QVGA_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, QVGA_regs[i][0], QVGA_regs[i][1]);
+                ret |= sensor_writeb2(sensor, QVGA_regs[i][0], QVGA_regs[i][1]);
             }
             break;
         case FRAMESIZE_QQVGA:
             for (int i=0; QQVGA_regs[i][0] && ret == 0; i++) {
-                ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, QQVGA_regs[i][0], QQVGA_regs[i][1]);
+                ret |= sensor_writeb2(sensor, QQVGA_regs[i][0], QQVGA_regs[i][1]);
             }
             break;
         default:
@@ -485,8 +495,8 @@ static int set_framerate(sensor_t *sensor, int framerate)
         osc_div = (highres == true) ? 0x00 : 0x01;
     }
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, PLL1_CONFIG, &pll_cfg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, PLL1_CONFIG, (pll_cfg & 0xFC) | osc_div);
+    ret |= sensor_readb2(sensor, PLL1_CONFIG, &pll_cfg);
+    ret |= sensor_writeb2(sensor, PLL1_CONFIG, (pll_cfg & 0xFC) | osc_div);
     return ret;
 }
 
@@ -509,7 +519,7 @@ static int set_brightness(sensor_t *sensor, int level)
             ae_mean = 100;
             break;
     }
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_TARGET_MEAN, ae_mean);
+    return sensor_writeb2(sensor, AE_TARGET_MEAN, ae_mean);
 }
 
 static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
@@ -532,38 +542,38 @@ static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
         default:
             return -1;
     }
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN, (gain & 0x07));
+    ret |= sensor_writeb2(sensor, MAX_AGAIN, (gain & 0x07));
     return ret;
 }
 
 static int set_colorbar(sensor_t *sensor, int enable)
 {
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, TEST_PATTERN_MODE, enable & 0x1);
+    return sensor_writeb2(sensor, TEST_PATTERN_MODE, enable & 0x1);
 }
 
 static int set_auto_gain(sensor_t *sensor, int enable, float gain_db, float gain_db_ceiling)
 {
     uint8_t ae_ctrl = 0;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AE_CTRL, &ae_ctrl);
+    int ret = sensor_readb2(sensor, AE_CTRL, &ae_ctrl);
     if (!enable && (!isnanf(gain_db)) && (!isinff(gain_db))) {
         gain_db = IM_MAX(IM_MIN(gain_db, 24.0f), 0.0f);
         uint8_t gain = fast_ceilf(fast_log2(fast_expf((gain_db / 20.0f) * fast_log(10.0f))));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, (ae_ctrl & 0xFE));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, ANALOG_GAIN, ((gain & 0x7)<<4));
+        ret |= sensor_writeb2(sensor, AE_CTRL, (ae_ctrl & 0xFE));
+        ret |= sensor_writeb2(sensor, ANALOG_GAIN, ((gain & 0x7)<<4));
     } else if (enable && (!isnanf(gain_db_ceiling)) && (!isinff(gain_db_ceiling))) {
         gain_db_ceiling = IM_MAX(IM_MIN(gain_db_ceiling, 24.0f), 0.0f);
         uint8_t gain = fast_ceilf(fast_log2(fast_expf((gain_db_ceiling / 20.0f) * fast_log(10.0f))));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MAX_AGAIN, (gain & 0x07));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, (ae_ctrl | 0x01));
+        ret |= sensor_writeb2(sensor, MAX_AGAIN, (gain & 0x07));
+        ret |= sensor_writeb2(sensor, AE_CTRL, (ae_ctrl | 0x01));
     }
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, COMMAND_UPDATE, 0x01);
+    ret |= sensor_writeb2(sensor, COMMAND_UPDATE, 0x01);
     return ret;
 }
 
 static int get_gain_db(sensor_t *sensor, float *gain_db)
 {
     uint8_t gain;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, ANALOG_GAIN, &gain) != 0) {
+    if (sensor_readb2(sensor, ANALOG_GAIN, &gain) != 0) {
         return -1;
     }
     *gain_db = fast_floorf(fast_log(1 << (gain>>4)) / fast_log(10.0f) * 20.0f);
@@ -573,7 +583,7 @@ static int get_gain_db(sensor_t *sensor, float *gain_db)
 static int get_vt_pix_clk(sensor_t *sensor, uint32_t *vt_pix_clk)
 {
     uint8_t reg;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, PLL1_CONFIG, &reg) != 0) {
+    if (sensor_readb2(sensor, PLL1_CONFIG, &reg) != 0) {
         return -1;
     }
     // 00 -> MCLK / 1
@@ -590,10 +600,10 @@ static int get_vt_pix_clk(sensor_t *sensor, uint32_t *vt_pix_clk)
 static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
 {
     uint8_t ae_ctrl = 0;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AE_CTRL, &ae_ctrl);
+    int ret = sensor_readb2(sensor, AE_CTRL, &ae_ctrl);
 
     if (enable) {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, (ae_ctrl | 0x01));
+        ret |= sensor_writeb2(sensor, AE_CTRL, (ae_ctrl | 0x01));
     } else {
         uint32_t line_len;
         uint32_t frame_len;
@@ -626,10 +636,10 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
             coarse_int = frame_len-4;
         }
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AE_CTRL, (ae_ctrl & 0xFE));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, INTEGRATION_H, coarse_int>>8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, INTEGRATION_L, coarse_int&0xff);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, COMMAND_UPDATE, 0x01);
+        ret |= sensor_writeb2(sensor, AE_CTRL, (ae_ctrl & 0xFE));
+        ret |= sensor_writeb2(sensor, INTEGRATION_H, coarse_int>>8);
+        ret |= sensor_writeb2(sensor, INTEGRATION_L, coarse_int&0xff);
+        ret |= sensor_writeb2(sensor, COMMAND_UPDATE, 0x01);
     }
 
     return ret;
@@ -655,27 +665,23 @@ static int get_exposure_us(sensor_t *sensor, int *exposure_us)
             return -1;
     }
     ret |= get_vt_pix_clk(sensor, &vt_pix_clk);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, INTEGRATION_H, &((uint8_t*)&coarse_int)[1]);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, INTEGRATION_L, &((uint8_t*)&coarse_int)[0]);
+    ret |= sensor_readb2(sensor, INTEGRATION_H, &((uint8_t*)&coarse_int)[1]);
+    ret |= sensor_readb2(sensor, INTEGRATION_L, &((uint8_t*)&coarse_int)[0]);
     *exposure_us = fast_roundf(coarse_int * line_len / (vt_pix_clk / 1000000.0f));
     return ret;
 }
 
 static int set_hmirror(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, HIMAX_SET_HMIRROR(reg, enable)) ;
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, COMMAND_UPDATE, 0x01);
+    int ret = sensor_update_reg_bits(sensor, IMG_ORIENTATION, 0x01, enable ? 0x01 : 0x00);
+    ret |= sensor_writeb2(sensor, COMMAND_UPDATE, 0x01);
     return ret;
 }
 
 static int set_vflip(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, IMG_ORIENTATION, HIMAX_SET_VMIRROR(reg, enable)) ;
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, COMMAND_UPDATE, 0x01);
+    int ret = sensor_update_reg_bits(sensor, IMG_ORIENTATION, 0x02, enable ? 0x02 : 0x00);
+    ret |= sensor_writeb2(sensor, COMMAND_UPDATE, 0x01);
     return ret;
 }
 
@@ -689,11 +695,8 @@ static int ioctl(sensor_t *sensor, int request, va_list ap)
         }
 
         case IOCTL_HIMAX_MD_ENABLE: {
-            int ret = 0;
-            uint8_t md_ctrl = 0;
             uint32_t enable = va_arg(ap, uint32_t) & 0x01;
-            ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, MD_CTRL, &md_ctrl);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_CTRL, (md_ctrl & 0xFE) | enable);
+            ret = sensor_update_reg_bits(sensor, MD_CTRL, 0x01, enable);
             break;
         }
 
@@ -732,21 +735,21 @@ static int ioctl(sensor_t *sensor, int request, va_list ap)
             y1 = MAX((y1 / roi_h - 1), 0);
             x2 = MIN((x2 / roi_w) + !!(x2 % roi_w), 0xF);
             y2 = MIN((y2 / roi_h) + !!(y2 % roi_h), roi_max_h);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, ROI_START_END_H, ((x2 & 0xF) << 4) |  (x1 & 0x0F));
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, ROI_START_END_V, ((y2 & 0xF) << 4) |  (y1 & 0x0F));
+            ret |= sensor_writeb2(sensor, ROI_START_END_H, ((x2 & 0xF) << 4) |  (x1 & 0x0F));
+            ret |= sensor_writeb2(sensor, ROI_START_END_V, ((y2 & 0xF) << 4) |  (y1 & 0x0F));
             break;
         }
 
         case IOCTL_HIMAX_MD_THRESHOLD: {
             uint32_t threshold = va_arg(ap, uint32_t) & 0x3F;
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_TH_STR_L, threshold);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_TH_STR_H, threshold);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, MD_LIGHT_COEF, threshold);
+            ret |= sensor_writeb2(sensor, MD_TH_STR_L, threshold);
+            ret |= sensor_writeb2(sensor, MD_TH_STR_H, threshold);
+            ret |= sensor_writeb2(sensor, MD_LIGHT_COEF, threshold);
             break;
         }
 
         case IOCTL_HIMAX_MD_CLEAR: {
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, INT_CLEAR, (1 << 3));
+            ret = sensor_writeb2(sensor, INT_CLEAR, (1 << 3));
             break;
         }
 
@@ -778,6 +781,7 @@ int hm0360_init(sensor_t *sensor)
     sensor->set_hmirror         = set_hmirror;
     sensor->set_vflip           = set_vflip;
     sensor->ioctl               = ioctl;
+    sensor->volatile_regs       = volatile_regs;
 
     // Set sensor flags
     sensor->hw_flags.vsync      = 0;
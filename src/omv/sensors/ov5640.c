@@ -642,6 +642,18 @@ static const uint8_t saturation_regs[NUM_SATURATION_LEVELS][6] = {
     {0x2b, 0xab, 0xd6, 0xda, 0xd6, 0x04}, /* +3 */
 };
 
+// Registers updated by the sensor itself, self-clearing or used as mailboxes.
+static const uint16_t volatile_regs[][2] = {
+    {SYSTEM_RESET_00,       SYSTEM_RESET_00},
+    {SYSTEM_CTROL0,         SYSTEM_CTROL0},
+    {AF_CMD_MAIN,           AF_FW_STATUS},
+    {0x3212,                0x3212},            // Group hold control.
+    {AWB_R_GAIN_H,          AWB_B_GAIN_L},
+    {AEC_PK_EXPOSURE_0,     AEC_PK_EXPOSURE_2},
+    {AEC_PK_REAL_GAIN_H,    AEC_PK_REAL_GAIN_L},
+    {0x0000,                0x0000},
+};
+
 static int reset(sensor_t *sensor)
 {
     int ret = 0;
@@ -654,35 +666,29 @@ static int reset(sensor_t *sensor)
     hts_target = 0;
 
     // Reset all registers
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, SCCB_SYSTEM_CTRL_1, 0x11);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, SYSTEM_CTROL0, 0x82);
+    ret |= sensor_writeb2(sensor, SCCB_SYSTEM_CTRL_1, 0x11);
+    ret |= sensor_writeb2(sensor, SYSTEM_CTROL0, 0x82);
 
     // Delay 5 ms
     mp_hal_delay_ms(5);
 
-    // Write default regsiters
-    for (int i = 0; default_regs[i][0]; i++) {
-        int addr = (default_regs[i][0] << 8) | (default_regs[i][1] << 0);
-        int data = default_regs[i][2];
-
-        #if (OMV_OV5640_REV_Y_CHECK == 1)
-        // Rev V (480 MHz / 20) -> 24 MHz PCLK / 3 * 100 = 800 MHz / 10 = 80 MHz PCLK.
-        // Rev Y (400 MHz / 16) -> 25 MHz PCLK / 3 * 84 = 700 MHz / 10 = 70 MHz PCLK.
-        if (HAL_GetREVID() < 0x2003) { // Is this REV Y?
-            if (addr == SC_PLL_CONTRL2) {
-                data = OMV_OV5640_REV_Y_CTRL2;
-            }
-            if (addr == SC_PLL_CONTRL3) {
-                data = OMV_OV5640_REV_Y_CTRL3;
-            }
-        }
-        #endif
+    // The software reset discards any shadowed register values.
+    sensor_reg_shadow_reset(sensor);
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, addr, data);
+    // Write default regsiters
+    ret |= sensor_write_regs2(sensor, default_regs);
+
+    #if (OMV_OV5640_REV_Y_CHECK == 1)
+    // Rev V (480 MHz / 20) -> 24 MHz PCLK / 3 * 100 = 800 MHz / 10 = 80 MHz PCLK.
+    // Rev Y (400 MHz / 16) -> 25 MHz PCLK / 3 * 84 = 700 MHz / 10 = 70 MHz PCLK.
+    if (HAL_GetREVID() < 0x2003) { // Is this REV Y?
+        ret |= sensor_writeb2(sensor, SC_PLL_CONTRL2, OMV_OV5640_REV_Y_CTRL2);
+        ret |= sensor_writeb2(sensor, SC_PLL_CONTRL3, OMV_OV5640_REV_Y_CTRL3);
     }
+    #endif
 
     #if (OMV_ENABLE_OV5640_AF == 1)
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, SYSTEM_RESET_00, 0x20); // force mcu reset
+    ret |= sensor_writeb2(sensor, SYSTEM_RESET_00, 0x20); // force mcu reset
 
     // Write firmware
     uint16_t fw_addr = __REV16(MCU_FIRMWARE_BASE);
@@ -690,10 +696,10 @@ static int reset(sensor_t *sensor)
     ret |= cambus_write_bytes(&sensor->bus, sensor->slv_addr, (uint8_t *) af_firmware_regs, sizeof(af_firmware_regs), CAMBUS_XFER_NO_FLAGS);
 
     for (int i = 0; af_firmware_command_regs[i][0]; i++) {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, (af_firmware_command_regs[i][0] << 8) | (af_firmware_command_regs[i][1] << 0), af_firmware_command_regs[i][2]);
+        ret |= sensor_writeb2(sensor, (af_firmware_command_regs[i][0] << 8) | (af_firmware_command_regs[i][1] << 0), af_firmware_command_regs[i][2]);
     }
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, SYSTEM_RESET_00, 0x00); // release mcu reset
+    ret |= sensor_writeb2(sensor, SYSTEM_RESET_00, 0x00); // release mcu reset
     #endif
 
     // Delay 300 ms
@@ -711,13 +717,13 @@ static int sleep(sensor_t *sensor, int enable)
         reg = 0x02;
     }
 
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, SYSTEM_CTROL0, reg);
+    return sensor_writeb2(sensor, SYSTEM_CTROL0, reg);
 }
 
 static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 {
     uint8_t reg_data;
-    if (cambus_readb2(&sensor->bus, sensor->slv_addr, reg_addr, &reg_data) != 0) {
+    if (sensor_readb2(sensor, reg_addr, &reg_data) != 0) {
         return -1;
     }
     return reg_data;
@@ -725,7 +731,7 @@ static int read_reg(sensor_t *sensor, uint16_t reg_addr)
 
 static int write_reg(sensor_t *sensor, uint16_t reg_addr, uint16_t reg_data)
 {
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, reg_addr, reg_data);
+    return sensor_writeb2(sensor, reg_addr, reg_data);
 }
 
 // HTS (Horizontal Time) is the readout width plus the HSYNC_TIME time. However, if this value gets
@@ -760,7 +766,6 @@ static int calculate_vts(sensor_t *sensor, uint16_t readout_height)
 
 static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
 {
-    uint8_t reg;
     int ret = 0;
 
     // Not a multiple of 8. The JPEG encoder on the OV5640 can't handle this.
@@ -784,43 +789,38 @@ static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
 
     switch (pixformat) {
         case PIXFORMAT_GRAYSCALE:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL, 0x10);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL, 0x10);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL_MUX, 0x00);
             break;
         case PIXFORMAT_RGB565:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL, 0x6F);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x01);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL, 0x6F);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL_MUX, 0x01);
             break;
         case PIXFORMAT_YUV422:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL, 0x30);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL, 0x30);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL_MUX, 0x00);
             break;
         case PIXFORMAT_BAYER:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL, 0x00);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x01);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL, 0x00);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL_MUX, 0x01);
             break;
         case PIXFORMAT_JPEG:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL, 0x30);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, FORMAT_CONTROL_MUX, 0x00);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL, 0x30);
+            ret |= sensor_writeb2(sensor, FORMAT_CONTROL_MUX, 0x00);
             break;
         default:
             return -1;
     }
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, (reg & 0xDF) | ((pixformat == PIXFORMAT_JPEG) ? 0x20 : 0x00));
-
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SYSTEM_RESET_02, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, SYSTEM_RESET_02, (reg & 0xE3) | ((pixformat == PIXFORMAT_JPEG) ? 0x00 : 0x1C));
-
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, CLOCK_ENABLE_02, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, CLOCK_ENABLE_02, (reg & 0xD7) | ((pixformat == PIXFORMAT_JPEG) ? 0x28 : 0x00));
+    ret |= sensor_update_reg_bits(sensor, TIMING_TC_REG_21, 0x20, (pixformat == PIXFORMAT_JPEG) ? 0x20 : 0x00);
+    ret |= sensor_update_reg_bits(sensor, SYSTEM_RESET_02, 0x1C, (pixformat == PIXFORMAT_JPEG) ? 0x00 : 0x1C);
+    ret |= sensor_update_reg_bits(sensor, CLOCK_ENABLE_02, 0x28, (pixformat == PIXFORMAT_JPEG) ? 0x28 : 0x00);
 
     if (hts_target) {
         uint16_t sensor_hts = calculate_hts(sensor, resolution[sensor->framesize][0]);
+        uint8_t hts_regs[] = {sensor_hts >> 8, sensor_hts};
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_H, sensor_hts >> 8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_L, sensor_hts);
+        ret |= sensor_write_burst2(sensor, TIMING_HTS_H, hts_regs, sizeof(hts_regs));
     }
 
     return ret;
@@ -828,7 +828,6 @@ static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
 
 static int set_framesize(sensor_t *sensor, framesize_t framesize)
 {
-    uint8_t reg;
     int ret = 0;
     uint16_t w = resolution[framesize][0];
     uint16_t h = resolution[framesize][1];
@@ -914,50 +913,29 @@ static int set_framesize(sensor_t *sensor, framesize_t framesize)
 
     // Step 5: Write regs.
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HS_H, sensor_ws >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HS_L, sensor_ws);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VS_H, sensor_hs >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VS_L, sensor_hs);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HW_H, sensor_we >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HW_L, sensor_we);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VH_H, sensor_he >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VH_L, sensor_he);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_DVPHO_H, w >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_DVPHO_L, w);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_DVPVO_H, h >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_DVPVO_L, h);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_H, sensor_hts >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_L, sensor_hts);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_H, sensor_vts >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_L, sensor_vts);
+    uint8_t timing_regs[] = {
+        sensor_ws >> 8, sensor_ws,          // TIMING_HS_H/L
+        sensor_hs >> 8, sensor_hs,          // TIMING_VS_H/L
+        sensor_we >> 8, sensor_we,          // TIMING_HW_H/L
+        sensor_he >> 8, sensor_he,          // TIMING_VH_H/L
+        w >> 8, w,                          // TIMING_DVPHO_H/L
+        h >> 8, h,                          // TIMING_DVPVO_H/L
+        sensor_hts >> 8, sensor_hts,        // TIMING_HTS_H/L
+        sensor_vts >> 8, sensor_vts,        // TIMING_VTS_H/L
+        x_off >> 8, x_off,                  // TIMING_HOFFSET_H/L
+        y_off >> 8, y_off,                  // TIMING_VOFFSET_H/L
+        sensor_x_inc,                       // TIMING_X_INC
+        sensor_y_inc,                       // TIMING_Y_INC
+    };
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HOFFSET_H, x_off >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_HOFFSET_L, x_off);
+    ret |= sensor_write_burst2(sensor, TIMING_HS_H, timing_regs, sizeof(timing_regs));
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VOFFSET_H, y_off >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VOFFSET_L, y_off);
+    ret |= sensor_update_reg_bits(sensor, TIMING_TC_REG_20, 0x01, (sensor_div > 1));
+    ret |= sensor_update_reg_bits(sensor, TIMING_TC_REG_21, 0x01, (sensor_div > 1));
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_X_INC, sensor_x_inc);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_Y_INC, sensor_y_inc);
+    uint8_t vfifo_regs[] = {w >> 8, w, h >> 8, h}; // VFIFO_HSIZE_H/L and VFIFO_VSIZE_H/L
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_20, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_20, (reg & 0xFE) | (sensor_div > 1));
-
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, (reg & 0xFE) | (sensor_div > 1));
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, VFIFO_HSIZE_H, w >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, VFIFO_HSIZE_L, w);
-
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, VFIFO_VSIZE_H, h >> 8);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, VFIFO_VSIZE_L, h);
+    ret |= sensor_write_burst2(sensor, VFIFO_HSIZE_H, vfifo_regs, sizeof(vfifo_regs));
 
     return ret;
 }
@@ -971,11 +949,11 @@ static int set_contrast(sensor_t *sensor, int level)
         return -1;
     }
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x03); // start group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5586, (new_level + 5) << 2);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5585, contrast_regs[new_level][0]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x13); // end group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0xa3); // launch group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0x03); // start group 3
+    ret |= sensor_writeb2(sensor, 0x5586, (new_level + 5) << 2);
+    ret |= sensor_writeb2(sensor, 0x5585, contrast_regs[new_level][0]);
+    ret |= sensor_writeb2(sensor, 0x3212, 0x13); // end group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0xa3); // launch group 3
 
     return ret;
 }
@@ -989,11 +967,11 @@ static int set_brightness(sensor_t *sensor, int level)
         return -1;
     }
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x03); // start group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5587, abs(level) << 4);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5588, (level < 0) ? 0x09 : 0x01);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x13); // end group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0xa3); // launch group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0x03); // start group 3
+    ret |= sensor_writeb2(sensor, 0x5587, abs(level) << 4);
+    ret |= sensor_writeb2(sensor, 0x5588, (level < 0) ? 0x09 : 0x01);
+    ret |= sensor_writeb2(sensor, 0x3212, 0x13); // end group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0xa3); // launch group 3
 
     return ret;
 }
@@ -1007,27 +985,26 @@ static int set_saturation(sensor_t *sensor, int level)
         return -1;
     }
 
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x03); // start group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5581, 0x1c);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5582, 0x5a);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5583, 0x06);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5584, saturation_regs[new_level][0]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5585, saturation_regs[new_level][1]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5586, saturation_regs[new_level][2]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5587, saturation_regs[new_level][3]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5588, saturation_regs[new_level][4]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5589, saturation_regs[new_level][5]);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x558b, 0x98);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x558a, 0x01);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x13); // end group 3
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0xa3); // launch group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0x03); // start group 3
+    ret |= sensor_writeb2(sensor, 0x5581, 0x1c);
+    ret |= sensor_writeb2(sensor, 0x5582, 0x5a);
+    ret |= sensor_writeb2(sensor, 0x5583, 0x06);
+    ret |= sensor_writeb2(sensor, 0x5584, saturation_regs[new_level][0]);
+    ret |= sensor_writeb2(sensor, 0x5585, saturation_regs[new_level][1]);
+    ret |= sensor_writeb2(sensor, 0x5586, saturation_regs[new_level][2]);
+    ret |= sensor_writeb2(sensor, 0x5587, saturation_regs[new_level][3]);
+    ret |= sensor_writeb2(sensor, 0x5588, saturation_regs[new_level][4]);
+    ret |= sensor_writeb2(sensor, 0x5589, saturation_regs[new_level][5]);
+    ret |= sensor_writeb2(sensor, 0x558b, 0x98);
+    ret |= sensor_writeb2(sensor, 0x558a, 0x01);
+    ret |= sensor_writeb2(sensor, 0x3212, 0x13); // end group 3
+    ret |= sensor_writeb2(sensor, 0x3212, 0xa3); // launch group 3
 
     return ret;
 }
 
 static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
 {
-    uint8_t reg;
     int ret = 0;
 
     int new_gainceiling = 16 << (gainceiling + 1);
@@ -1035,47 +1012,36 @@ static int set_gainceiling(sensor_t *sensor, gainceiling_t gainceiling)
         return -1;
     }
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_H, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_H, (reg & 0xFC) | (new_gainceiling >> 8));
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_L, new_gainceiling);
+    ret |= sensor_update_reg_bits(sensor, AEC_GAIN_CEILING_H, 0x03, new_gainceiling >> 8);
+    ret |= sensor_writeb2(sensor, AEC_GAIN_CEILING_L, new_gainceiling);
 
     return ret;
 }
 
 static int set_quality(sensor_t *sensor, int qs)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, JPEG_CTRL07, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, JPEG_CTRL07, (reg & 0xC0) | (qs >> 2));
-
-    return ret;
+    return sensor_update_reg_bits(sensor, JPEG_CTRL07, 0x3F, qs >> 2);
 }
 
 static int set_colorbar(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, PRE_ISP_TEST, &reg);
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, PRE_ISP_TEST, (reg & 0x7F) | (enable ? 0x80 : 0x00)) | ret;
+    return sensor_update_reg_bits(sensor, PRE_ISP_TEST, 0x80, enable ? 0x80 : 0x00);
 }
 
 static int set_auto_gain(sensor_t *sensor, int enable, float gain_db, float gain_db_ceiling)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_MANUAL, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_MANUAL, (reg & 0xFD) | ((enable == 0) << 1));
+    int ret = sensor_update_reg_bits(sensor, AEC_PK_MANUAL, 0x02, (enable == 0) << 1);
 
     if ((enable == 0) && (!isnanf(gain_db)) && (!isinff(gain_db))) {
         int gain = IM_MAX(IM_MIN(fast_expf((gain_db / 20.0) * fast_log(10.0)) * 16.0, 1023), 0);
 
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_REAL_GAIN_H, &reg);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_REAL_GAIN_H, (reg & 0xFC) | (gain >> 8));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_REAL_GAIN_L, gain);
+        ret |= sensor_update_reg_bits(sensor, AEC_PK_REAL_GAIN_H, 0x03, gain >> 8);
+        ret |= sensor_writeb2(sensor, AEC_PK_REAL_GAIN_L, gain);
     } else if ((enable != 0) && (!isnanf(gain_db_ceiling)) && (!isinff(gain_db_ceiling))) {
         int gain_ceiling = IM_MAX(IM_MIN(fast_expf((gain_db_ceiling / 20.0) * fast_log(10.0)) * 16.0, 1023), 0);
 
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_H, &reg);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_H, (reg & 0xFC) | (gain_ceiling >> 8));
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_GAIN_CEILING_L, gain_ceiling);
+        ret |= sensor_update_reg_bits(sensor, AEC_GAIN_CEILING_H, 0x03, gain_ceiling >> 8);
+        ret |= sensor_writeb2(sensor, AEC_GAIN_CEILING_L, gain_ceiling);
     }
 
     return ret;
@@ -1085,8 +1051,8 @@ static int get_gain_db(sensor_t *sensor, float *gain_db)
 {
     uint8_t gainh, gainl;
 
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_REAL_GAIN_H, &gainh);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_REAL_GAIN_L, &gainl);
+    int ret = sensor_readb2(sensor, AEC_PK_REAL_GAIN_H, &gainh);
+    ret |= sensor_readb2(sensor, AEC_PK_REAL_GAIN_L, &gainl);
 
     *gain_db = 20.0 * (fast_log((((gainh & 0x3) << 8) | gainl) / 16.0) / fast_log(10.0));
 
@@ -1124,22 +1090,21 @@ static int calc_pclk_freq(uint8_t sc_pll_ctrl_0, uint8_t sc_pll_ctrl_1, uint8_t
 
 static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
 {
-    uint8_t reg, spc0, spc1, spc2, spc3, sysrootdiv, hts_h, hts_l, vts_h, vts_l;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_MANUAL, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_MANUAL, (reg & 0xFE) | ((enable == 0) << 0));
+    uint8_t spc0, spc1, spc2, spc3, sysrootdiv, hts_h, hts_l, vts_h, vts_l;
+    int ret = sensor_update_reg_bits(sensor, AEC_PK_MANUAL, 0x01, (enable == 0) << 0);
 
     if ((enable == 0) && (exposure_us >= 0)) {
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL0, &spc0);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL1, &spc1);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL2, &spc2);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL3, &spc3);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SYSTEM_ROOT_DIVIDER, &sysrootdiv);
+        ret |= sensor_readb2(sensor, SC_PLL_CONTRL0, &spc0);
+        ret |= sensor_readb2(sensor, SC_PLL_CONTRL1, &spc1);
+        ret |= sensor_readb2(sensor, SC_PLL_CONTRL2, &spc2);
+        ret |= sensor_readb2(sensor, SC_PLL_CONTRL3, &spc3);
+        ret |= sensor_readb2(sensor, SYSTEM_ROOT_DIVIDER, &sysrootdiv);
 
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_H, &hts_h);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_L, &hts_l);
+        ret |= sensor_readb2(sensor, TIMING_HTS_H, &hts_h);
+        ret |= sensor_readb2(sensor, TIMING_HTS_L, &hts_l);
 
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_H, &vts_h);
-        ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_L, &vts_l);
+        ret |= sensor_readb2(sensor, TIMING_VTS_H, &vts_h);
+        ret |= sensor_readb2(sensor, TIMING_VTS_L, &vts_l);
 
         uint16_t hts = (hts_h << 8) | hts_l;
         uint16_t vts = (vts_h << 8) | vts_l;
@@ -1150,12 +1115,12 @@ static int set_auto_exposure(sensor_t *sensor, int enable, int exposure_us)
 
         int new_vts = IM_MAX(exposure, vts);
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_0, exposure >> 12);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_1, exposure >> 4);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_2, exposure << 4);
+        ret |= sensor_writeb2(sensor, AEC_PK_EXPOSURE_0, exposure >> 12);
+        ret |= sensor_writeb2(sensor, AEC_PK_EXPOSURE_1, exposure >> 4);
+        ret |= sensor_writeb2(sensor, AEC_PK_EXPOSURE_2, exposure << 4);
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_H, new_vts >> 8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_VTS_L, new_vts);
+        uint8_t vts_regs[] = {new_vts >> 8, new_vts};
+        ret |= sensor_write_burst2(sensor, TIMING_VTS_H, vts_regs, sizeof(vts_regs));
     }
 
     return ret;
@@ -1166,18 +1131,18 @@ static int get_exposure_us(sensor_t *sensor, int *exposure_us)
     uint8_t spc0, spc1, spc2, spc3, sysrootdiv, aec_0, aec_1, aec_2, hts_h, hts_l;
     int ret = 0;
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL0, &spc0);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL1, &spc1);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL2, &spc2);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SC_PLL_CONTRL3, &spc3);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, SYSTEM_ROOT_DIVIDER, &sysrootdiv);
+    ret |= sensor_readb2(sensor, SC_PLL_CONTRL0, &spc0);
+    ret |= sensor_readb2(sensor, SC_PLL_CONTRL1, &spc1);
+    ret |= sensor_readb2(sensor, SC_PLL_CONTRL2, &spc2);
+    ret |= sensor_readb2(sensor, SC_PLL_CONTRL3, &spc3);
+    ret |= sensor_readb2(sensor, SYSTEM_ROOT_DIVIDER, &sysrootdiv);
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_0, &aec_0);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_1, &aec_1);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AEC_PK_EXPOSURE_2, &aec_2);
+    ret |= sensor_readb2(sensor, AEC_PK_EXPOSURE_0, &aec_0);
+    ret |= sensor_readb2(sensor, AEC_PK_EXPOSURE_1, &aec_1);
+    ret |= sensor_readb2(sensor, AEC_PK_EXPOSURE_2, &aec_2);
 
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_H, &hts_h);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_HTS_L, &hts_l);
+    ret |= sensor_readb2(sensor, TIMING_HTS_H, &hts_h);
+    ret |= sensor_readb2(sensor, TIMING_HTS_L, &hts_l);
 
     uint32_t aec = ((aec_0 << 16) | (aec_1 << 8) | aec_2) >> 4;
     uint16_t hts = (hts_h << 8) | hts_l;
@@ -1191,9 +1156,7 @@ static int get_exposure_us(sensor_t *sensor, int *exposure_us)
 
 static int set_auto_whitebal(sensor_t *sensor, int enable, float r_gain_db, float g_gain_db, float b_gain_db)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_MANUAL_CONTROL, &reg);
-    ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_MANUAL_CONTROL, (reg & 0xFE) | (enable == 0));
+    int ret = sensor_update_reg_bits(sensor, AWB_MANUAL_CONTROL, 0x01, (enable == 0));
 
     if ((enable == 0) && (!isnanf(r_gain_db)) && (!isnanf(g_gain_db)) && (!isnanf(b_gain_db))
                       && (!isinff(r_gain_db)) && (!isinff(g_gain_db)) && (!isinff(b_gain_db))) {
@@ -1202,12 +1165,12 @@ static int set_auto_whitebal(sensor_t *sensor, int enable, float r_gain_db, floa
         int g_gain = IM_MAX(IM_MIN(fast_roundf(fast_expf((g_gain_db / 20.0) * fast_log(10.0))), 4095), 0);
         int b_gain = IM_MAX(IM_MIN(fast_roundf(fast_expf((b_gain_db / 20.0) * fast_log(10.0))), 4095), 0);
 
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_R_GAIN_H, r_gain >> 8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_R_GAIN_L, r_gain);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_G_GAIN_H, g_gain >> 8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_G_GAIN_L, g_gain);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_B_GAIN_H, b_gain >> 8);
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, AWB_B_GAIN_L, b_gain);
+        ret |= sensor_writeb2(sensor, AWB_R_GAIN_H, r_gain >> 8);
+        ret |= sensor_writeb2(sensor, AWB_R_GAIN_L, r_gain);
+        ret |= sensor_writeb2(sensor, AWB_G_GAIN_H, g_gain >> 8);
+        ret |= sensor_writeb2(sensor, AWB_G_GAIN_L, g_gain);
+        ret |= sensor_writeb2(sensor, AWB_B_GAIN_H, b_gain >> 8);
+        ret |= sensor_writeb2(sensor, AWB_B_GAIN_L, b_gain);
     }
 
     return ret;
@@ -1217,12 +1180,12 @@ static int get_rgb_gain_db(sensor_t *sensor, float *r_gain_db, float *g_gain_db,
 {
     uint8_t redh, redl, greenh, greenl, blueh, bluel;
 
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_R_GAIN_H, &redh);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_R_GAIN_L, &redl);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_G_GAIN_H, &greenh);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_G_GAIN_L, &greenl);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_B_GAIN_H, &blueh);
-    ret |= cambus_readb2(&sensor->bus, sensor->slv_addr, AWB_B_GAIN_L, &bluel);
+    int ret = sensor_readb2(sensor, AWB_R_GAIN_H, &redh);
+    ret |= sensor_readb2(sensor, AWB_R_GAIN_L, &redl);
+    ret |= sensor_readb2(sensor, AWB_G_GAIN_H, &greenh);
+    ret |= sensor_readb2(sensor, AWB_G_GAIN_L, &greenl);
+    ret |= sensor_readb2(sensor, AWB_B_GAIN_H, &blueh);
+    ret |= sensor_readb2(sensor, AWB_B_GAIN_L, &bluel);
 
     *r_gain_db = 20.0 * (fast_log(((redh & 0xF) << 8) | redl) / fast_log(10.0));
     *g_gain_db = 20.0 * (fast_log(((greenh & 0xF) << 8) | greenl) / fast_log(10.0));
@@ -1233,26 +1196,12 @@ static int get_rgb_gain_db(sensor_t *sensor, float *r_gain_db, float *g_gain_db,
 
 static int set_hmirror(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, &reg);
-    if (enable){
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, reg|0x06);
-    } else {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_21, reg&0xF9);
-    }
-    return ret;
+    return sensor_update_reg_bits(sensor, TIMING_TC_REG_21, 0x06, enable ? 0x06 : 0x00);
 }
 
 static int set_vflip(sensor_t *sensor, int enable)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_20, &reg);
-    if (!enable){
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_20, reg|0x06);
-    } else {
-        ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, TIMING_TC_REG_20, reg&0xF9);
-    }
-    return ret;
+    return sensor_update_reg_bits(sensor, TIMING_TC_REG_20, 0x06, enable ? 0x00 : 0x06);
 }
 
 static int set_special_effect(sensor_t *sensor, sde_t sde)
@@ -1261,22 +1210,22 @@ static int set_special_effect(sensor_t *sensor, sde_t sde)
 
     switch (sde) {
         case SDE_NEGATIVE:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x03); // start group 3
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5580, 0x40);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5003, 0x08);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5583, 0x40); // sat U
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5584, 0x10); // sat V
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x13); // end group 3
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0xa3); // latch group 3
+            ret |= sensor_writeb2(sensor, 0x3212, 0x03); // start group 3
+            ret |= sensor_writeb2(sensor, 0x5580, 0x40);
+            ret |= sensor_writeb2(sensor, 0x5003, 0x08);
+            ret |= sensor_writeb2(sensor, 0x5583, 0x40); // sat U
+            ret |= sensor_writeb2(sensor, 0x5584, 0x10); // sat V
+            ret |= sensor_writeb2(sensor, 0x3212, 0x13); // end group 3
+            ret |= sensor_writeb2(sensor, 0x3212, 0xa3); // latch group 3
             break;
         case SDE_NORMAL:
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x03); // start group 3
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5580, 0x06);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5583, 0x40); // sat U
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5584, 0x10); // sat V
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x5003, 0x08);
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0x13); // end group 3
-            ret |= cambus_writeb2(&sensor->bus, sensor->slv_addr, 0x3212, 0xa3); // latch group 3
+            ret |= sensor_writeb2(sensor, 0x3212, 0x03); // start group 3
+            ret |= sensor_writeb2(sensor, 0x5580, 0x06);
+            ret |= sensor_writeb2(sensor, 0x5583, 0x40); // sat U
+            ret |= sensor_writeb2(sensor, 0x5584, 0x10); // sat V
+            ret |= sensor_writeb2(sensor, 0x5003, 0x08);
+            ret |= sensor_writeb2(sensor, 0x3212, 0x13); // end group 3
+            ret |= sensor_writeb2(sensor, 0x3212, 0xa3); // latch group 3
             break;
         default:
             return -1;
@@ -1287,9 +1236,7 @@ static int set_special_effect(sensor_t *sensor, sde_t sde)
 
 static int set_lens_correction(sensor_t *sensor, int enable, int radi, int coef)
 {
-    uint8_t reg;
-    int ret = cambus_readb2(&sensor->bus, sensor->slv_addr, ISP_CONTROL_00, &reg);
-    return cambus_writeb2(&sensor->bus, sensor->slv_addr, ISP_CONTROL_00, (reg & 0x7F) | (enable ? 0x80 : 0x00)) | ret;
+    return sensor_update_reg_bits(sensor, ISP_CONTROL_00, 0x80, enable ? 0x80 : 0x00);
 }
 
 static int ioctl(sensor_t *sensor, int request, va_list ap)
@@ -1323,22 +1270,22 @@ static int ioctl(sensor_t *sensor, int request, va_list ap)
         }
     #if (OMV_ENABLE_OV5640_AF == 1)
         case IOCTL_TRIGGER_AUTO_FOCUS: {
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, AF_CMD_MAIN, 0x03);
+            ret = sensor_writeb2(sensor, AF_CMD_MAIN, 0x03);
             break;
         }
         case IOCTL_PAUSE_AUTO_FOCUS: {
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, AF_CMD_MAIN, 0x06);
+            ret = sensor_writeb2(sensor, AF_CMD_MAIN, 0x06);
             break;
         }
         case IOCTL_RESET_AUTO_FOCUS: {
-            ret = cambus_writeb2(&sensor->bus, sensor->slv_addr, AF_CMD_MAIN, 0x08);
+            ret = sensor_writeb2(sensor, AF_CMD_MAIN, 0x08);
             break;
         }
         case IOCTL_WAIT_ON_AUTO_FOCUS: {
             mp_uint_t start_tick = mp_hal_ticks_ms(), delay_ms = va_arg(ap, uint32_t);
             for (;;) {
                 uint8_t reg;
-                ret = cambus_readb2(&sensor->bus, sensor->slv_addr, AF_CMD_ACK, &reg);
+                ret = sensor_readb2(sensor, AF_CMD_ACK, &reg);
                 if ((ret < 0) || (!reg)) break;
                 if ((mp_hal_ticks_ms() - start_tick) >= delay_ms) return -1;
                 mp_hal_delay_ms(1);
@@ -1381,6 +1328,7 @@ int ov5640_init(sensor_t *sensor)
     sensor->set_special_effect  = set_special_effect;
     sensor->set_lens_correction = set_lens_correction;
     sensor->ioctl               = ioctl;
+    sensor->volatile_regs       = volatile_regs;
 
     // Set sensor flags
     sensor->hw_flags.vsync      = 1;
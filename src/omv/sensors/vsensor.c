@@ -0,0 +1,640 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Virtual sensor driver.
+ *
+ * Replays frames recorded with ImageIO, MJPEG files or image files (PGM/PPM/BMP/JPG/PNG)
+ * through the regular snapshot path, so whole script pipelines can be run and measured
+ * without an image sensor. Frames are scaled to the frame size and cropped to the window
+ * the same way the other drivers do it.
+ */
+#include "omv_boardconfig.h"
+#if (OMV_ENABLE_VSENSOR == 1)
+
+#include <string.h>
+#include "py/mphal.h"
+#include "sensor.h"
+#include "framebuffer.h"
+#include "fb_alloc.h"
+#include "ff_wrapper.h"
+#include "vsensor.h"
+
+// ImageIO file stream format (see py_imageio.c).
+#define IMAGEIO_OLD_BINARY_BPP      (0)
+#define IMAGEIO_OLD_GRAYSCALE_BPP   (1)
+#define IMAGEIO_OLD_RGB565_BPP      (2)
+#define IMAGEIO_OLD_BAYER_BPP       (3)
+#define IMAGEIO_OLD_JPG_BPP         (4)
+#define IMAGEIO_MAGIC_SIZE          (16)
+#define IMAGEIO_ALIGN_SIZE          (16)
+#define IMAGEIO_AFTER_SIZE_PADDING  (12)
+#define IMAGEIO_ORIGINAL_VER        (10)
+#define IMAGEIO_RGB565_FIXED_VER    (11)
+#define IMAGEIO_NEW_PIXFORMAT_VER   (20)
+
+#define VSENSOR_PATH_MAX            (64)
+#define VSENSOR_NUMBER_MAX          (10)    // Digits of the largest frame number.
+#define VSENSOR_NAME_MAX            (VSENSOR_PATH_MAX + VSENSOR_NUMBER_MAX)
+
+typedef enum {
+    VSENSOR_SOURCE_NONE,
+    VSENSOR_SOURCE_IMAGEIO,     // ImageIO file stream.
+    VSENSOR_SOURCE_MJPEG,       // MJPEG AVI file.
+    VSENSOR_SOURCE_IMAGES,      // One image file or numbered image files, e.g. "frames/%04d.pgm".
+} vsensor_source_t;
+
+static FIL fp;
+static vsensor_source_t source = VSENSOR_SOURCE_NONE;
+static char source_path[VSENSOR_PATH_MAX]; // Path with the frame number of a sequence cut out.
+static int number_offset = -1;      // Offset of the frame number in source_path (-1 if none).
+static int number_width = 0;        // Minimum number of digits of the frame number.
+static char number_pad = ' ';       // Padding of the frame number.
+static bool source_loop = true;
+static bool source_realtime = false;
+static int imageio_version = 0;
+static uint32_t data_start = 0;     // File offset of the first frame.
+static uint32_t data_end = 0;       // File offset past the last frame.
+static int mjpeg_w = 0;
+static int mjpeg_h = 0;
+static uint32_t mjpeg_frame_ms = 0;
+static uint32_t first_index = 0;    // Number of the first file of an image sequence.
+static uint32_t frame_index = 0;    // Number of frames read since the start of the source.
+static uint32_t timestamp_ms = 0;   // Recorded timestamp of the last frame.
+static bool h_mirror = false;
+static bool v_flip = false;
+
+// Copies path to source_path, cutting out the frame number of an image sequence, which is
+// written "%d", "%<width>d" or "%0<width>d" like in printf(). "%%" is a literal '%'. Returns
+// -1 if the path is too long or has any other '%' conversion.
+static int vsensor_parse_path(const char *path)
+{
+    int len = 0, offset = -1;
+
+    for (const char *p = path; *p; p++) {
+        if (len >= (VSENSOR_PATH_MAX - 1)) {
+            return -1;
+        }
+
+        if (*p != '%') {
+            source_path[len++] = *p;
+            continue;
+        }
+
+        if (*(++p) == '%') {
+            source_path[len++] = '%';
+            continue;
+        }
+
+        // Only one frame number is allowed.
+        if (offset >= 0) {
+            return -1;
+        }
+
+        number_pad = (*p == '0') ? '0' : ' ';
+        number_width = 0;
+
+        for (; ('0' <= *p) && (*p <= '9'); p++) {
+            number_width = (number_width * 10) + (*p - '0');
+            if (number_width > VSENSOR_NUMBER_MAX) {
+                return -1;
+            }
+        }
+
+        if (*p != 'd') {
+            return -1;
+        }
+
+        offset = len;
+    }
+
+    source_path[len] = '\0';
+    number_offset = offset;
+    return 0;
+}
+
+static bool vsensor_is_sequence()
+{
+    return number_offset >= 0;
+}
+
+// Builds the file name of frame index of an image sequence (path is VSENSOR_NAME_MAX long).
+static bool vsensor_sequence_path(char *path, uint32_t index)
+{
+    char digits[VSENSOR_NUMBER_MAX];
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + (index % 10);
+        index /= 10;
+    } while (index);
+
+    memcpy(path, source_path, number_offset);
+    char *p = path + number_offset;
+
+    for (int i = n; i < number_width; i++) {
+        *p++ = number_pad;
+    }
+
+    while (n) {
+        *p++ = digits[--n];
+    }
+
+    strcpy(p, source_path + number_offset);
+    return f_stat_helper(path, NULL) == FR_OK;
+}
+
+static void vsensor_close()
+{
+    if ((source == VSENSOR_SOURCE_IMAGEIO) || (source == VSENSOR_SOURCE_MJPEG)) {
+        f_close(&fp);
+    }
+
+    source = VSENSOR_SOURCE_NONE;
+}
+
+static void vsensor_rewind()
+{
+    if ((source == VSENSOR_SOURCE_IMAGEIO) || (source == VSENSOR_SOURCE_MJPEG)) {
+        file_seek(&fp, data_start);
+    }
+
+    frame_index = 0;
+    timestamp_ms = 0;
+}
+
+static void vsensor_open_mjpeg()
+{
+    read_long_ignore(&fp); // RIFF size
+    read_long_expect(&fp, *((uint32_t *) "AVI "));
+
+    // Walk the chunks until the movi list, descending into the other lists.
+    for (;;) {
+        uint32_t fourcc, size;
+        read_long(&fp, &fourcc);
+        read_long(&fp, &size);
+
+        if (fourcc == *((uint32_t *) "LIST")) {
+            uint32_t type;
+            read_long(&fp, &type);
+
+            if (type == *((uint32_t *) "movi")) {
+                data_start = f_tell(&fp);
+                // The movi size is only updated when the file is closed.
+                data_end = size ? IM_MIN(data_start + size - 4, f_size(&fp)) : f_size(&fp);
+                break;
+            }
+        } else if (fourcc == *((uint32_t *) "avih")) {
+            uint32_t us, w, h;
+            read_long(&fp, &us); // dwMicroSecPerFrame
+            file_seek(&fp, f_tell(&fp) + 28);
+            read_long(&fp, &w); // dwWidth
+            read_long(&fp, &h); // dwHeight
+            file_seek(&fp, f_tell(&fp) + size - 40);
+            mjpeg_frame_ms = (us + 500) / 1000;
+            mjpeg_w = w;
+            mjpeg_h = h;
+        } else {
+            file_seek(&fp, f_tell(&fp) + ((size + 1) & ~1));
+        }
+    }
+}
+
+static int vsensor_open(const char *path, bool loop, bool realtime)
+{
+    vsensor_close();
+
+    if (vsensor_parse_path(path) != 0) {
+        return -1;
+    }
+
+    source_loop = loop;
+    source_realtime = realtime;
+
+    if (vsensor_is_sequence()) {
+        char name[VSENSOR_NAME_MAX];
+        // Sequences may be numbered from 0 or from 1.
+        for (first_index = 0; !vsensor_sequence_path(name, first_index); first_index++) {
+            if (first_index == 1) {
+                return -1;
+            }
+        }
+
+        source = VSENSOR_SOURCE_IMAGES;
+    } else {
+        uint32_t magic;
+        file_read_open(&fp, source_path);
+        read_long(&fp, &magic);
+
+        if (magic == *((uint32_t *) "OMV ")) {
+            uint8_t version_hi, version_lo;
+            read_long_expect(&fp, *((uint32_t *) "IMG "));
+            read_long_expect(&fp, *((uint32_t *) "STR "));
+            read_byte_expect(&fp, 'V');
+            read_byte(&fp, &version_hi);
+            read_byte_expect(&fp, '.');
+            read_byte(&fp, &version_lo);
+            imageio_version = ((version_hi - '0') * 10) + (version_lo - '0');
+
+            if ((imageio_version != IMAGEIO_ORIGINAL_VER)
+            && (imageio_version != IMAGEIO_RGB565_FIXED_VER)
+            && (imageio_version != IMAGEIO_NEW_PIXFORMAT_VER)) {
+                ff_unsupported_format(&fp);
+            }
+
+            data_start = IMAGEIO_MAGIC_SIZE;
+            data_end = f_size(&fp);
+            source = VSENSOR_SOURCE_IMAGEIO;
+        } else if (magic == *((uint32_t *) "RIFF")) {
+            vsensor_open_mjpeg();
+            source = VSENSOR_SOURCE_MJPEG;
+        } else {
+            // A single image file is replayed on every snapshot.
+            file_close(&fp);
+            source = VSENSOR_SOURCE_IMAGES;
+        }
+    }
+
+    vsensor_rewind();
+    return 0;
+}
+
+// Reads the next frame into fb_alloc() memory. Returns false at the end of the source.
+static bool vsensor_read_frame(image_t *img, uint32_t *elapsed_ms)
+{
+    *elapsed_ms = 0;
+
+    switch (source) {
+        case VSENSOR_SOURCE_IMAGEIO: {
+            uint32_t w, h, bpp;
+
+            if (f_tell(&fp) >= data_end) {
+                return false;
+            }
+
+            read_long(&fp, elapsed_ms);
+            read_long(&fp, &w);
+            read_long(&fp, &h);
+            read_long(&fp, &bpp);
+            img->w = w;
+            img->h = h;
+
+            if (imageio_version < IMAGEIO_NEW_PIXFORMAT_VER) {
+                if (bpp == IMAGEIO_OLD_BINARY_BPP) {
+                    img->pixfmt = PIXFORMAT_BINARY;
+                } else if (bpp == IMAGEIO_OLD_GRAYSCALE_BPP) {
+                    img->pixfmt = PIXFORMAT_GRAYSCALE;
+                } else if (bpp == IMAGEIO_OLD_RGB565_BPP) {
+                    img->pixfmt = PIXFORMAT_RGB565;
+                } else if (bpp == IMAGEIO_OLD_BAYER_BPP) {
+                    img->pixfmt = PIXFORMAT_BAYER;
+                } else if (bpp >= IMAGEIO_OLD_JPG_BPP) {
+                    img->pixfmt = PIXFORMAT_JPEG;
+                    img->size = bpp;
+                } else {
+                    ff_file_corrupted(&fp);
+                }
+            } else {
+                uint32_t size;
+
+                if (!IMLIB_PIXFORMAT_IS_VALID(bpp)) {
+                    ff_file_corrupted(&fp);
+                }
+
+                img->pixfmt = bpp;
+                read_long(&fp, &size);
+                img->size = size;
+                file_seek(&fp, f_tell(&fp) + IMAGEIO_AFTER_SIZE_PADDING);
+            }
+
+            uint32_t size = image_size(img);
+            img->data = fb_alloc(size, FB_ALLOC_NO_HINT);
+            read_data(&fp, img->data, size);
+
+            // Check if original byte reversed data.
+            if ((img->pixfmt == PIXFORMAT_RGB565) && (imageio_version == IMAGEIO_ORIGINAL_VER)) {
+                uint16_t *data_ptr = (uint16_t *) img->data;
+
+                for (size_t i = 0, ii = img->w * img->h; i < ii; i++) {
+                    data_ptr[i] = (data_ptr[i] >> 8) | (data_ptr[i] << 8);
+                }
+            }
+
+            if (size % IMAGEIO_ALIGN_SIZE) {
+                file_seek(&fp, f_tell(&fp) + IMAGEIO_ALIGN_SIZE - (size % IMAGEIO_ALIGN_SIZE));
+            }
+
+            break;
+        }
+        case VSENSOR_SOURCE_MJPEG: {
+            uint32_t fourcc, size;
+
+            // Skip anything that is not a compressed video frame.
+            for (;;) {
+                if ((f_tell(&fp) + 8) > data_end) {
+                    return false;
+                }
+
+                read_long(&fp, &fourcc);
+                read_long(&fp, &size);
+
+                if (fourcc == *((uint32_t *) "00dc")) {
+                    break;
+                }
+
+                file_seek(&fp, f_tell(&fp) + ((size + 1) & ~1));
+            }
+
+            img->w = mjpeg_w;
+            img->h = mjpeg_h;
+            img->pixfmt = PIXFORMAT_JPEG;
+            img->size = size;
+            img->data = fb_alloc(size, FB_ALLOC_NO_HINT);
+            read_data(&fp, img->data, size);
+
+            if (size % 2) {
+                file_seek(&fp, f_tell(&fp) + 1);
+            }
+
+            *elapsed_ms = mjpeg_frame_ms;
+            break;
+        }
+        case VSENSOR_SOURCE_IMAGES: {
+            FIL img_fp;
+            img_read_settings_t rs;
+            char name[VSENSOR_NAME_MAX];
+            const char *path = source_path;
+
+            if (vsensor_is_sequence()) {
+                if (!vsensor_sequence_path(name, first_index + frame_index)) {
+                    return false;
+                }
+
+                path = name;
+            }
+
+            imlib_read_geometry(&img_fp, img, path, &rs);
+            file_buffer_off(&img_fp);
+            file_close(&img_fp);
+
+            img->data = fb_alloc(image_size(img), FB_ALLOC_NO_HINT);
+            imlib_load_image(img, path);
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Waits until the frame is due. The frame rate set by the user has priority over the
+// recorded frame times, which are only followed in realtime mode.
+static void vsensor_wait(sensor_t *sensor, uint32_t period_ms)
+{
+    uint32_t tick = mp_hal_ticks_ms();
+
+    if (sensor->last_frame_ms_valid && period_ms) {
+        uint32_t next_ms = sensor->last_frame_ms + period_ms;
+
+        if (((int32_t) (next_ms - tick)) > 0) {
+            mp_hal_delay_ms(next_ms - tick);
+            tick = next_ms;
+        }
+        // Otherwise replay fell behind, so start pacing again from now instead of bursting.
+    }
+
+    sensor->last_frame_ms = tick;
+    sensor->last_frame_ms_valid = true;
+}
+
+static void vsensor_flip(image_t *img)
+{
+    int bpp = img->bpp;
+
+    for (int y = 0, yy = v_flip ? (img->h / 2) : img->h; y < yy; y++) {
+        uint8_t *row_ptr = img->data + (y * img->w * bpp);
+        uint8_t *other_ptr = v_flip ? (img->data + ((img->h - y - 1) * img->w * bpp)) : row_ptr;
+
+        for (int x = 0, xx = (h_mirror && (row_ptr == other_ptr)) ? (img->w / 2) : img->w; x < xx; x++) {
+            uint8_t *a = row_ptr + (x * bpp), *b = other_ptr + ((h_mirror ? (img->w - x - 1) : x) * bpp);
+
+            for (int i = 0; i < bpp; i++) {
+                uint8_t t = a[i];
+                a[i] = b[i];
+                b[i] = t;
+            }
+        }
+    }
+
+    // The middle row of an odd height image still has to be mirrored.
+    if (v_flip && h_mirror && (img->h % 2)) {
+        uint8_t *row_ptr = img->data + ((img->h / 2) * img->w * bpp);
+
+        for (int x = 0, xx = img->w / 2; x < xx; x++) {
+            uint8_t *a = row_ptr + (x * bpp), *b = row_ptr + ((img->w - x - 1) * bpp);
+
+            for (int i = 0; i < bpp; i++) {
+                uint8_t t = a[i];
+                a[i] = b[i];
+                b[i] = t;
+            }
+        }
+    }
+}
+
+static int reset(sensor_t *sensor)
+{
+    h_mirror = false;
+    v_flip = false;
+
+    if (source != VSENSOR_SOURCE_NONE) {
+        vsensor_rewind();
+    }
+
+    return 0;
+}
+
+static int set_pixformat(sensor_t *sensor, pixformat_t pixformat)
+{
+    switch (pixformat) {
+        case PIXFORMAT_GRAYSCALE:
+        case PIXFORMAT_RGB565:
+        case PIXFORMAT_JPEG:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+static int set_framesize(sensor_t *sensor, framesize_t framesize)
+{
+    return 0;
+}
+
+static int set_hmirror(sensor_t *sensor, int enable)
+{
+    h_mirror = enable;
+    return 0;
+}
+
+static int set_vflip(sensor_t *sensor, int enable)
+{
+    v_flip = enable;
+    return 0;
+}
+
+static int ioctl(sensor_t *sensor, int request, va_list ap)
+{
+    int ret = 0;
+
+    switch (request) {
+        case IOCTL_VSENSOR_SET_SOURCE: {
+            const char *path = va_arg(ap, const char *);
+            int loop = va_arg(ap, int);
+            int realtime = va_arg(ap, int);
+            ret = vsensor_open(path, loop, realtime);
+            break;
+        }
+        case IOCTL_VSENSOR_GET_FRAME_INFO: {
+            *va_arg(ap, int *) = frame_index;
+            *va_arg(ap, int *) = timestamp_ms;
+            break;
+        }
+        default: {
+            ret = -1;
+            break;
+        }
+    }
+
+    return ret;
+}
+
+static int snapshot(sensor_t *sensor, image_t *image, uint32_t flags)
+{
+    framebuffer_update_jpeg_buffer();
+
+    if (MAIN_FB()->n_buffers != 1) {
+        framebuffer_set_buffers(1);
+    }
+
+    if ((source == VSENSOR_SOURCE_NONE) || (!sensor->framesize) || (!sensor->pixformat)) {
+        return -1;
+    }
+
+    fb_alloc_mark();
+
+    image_t src = {};
+    uint32_t elapsed_ms;
+
+    if (!vsensor_read_frame(&src, &elapsed_ms)) {
+        if (!source_loop) {
+            fb_alloc_free_till_mark();
+            return SENSOR_ERROR_END_OF_STREAM;
+        }
+
+        vsensor_rewind();
+
+        if (!vsensor_read_frame(&src, &elapsed_ms)) {
+            fb_alloc_free_till_mark();
+            return SENSOR_ERROR_END_OF_STREAM;
+        }
+    }
+
+    uint32_t framerate_ms = IM_DIV(1000, sensor->framerate);
+
+    // Image files carry no timing so they are timestamped using the frame rate.
+    if (!elapsed_ms) {
+        elapsed_ms = framerate_ms;
+    }
+
+    timestamp_ms = frame_index ? (timestamp_ms + elapsed_ms) : 0;
+    frame_index += 1;
+
+    vsensor_wait(sensor, framerate_ms ? framerate_ms : (source_realtime ? elapsed_ms : 0));
+
+    // The source frame shrinks the frame buffer so it is checked after the frame is read.
+    if (sensor_check_framebuffer_size() == -1) {
+        fb_alloc_free_till_mark();
+        return SENSOR_ERROR_FRAMEBUFFER_OVERFLOW;
+    }
+
+    framebuffer_free_current_buffer();
+    vbuffer_t *buffer = framebuffer_get_tail(FB_NO_FLAGS);
+
+    if (!buffer) {
+        fb_alloc_free_till_mark();
+        return SENSOR_ERROR_FRAMEBUFFER_ERROR;
+    }
+
+    if (sensor->pixformat == PIXFORMAT_JPEG) {
+        // JPEG frames are passed through as recorded.
+        if ((src.pixfmt != PIXFORMAT_JPEG) || (src.size > framebuffer_get_buffer_size())) {
+            fb_alloc_free_till_mark();
+            return SENSOR_ERROR_PIXFORMAT_UNSUPPORTED;
+        }
+
+        MAIN_FB()->w        = src.w;
+        MAIN_FB()->h        = src.h;
+        MAIN_FB()->size     = src.size;
+        MAIN_FB()->pixfmt   = PIXFORMAT_JPEG;
+
+        framebuffer_init_image(image);
+        memcpy(image->data, src.data, src.size);
+    } else {
+        MAIN_FB()->w        = MAIN_FB()->u;
+        MAIN_FB()->h        = MAIN_FB()->v;
+        MAIN_FB()->pixfmt   = sensor->pixformat;
+
+        framebuffer_init_image(image);
+
+        int res_w = resolution[sensor->framesize][0];
+        int res_h = resolution[sensor->framesize][1];
+        float x_scale = res_w / ((float) src.w);
+        float y_scale = res_h / ((float) src.h);
+        // MAX == KeepAspectRationByExpanding - MIN == KeepAspectRatio
+        float scale = IM_MAX(x_scale, y_scale);
+        int x_offset = (res_w - (src.w * scale)) / 2;
+        int y_offset = (res_h - (src.h * scale)) / 2;
+        // Crop the mirrored window so that flipping the frame afterwards shows the right part.
+        int x = h_mirror ? (res_w - MAIN_FB()->x - MAIN_FB()->u) : MAIN_FB()->x;
+        int y = v_flip ? (res_h - MAIN_FB()->y - MAIN_FB()->v) : MAIN_FB()->y;
+
+        // Scales the frame to the frame size and crops it to the window in one pass.
+        imlib_draw_image(image, &src, x_offset - x, y_offset - y, scale, scale, NULL,
+                         -1, 256, NULL, NULL, IMAGE_HINT_BILINEAR, NULL, NULL);
+
+        if (h_mirror || v_flip) {
+            vsensor_flip(image);
+        }
+    }
+
+    fb_alloc_free_till_mark();
+    return 0;
+}
+
+int vsensor_init(sensor_t *sensor)
+{
+    sensor->reset               = reset;
+    sensor->snapshot            = snapshot;
+    sensor->set_pixformat       = set_pixformat;
+    sensor->set_framesize       = set_framesize;
+    sensor->set_hmirror         = set_hmirror;
+    sensor->set_vflip           = set_vflip;
+    sensor->ioctl               = ioctl;
+
+    sensor->hw_flags.vsync      = 0;
+    sensor->hw_flags.hsync      = 0;
+    sensor->hw_flags.pixck      = 0;
+    sensor->hw_flags.fsync      = 0;
+    sensor->hw_flags.jpege      = 1;
+    sensor->hw_flags.gs_bpp     = 1;
+
+    return 0;
+}
+#endif // (OMV_ENABLE_VSENSOR == 1)
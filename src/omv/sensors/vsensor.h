@@ -0,0 +1,14 @@
+/*
+ * This file is part of the OpenMV project.
+ *
+ * Copyright (c) 2013-2021 Ibrahim Abdelkader <iabdalkader@openmv.io>
+ * Copyright (c) 2013-2021 Kwabena W. Agyeman <kwagyeman@openmv.io>
+ *
+ * This work is licensed under the MIT license, see the file LICENSE for details.
+ *
+ * Virtual sensor driver (replays recorded frames).
+ */
+#ifndef __VSENSOR_H__
+#define __VSENSOR_H__
+int vsensor_init(sensor_t *sensor);
+#endif // __VSENSOR_H__